@@ -51,19 +51,15 @@ ExpatAttributes::ExpatAttributes (const XML_Char** attrs,
 				  const XML_Char* elementName,
 				  const XML_Char sep)
 {
-  unsigned int size = 0;
-  while (attrs[2 * size]) ++size;
-
-  mNames .reserve(size);
-  mValues.reserve(size);
+  reset(attrs, elementName, sep);
+}
 
-  for (unsigned int n = 0; n < size; ++n)
-  {
-    mNames .push_back( XMLTriple( attrs[2 * n], sep ) );
-    mValues.push_back( string   ( attrs[2 * n + 1]  ) );
-  }
 
-  mElementName = elementName;
+/**
+ * Creates a new empty ExpatAttributes set.
+ */
+ExpatAttributes::ExpatAttributes ()
+{
 }
 
 
@@ -74,5 +70,32 @@ ExpatAttributes::~ExpatAttributes ()
 {
 }
 
+
+/**
+ * Replaces the contents of this set with the given "raw" Expat
+ * attributes, reusing the existing names and values.
+ */
+void
+ExpatAttributes::reset (const XML_Char** attrs,
+                        const XML_Char* elementName,
+                        const XML_Char sep)
+{
+  unsigned int size = 0;
+  while (attrs[2 * size]) ++size;
+
+  mNames .resize(size);
+  mValues.resize(size);
+
+  for (unsigned int n = 0; n < size; ++n)
+  {
+    mNames [n].setTriplet( attrs[2 * n], sep );
+    mValues[n].assign    ( attrs[2 * n + 1]  );
+  }
+
+  reindex();
+
+  mElementName.assign(elementName);
+}
+
 LIBLX_CPP_NAMESPACE_END
 /** @endcond */
@@ -64,10 +64,29 @@ public:
 		   const XML_Char sepchar = ' ');
 
 
+  /**
+   * Creates a new empty ExpatAttributes set, to be filled by reset().
+   */
+  ExpatAttributes ();
+
+
   /**
    * Destroys this ExpatAttributes set.
    */
   virtual ~ExpatAttributes ();
+
+
+  /**
+   * Replaces the contents of this set with the given "raw" Expat
+   * attributes.  The names and values already held by this set are
+   * overwritten in place, so a set that is reset for every element
+   * reuses its storage.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  void reset (const XML_Char** attrs,
+              const XML_Char* elementName,
+              const XML_Char sepchar = ' ');
 };
 
 LIBLX_CPP_NAMESPACE_END
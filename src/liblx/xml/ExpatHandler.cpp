@@ -124,6 +124,8 @@ ExpatHandler::ExpatHandler (XML_Parser parser, XMLHandler& handler) :
   XML_SetUserData            ( mParser, static_cast<void*>(this)     );
   XML_SetReturnNSTriplet     ( mParser, 1                            );
   mHandlerError = NULL;
+  mStopOffset   = -1;
+  mTrackPositions = true;
   setHasXMLDeclaration(false);
 }
 
@@ -136,6 +138,8 @@ ExpatHandler::ExpatHandler (const ExpatHandler& other)
   , mHandler (other.mHandler)
   , mNamespaces (other.mNamespaces)
   , mHandlerError(NULL)
+  , mStopOffset(other.mStopOffset)
+  , mTrackPositions(other.mTrackPositions)
 {
 }
 
@@ -151,6 +155,8 @@ ExpatHandler& ExpatHandler::operator=(const ExpatHandler& other)
   mHandler = other.mHandler; 
   mNamespaces = other.mNamespaces;
   mHandlerError = NULL;
+  mStopOffset = other.mStopOffset;
+  mTrackPositions = other.mTrackPositions;
 
   return *this;
 }
@@ -170,6 +176,7 @@ ExpatHandler::~ExpatHandler ()
 void
 ExpatHandler::startDocument ()
 {
+  mStopOffset = -1;
   mHandler.startDocument();
 }
 
@@ -212,13 +219,43 @@ ExpatHandler::XML (const XML_Char* version, const XML_Char* encoding)
 void
 ExpatHandler::startElement (const XML_Char* name, const XML_Char** attrs)
 {
-  const XMLTriple       triple    ( name  );
-  const ExpatAttributes attributes( attrs, name );
-  const XMLToken        element   ( triple, attributes, mNamespaces,
-			            getLine(), getColumn() );
+  if (mHandler.isSkipping())
+  {
+    mHandler.skipStartElement();
+    mNamespaces.clear();
+    return;
+  }
+
+  mTriple.setTriplet( name );
+
+  if (!mHandler.acceptElement(mTriple))
+  {
+    mHandler.skipStartElement();
+    mNamespaces.clear();
+    return;
+  }
 
-  mHandler.startElement(element);
+  mAttributes.reset( attrs, name );
+
+  if (mTrackPositions)
+  {
+    mToken.assignStart( mTriple, mAttributes, mNamespaces,
+                        getLine(), getColumn() );
+  }
+  else
+  {
+    mToken.assignStart( mTriple, mAttributes, mNamespaces, 0, 0,
+                        (size_t) XML_GetCurrentByteIndex(mParser) );
+  }
+
+  mHandler.startElement(mToken);
   mNamespaces.clear();
+
+  if (mHandler.isStopped())
+  {
+    mStopOffset = static_cast<long>( XML_GetCurrentByteIndex(mParser) );
+    XML_StopParser(mParser, XML_FALSE);
+  }
 }
 
 
@@ -245,7 +282,7 @@ ExpatHandler::startNamespace (const XML_Char* prefix, const XML_Char* uri)
                                  "The prefix 'xml' is reserved in XML",
                                  getLine(), getColumn());
   }
-  else
+  else if (!mHandler.isSkipping())
   {
     mNamespaces.add(uri ? uri : "", prefix ? prefix : "");
   }
@@ -270,10 +307,25 @@ ExpatHandler::endDocument ()
 void
 ExpatHandler::endElement (const XML_Char* name)
 {
-  const XMLTriple  triple ( name );
-  const XMLToken   element( triple, getLine(), getColumn() );
+  if (mHandler.isSkipping())
+  {
+    mHandler.skipEndElement();
+    return;
+  }
+
+  mTriple.setTriplet( name );
+
+  if (mTrackPositions)
+  {
+    mToken.assignEnd( mTriple, getLine(), getColumn() );
+  }
+  else
+  {
+    mToken.assignEnd( mTriple, 0, 0,
+                      (size_t) XML_GetCurrentByteIndex(mParser) );
+  }
 
-  mHandler.endElement(element);
+  mHandler.endElement(mToken);
 }
 
 
@@ -286,8 +338,19 @@ ExpatHandler::endElement (const XML_Char* name)
 void
 ExpatHandler::characters (const XML_Char* chars, int length)
 {
-  XMLToken data( string(chars, length) );
-  mHandler.characters(data);
+  if (mHandler.isSkipping()) return;
+
+  if (mTrackPositions)
+  {
+    mToken.assignText( chars, static_cast<size_t>(length) );
+  }
+  else
+  {
+    mToken.assignText( chars, static_cast<size_t>(length), 0, 0,
+                       (size_t) XML_GetCurrentByteIndex(mParser) );
+  }
+
+  mHandler.characters(mToken);
 }
 
 
@@ -301,6 +364,28 @@ ExpatHandler::getColumn () const
 }
 
 
+/**
+ * Sets whether elements get their line and column numbers or only their
+ * byte offset.
+ */
+void
+ExpatHandler::setTrackPositions (bool track)
+{
+  mTrackPositions = track;
+}
+
+
+/**
+ * @return the byte offset of the start element at which the XMLHandler
+ * stopped the parser, or -1 if it has not stopped it.
+ */
+long
+ExpatHandler::getStopOffset () const
+{
+  return mStopOffset;
+}
+
+
 /**
  * @return the line number of the current XML event.
  */
@@ -46,7 +46,10 @@
 #include <expat.h>
 #include <liblx/xml/XMLHandler.h>
 #include <liblx/xml/XMLNamespaces.h>
+#include <liblx/xml/XMLTriple.h>
+#include <liblx/xml/XMLToken.h>
 #include <liblx/xml/XMLError.h>
+#include <liblx/xml/ExpatAttributes.h>
 
 
 LIBLX_CPP_NAMESPACE_BEGIN
@@ -159,6 +162,20 @@ public:
    */
   XMLError* error() { return mHandlerError; };
 
+  /**
+   * Returns the byte offset of the start element at which the XMLHandler
+   * stopped the parser, or @c -1 if it has not stopped it.
+   */
+  long getStopOffset () const;
+
+
+  /**
+   * Sets whether elements get their line and column numbers (the
+   * default) or only their byte offset.
+   */
+  void setTrackPositions (bool track);
+
+
   bool hasXMLDeclaration() { return gotXMLDecl; } 
   void setHasXMLDeclaration(bool value) { gotXMLDecl = value; }
 
@@ -171,6 +188,14 @@ protected:
   XMLNamespaces mNamespaces;
 
   XMLError*     mHandlerError;
+  long          mStopOffset;
+  bool          mTrackPositions;
+
+  // Scratch objects refilled for every event so that their storage is
+  // reused instead of being allocated per element.
+  XMLTriple       mTriple;
+  ExpatAttributes mAttributes;
+  XMLToken        mToken;
 
 };
 
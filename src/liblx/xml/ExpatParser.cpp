@@ -218,6 +218,18 @@ ExpatParser::getLine () const
 }
 
 
+/**
+ * Sets whether the line and column of every element are looked up while
+ * parsing, or only their byte offset.
+ */
+void
+ExpatParser::setTrackPositions (bool track)
+{
+  XMLParser::setTrackPositions(track);
+  mHandler.setTrackPositions(track);
+}
+
+
 /**
  * Parses XML content in one fell swoop.
  *
@@ -309,6 +321,9 @@ ExpatParser::parseFirst (const char* content, bool isFile)
     }
   }
 
+  mByteOffset = 0;
+  mLineStarts.clear();
+
   if ( !mSource->error() )
   {
     mHandler.startDocument();
@@ -357,8 +372,19 @@ ExpatParser::parseNext ()
 
   // Attempt to parse the content, checking for the Expat return status.
 
+  if (!mTrackPositions) indexLines(static_cast<const char*>(mBuffer), bytes);
+  mByteOffset += bytes;
+
   if ( XML_ParseBuffer(mParser, bytes, done) == XML_STATUS_ERROR )
   {
+    if ( XML_GetErrorCode(mParser) == XML_ERROR_ABORTED
+         && mHandler.getStopOffset() >= 0 )
+    {
+      // the handler wants no more of the document
+      mByteOffset = static_cast<size_t>( mHandler.getStopOffset() );
+      return true;
+    }
+
     reportError(translateError(XML_GetErrorCode(mParser)), "",
 		XML_GetCurrentLineNumber(mParser),
 		XML_GetCurrentColumnNumber(mParser));
@@ -36,6 +36,8 @@
  * also available online as http://sbml.org/software/libsbml/license.html
  * ---------------------------------------------------------------------- -->*/
 
+#include <cstring>
+
 #include <liblx/xml/LibXMLTranscode.h>
 #include <liblx/xml/LibXMLAttributes.h>
 
@@ -70,6 +72,8 @@ LibXMLAttributes::LibXMLAttributes (  const xmlChar** attributes
     mValues.push_back( value );
   }
 
+  reindex();
+
   mElementName = LibXMLTranscode(elementName);
 }
 
@@ -82,6 +86,57 @@ LibXMLAttributes::~LibXMLAttributes ()
 }
 
 
+/**
+ * Creates a new empty LibXMLAttributes set.
+ */
+LibXMLAttributes::LibXMLAttributes ()
+{
+}
+
+
+/**
+ * Replaces the contents of this set with the given "raw" LibXML
+ * attributes, reusing the existing names and values.
+ */
+void
+LibXMLAttributes::reset (  const xmlChar** attributes
+                         , const xmlChar*  elementName
+                         , const unsigned  int& size )
+{
+  mNames .resize(size);
+  mValues.resize(size);
+
+  for (unsigned int n = 0; n < size; ++n)
+  {
+    const char* name   = reinterpret_cast<const char*>( attributes[5 * n]     );
+    const char* prefix = reinterpret_cast<const char*>( attributes[5 * n + 1] );
+    const char* uri    = reinterpret_cast<const char*>( attributes[5 * n + 2] );
+
+    if (uri != NULL && strstr(uri, "&#38;") != NULL)
+    {
+      // rare enough that going through temporaries does not matter
+      mNames[n] = XMLTriple( LibXMLTranscode( attributes[5 * n]     ),
+                             LibXMLTranscode( attributes[5 * n + 2], true ),
+                             LibXMLTranscode( attributes[5 * n + 1] ) );
+    }
+    else
+    {
+      mNames[n].assign(name, uri, prefix);
+    }
+
+    const xmlChar* start = attributes[5 * n + 3];
+    const xmlChar* end   = attributes[5 * n + 4];
+    int length           = (int)(end - start) / (int)sizeof(xmlChar);
+
+    LibXMLTranscode((length > 0) ? start : 0, true, length).assignTo(mValues[n]);
+  }
+
+  reindex();
+
+  LibXMLTranscode(elementName).assignTo(mElementName);
+}
+
+
 LIBLX_CPP_NAMESPACE_END
 
 /** @endcond */
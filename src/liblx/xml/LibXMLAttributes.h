@@ -60,10 +60,27 @@ public:
 		    , const unsigned int& size);
 
 
+  /**
+   * Creates a new empty LibXMLAttributes set, to be filled by reset().
+   */
+  LibXMLAttributes ();
+
+
   /**
    * Destroys this LibXMLAttributes set.
    */
   virtual ~LibXMLAttributes ();
+
+
+  /**
+   * Replaces the contents of this set with the given "raw" LibXML
+   * attributes.  The names and values already held by this set are
+   * overwritten in place, so a set that is reset for every element
+   * reuses its storage.
+   */
+  void reset (  const xmlChar** attributes
+              , const xmlChar*  elementName
+              , const unsigned int& size);
 };
 
 LIBLX_CPP_NAMESPACE_END
@@ -74,12 +74,10 @@ x_start_element (  void*           user_data
                  , int             num_defaulted
                  , const xmlChar** attributes )
 {
-  const LibXMLAttributes attrs(attributes, localname,
-			       (unsigned int)(num_attributes + num_defaulted));
-  const LibXMLNamespaces xmlns(namespaces, (unsigned int)num_namespaces);
-
   static_cast<LibXMLHandler*>(user_data)->
-    startElement(localname, prefix, uri, attrs, xmlns);
+    startElement(localname, prefix, uri,
+                 namespaces, (unsigned int)num_namespaces,
+                 attributes, (unsigned int)(num_attributes + num_defaulted));
 }
 
 
@@ -166,6 +164,8 @@ LibXMLHandler::LibXMLHandler (XMLHandler& handler) :
    mHandler( handler )
  , mContext( NULL    )
  , mLocator( NULL    )
+ , mStopOffset( -1   )
+ , mTrackPositions( true )
 {
 }
 
@@ -177,6 +177,8 @@ LibXMLHandler::LibXMLHandler (const LibXMLHandler& other)
   : mHandler (other.mHandler)
   , mContext (other.mContext)
   , mLocator (other.mLocator)
+  , mStopOffset (other.mStopOffset)
+  , mTrackPositions (other.mTrackPositions)
 {
 }
 
@@ -191,6 +193,8 @@ LibXMLHandler& LibXMLHandler::operator=(const LibXMLHandler& other)
   mHandler = other.mHandler;
   mContext = other.mContext; 
   mLocator = other.mLocator;
+  mStopOffset = other.mStopOffset;
+  mTrackPositions = other.mTrackPositions;
 
   return *this;
 }
@@ -213,36 +217,57 @@ LibXMLHandler::startDocument ()
   const string version  = LibXMLTranscode( mContext->version  );
   const string encoding = LibXMLTranscode( mContext->encoding );
 
+  mStopOffset = -1;
+
   mHandler.startDocument();
   mHandler.XML(version, encoding);
 }
 
 
 /**
- * Receive notification of the start of an element.
- *
- * @param  localname   The local part of the element name
- * @param  prefix      The namespace prefix part of the element name.
- * @param  uri         The URI of the namespace for this element
- * @param  namespaces  The namespace definitions for this element
- * @param  attributes  The specified or defaulted attributes
+ * Receive notification of the start of an element, with the namespace
+ * declarations and attributes in "raw" LibXML form.
  */
 void
 LibXMLHandler::startElement (  const xmlChar*           localname
                              , const xmlChar*           prefix
                              , const xmlChar*           uri
-                             , const LibXMLAttributes&  attributes
-                             , const LibXMLNamespaces&  namespaces )
+                             , const xmlChar**          namespaces
+                             , unsigned int             numNamespaces
+                             , const xmlChar**          attributes
+                             , unsigned int             numAttributes )
 {
-  const string nsuri    = LibXMLTranscode( uri       );
-  const string name     = LibXMLTranscode( localname );
-  const string nsprefix = LibXMLTranscode( prefix    );
-
-  const XMLTriple  triple ( name, nsuri, nsprefix );
-  const XMLToken   element( triple, attributes, namespaces,
-                            getLine(), getColumn() );
+  if (mHandler.isSkipping())
+  {
+    mHandler.skipStartElement();
+    return;
+  }
+
+  mTriple.assign( reinterpret_cast<const char*>( localname ),
+                  reinterpret_cast<const char*>( uri       ),
+                  reinterpret_cast<const char*>( prefix    ) );
+
+  if (!mHandler.acceptElement(mTriple))
+  {
+    mHandler.skipStartElement();
+    return;
+  }
+
+  mAttributes.reset(attributes, localname, numAttributes);
+  mNamespaces.reset(namespaces, numNamespaces);
+
+  if (mTrackPositions)
+  {
+    mToken.assignStart( mTriple, mAttributes, mNamespaces,
+                        getLine(), getColumn() );
+  }
+  else
+  {
+    mToken.assignStart( mTriple, mAttributes, mNamespaces, 0, 0, getOffset() );
+  }
 
-  mHandler.startElement(element);
+  mHandler.startElement(mToken);
+  checkStopped();
 }
 
 
@@ -258,14 +283,26 @@ LibXMLHandler::endElement (  const xmlChar*   localname
                            , const xmlChar*   prefix
                            , const xmlChar*   uri )
 {
-  const string nsuri    = LibXMLTranscode( uri       );
-  const string name     = LibXMLTranscode( localname );
-  const string nsprefix = LibXMLTranscode( prefix    );
-
-  const XMLTriple  triple ( name, nsuri, nsprefix );
-  const XMLToken   element( triple, getLine(), getColumn() );
+  if (mHandler.isSkipping())
+  {
+    mHandler.skipEndElement();
+    return;
+  }
+
+  mTriple.assign( reinterpret_cast<const char*>( localname ),
+                  reinterpret_cast<const char*>( uri       ),
+                  reinterpret_cast<const char*>( prefix    ) );
+
+  if (mTrackPositions)
+  {
+    mToken.assignEnd( mTriple, getLine(), getColumn() );
+  }
+  else
+  {
+    mToken.assignEnd( mTriple, 0, 0, getOffset() );
+  }
 
-  mHandler.endElement(element);
+  mHandler.endElement(mToken);
 }
 
 
@@ -288,8 +325,20 @@ LibXMLHandler::endDocument ()
 void
 LibXMLHandler::characters (const xmlChar* chars, int length)
 {
-  XMLToken data( LibXMLTranscode(chars, length) );
-  mHandler.characters(data);
+  if (mHandler.isSkipping()) return;
+
+  if (mTrackPositions)
+  {
+    mToken.assignText( reinterpret_cast<const char*>(chars),
+                       static_cast<size_t>(length) );
+  }
+  else
+  {
+    mToken.assignText( reinterpret_cast<const char*>(chars),
+                       static_cast<size_t>(length), 0, 0, getOffset() );
+  }
+
+  mHandler.characters(mToken);
 }
 
 
@@ -317,6 +366,55 @@ LibXMLHandler::setDocumentLocator (const xmlSAXLocator* locator)
 }
 
 
+/**
+ * Halts the parser if the XMLHandler wants no more of the document.  The
+ * rest of the chunk being parsed is not reported either.
+ */
+void
+LibXMLHandler::checkStopped ()
+{
+  if (!mHandler.isStopped() || mContext == NULL) return;
+
+  mStopOffset = static_cast<long>( xmlByteConsumed(mContext) );
+  xmlStopParser(mContext);
+}
+
+
+/**
+ * Sets whether elements get their line and column numbers or only their
+ * byte offset.
+ */
+void
+LibXMLHandler::setTrackPositions (bool track)
+{
+  mTrackPositions = track;
+}
+
+
+/**
+ * @return the number of bytes of the input consumed by the parser.
+ */
+size_t
+LibXMLHandler::getOffset () const
+{
+  if (mContext == NULL) return 0;
+
+  const long consumed = xmlByteConsumed(mContext);
+  return (consumed > 0) ? static_cast<size_t>(consumed) : 0;
+}
+
+
+/**
+ * @return the byte offset reached when the XMLHandler stopped the parser
+ * at a start element, or -1 if it has not stopped it.
+ */
+long
+LibXMLHandler::getStopOffset () const
+{
+  return mStopOffset;
+}
+
+
 /**
  * @return the internal xmlSAXHandler that redirects libXML callbacks to
  * the method above.  Pass the return value along with "this" to one of the
@@ -42,12 +42,13 @@
 #include <libxml/parser.h>
 
 #include <liblx/xml/XMLHandler.h>
+#include <liblx/xml/XMLTriple.h>
+#include <liblx/xml/XMLToken.h>
+#include <liblx/xml/LibXMLAttributes.h>
+#include <liblx/xml/LibXMLNamespaces.h>
 
 LIBLX_CPP_NAMESPACE_BEGIN
 
-class LibXMLAttributes;
-class LibXMLNamespaces;
-
 
 class LibXMLHandler
 {
@@ -85,21 +86,27 @@ public:
 
 
   /**
-   * Receive notification of the start of an element.
+   * Receive notification of the start of an element, with the namespace
+   * declarations and attributes in the "raw" form delivered by LibXML.
+   * The attribute and namespace sets are refilled in place.
    *
-   * @param  localname   The local part of the element name
-   * @param  prefix      The namespace prefix part of the element name.
-   * @param  uri         The URI of the namespace for this element
-   * @param  namespaces  The namespace definitions for this element
-   * @param  attributes  The specified or defaulted attributes
+   * @param  localname      The local part of the element name
+   * @param  prefix         The namespace prefix part of the element name.
+   * @param  uri            The URI of the namespace for this element
+   * @param  namespaces     The namespace definitions for this element
+   * @param  numNamespaces  The number of namespace definitions
+   * @param  attributes     The specified or defaulted attributes
+   * @param  numAttributes  The number of attributes
    */
   void startElement
   (
      const xmlChar*           localname
    , const xmlChar*           prefix
    , const xmlChar*           uri
-   , const LibXMLAttributes&  attributes
-   , const LibXMLNamespaces&  namespaces
+   , const xmlChar**          namespaces
+   , unsigned int             numNamespaces
+   , const xmlChar**          attributes
+   , unsigned int             numAttributes
   );
 
 
@@ -161,6 +168,26 @@ public:
   unsigned int getLine () const;
 
 
+  /**
+   * @return the number of bytes of the input consumed by the parser.
+   */
+  size_t getOffset () const;
+
+
+  /**
+   * @return the byte offset reached when the XMLHandler stopped the
+   * parser at a start element, or @c -1 if it has not stopped it.
+   */
+  long getStopOffset () const;
+
+
+  /**
+   * Sets whether elements get their line and column numbers (the
+   * default) or only their byte offset.
+   */
+  void setTrackPositions (bool track);
+
+
   /**
    * @return the internal xmlSAXHandler that redirects libXML callbacks to
    * the methods above.  Pass the return value along with "this" to one of
@@ -175,9 +202,24 @@ public:
 
 protected:
 
+  /**
+   * Halts the parser if the XMLHandler wants no more of the document.
+   */
+  void checkStopped ();
+
+
   XMLHandler&          mHandler;
   xmlParserCtxt*       mContext;
   const xmlSAXLocator* mLocator;
+  long                 mStopOffset;
+  bool                 mTrackPositions;
+
+  // Scratch objects refilled for every event so that their storage is
+  // reused instead of being allocated per element.
+  XMLTriple            mTriple;
+  LibXMLAttributes     mAttributes;
+  LibXMLNamespaces     mNamespaces;
+  XMLToken             mToken;
 };
 
 LIBLX_CPP_NAMESPACE_END
@@ -54,15 +54,15 @@ LIBLX_CPP_NAMESPACE_BEGIN
 LibXMLNamespaces::LibXMLNamespaces (  const xmlChar**     namespaces
                                     , const unsigned int& size )
 {
-  mNamespaces.reserve(size);
+  reset(namespaces, size);
+}
 
-  for (unsigned int n = 0; n < size; ++n)
-  {
-    const string prefix = LibXMLTranscode( namespaces[2 * n]     );
-    const string uri    = LibXMLTranscode( namespaces[2 * n + 1], true );
 
-    add(uri, prefix);
-  }
+/**
+ * Creates a new empty list of XML namespace declarations.
+ */
+LibXMLNamespaces::LibXMLNamespaces ()
+{
 }
 
 
@@ -73,6 +73,27 @@ LibXMLNamespaces::~LibXMLNamespaces ()
 {
 }
 
+
+/**
+ * Replaces the contents of this list with the given "raw" LibXML
+ * prefix/URI pairs.
+ */
+void
+LibXMLNamespaces::reset (  const xmlChar**     namespaces
+                         , const unsigned int& size )
+{
+  clear();
+  mNamespaces.reserve(size);
+
+  for (unsigned int n = 0; n < size; ++n)
+  {
+    const string prefix = LibXMLTranscode( namespaces[2 * n]     );
+    const string uri    = LibXMLTranscode( namespaces[2 * n + 1], true );
+
+    add(uri, prefix);
+  }
+}
+
 /** @endcond */
 
 LIBLX_CPP_NAMESPACE_END
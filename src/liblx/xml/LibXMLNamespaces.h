@@ -59,10 +59,24 @@ public:
   LibXMLNamespaces (const xmlChar** namespaces, const unsigned int& size);
 
 
+  /**
+   * Creates a new empty list of XML namespace declarations, to be filled
+   * by reset().
+   */
+  LibXMLNamespaces ();
+
+
   /**
    * Destroys this list of XML namespace declarations.
    */
   virtual ~LibXMLNamespaces ();
+
+
+  /**
+   * Replaces the contents of this list with the given "raw" LibXML
+   * prefix/URI pairs.
+   */
+  void reset (const xmlChar** namespaces, const unsigned int& size);
 };
 
 /** @endcond */
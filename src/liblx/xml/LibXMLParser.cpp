@@ -295,6 +295,18 @@ LibXMLParser::getLine () const
 }
 
 
+/**
+ * Sets whether the line and column of every element are looked up while
+ * parsing, or only their byte offset.
+ */
+void
+LibXMLParser::setTrackPositions (bool track)
+{
+  XMLParser::setTrackPositions(track);
+  mHandler.setTrackPositions(track);
+}
+
+
 /**
  * Parses XML content in one fell swoop.
  *
@@ -387,6 +399,9 @@ LibXMLParser::parseFirst (const char* content, bool isFile)
     return false;
   }
 
+  mByteOffset = 0;
+  mLineStarts.clear();
+
   if ( !error() )
   {
     mHandler.startDocument();
@@ -417,8 +432,18 @@ LibXMLParser::parseNext ()
     return false;
   }
 
+  if (!mTrackPositions) indexLines(mBuffer, bytes);
+  mByteOffset += bytes;
+
   if ( xmlParseChunk(mParser, mBuffer, bytes, done) )
   {
+    if ( mHandler.getStopOffset() >= 0 )
+    {
+      // the handler wants no more of the document
+      mByteOffset = static_cast<size_t>( mHandler.getStopOffset() );
+      return true;
+    }
+
     xmlErrorPtr libxmlError = xmlGetLastError();
 
     // I tried reporting the message from libXML that's available in
@@ -85,6 +85,13 @@ public:
   virtual unsigned int getLine () const;
 
 
+  /**
+   * Sets whether the line and column of every element are looked up
+   * while parsing, or only their byte offset.
+   */
+  virtual void setTrackPositions (bool track);
+
+
   /**
    * Parses XML content in one fell swoop.
    *
@@ -72,14 +72,27 @@ int replaceAll(string& str, const string& tstr, const string& rstr)
 
 
 LibXMLTranscode::operator string ()
+{
+  string str;
+  assignTo(str);
+
+  return str;
+}
+
+
+void
+LibXMLTranscode::assignTo (string& str)
 {
   if (mBuffer == NULL)
   {
-    return "";
+    str.clear();
   }
   else
   {
-    string str =  (mLen == -1) ? string(mBuffer) : string(mBuffer, (size_t)mLen);
+    if (mLen == -1)
+      str.assign(mBuffer);
+    else
+      str.assign(mBuffer, (size_t)mLen);
 
     if ( mReplaceNCR )
     {
@@ -89,8 +102,6 @@ LibXMLTranscode::operator string ()
       if ( str.length() >= NCRAmp.length() ) 
         LIBLX_CPP_NAMESPACE ::replaceAll(str, NCRAmp,"&");
     }
-
-    return str;
   }
 }
 
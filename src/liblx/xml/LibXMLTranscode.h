@@ -65,6 +65,12 @@ public:
 
   operator std::string ();
 
+  /**
+   * Stores the transcoded string in @p str, reusing the storage it
+   * already holds.
+   */
+  void assignTo (std::string& str);
+
 private:
 
   const char* mBuffer;
@@ -0,0 +1,353 @@
+/**
+ * @file    XMLAttributeSchema.h
+ * @brief   Reads the attributes of an element into a struct in one pass
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ *
+ * @class XMLAttributeSchema
+ * @sbmlbrief{core} Describes how the attributes of an element map onto
+ * the members of a struct.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * A reader that calls XMLAttributes::readInto() once per attribute looks
+ * every name up separately.  An XMLAttributeSchema instead lists the
+ * attributes of an element once, as a static table of XMLAttributeField
+ * entries that each name an attribute, the member it is read into and
+ * whether it is required:
+ * @code
+ * struct Species
+ * {
+ *   std::string  id;
+ *   double       initialAmount;
+ *   bool         constant;
+ * };
+ *
+ * static const XMLAttributeField<Species> speciesFields[] =
+ * {
+ *   XMLAttributeField<Species>("id",            &Species::id,            true ),
+ *   XMLAttributeField<Species>("initialAmount", &Species::initialAmount       ),
+ *   XMLAttributeField<Species>("constant",      &Species::constant,      true )
+ * };
+ *
+ * static const XMLAttributeSchema<Species> speciesSchema(speciesFields);
+ *
+ * Species species;
+ * speciesSchema.read(element.getAttributes(), species, log,
+ *                    element.getLine(), element.getColumn());
+ * @endcode
+ *
+ * XMLAttributeSchema::read() walks the attributes of the element once,
+ * finding the field of each through a hash index built when the schema
+ * is constructed, and then reads the fields in table order.  Each field
+ * is read exactly as the matching XMLAttributes::readInto() overload
+ * would read it (by local name, first match wins), so the values, and
+ * the type and required-attribute errors logged, are the same as for a
+ * sequence of readInto() calls in the same order.
+ *
+ * Members may be of type @c bool, @c double, @c long, @c int,
+ * <code>unsigned int</code> or @c std::string.  A schema holds no state
+ * beyond its table, so one static schema can be shared by any number of
+ * readers and threads.
+ */
+
+#ifndef XMLAttributeSchema_h
+#define XMLAttributeSchema_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#if defined(__cplusplus) && !defined(SWIG)
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/XMLAttributes.h>
+#include <liblx/xml/XMLNameIndex.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+template <class T>
+class XMLAttributeField
+{
+public:
+
+  /**
+   * Creates a field that reads the attribute name into a member of type
+   * @c bool, @c double, @c long, @c int, <code>unsigned int</code> or
+   * @c std::string.
+   *
+   * @param name the (local) name of the attribute.
+   * @param member the member of @c T that receives the value.
+   * @param required whether an error is logged when the attribute is
+   * missing.
+   */
+  XMLAttributeField (const char* name, bool T::* member, bool required = false)
+    : mName(name), mType(Boolean), mRequired(required) { mMember.b = member; }
+
+  XMLAttributeField (const char* name, double T::* member, bool required = false)
+    : mName(name), mType(Double), mRequired(required) { mMember.d = member; }
+
+  XMLAttributeField (const char* name, long T::* member, bool required = false)
+    : mName(name), mType(Long), mRequired(required) { mMember.l = member; }
+
+  XMLAttributeField (const char* name, int T::* member, bool required = false)
+    : mName(name), mType(Int), mRequired(required) { mMember.i = member; }
+
+  XMLAttributeField (const char* name, unsigned int T::* member,
+                     bool required = false)
+    : mName(name), mType(UnsignedInt), mRequired(required) { mMember.u = member; }
+
+  XMLAttributeField (const char* name, std::string T::* member,
+                     bool required = false)
+    : mName(name), mType(String), mRequired(required) { mMember.s = member; }
+
+
+  /**
+   * @return the name of the attribute read by this field.
+   */
+  const char* getName () const { return mName; }
+
+
+  /**
+   * @return true if a missing attribute is logged as an error.
+   */
+  bool isRequired () const { return mRequired; }
+
+
+  /**
+   * Reads the attribute at index (or -1 if it is missing) into the member
+   * of object, as XMLAttributes::readInto() does.
+   *
+   * @return true if the member was assigned.
+   */
+  bool read (const XMLAttributes& attributes, int index, T& object,
+             XMLErrorLog* log, unsigned int line, unsigned int column) const
+  {
+    const std::string name(mName);
+
+    switch (mType)
+    {
+    case Boolean:
+      return attributes.readInto(index, name, object.*mMember.b, log,
+                                 mRequired, line, column);
+    case Double:
+      return attributes.readInto(index, name, object.*mMember.d, log,
+                                 mRequired, line, column);
+    case Long:
+      return attributes.readInto(index, name, object.*mMember.l, log,
+                                 mRequired, line, column);
+    case Int:
+      return attributes.readInto(index, name, object.*mMember.i, log,
+                                 mRequired, line, column);
+    case UnsignedInt:
+      return attributes.readInto(index, name, object.*mMember.u, log,
+                                 mRequired, line, column);
+    default:
+      return attributes.readInto(index, name, object.*mMember.s, log,
+                                 mRequired, line, column);
+    }
+  }
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  enum Type { Boolean, Double, Long, Int, UnsignedInt, String };
+
+  union Member
+  {
+    bool         T::* b;
+    double       T::* d;
+    long         T::* l;
+    int          T::* i;
+    unsigned int T::* u;
+    std::string  T::* s;
+  };
+
+  const char* mName;
+  Type        mType;
+  bool        mRequired;
+  Member      mMember;
+
+  /** @endcond */
+};
+
+
+template <class T>
+class XMLAttributeSchema
+{
+public:
+
+  /**
+   * Creates a schema over a table of fields.  The table is not copied
+   * and must outlive the schema; it is normally a static array.
+   *
+   * @param fields the fields, in the order they are read.
+   * @param numFields the number of entries in fields.
+   */
+  XMLAttributeSchema (const XMLAttributeField<T>* fields,
+                      unsigned int numFields)
+    : mFields(fields)
+    , mNumFields(numFields)
+  {
+    init();
+  }
+
+
+  /**
+   * Creates a schema over a static array of fields.
+   */
+  template <size_t N>
+  explicit XMLAttributeSchema (const XMLAttributeField<T> (&fields)[N])
+    : mFields(fields)
+    , mNumFields(N)
+  {
+    init();
+  }
+
+
+  /**
+   * @return the number of fields in this schema.
+   */
+  unsigned int getNumFields () const { return mNumFields; }
+
+
+  /**
+   * @return the nth field of this schema.
+   */
+  const XMLAttributeField<T>& getField (unsigned int n) const
+  {
+    return mFields[n];
+  }
+
+
+  /**
+   * @return the position of the field reading the attribute name, or -1.
+   */
+  int getFieldIndex (const std::string& name) const
+  {
+    size_t hash = XMLNameIndex::hash(name);
+    size_t slot = mIndex.start(hash);
+    int    n;
+
+    while ((n = mIndex.next(slot, hash)) != -1)
+    {
+      if (mNames[(size_t)n] == name) return n;
+    }
+
+    return -1;
+  }
+
+
+  /**
+   * Reads the attributes of an element into object.  Members whose
+   * attribute is missing or malformed are left unchanged; errors are
+   * logged to log, or to the log of attributes if log is NULL.
+   *
+   * @param attributes the attributes of the element.
+   * @param object the struct to fill in.
+   * @param log the XMLErrorLog for type and required-attribute errors.
+   * @param line the line number reported with errors.
+   * @param column the column number reported with errors.
+   *
+   * @return true if every attribute present was read and no required
+   * attribute is missing, false otherwise.
+   */
+  bool read (const XMLAttributes& attributes, T& object,
+             XMLErrorLog* log = NULL,
+             unsigned int line = 0, unsigned int column = 0) const
+  {
+    static const unsigned int Inline = 32;
+
+    int               inlineIndexes[Inline];
+    std::vector<int>  heapIndexes;
+    int*              indexes = inlineIndexes;
+
+    if (mNumFields > Inline)
+    {
+      heapIndexes.resize(mNumFields);
+      indexes = &heapIndexes[0];
+    }
+
+    for (unsigned int f = 0; f < mNumFields; ++f) indexes[f] = -1;
+
+    int length = attributes.getLength();
+    for (int a = 0; a < length; ++a)
+    {
+      int f = getFieldIndex( attributes.mNames[(size_t)a].getName() );
+      if (f != -1 && indexes[f] == -1) indexes[f] = a;
+    }
+
+    bool complete = true;
+    for (unsigned int f = 0; f < mNumFields; ++f)
+    {
+      const XMLAttributeField<T>& field = mFields[f];
+
+      if (!field.read(attributes, indexes[f], object, log, line, column)
+          && (indexes[f] != -1 || field.isRequired()))
+      {
+        complete = false;
+      }
+    }
+
+    return complete;
+  }
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  void init ()
+  {
+    mNames.reserve(mNumFields);
+
+    for (unsigned int f = 0; f < mNumFields; ++f)
+    {
+      mNames.push_back(mFields[f].getName());
+      mIndex.insert( XMLNameIndex::hash(mNames.back()) );
+    }
+  }
+
+  const XMLAttributeField<T>* mFields;
+  unsigned int                mNumFields;
+  std::vector<std::string>    mNames;
+  XMLNameIndex                mIndex;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus && !SWIG */
+
+#endif  /* XMLAttributeSchema_h */
@@ -34,6 +34,7 @@
  * also available online as http://sbml.org/software/libsbml/license.html
  * ---------------------------------------------------------------------- -->*/
 
+#include <algorithm>
 #include <cerrno>
 #include <clocale>
 #include <cstdlib>
@@ -61,7 +62,7 @@ LIBLX_CPP_NAMESPACE_BEGIN
 static const std::string
 trim (const std::string& s)
 {
-  static const std::string whitespace(" \t\r\n");
+  const char* whitespace = " \t\r\n";
 
   std::string::size_type begin = s.find_first_not_of(whitespace);
   std::string::size_type end   = s.find_last_not_of (whitespace);
@@ -93,6 +94,7 @@ XMLAttributes::XMLAttributes(const XMLAttributes& orig)
  , mValues(orig.mValues.begin(), orig.mValues.end())
  , mElementName(orig.mElementName)
  , mLog(orig.mLog)
+ , mIndex(orig.mIndex)
 {
 }
 
@@ -109,6 +111,7 @@ XMLAttributes::operator=(const XMLAttributes& rhs)
     this->mValues.assign( rhs.mValues.begin(), rhs.mValues.end() ); 
     this->mElementName = rhs.mElementName;
     this->mLog = rhs.mLog;
+    this->mIndex = rhs.mIndex;
   }
 
   return *this;
@@ -150,6 +153,7 @@ XMLAttributes::add (const std::string& name,
   {
     mNames .push_back( XMLTriple(name, namespaceURI, prefix) );
     mValues.push_back( value );
+    indexLast();
   }
   else
   {
@@ -183,6 +187,7 @@ XMLAttributes::addResource (const std::string& name, const std::string& value)
 {
   mNames .push_back( XMLTriple(name, "", "") );
   mValues.push_back( value );
+  indexLast();
   return LIBLX_OPERATION_SUCCESS;
 }
 /** @endcond */
@@ -206,6 +211,7 @@ XMLAttributes::removeResource (int n)
 
   mNames.erase(names_iter);
   mValues.erase(values_iter);
+  reindex();
 
   return LIBLX_OPERATION_SUCCESS;
 }
@@ -252,6 +258,7 @@ XMLAttributes::clear()
 {
   mNames.clear();
   mValues.clear();
+  mIndex.clear();
   return LIBLX_OPERATION_SUCCESS;
 }
 
@@ -264,9 +271,23 @@ XMLAttributes::clear()
 int
 XMLAttributes::getIndex (const std::string& name) const
 {
+  if (isIndexed())
+  {
+    size_t hash  = XMLNameIndex::hash(name);
+    size_t slot  = mIndex.start(hash);
+    int    index;
+
+    while ((index = mIndex.next(slot, hash)) != -1)
+    {
+      if (mNames[(size_t)index].getName() == name) return index;
+    }
+
+    return -1;
+  }
+
   for (int index = 0; index < getLength(); ++index)
   {
-    if (getName(index) == name) return index;
+    if (mNames[(size_t)index].getName() == name) return index;
   }
   
   return -1;
@@ -282,9 +303,25 @@ XMLAttributes::getIndex (const std::string& name) const
 int
 XMLAttributes::getIndex (const std::string& name, const std::string& uri) const
 {
+  if (isIndexed())
+  {
+    size_t hash  = XMLNameIndex::hash(name);
+    size_t slot  = mIndex.start(hash);
+    int    index;
+
+    while ((index = mIndex.next(slot, hash)) != -1)
+    {
+      const XMLTriple& triple = mNames[(size_t)index];
+      if (triple.getName() == name && triple.getURI() == uri) return index;
+    }
+
+    return -1;
+  }
+
   for (int index = 0; index < getLength(); ++index)
   {
-    if ( (getName(index) == name) && (getURI(index) == uri) ) return index;
+    const XMLTriple& triple = mNames[(size_t)index];
+    if ( (triple.getName() == name) && (triple.getURI() == uri) ) return index;
   }
   
   return -1;
@@ -299,6 +336,19 @@ XMLAttributes::getIndex (const std::string& name, const std::string& uri) const
 int 
 XMLAttributes::getIndex (const XMLTriple& triple) const
 {
+  if (isIndexed())
+  {
+    size_t hash  = XMLNameIndex::hash(triple.getName());
+    size_t slot  = mIndex.start(hash);
+    int    index;
+
+    while ((index = mIndex.next(slot, hash)) != -1)
+    {
+      if (mNames[(size_t)index] == triple) return index;
+    }
+
+    return -1;
+  }
 
   for (int index = 0; index < getLength(); ++index)
   {
@@ -1251,6 +1301,75 @@ XMLAttributes::setErrorLog (XMLErrorLog* log)
 /** @endcond */
 
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Exchanges the contents of this XMLAttributes set with those of other.
+ */
+void
+XMLAttributes::swap (XMLAttributes& other)
+{
+  mNames      .swap(other.mNames);
+  mValues     .swap(other.mValues);
+  mIndex      .swap(other.mIndex);
+  mElementName.swap(other.mElementName);
+  std::swap(mLog, other.mLog);
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Rebuilds the name index from scratch, or drops it if this set has
+ * become narrow enough for linear scans.
+ */
+void
+XMLAttributes::reindex ()
+{
+  mIndex.clear();
+
+  if (mNames.size() < XMLNameIndex::Threshold) return;
+
+  for (size_t n = 0; n < mNames.size(); ++n)
+  {
+    mIndex.insert( XMLNameIndex::hash(mNames[n].getName()) );
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Adds the last attribute to the name index.
+ */
+void
+XMLAttributes::indexLast ()
+{
+  if (mIndex.size() + 1 == mNames.size() && mIndex.isBuilt())
+  {
+    mIndex.insert( XMLNameIndex::hash(mNames.back().getName()) );
+  }
+  else if (mNames.size() >= XMLNameIndex::Threshold)
+  {
+    reindex();
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return true if lookups can use the name index.  A subclass that
+ * changed the number of names without calling reindex() falls back to
+ * linear scans.
+ */
+bool
+XMLAttributes::isIndexed () const
+{
+  return mIndex.isBuilt() && mIndex.size() == mNames.size();
+}
+/** @endcond */
+
+
 /** @cond doxygenLibsbmlInternal */
 /*
  * Inserts this XMLAttributes set into stream.
@@ -239,12 +239,15 @@ foo:myattribute="7"
 #include <stdexcept>
 
 #include <liblx/xml/XMLTriple.h>
+#include <liblx/xml/XMLNameIndex.h>
 
 LIBLX_CPP_NAMESPACE_BEGIN
 
 class XMLErrorLog;
 /** @cond doxygenLibsbmlInternal */
 class XMLOutputStream;
+template <class T> class XMLAttributeField;
+template <class T> class XMLAttributeSchema;
 /** @endcond */
 
 class LIBLX_EXTERN XMLAttributes
@@ -1551,6 +1554,17 @@ public:
   /** @endcond */
 
 
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Exchanges the contents of this XMLAttributes set with those of
+   * @p other without copying names or values.
+   *
+   * @param other the XMLAttributes set to swap contents with.
+   */
+  void swap (XMLAttributes& other);
+  /** @endcond */
+
+
 #ifndef SWIG
 
   /** @cond doxygenLibsbmlInternal */
@@ -1566,6 +1580,11 @@ public:
   LIBLX_EXTERN
   friend XMLOutputStream&
   operator<< (XMLOutputStream& stream, const XMLAttributes& attributes);
+
+
+  /* The schema classes read through the index-based readInto() methods. */
+  template <class T> friend class XMLAttributeField;
+  template <class T> friend class XMLAttributeSchema;
   /** @endcond */
 
 #endif  /* !SWIG */
@@ -1803,12 +1822,34 @@ protected:
 
 
 
+  /**
+   * Rebuilds the name index after mNames has been refilled; subclasses
+   * that fill mNames directly must call this when they are done.
+   */
+  void reindex ();
+
+
+  /**
+   * Adds the last attribute to the name index, building the index once
+   * this set reaches XMLNameIndex::Threshold attributes.
+   */
+  void indexLast ();
+
+
+  /**
+   * @return true if lookups can use the name index.
+   */
+  bool isIndexed () const;
+
+
   std::vector<XMLTriple>    mNames;
   std::vector<std::string>  mValues;
 
   std::string               mElementName;
   XMLErrorLog*              mLog;
 
+  XMLNameIndex              mIndex;
+
   /** @endcond */
 };
 
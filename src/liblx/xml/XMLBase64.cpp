@@ -0,0 +1,424 @@
+/**
+ * @file    XMLBase64.cpp
+ * @brief   Base64 encoding and decoding of XML character data
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <sstream>
+
+#include <liblx/xml/XMLToken.h>
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLOutputStream.h>
+#include <liblx/xml/XMLBase64.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+/** @cond doxygenLibsbmlInternal */
+
+static const int Invalid    = -1;
+static const int Whitespace = -2;
+static const int Padding    = -3;
+
+/*
+ * Maps every byte to its 6-bit base64 value, or to one of the negative
+ * codes above.  All the negative codes have the sign bit set, so four
+ * lookups can be checked for validity with a single test.
+ */
+static const signed char sDecode[256] =
+{
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -2, -2, -1, -1, -2, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+  52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -3, -1, -1,
+  -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+  15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+  -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+  41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+
+static const char sEncode[] =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+
+/*
+ * Encodes the three bytes at in as four characters at out.
+ */
+static inline void
+encodeGroup (const unsigned char* in, char* out)
+{
+  out[0] = sEncode[  in[0] >> 2 ];
+  out[1] = sEncode[ ((in[0] & 0x03) << 4) | (in[1] >> 4) ];
+  out[2] = sEncode[ ((in[1] & 0x0F) << 2) | (in[2] >> 6) ];
+  out[3] = sEncode[   in[2] & 0x3F ];
+}
+
+/** @endcond */
+
+
+/*
+ * Creates a new XMLBase64Decoder appending to bytes.
+ */
+XMLBase64Decoder::XMLBase64Decoder (std::vector<unsigned char>& bytes,
+                                    XMLErrorLog* log) :
+   mBytes  ( &bytes )
+ , mLog    ( log    )
+ , mGroup  ( 0      )
+ , mCount  ( 0      )
+ , mPadding( 0      )
+ , mDone   ( false  )
+ , mValid  ( true   )
+ , mLine   ( 0      )
+ , mColumn ( 0      )
+{
+}
+
+
+/*
+ * Destroys this XMLBase64Decoder.
+ */
+XMLBase64Decoder::~XMLBase64Decoder ()
+{
+}
+
+
+/*
+ * Decodes the next length characters.  Runs of complete groups of four
+ * characters are decoded directly from chars; whitespace, padding and
+ * groups split across calls go through the per-character path, which
+ * collects the group in mGroup.
+ */
+bool
+XMLBase64Decoder::append (const char* chars, size_t length)
+{
+  if (chars == NULL) return mValid;
+
+  const unsigned char* p   = reinterpret_cast<const unsigned char*>(chars);
+  const unsigned char* end = p + length;
+
+  while (p < end)
+  {
+    if (mCount == 0 && !mDone)
+    {
+      while (end - p >= 4)
+      {
+        const int a = sDecode[p[0]];
+        const int b = sDecode[p[1]];
+        const int c = sDecode[p[2]];
+        const int d = sDecode[p[3]];
+
+        if ((a | b | c | d) < 0) break;
+
+        const unsigned long group = (a << 18) | (b << 12) | (c << 6) | d;
+
+        mBytes->push_back( static_cast<unsigned char>(group >> 16) );
+        mBytes->push_back( static_cast<unsigned char>(group >> 8)  );
+        mBytes->push_back( static_cast<unsigned char>(group)       );
+
+        p += 4;
+      }
+
+      if (p == end) break;
+    }
+
+    const unsigned char c = *p++;
+    const int           v = sDecode[c];
+
+    if (v == Whitespace) continue;
+
+    if (v == Padding)
+    {
+      if (mDone && mPadding > 0)
+      {
+        --mPadding;
+      }
+      else if (!mDone && mCount >= 2)
+      {
+        // '=' ends the data; the group holds one or two more bytes
+        mBytes->push_back( static_cast<unsigned char>(
+          (mCount == 2) ? (mGroup >> 4) : (mGroup >> 10)) );
+
+        if (mCount == 3)
+          mBytes->push_back( static_cast<unsigned char>(mGroup >> 2) );
+
+        mPadding = 3 - mCount;
+        mCount   = 0;
+        mGroup   = 0;
+        mDone    = true;
+      }
+      else
+      {
+        contentError(c);
+      }
+
+      continue;
+    }
+
+    if (v == Invalid || mDone)
+    {
+      contentError(c);
+      continue;
+    }
+
+    mGroup = (mGroup << 6) | v;
+
+    if (++mCount == 4)
+    {
+      mBytes->push_back( static_cast<unsigned char>(mGroup >> 16) );
+      mBytes->push_back( static_cast<unsigned char>(mGroup >> 8)  );
+      mBytes->push_back( static_cast<unsigned char>(mGroup)       );
+
+      mCount = 0;
+      mGroup = 0;
+    }
+  }
+
+  return mValid;
+}
+
+
+/*
+ * Decodes the characters in chars.
+ */
+bool
+XMLBase64Decoder::append (const std::string& chars)
+{
+  return append(chars.data(), chars.size());
+}
+
+
+/*
+ * Decodes the characters of a text token.
+ */
+void
+XMLBase64Decoder::characters (const XMLToken& data)
+{
+  append(data.getCharacters());
+}
+
+
+/*
+ * Decodes a final group that was not padded.
+ */
+bool
+XMLBase64Decoder::finish ()
+{
+  if (mCount == 1)
+  {
+    // a single character cannot encode a whole byte
+    contentError('\0');
+  }
+  else if (mCount > 1)
+  {
+    mBytes->push_back( static_cast<unsigned char>(
+      (mCount == 2) ? (mGroup >> 4) : (mGroup >> 10)) );
+
+    if (mCount == 3)
+      mBytes->push_back( static_cast<unsigned char>(mGroup >> 2) );
+  }
+
+  mCount = 0;
+  mGroup = 0;
+
+  return mValid;
+}
+
+
+bool
+XMLBase64Decoder::isValid () const
+{
+  return mValid;
+}
+
+
+void
+XMLBase64Decoder::setPosition (unsigned int line, unsigned int column)
+{
+  mLine   = line;
+  mColumn = column;
+}
+
+
+/*
+ * Appends the bytes encoded by text to bytes.
+ */
+bool
+XMLBase64Decoder::decode (const std::string&          text,
+                          std::vector<unsigned char>& bytes,
+                          XMLErrorLog*                log,
+                          unsigned int                line,
+                          unsigned int                column)
+{
+  bytes.reserve(bytes.size() + text.size() / 4 * 3 + 2);
+
+  XMLBase64Decoder decoder(bytes, log);
+  decoder.setPosition(line, column);
+
+  decoder.append(text);
+  return decoder.finish();
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Logs the first invalid content seen by this decoder.  A NUL character
+ * stands for truncated input.
+ */
+void
+XMLBase64Decoder::contentError (char c)
+{
+  if (!mValid) return;
+  mValid = false;
+
+  if (mLog == NULL) return;
+
+  ostringstream message;
+
+  message << "The text content must be base64 encoded data.  ";
+
+  if (c == '\0')
+    message << "The data ends in the middle of a byte.";
+  else if (c == '=')
+    message << "The padding character '=' is misplaced.";
+  else if (static_cast<unsigned char>(c) < 0x20)
+    message << "The control character " << static_cast<int>(c)
+            << " is not valid.";
+  else if (mDone)
+    message << "The character '" << c << "' follows the padding.";
+  else
+    message << "The character '" << c << "' is not valid.";
+
+  mLog->add( XMLError(UninterpretableXMLContent, message.str(),
+                      mLine, mColumn) );
+}
+/** @endcond */
+
+
+/*
+ * Creates a new XMLBase64Encoder writing to stream.
+ */
+XMLBase64Encoder::XMLBase64Encoder (XMLOutputStream& stream) :
+   mStream    ( stream )
+ , mCarryCount( 0      )
+{
+}
+
+
+/*
+ * Destroys this XMLBase64Encoder.
+ */
+XMLBase64Encoder::~XMLBase64Encoder ()
+{
+}
+
+
+/*
+ * Encodes the next length bytes of data.  Complete groups of three bytes
+ * are encoded into a fixed buffer that is flushed to the stream whenever
+ * it fills up; up to two remaining bytes are kept for the next call.
+ */
+void
+XMLBase64Encoder::append (const void* data, size_t length)
+{
+  if (data == NULL || length == 0) return;
+
+  const unsigned char* p   = static_cast<const unsigned char*>(data);
+  const unsigned char* end = p + length;
+
+  char   buffer[4096];
+  size_t used = 0;
+
+  if (mCarryCount > 0)
+  {
+    while (mCarryCount < 3 && p < end) mCarry[mCarryCount++] = *p++;
+    if (mCarryCount < 3) return;
+
+    encodeGroup(mCarry, buffer);
+    used        = 4;
+    mCarryCount = 0;
+  }
+
+  while (end - p >= 3)
+  {
+    if (used + 4 > sizeof(buffer))
+    {
+      mStream.writeUnescapedChars(buffer, used);
+      used = 0;
+    }
+
+    encodeGroup(p, buffer + used);
+    used += 4;
+    p    += 3;
+  }
+
+  while (p < end) mCarry[mCarryCount++] = *p++;
+
+  if (used > 0) mStream.writeUnescapedChars(buffer, used);
+}
+
+
+/*
+ * Writes the final, padded group.
+ */
+void
+XMLBase64Encoder::finish ()
+{
+  if (mCarryCount == 0) return;
+
+  char out[4];
+
+  if (mCarryCount == 1) mCarry[1] = 0;
+  mCarry[2] = 0;
+
+  encodeGroup(mCarry, out);
+
+  out[3] = '=';
+  if (mCarryCount == 1) out[2] = '=';
+
+  mStream.writeUnescapedChars(out, 4);
+  mCarryCount = 0;
+}
+
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,274 @@
+/**
+ * @file    XMLBase64.h
+ * @brief   Base64 encoding and decoding of XML character data
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ *
+ * @class XMLBase64Decoder
+ * @sbmlbrief{core} Decodes base64 text content into bytes.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * Binary payloads are often stored as base64 text inside an element.  An
+ * XMLBase64Decoder turns such text into the bytes it encodes, appending
+ * them to a <code>std::vector&lt;unsigned char&gt;</code>.  XML whitespace
+ * within the text (e.g., line breaks inserted by the producer) is ignored,
+ * and the final padding characters are optional.
+ *
+ * The text can be given all at once with the static decode() method or
+ * piece by piece with append(); groups of four characters split across
+ * two pieces are handled transparently.  Since XMLBase64Decoder is an
+ * XMLHandler, it can be passed to XMLInputStream::readCharacters() to
+ * decode a text node of any size chunk by chunk (see
+ * XMLInputStream::setCharacterChunkSize()).
+ *
+ * The first invalid character is reported to the XMLErrorLog (if any) as
+ * an @sbmlconstant{UninterpretableXMLContent, XMLErrorCode_t} error.
+ *
+ * @see XMLBase64Encoder
+ */
+
+/**
+ * @class XMLBase64Encoder
+ * @sbmlbrief{core} Writes bytes as base64 text content.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * An XMLBase64Encoder writes the base64 encoding of the bytes passed to
+ * append() as text content of the current element of an XMLOutputStream.
+ * The encoded text goes straight to the stream's underlying
+ * <code>std::ostream</code> through a small fixed buffer; it is never
+ * built as a string.  The bytes can be given in pieces of any size;
+ * finish() writes the final, padded group.
+ *
+ * @see XMLOutputStream::writeBase64()
+ * @see XMLBase64Decoder
+ */
+
+#ifndef XMLBase64_h
+#define XMLBase64_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/XMLHandler.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLErrorLog;
+class XMLOutputStream;
+class XMLToken;
+
+
+class LIBLX_EXTERN XMLBase64Decoder : public XMLHandler
+{
+public:
+
+  /**
+   * Creates a new XMLBase64Decoder that appends the decoded bytes to
+   * @p bytes.
+   *
+   * @param bytes the vector to which the decoded bytes are appended.
+   * @param log an XMLErrorLog to which invalid content is reported.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLBase64Decoder (std::vector<unsigned char>& bytes,
+                    XMLErrorLog* log = NULL);
+
+
+  /**
+   * Destroys this XMLBase64Decoder.
+   */
+  virtual ~XMLBase64Decoder ();
+
+
+  /**
+   * Decodes the next @p length characters of base64 text.
+   *
+   * @param chars the characters to decode.
+   * @param length the number of characters to use from @p chars.
+   *
+   * @return @c true if the text seen so far is valid, @c false otherwise.
+   */
+  bool append (const char* chars, size_t length);
+
+
+  /**
+   * Decodes the characters in @p chars.
+   *
+   * @param chars the characters to decode.
+   *
+   * @return @c true if the text seen so far is valid, @c false otherwise.
+   */
+  bool append (const std::string& chars);
+
+
+  /**
+   * Receive notification of character data; decodes the characters of
+   * @p data.
+   */
+  virtual void characters (const XMLToken& data);
+
+
+  /**
+   * Signals the end of the text, decoding a final group that was not
+   * padded.
+   *
+   * @return @c true if the whole text was valid base64, @c false
+   * otherwise.
+   */
+  bool finish ();
+
+
+  /**
+   * Returns @c true if no invalid content has been seen so far.
+   *
+   * @return @c true if the text seen so far is valid.
+   */
+  bool isValid () const;
+
+
+  /**
+   * Sets the line and column reported with errors.
+   *
+   * @param line the line number.
+   * @param column the column number.
+   */
+  void setPosition (unsigned int line, unsigned int column);
+
+
+  /**
+   * Appends the bytes encoded by the base64 text @p text to @p bytes.
+   *
+   * @param text the base64 text to decode.
+   * @param bytes the vector to which the decoded bytes are appended.
+   * @param log an XMLErrorLog to which invalid content is reported.
+   * @param line the line number reported with errors.
+   * @param column the column number reported with errors.
+   *
+   * @return @c true if @p text was valid base64, @c false otherwise.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  static bool decode (const std::string&          text,
+                      std::vector<unsigned char>& bytes,
+                      XMLErrorLog*                log    = NULL,
+                      unsigned int                line   = 0,
+                      unsigned int                column = 0);
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  XMLBase64Decoder (const XMLBase64Decoder& orig);
+  XMLBase64Decoder& operator= (const XMLBase64Decoder& rhs);
+
+  /** @endcond */
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  void contentError (char c);
+
+  std::vector<unsigned char>* mBytes;
+  XMLErrorLog*                mLog;
+
+  unsigned long               mGroup;
+  unsigned int                mCount;
+  unsigned int                mPadding;
+  bool                        mDone;
+  bool                        mValid;
+
+  unsigned int                mLine;
+  unsigned int                mColumn;
+
+  /** @endcond */
+};
+
+
+class LIBLX_EXTERN XMLBase64Encoder
+{
+public:
+
+  /**
+   * Creates a new XMLBase64Encoder writing to @p stream.
+   *
+   * @param stream the XMLOutputStream to write the base64 text to.
+   */
+  XMLBase64Encoder (XMLOutputStream& stream);
+
+
+  /**
+   * Destroys this XMLBase64Encoder.  Call finish() before, otherwise up to
+   * two bytes of the input may be missing from the output.
+   */
+  ~XMLBase64Encoder ();
+
+
+  /**
+   * Encodes the next @p length bytes of @p data.
+   *
+   * @param data the bytes to encode.
+   * @param length the number of bytes to use from @p data.
+   */
+  void append (const void* data, size_t length);
+
+
+  /**
+   * Writes the final group of the encoding, with padding.
+   */
+  void finish ();
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  XMLBase64Encoder (const XMLBase64Encoder& orig);
+  XMLBase64Encoder& operator= (const XMLBase64Encoder& rhs);
+
+  XMLOutputStream& mStream;
+  unsigned char    mCarry[3];
+  unsigned int     mCarryCount;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+#endif  /* XMLBase64_h */
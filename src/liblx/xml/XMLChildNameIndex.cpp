@@ -0,0 +1,457 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLChildNameIndex.cpp
+ * @brief   Hashed index of the names of the children of an XMLNode
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ */
+
+#include <liblx/xml/XMLChildNameIndex.h>
+#include <liblx/xml/XMLNameIndex.h>
+#include <liblx/xml/XMLNode.h>
+
+using namespace std;
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+/*
+ * Creates a new, empty index.
+ */
+XMLChildNameIndex::XMLChildNameIndex () :
+   mSlots   ()
+ , mNumNames( 0 )
+ , mNext    ()
+ , mPrev    ()
+ , mHash    ()
+{
+}
+
+
+/*
+ * Removes all children from this index.
+ */
+void
+XMLChildNameIndex::clear ()
+{
+  mSlots.clear();
+  mNumNames = 0;
+  mNext.clear();
+  mPrev.clear();
+  mHash.clear();
+}
+
+
+/*
+ * @return true if this index holds any children.
+ */
+bool
+XMLChildNameIndex::isBuilt () const
+{
+  return !mNext.empty();
+}
+
+
+/*
+ * @return the number of children in this index.
+ */
+size_t
+XMLChildNameIndex::size () const
+{
+  return mNext.size();
+}
+
+
+/*
+ * Indexes all of children.  Each child comes after those already linked,
+ * so it is appended to the list of its name.
+ */
+void
+XMLChildNameIndex::build (const std::vector<XMLNode*>& children)
+{
+  clear();
+
+  mNext.reserve(children.size());
+  mPrev.reserve(children.size());
+  mHash.reserve(children.size());
+
+  while (mNext.size() < children.size())
+  {
+    insert(children, static_cast<unsigned int>(mNext.size()));
+  }
+}
+
+
+/*
+ * Adds child n.  Appending, the usual case, leaves the positions of the
+ * other children as they are.
+ */
+void
+XMLChildNameIndex::insert (const std::vector<XMLNode*>& children,
+                           unsigned int n)
+{
+  if (n < mNext.size()) shift(n, 1);
+
+  mNext.insert(mNext.begin() + n, -1);
+  mPrev.insert(mPrev.begin() + n, -1);
+  mHash.insert(mHash.begin() + n, XMLNameIndex::hash(children[n]->getName()));
+
+  link(children, n);
+}
+
+
+/*
+ * Drops child n.  It is unlinked through the hash and neighbours it was
+ * indexed with, which do not depend on the children.
+ */
+void
+XMLChildNameIndex::remove (unsigned int n)
+{
+  unlink(n);
+
+  mNext.erase(mNext.begin() + n);
+  mPrev.erase(mPrev.begin() + n);
+  mHash.erase(mHash.begin() + n);
+
+  shift(n, -1);
+}
+
+
+/*
+ * Relinks child n if it has been renamed.  A child still has its old
+ * name if a neighbour in its list has the same name, or if it is alone
+ * in its list and the name finds it; anything else is relinked.
+ */
+void
+XMLChildNameIndex::rename (const std::vector<XMLNode*>& children,
+                           unsigned int n)
+{
+  const std::string& name = children[n]->getName();
+  const size_t       hash = XMLNameIndex::hash(name);
+
+  if (hash == mHash[n])
+  {
+    const int neighbour = (mPrev[n] != -1) ? mPrev[n] : mNext[n];
+
+    if (neighbour != -1)
+    {
+      if (children[(size_t)neighbour]->getName() == name) return;
+    }
+    else
+    {
+      const int slot = findSlot(children, hash, name);
+      if (slot != -1 && mSlots[(size_t)slot].first == (int)n) return;
+    }
+  }
+
+  unlink(n);
+  mHash[n] = hash;
+  link(children, n);
+}
+
+
+/*
+ * @return the position of the first child with the given name, or -1.
+ */
+int
+XMLChildNameIndex::find (const std::vector<XMLNode*>& children,
+                         const std::string& name) const
+{
+  const int slot = findSlot(children, XMLNameIndex::hash(name), name);
+  return (slot != -1) ? mSlots[(size_t)slot].first : -1;
+}
+
+
+/*
+ * @return the position of the next child after the nth with the same
+ * name, or -1.
+ */
+int
+XMLChildNameIndex::next (unsigned int n) const
+{
+  return mNext[n];
+}
+
+
+/*
+ * @return the slot of the children called name, or -1.
+ */
+int
+XMLChildNameIndex::findSlot (const std::vector<XMLNode*>& children,
+                             size_t hash, const std::string& name) const
+{
+  if (mSlots.empty()) return -1;
+
+  const size_t mask = mSlots.size() - 1;
+
+  for (size_t slot = hash & mask; mSlots[slot].first != -1;
+       slot = (slot + 1) & mask)
+  {
+    const Slot& current = mSlots[slot];
+
+    if (current.hash == hash
+        && children[(size_t)current.first]->getName() == name)
+    {
+      return static_cast<int>(slot);
+    }
+  }
+
+  return -1;
+}
+
+
+/*
+ * @return the slot of the list child n is linked into, found through the
+ * hash it was indexed under, so that it does not depend on the current
+ * name of the child.  Only if two names have the same hash is the list
+ * walked back to its first child to tell them apart.
+ */
+int
+XMLChildNameIndex::findSlotOf (unsigned int n) const
+{
+  const size_t mask  = mSlots.size() - 1;
+  const size_t hash  = mHash[n];
+  int          found = -1;
+  bool         again = false;
+
+  for (size_t slot = hash & mask; mSlots[slot].first != -1;
+       slot = (slot + 1) & mask)
+  {
+    if (mSlots[slot].hash != hash) continue;
+
+    if (found != -1) again = true;
+    found = static_cast<int>(slot);
+  }
+
+  if (!again) return found;
+
+  int first = static_cast<int>(n);
+  while (mPrev[(size_t)first] != -1) first = mPrev[(size_t)first];
+
+  for (size_t slot = hash & mask; mSlots[slot].first != -1;
+       slot = (slot + 1) & mask)
+  {
+    if (mSlots[slot].first == first) return static_cast<int>(slot);
+  }
+
+  return -1;
+}
+
+
+/*
+ * Links child n, which must not be linked, into the list of its name, in
+ * order of position.
+ */
+void
+XMLChildNameIndex::link (const std::vector<XMLNode*>& children,
+                         unsigned int n)
+{
+  const int slot = findSlot(children, mHash[n], children[n]->getName());
+
+  if (slot == -1)
+  {
+    insertSlot(mHash[n], n);
+    return;
+  }
+
+  Slot&     list  = mSlots[(size_t)slot];
+  const int index = static_cast<int>(n);
+
+  if (index > list.last)
+  {
+    mNext[(size_t)list.last] = index;
+    mPrev[n]                 = list.last;
+    list.last                = index;
+  }
+  else if (index < list.first)
+  {
+    mPrev[(size_t)list.first] = index;
+    mNext[n]                  = list.first;
+    list.first                = index;
+  }
+  else
+  {
+    // walk in from whichever end of the list is nearer to n
+    int before;
+
+    if (index - list.first <= list.last - index)
+    {
+      before = list.first;
+      while (mNext[(size_t)before] < index) before = mNext[(size_t)before];
+    }
+    else
+    {
+      before = list.last;
+      while (before > index) before = mPrev[(size_t)before];
+    }
+
+    const int after = mNext[(size_t)before];
+
+    mNext[(size_t)before] = index;
+    mPrev[n]              = before;
+    mNext[n]              = after;
+    mPrev[(size_t)after]  = index;
+  }
+}
+
+
+/*
+ * Takes child n out of the list it is linked into, dropping the slot of
+ * the list if n was the only child in it.
+ */
+void
+XMLChildNameIndex::unlink (unsigned int n)
+{
+  const size_t slot = static_cast<size_t>( findSlotOf(n) );
+  const int    prev = mPrev[n];
+  const int    next = mNext[n];
+
+  if (prev != -1) mNext[(size_t)prev] = next; else mSlots[slot].first = next;
+  if (next != -1) mPrev[(size_t)next] = prev; else mSlots[slot].last  = prev;
+
+  mPrev[n] = -1;
+  mNext[n] = -1;
+
+  if (mSlots[slot].first == -1) eraseSlot(slot);
+}
+
+
+/*
+ * Adds a slot for a name whose only child is n.  The table is kept at
+ * most half full, so probe sequences stay short.
+ */
+void
+XMLChildNameIndex::insertSlot (size_t hash, unsigned int n)
+{
+  if (2 * (mNumNames + 1) > mSlots.size()) grow();
+
+  const size_t mask = mSlots.size() - 1;
+  size_t       slot = hash & mask;
+
+  while (mSlots[slot].first != -1)
+  {
+    slot = (slot + 1) & mask;
+  }
+
+  mSlots[slot].hash  = hash;
+  mSlots[slot].first = static_cast<int>(n);
+  mSlots[slot].last  = static_cast<int>(n);
+  ++mNumNames;
+}
+
+
+/*
+ * Empties a slot, moving back the slots after it in the same probe run
+ * that could not be found past the gap otherwise.
+ */
+void
+XMLChildNameIndex::eraseSlot (size_t slot)
+{
+  const size_t mask = mSlots.size() - 1;
+
+  mSlots[slot].first = -1;
+  --mNumNames;
+
+  for (size_t next = (slot + 1) & mask; mSlots[next].first != -1;
+       next = (next + 1) & mask)
+  {
+    const size_t home = mSlots[next].hash & mask;
+
+    // a slot stays if its home lies cyclically within (slot, next]
+    const bool stays = (slot <= next) ? (slot < home && home <= next)
+                                      : (slot < home || home <= next);
+    if (stays) continue;
+
+    mSlots[slot]       = mSlots[next];
+    mSlots[next].first = -1;
+    slot               = next;
+  }
+}
+
+
+/*
+ * Doubles the table and reinserts the slots.
+ */
+void
+XMLChildNameIndex::grow ()
+{
+  const size_t capacity = mSlots.empty() ? 2 * XMLNameIndex::Threshold
+                                         : 2 * mSlots.size();
+
+  vector<Slot> old;
+  old.swap(mSlots);
+
+  Slot empty;
+  empty.hash  = 0;
+  empty.first = -1;
+  empty.last  = -1;
+  mSlots.assign(capacity, empty);
+
+  const size_t mask = capacity - 1;
+
+  for (size_t n = 0; n < old.size(); ++n)
+  {
+    if (old[n].first == -1) continue;
+
+    size_t slot = old[n].hash & mask;
+    while (mSlots[slot].first != -1) slot = (slot + 1) & mask;
+
+    mSlots[slot] = old[n];
+  }
+}
+
+
+/*
+ * Adds delta to every position from n on held in the links and slots.
+ */
+void
+XMLChildNameIndex::shift (unsigned int n, int delta)
+{
+  const int from = static_cast<int>(n);
+
+  for (size_t i = 0; i < mNext.size(); ++i)
+  {
+    if (mNext[i] >= from) mNext[i] += delta;
+    if (mPrev[i] >= from) mPrev[i] += delta;
+  }
+
+  for (size_t slot = 0; slot < mSlots.size(); ++slot)
+  {
+    if (mSlots[slot].first >= from) mSlots[slot].first += delta;
+    if (mSlots[slot].last  >= from) mSlots[slot].last  += delta;
+  }
+}
+
+
+LIBLX_CPP_NAMESPACE_END
+/** @endcond */
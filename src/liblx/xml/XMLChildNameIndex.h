@@ -0,0 +1,172 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLChildNameIndex.h
+ * @brief   Hashed index of the names of the children of an XMLNode
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLChildNameIndex
+ * @sbmlbrief{core} Index from names to the children of an XMLNode.
+ *
+ * An element with many children, such as an SBML listOf element, would
+ * make XMLNode::getIndex() and XMLNode::getChild(name) scan its children
+ * one by one.  Once it reaches XMLNameIndex::Threshold children, an
+ * XMLNode keeps an XMLChildNameIndex of them instead.
+ *
+ * The hash table holds one slot per distinct name, with the positions of
+ * the first and the last child of that name.  The children of each name
+ * are linked in order through the next and previous position stored for
+ * each child, so that many children of the same name, the usual shape
+ * of a list, take one slot and do not lengthen the probes for others.
+ *
+ * Names are not stored: they are read from the children themselves, so
+ * the index is given the children along with each change.
+ */
+
+#ifndef XMLChildNameIndex_h
+#define XMLChildNameIndex_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLNode;
+
+
+class LIBLX_EXTERN XMLChildNameIndex
+{
+public:
+
+  /**
+   * Creates a new, empty index.
+   */
+  XMLChildNameIndex ();
+
+
+  /**
+   * Removes all children from this index.
+   */
+  void clear ();
+
+
+  /**
+   * @return true if this index holds any children.
+   */
+  bool isBuilt () const;
+
+
+  /**
+   * @return the number of children in this index.
+   */
+  size_t size () const;
+
+
+  /**
+   * Indexes all of children, replacing what this index held.
+   */
+  void build (const std::vector<XMLNode*>& children);
+
+
+  /**
+   * Adds child n, which must be the only one of children not indexed
+   * yet.  The children after it move up by one.
+   */
+  void insert (const std::vector<XMLNode*>& children, unsigned int n);
+
+
+  /**
+   * Drops child n, which has been taken out of the children.  The
+   * children after it move down by one.
+   */
+  void remove (unsigned int n);
+
+
+  /**
+   * Moves child n to the list of its current name, if its name is not
+   * the one it was indexed under.
+   */
+  void rename (const std::vector<XMLNode*>& children, unsigned int n);
+
+
+  /**
+   * @return the position of the first child with the given name, or -1.
+   */
+  int find (const std::vector<XMLNode*>& children,
+            const std::string& name) const;
+
+
+  /**
+   * @return the position of the next child after the nth with the same
+   * name, or -1.
+   */
+  int next (unsigned int n) const;
+
+
+private:
+
+  /* The children with one name; an empty slot has first == -1. */
+  struct Slot
+  {
+    size_t hash;
+    int    first;
+    int    last;
+  };
+
+  int  findSlot (const std::vector<XMLNode*>& children, size_t hash,
+                 const std::string& name) const;
+  int  findSlotOf (unsigned int n) const;
+  void link (const std::vector<XMLNode*>& children, unsigned int n);
+  void unlink (unsigned int n);
+  void insertSlot (size_t hash, unsigned int n);
+  void eraseSlot (size_t slot);
+  void grow ();
+  void shift (unsigned int n, int delta);
+
+  std::vector<Slot>   mSlots;
+  size_t              mNumNames;
+  std::vector<int>    mNext;
+  std::vector<int>    mPrev;
+  std::vector<size_t> mHash;
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+#endif  /* XMLChildNameIndex_h */
+/** @endcond */
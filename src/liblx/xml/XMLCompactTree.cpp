@@ -0,0 +1,749 @@
+/**
+ * @file    XMLCompactTree.cpp
+ * @brief   Read-only XML trees that share identical subtrees
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <new>
+#include <sstream>
+#include <utility>
+
+#include <liblx/xml/XMLCompactTree.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNameIndex.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLOutputStream.h>
+#include <liblx/xml/operationReturnValues.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+#ifdef __cplusplus
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Mixes value into a running hash.
+ */
+static size_t
+combineHash (size_t seed, size_t value)
+{
+  return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+
+/*
+ * @return a hash of everything token holds but its position.
+ */
+static size_t
+hashToken (const XMLToken& token)
+{
+  size_t hash = (token.isStart() ? 1 : 0) + (token.isEnd() ? 2 : 0)
+              + (token.isText()  ? 4 : 0);
+
+  hash = combineHash(hash, XMLNameIndex::hash(token.getName()));
+  hash = combineHash(hash, XMLNameIndex::hash(token.getURI()));
+  hash = combineHash(hash, XMLNameIndex::hash(token.getPrefix()));
+  hash = combineHash(hash, XMLNameIndex::hash(token.getCharacters()));
+
+  const XMLAttributes& attributes = token.getAttributes();
+  for (int i = 0; i < attributes.getLength(); ++i)
+  {
+    hash = combineHash(hash, XMLNameIndex::hash(attributes.getName(i)));
+    hash = combineHash(hash, XMLNameIndex::hash(attributes.getURI(i)));
+    hash = combineHash(hash, XMLNameIndex::hash(attributes.getPrefix(i)));
+    hash = combineHash(hash, XMLNameIndex::hash(attributes.getValue(i)));
+  }
+
+  for (int i = 0; i < token.getNamespacesLength(); ++i)
+  {
+    hash = combineHash(hash, XMLNameIndex::hash(token.getNamespacePrefix(i)));
+    hash = combineHash(hash, XMLNameIndex::hash(token.getNamespaceURI(i)));
+  }
+
+  return hash;
+}
+
+
+/*
+ * @return true if a and b hold the same name, namespace declarations,
+ * attributes in the same order, and text, wherever they come from.
+ */
+static bool
+isSameToken (const XMLToken& a, const XMLToken& b)
+{
+  if (a.isStart()       != b.isStart()
+   || a.isEnd()         != b.isEnd()
+   || a.isText()        != b.isText()
+   || a.getName()       != b.getName()
+   || a.getURI()        != b.getURI()
+   || a.getPrefix()     != b.getPrefix()
+   || a.getCharacters() != b.getCharacters())
+  {
+    return false;
+  }
+
+  const XMLAttributes& aAttributes = a.getAttributes();
+  const XMLAttributes& bAttributes = b.getAttributes();
+
+  if (aAttributes.getLength() != bAttributes.getLength()
+   || a.getNamespacesLength() != b.getNamespacesLength())
+  {
+    return false;
+  }
+
+  for (int i = 0; i < aAttributes.getLength(); ++i)
+  {
+    if (aAttributes.getName(i)   != bAttributes.getName(i)
+     || aAttributes.getURI(i)    != bAttributes.getURI(i)
+     || aAttributes.getPrefix(i) != bAttributes.getPrefix(i)
+     || aAttributes.getValue(i)  != bAttributes.getValue(i))
+    {
+      return false;
+    }
+  }
+
+  for (int i = 0; i < a.getNamespacesLength(); ++i)
+  {
+    if (a.getNamespacePrefix(i) != b.getNamespacePrefix(i)
+     || a.getNamespaceURI(i)    != b.getNamespaceURI(i))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+const XMLCompactNode XMLCompactNode::Empty;
+
+
+/*
+ * Creates a new empty XMLCompactNode, the node returned for children
+ * that do not exist.
+ */
+XMLCompactNode::XMLCompactNode () :
+   XMLToken  ()
+ , mChildren ()
+ , mNext     ( NULL )
+ , mHash     ( 0 )
+ , mNumNodes ( 1 )
+ , mRefs     ( 0 )
+{
+}
+
+
+/*
+ * Creates a new XMLCompactNode holding a copy of token and no children.
+ */
+XMLCompactNode::XMLCompactNode (const XMLToken& token) :
+   XMLToken  ( token )
+ , mChildren ()
+ , mNext     ( NULL )
+ , mHash     ( 0 )
+ , mNumNodes ( 1 )
+ , mRefs     ( 0 )
+{
+}
+/** @endcond */
+
+
+/*
+ * Destroys this XMLCompactNode.
+ */
+XMLCompactNode::~XMLCompactNode ()
+{
+}
+
+
+/*
+ * @return the number of children of this node.
+ */
+unsigned int
+XMLCompactNode::getNumChildren () const
+{
+  return (unsigned int)mChildren.size();
+}
+
+
+/*
+ * @return the nth child of this XMLCompactNode, or an empty node if n is
+ * out of range.
+ */
+const XMLCompactNode&
+XMLCompactNode::getChild (unsigned int n) const
+{
+  return (n < mChildren.size()) ? *mChildren[n] : Empty;
+}
+
+
+/*
+ * @return the first child of this XMLCompactNode with the given name, or
+ * an empty node if there is none.
+ */
+const XMLCompactNode&
+XMLCompactNode::getChild (const std::string& name) const
+{
+  int index = getIndex(name);
+  return (index != -1) ? *mChildren[index] : Empty;
+}
+
+
+/*
+ * @return the index of the first child of this XMLCompactNode with the
+ * given name, or -1 if not present.
+ */
+int
+XMLCompactNode::getIndex (const std::string& name) const
+{
+  for (size_t n = 0; n < mChildren.size(); ++n)
+  {
+    if (mChildren[n]->getName() == name) return (int)n;
+  }
+
+  return -1;
+}
+
+
+/*
+ * @return true if this XMLCompactNode has a child with the given name.
+ */
+bool
+XMLCompactNode::hasChild (const std::string& name) const
+{
+  return getIndex(name) != -1;
+}
+
+
+/*
+ * @return the number of nodes in the subtree, counting each occurrence
+ * of a shared subtree.
+ */
+size_t
+XMLCompactNode::getNumNodes () const
+{
+  return mNumNodes;
+}
+
+
+/*
+ * @return the hash of the subtree rooted at this XMLCompactNode.
+ */
+size_t
+XMLCompactNode::getHash () const
+{
+  return mHash;
+}
+
+
+/*
+ * @return a private XMLNode copy of the subtree rooted at this
+ * XMLCompactNode.  Shared subtrees are copied as often as they occur;
+ * the copy is built without recursion.
+ */
+XMLNode*
+XMLCompactNode::toXMLNode () const
+{
+  XMLNode* root = new XMLNode(static_cast<const XMLToken&>(*this));
+
+  vector< pair<const XMLCompactNode*, XMLNode*> > stack;
+  stack.push_back(make_pair(this, root));
+
+  while (!stack.empty())
+  {
+    const XMLCompactNode* from = stack.back().first;
+    XMLNode*              to   = stack.back().second;
+    stack.pop_back();
+
+    for (unsigned int n = 0; n < from->getNumChildren(); ++n)
+    {
+      const XMLCompactNode* child = from->mChildren[n];
+      XMLNode* copy = new XMLNode(static_cast<const XMLToken&>(*child));
+
+      to->adoptChild(copy, n);
+      stack.push_back(make_pair(child, copy));
+    }
+  }
+
+  return root;
+}
+
+
+/*
+ * @return the XML string of this XMLCompactNode and its children.
+ */
+std::string
+XMLCompactNode::toXMLString () const
+{
+  std::ostringstream oss;
+  XMLOutputStream xos(oss,"UTF-8",false);
+  write(xos);
+
+  return oss.str();
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Writes this XMLCompactNode and its children to stream, as
+ * XMLNode::write() does.
+ */
+void
+XMLCompactNode::write (XMLOutputStream& stream) const
+{
+  unsigned int children = getNumChildren();
+
+  XMLToken::write(stream);
+
+  if (children > 0)
+  {
+    bool haveTextNode = false;
+    for (unsigned int c = 0; c < children; ++c)
+    {
+      const XMLCompactNode& current = getChild(c);
+      current.write(stream);
+      haveTextNode |= current.isText();
+    }
+
+    if (!mTriple.isEmpty())
+    {
+      stream.endElement( mTriple, haveTextNode);
+    }
+  }
+  else if ( isStart() && !isEnd() )
+  {
+    stream.endElement( mTriple );
+  }
+}
+/** @endcond */
+
+
+/*
+ * Creates a new, empty XMLCompactTree.
+ */
+XMLCompactTree::XMLCompactTree () :
+   mBuckets  ()
+ , mNumUnique( 0 )
+ , mRoot     ( NULL )
+{
+}
+
+
+/*
+ * Creates a new XMLCompactTree holding the tree rooted at root.
+ */
+XMLCompactTree::XMLCompactTree (const XMLNode& root) :
+   mBuckets  ()
+ , mNumUnique( 0 )
+ , mRoot     ( NULL )
+{
+  mRoot = internTree(root);
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Creates a new XMLCompactTree by reading XMLTokens from stream.  The
+ * elements still open are kept on a stack, with the children read so
+ * far for each; an element is stored when its end is reached, so that
+ * only the part of the document not yet known to be shared is ever held
+ * twice.
+ */
+XMLCompactTree::XMLCompactTree (XMLInputStream& stream) :
+   mBuckets  ()
+ , mNumUnique( 0 )
+ , mRoot     ( NULL )
+{
+  vector<XMLToken>        open;
+  vector<size_t>          first;     // where the children of each start
+  vector<XMLCompactNode*> children;
+  vector<XMLCompactNode*> siblings;
+
+  open.push_back( stream.next() );
+  first.push_back( 0 );
+
+  while ( !open.empty() )
+  {
+    bool close = open.back().isEnd() || !stream.isGood();
+
+    if ( !close )
+    {
+      const XMLToken& next = stream.peek();
+
+      if ( next.isStart() )
+      {
+        open.push_back( stream.next() );
+        first.push_back( children.size() );
+      }
+      else if ( next.isText() )
+      {
+        XMLToken text = stream.next();
+
+        // a stream with a character chunk size set delivers one text node
+        // as several consecutive text tokens
+        while ( stream.isGood() && stream.peek().isText() )
+        {
+          text.append( stream.nextView().getCharacters() );
+        }
+
+        if (!text.isWhitespace())
+        {
+          siblings.clear();
+          children.push_back( intern(text, siblings) );
+        }
+      }
+      else if ( next.isEnd() )
+      {
+        stream.next();
+        close = true;
+      }
+    }
+
+    if ( close )
+    {
+      siblings.assign(children.begin() + first.back(), children.end());
+      children.resize(first.back());
+
+      XMLCompactNode* node = intern(open.back(), siblings);
+      open.pop_back();
+      first.pop_back();
+
+      if (open.empty())
+      {
+        mRoot = node;
+      }
+      else
+      {
+        children.push_back(node);
+      }
+    }
+  }
+}
+/** @endcond */
+
+
+/*
+ * Destroys this XMLCompactTree and all its nodes.
+ */
+XMLCompactTree::~XMLCompactTree ()
+{
+  for (size_t b = 0; b < mBuckets.size(); ++b)
+  {
+    XMLCompactNode* node = mBuckets[b];
+    while (node != NULL)
+    {
+      XMLCompactNode* next = node->mNext;
+      delete node;
+      node = next;
+    }
+  }
+}
+
+
+/*
+ * @return the root of this XMLCompactTree, or NULL if it is empty.
+ */
+const XMLCompactNode*
+XMLCompactTree::getRoot () const
+{
+  return mRoot;
+}
+
+
+/*
+ * @return the number of nodes in the document, counting each occurrence
+ * of a shared subtree.
+ */
+size_t
+XMLCompactTree::getNumNodes () const
+{
+  return (mRoot != NULL) ? mRoot->getNumNodes() : 0;
+}
+
+
+/*
+ * @return the number of distinct subtrees stored.
+ */
+unsigned int
+XMLCompactTree::getNumUniqueNodes () const
+{
+  return mNumUnique;
+}
+
+
+/*
+ * Replaces the subtree at path by a copy of subtree.  The nodes on the
+ * path are stored again with one child changed, from the bottom up, and
+ * the old root let go of; nodes nothing refers to any longer are freed.
+ */
+int
+XMLCompactTree::replace (const std::vector<unsigned int>& path,
+                         const XMLNode& subtree)
+{
+  if (mRoot == NULL) return LIBLX_INVALID_XML_OPERATION;
+
+  vector<XMLCompactNode*> nodes(1, mRoot);
+  for (size_t n = 0; n < path.size(); ++n)
+  {
+    if (path[n] >= nodes.back()->getNumChildren())
+    {
+      return LIBLX_INVALID_XML_OPERATION;
+    }
+
+    nodes.push_back(nodes.back()->mChildren[path[n]]);
+  }
+
+  XMLCompactNode* node = internTree(subtree);
+
+  for (size_t n = path.size(); n-- > 0; )
+  {
+    const XMLCompactNode* parent = nodes[n];
+
+    vector<XMLCompactNode*> children(parent->mChildren);
+    for (size_t c = 0; c < children.size(); ++c)
+    {
+      if (c != path[n]) ++children[c]->mRefs;
+    }
+    children[path[n]] = node;
+
+    node = intern(*parent, children);
+  }
+
+  release(mRoot);
+  mRoot = node;
+
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return a private XMLNode copy of this XMLCompactTree, or NULL if it is
+ * empty.
+ */
+XMLNode*
+XMLCompactTree::toXMLNode () const
+{
+  return (mRoot != NULL) ? mRoot->toXMLNode() : NULL;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Returns the node holding token with the given children, creating it if
+ * this XMLCompactTree does not hold one yet, with one more reference to
+ * it.  The references to the children, one each, pass to the node
+ * returned, and children is left in an unspecified state.
+ */
+XMLCompactNode*
+XMLCompactTree::intern (const XMLToken& token,
+                        std::vector<XMLCompactNode*>& children)
+{
+  size_t hash     = combineHash(hashToken(token), children.size());
+  size_t numNodes = 1;
+
+  for (size_t c = 0; c < children.size(); ++c)
+  {
+    hash      = combineHash(hash, children[c]->mHash);
+    numNodes += children[c]->mNumNodes;
+  }
+
+  if (!mBuckets.empty())
+  {
+    XMLCompactNode* node = mBuckets[hash & (mBuckets.size() - 1)];
+    for (; node != NULL; node = node->mNext)
+    {
+      if (node->mHash == hash && node->mChildren == children
+          && isSameToken(*node, token))
+      {
+        // node holds a reference to each of the children already
+        for (size_t c = 0; c < children.size(); ++c)
+        {
+          --children[c]->mRefs;
+        }
+
+        ++node->mRefs;
+        return node;
+      }
+    }
+  }
+
+  if (mNumUnique + 1 > mBuckets.size()) grow();
+
+  XMLCompactNode* node = new XMLCompactNode(token);
+  node->mChildren.swap(children);
+  node->mHash     = hash;
+  node->mNumNodes = numNodes;
+  node->mRefs     = 1;
+
+  XMLCompactNode*& bucket = mBuckets[hash & (mBuckets.size() - 1)];
+  node->mNext = bucket;
+  bucket      = node;
+  ++mNumUnique;
+
+  return node;
+}
+
+
+/*
+ * Stores the tree rooted at root, children before their parents and
+ * without recursion, and returns the node for root.
+ */
+XMLCompactNode*
+XMLCompactTree::internTree (const XMLNode& root)
+{
+  vector<const XMLNode*>  open(1, &root);
+  vector<unsigned int>    next(1, 0);
+  vector<size_t>          first(1, 0);
+  vector<XMLCompactNode*> children;
+  vector<XMLCompactNode*> siblings;
+
+  while (true)
+  {
+    const XMLNode& node = *open.back();
+
+    if (next.back() < node.getNumChildren())
+    {
+      open.push_back(&node.getChild(next.back()++));
+      next.push_back(0);
+      first.push_back(children.size());
+      continue;
+    }
+
+    siblings.assign(children.begin() + first.back(), children.end());
+    children.resize(first.back());
+
+    XMLCompactNode* compact = intern(node, siblings);
+    if (open.size() == 1) return compact;
+
+    children.push_back(compact);
+    open.pop_back();
+    next.pop_back();
+    first.pop_back();
+  }
+}
+
+
+/*
+ * Drops one reference to node, freeing it, and in turn dropping its
+ * references to its children, if it was the last.
+ */
+void
+XMLCompactTree::release (XMLCompactNode* node)
+{
+  vector<XMLCompactNode*> stack(1, node);
+
+  while (!stack.empty())
+  {
+    node = stack.back();
+    stack.pop_back();
+
+    if (--node->mRefs > 0) continue;
+
+    XMLCompactNode** link = &mBuckets[node->mHash & (mBuckets.size() - 1)];
+    while (*link != node) link = &(*link)->mNext;
+    *link = node->mNext;
+    --mNumUnique;
+
+    stack.insert(stack.end(), node->mChildren.begin(), node->mChildren.end());
+    delete node;
+  }
+}
+
+
+/*
+ * Doubles the number of buckets and rehashes every node.
+ */
+void
+XMLCompactTree::grow ()
+{
+  size_t capacity = mBuckets.empty() ? 16 : 2 * mBuckets.size();
+
+  vector<XMLCompactNode*> buckets(capacity, (XMLCompactNode*)NULL);
+  for (size_t b = 0; b < mBuckets.size(); ++b)
+  {
+    XMLCompactNode* node = mBuckets[b];
+    while (node != NULL)
+    {
+      XMLCompactNode* next = node->mNext;
+      XMLCompactNode*& bucket = buckets[node->mHash & (capacity - 1)];
+      node->mNext = bucket;
+      bucket      = node;
+      node        = next;
+    }
+  }
+
+  mBuckets.swap(buckets);
+}
+/** @endcond */
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLCompactTree_t *
+XMLCompactTree_create (const XMLNode_t *root)
+{
+  if (root == NULL) return NULL;
+  return new(nothrow) XMLCompactTree(*root);
+}
+
+
+LIBLX_EXTERN
+void
+XMLCompactTree_free (XMLCompactTree_t *tree)
+{
+  delete static_cast<XMLCompactTree*>(tree);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLCompactTree_getNumUniqueNodes (const XMLCompactTree_t *tree)
+{
+  return (tree != NULL) ? tree->getNumUniqueNodes() : 0;
+}
+
+
+LIBLX_EXTERN
+XMLNode_t *
+XMLCompactTree_toXMLNode (const XMLCompactTree_t *tree)
+{
+  return (tree != NULL) ? tree->toXMLNode() : NULL;
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
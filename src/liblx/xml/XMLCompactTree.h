@@ -0,0 +1,432 @@
+/**
+ * @file    XMLCompactTree.h
+ * @brief   Read-only XML trees that share identical subtrees
+ *
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ *
+ * @class XMLCompactTree
+ * @sbmlbrief{core} A read-only XML tree in which identical subtrees are
+ * stored once.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * Generated documents often repeat large fragments word for word:
+ * annotations, unit definitions, the same MathML over and over.  An
+ * XMLNode tree holds each of them in full, since every XMLNode knows its
+ * parent and its position in it and so can only be in one place.  An
+ * XMLCompactTree holds the same document as XMLCompactNode objects, which
+ * know only their children, and keeps a single XMLCompactNode for all the
+ * subtrees that are alike in everything they hold (names, namespace
+ * declarations, attributes in order, and text), however many times they
+ * occur.
+ *
+ * An XMLCompactTree can be built from an XMLNode, or read straight from
+ * an XMLInputStream so that the full tree is never held in memory.  Its
+ * nodes are only ever handed out as @c const, and offer the read
+ * methods of XMLToken and those of XMLNode that look down the tree:
+ * @code{.cpp}
+XMLCompactTree tree(stream);
+
+const XMLCompactNode* root = tree.getRoot();
+for (unsigned int n = 0; n < root->getNumChildren(); ++n)
+{
+  const XMLCompactNode& child = root->getChild(n);
+  ...
+}
+@endcode
+ *
+ * A change goes through a private copy: XMLCompactNode::toXMLNode()
+ * gives an ordinary XMLNode copy of a subtree to modify, and replace()
+ * puts a modified subtree back in place.  Only the nodes on the way from
+ * the root to the subtree replaced are copied; whatever other places
+ * shared them still see them as they were.
+ *
+ * @note Where the same subtree occurs more than once, getLine() and
+ * getColumn() of its nodes give the position of its first occurrence.
+ */
+
+/**
+ * @class XMLCompactNode
+ * @sbmlbrief{core} A node of an XMLCompactTree.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * An XMLCompactNode is an XMLToken with children, which may also be the
+ * children of other nodes of the same XMLCompactTree.  It has no parent,
+ * and lives as long as the XMLCompactTree it belongs to.
+ */
+
+#ifndef XMLCompactTree_h
+#define XMLCompactTree_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/XMLToken.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLInputStream;
+class XMLNode;
+class XMLOutputStream;
+
+
+class LIBLX_EXTERN XMLCompactNode : public XMLToken
+{
+public:
+
+  /**
+   * Destroys this XMLCompactNode.
+   */
+  virtual ~XMLCompactNode ();
+
+
+  /**
+   * Returns the number of children of this XMLCompactNode.
+   *
+   * @return the number of children of this node.
+   */
+  unsigned int getNumChildren () const;
+
+
+  /**
+   * Returns the <code>n</code>th child of this XMLCompactNode.
+   *
+   * If the index @p n is greater than the number of child nodes, this
+   * method returns an empty node.
+   *
+   * @param n an unsigned integer, the index of the node to return.
+   *
+   * @return the  <code>n</code>th child of this XMLCompactNode.
+   */
+  const XMLCompactNode& getChild (unsigned int n) const;
+
+
+  /**
+   * Returns the first child of this XMLCompactNode with the corresponding
+   * name.
+   *
+   * If no child with corrsponding name can be found, this method returns
+   * an empty node.
+   *
+   * @param name the name of the node to return.
+   *
+   * @return the first child of this XMLCompactNode with the corresponding
+   * name.
+   */
+  const XMLCompactNode& getChild (const std::string& name) const;
+
+
+  /**
+   * Return the index of the first child of this XMLCompactNode with the
+   * given name.
+   *
+   * @param name a string, the name of the child for which the index is
+   * required.
+   *
+   * @return the index of the first child of this XMLCompactNode with the
+   * given name, or -1 if not present.
+   */
+  int getIndex (const std::string& name) const;
+
+
+  /**
+   * Return a boolean indicating whether this XMLCompactNode has a child
+   * with the given name.
+   *
+   * @param name a string, the name of the child to be checked.
+   *
+   * @return boolean indicating whether this XMLCompactNode has a child
+   * with the given name.
+   */
+  bool hasChild (const std::string& name) const;
+
+
+  /**
+   * Returns the number of nodes in the subtree rooted at this
+   * XMLCompactNode, this node included, counting each occurrence of a
+   * shared subtree.
+   *
+   * @return the number of nodes in the subtree as a document would hold
+   * them.
+   */
+  size_t getNumNodes () const;
+
+
+  /**
+   * Returns a hash of all the subtree rooted at this XMLCompactNode holds.
+   * Nodes of the same XMLCompactTree are identical exactly when they are
+   * the same object; the hash is what the tree finds them by.
+   *
+   * @return the hash of the subtree.
+   */
+  size_t getHash () const;
+
+
+  /**
+   * Returns a private copy of the subtree rooted at this XMLCompactNode,
+   * as an XMLNode tree that may be modified freely.
+   *
+   * @return the copy, which the caller owns.
+   */
+  XMLNode* toXMLNode () const;
+
+
+  /**
+   * Returns a string representation of this XMLCompactNode and its
+   * children, in the same form as XMLNode::toXMLString().
+   *
+   * @return the XML string.
+   */
+  std::string toXMLString () const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Writes this XMLCompactNode and its children to stream.
+   *
+   * @param stream XMLOutputStream, stream to which this XMLCompactNode
+   * is to be written.
+   */
+  void write (XMLOutputStream& stream) const;
+  /** @endcond */
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  XMLCompactNode ();
+  explicit XMLCompactNode (const XMLToken& token);
+
+  XMLCompactNode (const XMLCompactNode&);
+  XMLCompactNode& operator= (const XMLCompactNode&);
+
+  friend class XMLCompactTree;
+
+  static const XMLCompactNode Empty;
+
+  std::vector<XMLCompactNode*> mChildren;
+  XMLCompactNode*              mNext;       // next in the same bucket
+  size_t                       mHash;
+  size_t                       mNumNodes;
+  unsigned int                 mRefs;       // parents, and the tree root
+
+  /** @endcond */
+};
+
+
+class LIBLX_EXTERN XMLCompactTree
+{
+public:
+
+  /**
+   * Creates a new, empty XMLCompactTree.
+   */
+  XMLCompactTree ();
+
+
+  /**
+   * Creates a new XMLCompactTree holding the tree rooted at @p root.
+   *
+   * @param root the tree to hold.
+   */
+  explicit XMLCompactTree (const XMLNode& root);
+
+
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Creates a new XMLCompactTree by reading XMLTokens from stream, without
+   * building an XMLNode tree first.  The stream must be positioned on a
+   * start element (stream.peek().isStart() == true) and will be read until
+   * the matching end element is found, as by the XMLNode constructor that
+   * reads a stream.
+   */
+  explicit XMLCompactTree (XMLInputStream& stream);
+  /** @endcond */
+
+
+  /**
+   * Destroys this XMLCompactTree and all its nodes.
+   */
+  ~XMLCompactTree ();
+
+
+  /**
+   * @return the root of this XMLCompactTree, or @c NULL if it is empty.
+   */
+  const XMLCompactNode* getRoot () const;
+
+
+  /**
+   * Returns the number of nodes in this XMLCompactTree, counting each
+   * occurrence of a shared subtree: the number of XMLNode objects the
+   * same tree takes as an XMLNode tree.
+   *
+   * @return the number of nodes in the document.
+   */
+  size_t getNumNodes () const;
+
+
+  /**
+   * Returns the number of distinct subtrees this XMLCompactTree stores,
+   * which is the number of XMLCompactNode objects it holds.
+   *
+   * @return the number of nodes actually stored.
+   */
+  unsigned int getNumUniqueNodes () const;
+
+
+  /**
+   * Replaces the subtree reached from the root by following @p path, a
+   * list of child indices, by a copy of @p subtree.  The nodes on the way
+   * are copied rather than changed, so other occurrences of the subtrees
+   * they are shared with keep their contents.  An empty path replaces
+   * the whole tree.
+   *
+   * @param path the child indices that lead from the root to the subtree
+   * to replace.
+   * @param subtree the subtree to put in its place.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_XML_OPERATION, OperationReturnValues_t}
+   */
+  int replace (const std::vector<unsigned int>& path, const XMLNode& subtree);
+
+
+  /**
+   * Returns a private copy of this XMLCompactTree as an XMLNode tree,
+   * or @c NULL if it is empty.
+   *
+   * @return the copy, which the caller owns.
+   */
+  XMLNode* toXMLNode () const;
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  XMLCompactTree (const XMLCompactTree&);
+  XMLCompactTree& operator= (const XMLCompactTree&);
+
+  XMLCompactNode* intern (const XMLToken& token,
+                          std::vector<XMLCompactNode*>& children);
+  XMLCompactNode* internTree (const XMLNode& root);
+  void release (XMLCompactNode* node);
+  void grow ();
+
+  std::vector<XMLCompactNode*> mBuckets;
+  unsigned int                 mNumUnique;
+  XMLCompactNode*              mRoot;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+BEGIN_C_DECLS
+
+/**
+ * Creates a new XMLCompactTree_t structure holding the tree rooted at
+ * @p root.
+ *
+ * @param root the tree to hold.
+ *
+ * @return pointer to the new XMLCompactTree_t structure, or @c NULL if
+ * root is @c NULL.
+ *
+ * @memberof XMLCompactTree_t
+ */
+LIBLX_EXTERN
+XMLCompactTree_t *
+XMLCompactTree_create (const XMLNode_t *root);
+
+
+/**
+ * Destroys this XMLCompactTree_t structure.
+ *
+ * @param tree XMLCompactTree_t structure to be freed.
+ *
+ * @memberof XMLCompactTree_t
+ */
+LIBLX_EXTERN
+void
+XMLCompactTree_free (XMLCompactTree_t *tree);
+
+
+/**
+ * Returns the number of distinct subtrees the XMLCompactTree_t structure
+ * tree stores.
+ *
+ * @param tree the XMLCompactTree_t structure.
+ *
+ * @return the number of nodes stored, or @c 0 if tree is @c NULL.
+ *
+ * @memberof XMLCompactTree_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLCompactTree_getNumUniqueNodes (const XMLCompactTree_t *tree);
+
+
+/**
+ * Returns a private copy of the XMLCompactTree_t structure tree as an
+ * XMLNode_t tree.
+ *
+ * @param tree the XMLCompactTree_t structure.
+ *
+ * @return the copy, which the caller owns, or @c NULL if tree is @c NULL
+ * or empty.
+ *
+ * @memberof XMLCompactTree_t
+ */
+LIBLX_EXTERN
+XMLNode_t *
+XMLCompactTree_toXMLNode (const XMLCompactTree_t *tree);
+
+END_C_DECLS
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLCompactTree_h */
@@ -0,0 +1,99 @@
+/**
+ * @file    XMLElementFilter.h
+ * @brief   Selects the elements an XMLInputStream turns into tokens
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ *
+ * @class XMLElementFilter
+ * @sbmlbrief{core} Decides which elements of a document are read at all.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * An XMLElementFilter installed with XMLInputStream::setElementFilter()
+ * is asked about every start element, before its attributes and
+ * namespaces are read.  When accept() returns @c false, the element and
+ * everything inside it are dropped by the parser front end: no XMLToken
+ * is built for them, and the filter is not asked about the elements
+ * inside.  The stream continues as if the subtree were not there.
+ *
+ * A pass that only needs the annotations of a model, for instance, can
+ * reject the elements that hold large amounts of other content:
+ * @code{.cpp}
+class AnnotationsOnly : public XMLElementFilter
+{
+public:
+  virtual bool accept (const XMLTriple& element)
+  {
+    return element.getName() != "math" && element.getName() != "notes";
+  }
+};
+@endcode
+ */
+
+#ifndef XMLElementFilter_h
+#define XMLElementFilter_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLTriple;
+
+
+class LIBLX_EXTERN XMLElementFilter
+{
+public:
+
+  /**
+   * Destroys this XMLElementFilter.
+   */
+  virtual ~XMLElementFilter ();
+
+
+  /**
+   * Decides whether an element, and its content, is read.
+   *
+   * @param element the name, namespace URI and prefix of the element.
+   *
+   * @return @c true to read the element, @c false to drop it along with
+   * its content.
+   */
+  virtual bool accept (const XMLTriple& element) = 0;
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* XMLElementFilter_h */
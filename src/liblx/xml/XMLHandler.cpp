@@ -139,5 +139,63 @@ XMLHandler::characters (const XMLToken& )
 {
 }
 
+
+/*
+ * Decides whether an element is passed on at all.
+ *
+ * By default, accept every element.
+ */
+bool
+XMLHandler::acceptElement (const XMLTriple& )
+{
+  return true;
+}
+
+
+/*
+ * @return @c true while this handler is discarding a subtree.
+ *
+ * By default, return @c false.
+ */
+bool
+XMLHandler::isSkipping () const
+{
+  return false;
+}
+
+
+/*
+ * Receive notification of the start of an element that is being skipped.
+ *
+ * By default, do nothing.
+ */
+void
+XMLHandler::skipStartElement ()
+{
+}
+
+
+/*
+ * Receive notification of the end of an element that is being skipped.
+ *
+ * By default, do nothing.
+ */
+void
+XMLHandler::skipEndElement ()
+{
+}
+
+
+/*
+ * Returns @c true once this handler wants no more of the document.
+ *
+ * By default, return @c false.
+ */
+bool
+XMLHandler::isStopped () const
+{
+  return false;
+}
+
 LIBLX_CPP_NAMESPACE_END
 /** @endcond */
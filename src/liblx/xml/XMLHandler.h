@@ -53,6 +53,7 @@
 LIBLX_CPP_NAMESPACE_BEGIN
 
 class XMLToken;
+class XMLTriple;
 
 class LIBLX_EXTERN XMLHandler
 {
@@ -131,6 +132,58 @@ public:
    * to take specific actions for each chunk of character data.
    */
   virtual void characters (const XMLToken& data);
+
+
+  /**
+   * Decides whether an element is passed on at all.  Parser front ends
+   * call this with the element name before reading its attributes and
+   * namespaces.  For a rejected element they call skipStartElement()
+   * instead of startElement(), and the element is then skipped like any
+   * other subtree (see isSkipping()).
+   *
+   * By default, accept every element.
+   */
+  virtual bool acceptElement (const XMLTriple& element);
+
+
+  /**
+   * Returns @c true while this handler is discarding a subtree.
+   *
+   * Parser front ends check this before building an XMLToken.  While it
+   * returns @c true they report elements through skipStartElement() and
+   * skipEndElement() only, and drop character data.
+   *
+   * By default, return @c false.
+   */
+  virtual bool isSkipping () const;
+
+
+  /**
+   * Receive notification of the start of an element that is being skipped.
+   *
+   * By default, do nothing.
+   */
+  virtual void skipStartElement ();
+
+
+  /**
+   * Receive notification of the end of an element that is being skipped.
+   *
+   * By default, do nothing.
+   */
+  virtual void skipEndElement ();
+
+
+  /**
+   * Returns @c true once this handler wants no more of the document.
+   *
+   * Parser front ends check this after startElement() and halt the
+   * underlying parser, so that the rest of the current chunk is not
+   * parsed either.
+   *
+   * By default, return @c false.
+   */
+  virtual bool isStopped () const;
 };
 
 LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,321 @@
+/**
+ * @file    XMLIdIndex.cpp
+ * @brief   Index of the elements of an XMLNode tree by identifier
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <liblx/xml/XMLIdIndex.h>
+#include <liblx/xml/XMLNameIndex.h>
+#include <liblx/xml/XMLNode.h>
+
+using namespace std;
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+/*
+ * Creates a new, empty XMLIdIndex.
+ */
+XMLIdIndex::XMLIdIndex () :
+   mAttributes()
+ , mBuckets   ()
+ , mNumEntries( 0 )
+ , mValues    ()
+{
+}
+
+
+/*
+ * @return the number of identifier attributes.
+ */
+unsigned int
+XMLIdIndex::getNumAttributes () const
+{
+  return (unsigned int)mAttributes.size();
+}
+
+
+/*
+ * @return the name of the nth identifier attribute.
+ */
+std::string
+XMLIdIndex::getAttribute (unsigned int n) const
+{
+  return (n < mAttributes.size()) ? mAttributes[n] : std::string();
+}
+
+
+/*
+ * @return true if name is an identifier attribute.
+ */
+bool
+XMLIdIndex::hasAttribute (const std::string& name) const
+{
+  for (size_t n = 0; n < mAttributes.size(); ++n)
+  {
+    if (mAttributes[n] == name) return true;
+  }
+
+  return false;
+}
+
+
+/*
+ * @return the element whose identifier attribute has the given value.
+ */
+XMLNode*
+XMLIdIndex::getNode (const std::string& value) const
+{
+  if (mBuckets.empty()) return NULL;
+
+  size_t hash = XMLNameIndex::hash(value);
+  const Bucket& bucket = mBuckets[hash & (mBuckets.size() - 1)];
+
+  for (Bucket::const_iterator it = bucket.begin(); it != bucket.end(); ++it)
+  {
+    if (it->hash == hash && it->value == value) return it->node;
+  }
+
+  return NULL;
+}
+
+
+/*
+ * @return the number of entries in this index.
+ */
+unsigned int
+XMLIdIndex::getNumEntries () const
+{
+  return mNumEntries;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Adds an attribute name to record.
+ */
+bool
+XMLIdIndex::addAttribute (const std::string& name)
+{
+  if (hasAttribute(name)) return false;
+
+  mAttributes.push_back(name);
+  return true;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Records the identifier attributes of every element in the subtree
+ * rooted at node.
+ */
+void
+XMLIdIndex::addSubtree (XMLNode& node)
+{
+  vector<XMLNode*> pending(1, &node);
+
+  while (!pending.empty())
+  {
+    XMLNode* current = pending.back();
+    pending.pop_back();
+
+    add(*current);
+
+    for (unsigned int n = current->getNumChildren(); n > 0; --n)
+    {
+      pending.push_back(&current->getChild(n - 1));
+    }
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Forgets the identifier attributes of every element in the subtree
+ * rooted at node.
+ */
+void
+XMLIdIndex::removeSubtree (const XMLNode& node)
+{
+  vector<const XMLNode*> pending(1, &node);
+
+  while (!pending.empty())
+  {
+    const XMLNode* current = pending.back();
+    pending.pop_back();
+
+    remove(*current);
+
+    for (unsigned int n = current->getNumChildren(); n > 0; --n)
+    {
+      pending.push_back(&current->getChild(n - 1));
+    }
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Records the identifier attributes of node itself.  The values are kept
+ * per node as well, so that they can be forgotten once the attributes
+ * of the node have changed.
+ */
+void
+XMLIdIndex::add (XMLNode& node)
+{
+  remove(node);
+
+  if (!node.isStart()) return;
+
+  vector<string> values;
+
+  for (size_t n = 0; n < mAttributes.size(); ++n)
+  {
+    int index = node.getAttrIndex(mAttributes[n]);
+    if (index == -1) continue;
+
+    values.push_back(node.getAttrValue(index));
+    insert(values.back(), &node);
+  }
+
+  if (!values.empty()) mValues[&node].swap(values);
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Forgets the identifier values recorded for node itself.
+ */
+void
+XMLIdIndex::remove (const XMLNode& node)
+{
+  ValueMap::iterator it = mValues.find(&node);
+  if (it == mValues.end()) return;
+
+  for (size_t n = 0; n < it->second.size(); ++n)
+  {
+    erase(it->second[n], &node);
+  }
+
+  mValues.erase(it);
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Removes all entries, keeping the attribute names.
+ */
+void
+XMLIdIndex::clearEntries ()
+{
+  mBuckets.clear();
+  mNumEntries = 0;
+  mValues.clear();
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Adds a (value, node) entry, growing the table to keep buckets short.
+ */
+void
+XMLIdIndex::insert (const std::string& value, XMLNode* node)
+{
+  if (mNumEntries + 1 > mBuckets.size()) grow();
+
+  Entry entry;
+  entry.hash  = XMLNameIndex::hash(value);
+  entry.value = value;
+  entry.node  = node;
+
+  mBuckets[entry.hash & (mBuckets.size() - 1)].push_back(entry);
+  ++mNumEntries;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Removes the (value, node) entry, if present.
+ */
+void
+XMLIdIndex::erase (const std::string& value, const XMLNode* node)
+{
+  if (mBuckets.empty()) return;
+
+  size_t  hash   = XMLNameIndex::hash(value);
+  Bucket& bucket = mBuckets[hash & (mBuckets.size() - 1)];
+
+  for (Bucket::iterator it = bucket.begin(); it != bucket.end(); ++it)
+  {
+    if (it->node == node && it->hash == hash && it->value == value)
+    {
+      bucket.erase(it);
+      --mNumEntries;
+      return;
+    }
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Doubles the number of buckets.  Entries keep their relative order
+ * within a bucket, so the first element indexed under a value is still
+ * the one getNode() returns.
+ */
+void
+XMLIdIndex::grow ()
+{
+  size_t capacity = mBuckets.empty() ? 16 : 2 * mBuckets.size();
+
+  vector<Bucket> buckets(capacity);
+  for (size_t b = 0; b < mBuckets.size(); ++b)
+  {
+    for (Bucket::iterator it = mBuckets[b].begin(); it != mBuckets[b].end(); ++it)
+    {
+      buckets[it->hash & (capacity - 1)].push_back(*it);
+    }
+  }
+
+  mBuckets.swap(buckets);
+}
+/** @endcond */
+
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,214 @@
+/**
+ * @file    XMLIdIndex.h
+ * @brief   Index of the elements of an XMLNode tree by identifier
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ *
+ * @class XMLIdIndex
+ * @sbmlbrief{core} Maps identifier attribute values to the XMLNode
+ * elements that carry them.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * Resolving a reference such as <code>species="S1"</code> in an XMLNode
+ * tree otherwise means walking the whole tree.  The root of a tree can
+ * instead own an XMLIdIndex, set up with XMLNode::addIdAttribute() or by
+ * reading the tree with an XMLNode constructor that takes a list of
+ * identifier attribute names.  The index records, for every element in
+ * the tree, the value of each of those attributes, and is kept up to date
+ * as subtrees are added with XMLNode::addChild() or
+ * XMLNode::insertChild() and taken out with XMLNode::removeChild().
+ * Looking up a value is then a hash lookup:
+ * @code{.cpp}
+XMLNode* species = root.getNodeById("S1");
+ * @endcode
+ *
+ * Identifier attributes are matched by local name, in any namespace, as
+ * XMLToken::getAttrValue(const std::string&, const std::string&) does
+ * with an empty URI.  An element whose attributes change while it is in
+ * the tree is indexed again under its new values.  If several elements
+ * carry the same value, getNode() returns the one that was indexed first.
+ */
+
+#ifndef XMLIdIndex_h
+#define XMLIdIndex_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+#include <map>
+#include <string>
+#include <vector>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLNode;
+
+
+class LIBLX_EXTERN XMLIdIndex
+{
+public:
+
+  /**
+   * Creates a new, empty XMLIdIndex that indexes no attributes.
+   */
+  XMLIdIndex ();
+
+
+  /**
+   * Returns the number of attribute names this index records.
+   *
+   * @return the number of identifier attributes.
+   */
+  unsigned int getNumAttributes () const;
+
+
+  /**
+   * Returns the name of the <code>n</code>th identifier attribute.
+   *
+   * @param n an unsigned integer, the index of the attribute name.
+   *
+   * @return the attribute name, or an empty string if @p n is out of
+   * range.
+   */
+  std::string getAttribute (unsigned int n) const;
+
+
+  /**
+   * Predicate returning @c true if this index records the given
+   * attribute.
+   *
+   * @param name the local name of an attribute.
+   *
+   * @return @c true if @p name is an identifier attribute.
+   */
+  bool hasAttribute (const std::string& name) const;
+
+
+  /**
+   * Returns the element whose identifier attribute has the given value.
+   *
+   * @param value the value to look up.
+   *
+   * @return the element, or @c NULL if no element in the tree carries
+   * @p value.
+   */
+  XMLNode* getNode (const std::string& value) const;
+
+
+  /**
+   * Returns the number of (value, element) entries in this index.
+   *
+   * @return the number of entries.
+   */
+  unsigned int getNumEntries () const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+  /**
+   * Adds an attribute name to record.  Elements already in the index are
+   * not revisited.
+   *
+   * @return true if name was added, false if it was already recorded.
+   */
+  bool addAttribute (const std::string& name);
+
+
+  /**
+   * Records the identifier attributes of every element in the subtree
+   * rooted at node.
+   */
+  void addSubtree (XMLNode& node);
+
+
+  /**
+   * Forgets the identifier attributes of every element in the subtree
+   * rooted at node.
+   */
+  void removeSubtree (const XMLNode& node);
+
+
+  /**
+   * Records the identifier attributes of node itself, replacing the
+   * values recorded for it before.
+   */
+  void add (XMLNode& node);
+
+
+  /**
+   * Forgets the identifier values recorded for node itself, whatever its
+   * attributes are now.
+   */
+  void remove (const XMLNode& node);
+
+
+  /**
+   * Removes all entries, keeping the attribute names.
+   */
+  void clearEntries ();
+
+  /** @endcond */
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  struct Entry
+  {
+    size_t      hash;
+    std::string value;
+    XMLNode*    node;
+  };
+
+  typedef std::vector<Entry> Bucket;
+
+  void insert (const std::string& value, XMLNode* node);
+  void erase (const std::string& value, const XMLNode* node);
+  void grow ();
+
+  typedef std::map<const XMLNode*, std::vector<std::string> > ValueMap;
+
+  std::vector<std::string> mAttributes;
+  std::vector<Bucket>      mBuckets;
+  unsigned int             mNumEntries;
+  ValueMap                 mValues;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* XMLIdIndex_h */
@@ -64,6 +64,10 @@ XMLInputStream::XMLInputStream (  const char*   content
    mIsError ( false )
  , mParser  ( XMLParser::create( mTokenizer, library) )
  , mXMLns  ( NULL )
+ , mTapePosition( 0 )
+ , mMarkPosition( 0 )
+ , mRecording   ( false )
+ , mReplayPeeked( false )
 {
   // if the content points to nothing throw an exception ??
   //if (content == NULL)
@@ -83,6 +87,10 @@ XMLInputStream::XMLInputStream (  const char*   content
    : mIsError(true)   
    , mParser(NULL)
    , mXMLns(NULL)
+   , mTapePosition(0)
+   , mMarkPosition(0)
+   , mRecording(false)
+   , mReplayPeeked(false)
  {
  }
 
@@ -156,7 +164,7 @@ XMLInputStream::getErrorLog ()
 bool
 XMLInputStream::isEOF () const
 {
-  return mTokenizer.isEOF();
+  return mTapePosition >= mTape.size() && mTokenizer.isEOF();
 }
 
 
@@ -189,8 +197,48 @@ XMLInputStream::isGood () const
 XMLToken
 XMLInputStream::next ()
 {
+  if ( isReplaying() )
+  {
+    XMLToken token( peek() );
+    skipNext();
+    return token;
+  }
+
+  queueToken();
+  if ( !mTokenizer.hasNext() ) return XMLToken();
+
+  record();
+  return mTokenizer.next();
+}
+
+
+/*
+ * Consumes the next XMLToken and returns a view of it that remains valid
+ * until the next call to nextView().
+ *
+ * @return the next XMLToken or EOF (XMLToken.isEOF() == true).
+ */
+const XMLToken&
+XMLInputStream::nextView ()
+{
+  if ( isReplaying() )
+  {
+    if (mReplayPeeked)
+      mReplayView.swap(mReplayPeek);
+    else
+      mTape.get(mTapePosition, mReplayView);
+
+    ++mTapePosition;
+    mReplayPeeked = false;
+
+    return mReplayView;
+  }
+
   queueToken();
-  return mTokenizer.hasNext() ? mTokenizer.next() : XMLToken();
+  if ( !mTokenizer.hasNext() ) return mEOF;
+
+  record();
+  return mTokenizer.nextView();
 }
 
 
@@ -203,11 +251,217 @@ XMLInputStream::next ()
 const XMLToken&
 XMLInputStream::peek ()
 {
+  if ( isReplaying() )
+  {
+    if (!mReplayPeeked)
+    {
+      mTape.get(mTapePosition, mReplayPeek);
+      mReplayPeeked = true;
+    }
+
+    return mReplayPeek;
+  }
+
   queueToken();
   return mTokenizer.hasNext() ? mTokenizer.peek() : mEOF;
 }
 
 
+/*
+ * Starts recording the tokens read from this stream, so that reading can
+ * later go back to this point with rewind().
+ */
+int
+XMLInputStream::mark ()
+{
+  if ( isReplaying() )
+  {
+    // the tape beyond this point is still to be read
+    mMarkPosition = mTapePosition;
+  }
+  else
+  {
+    mTape.clear();
+    mTapePosition = 0;
+    mMarkPosition = 0;
+  }
+
+  mRecording = true;
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * Goes back to the last mark().
+ */
+int
+XMLInputStream::rewind ()
+{
+  if (!mRecording) return LIBLX_INVALID_XML_OPERATION;
+
+  mTapePosition = mMarkPosition;
+  mReplayPeeked = false;
+
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * Stops recording.  Tokens that are still to be replayed are read first.
+ */
+int
+XMLInputStream::unmark ()
+{
+  mRecording = false;
+  isReplaying();
+
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return true if mark() has been called and unmark() has not.
+ */
+bool
+XMLInputStream::isMarked () const
+{
+  return mRecording;
+}
+
+
+/*
+ * Limits how much of the document is read.
+ */
+int
+XMLInputStream::setReadLimit (unsigned int depth, unsigned int elements)
+{
+  mTokenizer.setReadLimit(depth, elements);
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * Sets a condition that decides where reading ends.
+ */
+int
+XMLInputStream::setStopCondition (XMLStopCondition* condition)
+{
+  mTokenizer.setStopCondition(condition);
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the XMLStopCondition set on this stream, or NULL.
+ */
+XMLStopCondition*
+XMLInputStream::getStopCondition () const
+{
+  return mTokenizer.getStopCondition();
+}
+
+
+/*
+ * Stops reading the document and closes the input.
+ */
+int
+XMLInputStream::close ()
+{
+  while ( mTokenizer.hasNext() ) mTokenizer.popFront();
+
+  if ( !mTokenizer.isStopped() )
+  {
+    mTokenizer.stop(true);
+    if (mParser != NULL) mParser->parseReset();
+  }
+
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the byte offset reached in the input.
+ */
+size_t
+XMLInputStream::getByteOffset () const
+{
+  return (mParser != NULL) ? mParser->getByteOffset() : 0;
+}
+
+
+/*
+ * Sets whether text that holds nothing but whitespace is dropped.
+ */
+int
+XMLInputStream::setIgnoreWhitespace (bool ignore)
+{
+  mTokenizer.setIgnoreWhitespace(ignore);
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return true if whitespace-only text is dropped.
+ */
+bool
+XMLInputStream::getIgnoreWhitespace () const
+{
+  return mTokenizer.getIgnoreWhitespace();
+}
+
+
+/*
+ * Sets whether the line and column of every element are looked up while
+ * parsing.
+ */
+int
+XMLInputStream::setTrackPositions (bool track)
+{
+  if (mParser == NULL) return LIBLX_OPERATION_FAILED;
+
+  // the line index has to start with the first chunk
+  if (mParser->getByteOffset() > 0) return LIBLX_INVALID_XML_OPERATION;
+
+  mParser->setTrackPositions(track);
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return true if the line and column of every element are looked up
+ * while parsing.
+ */
+bool
+XMLInputStream::getTrackPositions () const
+{
+  return (mParser == NULL) || mParser->getTrackPositions();
+}
+
+
+/*
+ * Returns the line and column at which a token read from this stream
+ * occurs.
+ */
+int
+XMLInputStream::getPosition (const XMLToken& token,
+                             unsigned int& line, unsigned int& column) const
+{
+  if (token.getLine() > 0 || token.getOffset() == 0)
+  {
+    line   = token.getLine();
+    column = token.getColumn();
+    return LIBLX_OPERATION_SUCCESS;
+  }
+
+  if (mParser != NULL && mParser->getPosition(token.getOffset(), line, column))
+  {
+    return LIBLX_OPERATION_SUCCESS;
+  }
+
+  return LIBLX_OPERATION_FAILED;
+}
+
+
 /*
  * Runs mParser until mTokenizer is ready to deliver at least one XMLToken
  * or a fatal error occurs.
@@ -221,7 +475,7 @@ XMLInputStream::queueToken ()
 
   while ( success && mTokenizer.hasNext() == false )
   {
-    success = mParser->parseNext();
+    success = parseNext();
   }
 
   if (success == false && isEOF() == false)
@@ -238,7 +492,7 @@ XMLInputStream::requeueToken ()
   if ( !isGood() ) return success;
   else if (this->mTokenizer.mEOFSeen == true) return success;
 
-  success = mParser->parseNext();
+  success = parseNext();
 
   if (success == false && isEOF() == false)
   {
@@ -249,6 +503,24 @@ XMLInputStream::requeueToken ()
 }
 
 
+/*
+ * Parses the next chunk, unless reading has been stopped.  Once the
+ * tokenizer stops, the parser has nothing more to do, and its input is
+ * released right away rather than when this stream is destroyed.
+ */
+bool
+XMLInputStream::parseNext ()
+{
+  if ( mTokenizer.isStopped() ) return false;
+
+  const bool success = mParser->parseNext();
+
+  if ( mTokenizer.isStopped() ) mParser->parseReset();
+
+  return success;
+}
+
+
 /*
  * Sets the XMLErrorLog this stream will use to log errors.
  */
@@ -262,17 +534,270 @@ XMLInputStream::setErrorLog (XMLErrorLog* log)
 /*
  * Consume zero or more XMLTokens up to and including the corresponding
  * end XML element or EOF.
+ *
+ * When element is one of the elements being read, its level among them
+ * gives the depth to skip: tokens that are already queued are dropped
+ * while counting it, and the rest of the subtree is skipped inside the
+ * parser, where the tokenizer only counts start and end elements, so no
+ * XMLToken, attributes or namespaces are built for it.  Any other element
+ * is skipped by looking for its end tag.
  */
 void
 XMLInputStream::skipPastEnd (const XMLToken& element)
 {
   if ( element.isEnd() ) return;
 
+  // tolerate callers that peeked at element without consuming it
+  if ( isGood() && isSameStart(peek(), element) )
+  {
+    skipNext();
+    skipToEnd();
+    return;
+  }
+
+  // tokens read back from the tape are behind the tokenizer
+  const size_t level = isReplaying() ? XMLTokenizer::npos
+                                     : mTokenizer.getReadingLevel(element);
+
+  if (level != XMLTokenizer::npos)
+  {
+    skipToEnd( static_cast<unsigned int>(level) );
+    return;
+  }
+
   while ( isGood() && !peek().isEndFor(element) ) next();
   next();
 }
 
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Consumes the rest of the element whose start was read last, and of the
+ * depth elements enclosing it, up to and including the outermost end.
+ */
+void
+XMLInputStream::skipToEnd (unsigned int depth)
+{
+  if ( mRecording || isReplaying() )
+  {
+    // the tokens have to be recorded, or they come from the tape
+    while ( isGood() )
+    {
+      const XMLToken& token = peek();
+      const bool      start = token.isStart();
+      const bool      end   = token.isEnd();
+
+      if ( token.isEOF() ) return;
+      skipNext();
+
+      if (start && !end)
+      {
+        ++depth;
+      }
+      else if (end && !start)
+      {
+        if (depth == 0) return;
+        --depth;
+      }
+    }
+
+    return;
+  }
+
+  while ( isGood() && mTokenizer.hasNext() )
+  {
+    const XMLToken& token = mTokenizer.peek();
+    const bool      start = token.isStart();
+    const bool      end   = token.isEnd();
+
+    mTokenizer.popFront();
+
+    if (start && !end)
+    {
+      ++depth;
+    }
+    else if (end && !start)
+    {
+      if (depth == 0) return;
+      --depth;
+    }
+  }
+
+  if ( !isGood() ) return;
+
+  mTokenizer.startSkipping(depth + 1);
+
+  bool success = true;
+
+  while ( success && mTokenizer.isSkipping() )
+  {
+    success = parseNext();
+  }
+
+  if (success == false && isEOF() == false)
+  {
+    mIsError = true;
+  }
+}
+
+
+/*
+ * @return true while tokens are read back from mTape.  Once they have all
+ * been read, and nothing is being recorded, the tape is emptied.
+ */
+bool
+XMLInputStream::isReplaying ()
+{
+  if (mTapePosition < mTape.size()) return true;
+
+  if (!mRecording && !mTape.empty())
+  {
+    mTape.clear();
+    mTapePosition = 0;
+    mMarkPosition = 0;
+  }
+
+  return false;
+}
+
+
+/*
+ * Appends the next queued token to mTape if recording.
+ */
+void
+XMLInputStream::record ()
+{
+  if (!mRecording) return;
+
+  mTape.append( mTokenizer.peek() );
+  ++mTapePosition;
+}
+
+
+/*
+ * Moves the next token of the document onto the end of mTape.  It is
+ * consumed from the tokenizer as if it had been read, and is replayed
+ * when the tokens before it have been.
+ */
+bool
+XMLInputStream::recordAhead ()
+{
+  queueToken();
+  if ( !mTokenizer.hasNext() ) return false;
+
+  mTape.append( mTokenizer.peek() );
+  mTokenizer.popFront();
+
+  return true;
+}
+
+
+/*
+ * Finds the end of the element being read on mTape: the first end
+ * element after the replay position that closes no element started
+ * after it.
+ */
+size_t
+XMLInputStream::replayReadingExtent ()
+{
+  unsigned int depth = 0;
+
+  for (size_t index = mTapePosition; ; ++index)
+  {
+    if (index == mTape.size() && !recordAhead()) return index;
+
+    const bool start = mTape.isStart(index);
+    const bool end   = mTape.isEnd(index);
+
+    if (start && !end)
+    {
+      ++depth;
+    }
+    else if (end && !start)
+    {
+      if (depth == 0) return index;
+      --depth;
+    }
+  }
+}
+
+
+/*
+ * Counts the children called name, or all children, of the element being
+ * replayed, up to extent.
+ */
+unsigned int
+XMLInputStream::countReplayChildren (size_t extent, const std::string& name)
+{
+  unsigned int depth       = 0;
+  unsigned int numChildren = 0;
+
+  for (size_t index = mTapePosition; index < extent; ++index)
+  {
+    const bool start = mTape.isStart(index);
+    const bool end   = mTape.isEnd(index);
+
+    if (start && depth == 0 && (name.empty() || name == mTape.getName(index)))
+    {
+      ++numChildren;
+    }
+
+    if (start && !end)
+    {
+      ++depth;
+    }
+    else if (end && !start)
+    {
+      --depth;
+    }
+  }
+
+  return numChildren;
+}
+
+
+/*
+ * Consumes the next token without handing it out.
+ */
+void
+XMLInputStream::skipNext ()
+{
+  if ( isReplaying() )
+  {
+    ++mTapePosition;
+    mReplayPeeked = false;
+    return;
+  }
+
+  queueToken();
+  if ( !mTokenizer.hasNext() ) return;
+
+  record();
+  mTokenizer.popFront();
+}
+
+
+/*
+ * @return true if token is the (unconsumed) start element element, i.e.,
+ * the same start tag at the same position in the document.
+ */
+bool
+XMLInputStream::isSameStart (const XMLToken& token, const XMLToken& element)
+{
+  if (&token == &element) return true;
+
+  return
+    token.isStart()                          &&
+    !token.isEnd()                           &&
+    token.getLine  () == element.getLine  () &&
+    token.getColumn() == element.getColumn() &&
+    token.getOffset() == element.getOffset() &&
+    token.getName  () == element.getName  () &&
+    token.getURI   () == element.getURI   ();
+}
+/** @endcond */
+
+
 /*
  * Consume zero or more XMLTokens up to but not including the next XML
  * element or EOF.
@@ -284,6 +809,69 @@ XMLInputStream::skipText ()
 }
 
 
+/*
+ * Sets the maximum number of bytes of character data per text token.
+ */
+int
+XMLInputStream::setCharacterChunkSize (unsigned int size)
+{
+  mTokenizer.setCharacterChunkSize(size);
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the maximum number of bytes of character data per text token.
+ */
+unsigned int
+XMLInputStream::getCharacterChunkSize () const
+{
+  return static_cast<unsigned int>( mTokenizer.getCharacterChunkSize() );
+}
+
+
+/*
+ * Consumes the text tokens up to the next element or EOF, handing each one
+ * to handler.
+ */
+size_t
+XMLInputStream::readCharacters (XMLHandler& handler)
+{
+  size_t total = 0;
+
+  while ( isGood() && peek().isText() )
+  {
+    const XMLToken& chunk = nextView();
+
+    total += chunk.getCharacters().size();
+    handler.characters(chunk);
+  }
+
+  return total;
+}
+
+
+/*
+ * Sets the filter that decides which elements are read.
+ */
+int
+XMLInputStream::setElementFilter (XMLElementFilter* filter)
+{
+  mTokenizer.setElementFilter(filter);
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the XMLElementFilter set on this stream, or NULL.
+ */
+XMLElementFilter*
+XMLInputStream::getElementFilter () const
+{
+  return mTokenizer.getElementFilter();
+}
+
+
 /*
  * Prints a string representation of the underlying token stream, for
  * debugging purposes.
@@ -315,23 +903,48 @@ XMLInputStream::setXMLNamespaces(XMLNamespaces * xmlns)
   }
 }
 
+/*
+ * The structural queries below need the element being read to be queued
+ * up to its end.  The tokenizer tracks the structure of the queue as it
+ * grows, so each query is answered once the end has been parsed, without
+ * rescanning the queue.  While tokens are replayed, the element being
+ * read is the one on the tape, and the queries scan the tape instead.
+ */
 unsigned int
 XMLInputStream::determineNumberChildren(const std::string elementName)
 {
   bool valid = false;
-  unsigned int num = this->mTokenizer.determineNumberChildren(valid, elementName);
 
-  bool canReQ = true;
-  while (canReQ == true && isGood() == true && valid == false)
+  if ( isReplaying() )
   {
-    canReQ = requeueToken();
-    if (canReQ == true)
+    const size_t extent      = replayReadingExtent();
+    unsigned int numChildren = countReplayChildren(extent, "");
+
+    if (elementName.empty() || elementName == "apply")
     {
-      num = this->mTokenizer.determineNumberChildren(valid, elementName);
+      // the function should be an empty element unless it is a user
+      // function (ci) or a csymbol, as in XMLTokenizer
+      size_t index = mTapePosition;
+      while (index < extent && mTape.isText(index)) ++index;
+
+      if (index == extent) return 0;
+
+      const std::string name = mTape.getName(index);
+
+      if (name != "ci" && name != "csymbol"
+          && !(mTape.isStart(index) && mTape.isEnd(index)))
+      {
+        return 0;
+      }
+
+      if (elementName.empty() && numChildren > 0) --numChildren;
     }
+
+    return numChildren;
   }
 
-  return num;
+  queueReadingElement();
+  return mTokenizer.determineNumberChildren(valid, elementName);
 }
 
 
@@ -340,20 +953,14 @@ XMLInputStream::determineNumSpecificChildren(const std::string& childName,
                                              const std::string& container)
 {
   bool valid = false;
-  unsigned int num = this->mTokenizer.determineNumSpecificChildren(valid, 
-                                                       childName, container);
 
-  while (isGood() == true && valid == false)
+  if ( isReplaying() )
   {
-    requeueToken();
-    if (isGood() == true)
-    {
-      num = this->mTokenizer.determineNumSpecificChildren(valid, 
-                                                       childName, container);
-    }
+    return countReplayChildren(replayReadingExtent(), childName);
   }
 
-  return num;
+  queueReadingElement();
+  return mTokenizer.determineNumSpecificChildren(valid, childName, container);
 }
 
 
@@ -362,23 +969,42 @@ XMLInputStream::containsChild(const std::string& childName,
                                              const std::string& container)
 {
   bool valid = false;
-  bool hasChild = this->mTokenizer.containsChild(valid, 
-                                                       childName, container);
 
-  while (isGood() == true && valid == false)
+  if ( isReplaying() )
   {
-    requeueToken();
-    if (isGood() == true)
+    const size_t extent = replayReadingExtent();
+
+    for (size_t index = mTapePosition; index < extent; ++index)
     {
-      hasChild = this->mTokenizer.containsChild(valid, 
-                                                       childName, container);
+      if (childName == mTape.getName(index)) return true;
     }
+
+    return false;
   }
 
-  return hasChild;
+  queueReadingElement();
+  return mTokenizer.containsChild(valid, childName, container);
 }
 
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Parses until the end of the element whose content is being read has
+ * been queued, or the end of the input.
+ */
+void
+XMLInputStream::queueReadingElement ()
+{
+  queueToken();
+
+  while ( isGood() && !mTokenizer.isReadingElementQueued() )
+  {
+    if ( !requeueToken() ) break;
+  }
+}
+/** @endcond */
+
+
 LIBLX_EXTERN
 XMLInputStream_t *
 XMLInputStream_create (const char* content, int isFile, const char *library)
@@ -451,6 +1077,15 @@ XMLInputStream_next (XMLInputStream_t *stream)
 }
 
 
+LIBLX_EXTERN
+const XMLToken_t *
+XMLInputStream_nextView (XMLInputStream_t *stream)
+{
+  if (stream == NULL) return NULL;
+  return &(stream->nextView());
+}
+
+
 LIBLX_EXTERN
 const XMLToken_t *
 XMLInputStream_peek (XMLInputStream_t *stream)
@@ -479,6 +1114,98 @@ XMLInputStream_skipText (XMLInputStream_t *stream)
 }
 
 
+LIBLX_EXTERN
+int
+XMLInputStream_setCharacterChunkSize (XMLInputStream_t *stream,
+                                      unsigned int size)
+{
+  if (stream == NULL) return LIBLX_INVALID_OBJECT;
+  return stream->setCharacterChunkSize(size);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLInputStream_getCharacterChunkSize (XMLInputStream_t *stream)
+{
+  if (stream == NULL) return 0;
+  return stream->getCharacterChunkSize();
+}
+
+
+LIBLX_EXTERN
+int
+XMLInputStream_mark (XMLInputStream_t *stream)
+{
+  if (stream == NULL) return LIBLX_INVALID_OBJECT;
+  return stream->mark();
+}
+
+
+LIBLX_EXTERN
+int
+XMLInputStream_rewind (XMLInputStream_t *stream)
+{
+  if (stream == NULL) return LIBLX_INVALID_OBJECT;
+  return stream->rewind();
+}
+
+
+LIBLX_EXTERN
+int
+XMLInputStream_unmark (XMLInputStream_t *stream)
+{
+  if (stream == NULL) return LIBLX_INVALID_OBJECT;
+  return stream->unmark();
+}
+
+
+LIBLX_EXTERN
+int
+XMLInputStream_setReadLimit (XMLInputStream_t *stream,
+                             unsigned int depth, unsigned int elements)
+{
+  if (stream == NULL) return LIBLX_INVALID_OBJECT;
+  return stream->setReadLimit(depth, elements);
+}
+
+
+LIBLX_EXTERN
+int
+XMLInputStream_close (XMLInputStream_t *stream)
+{
+  if (stream == NULL) return LIBLX_INVALID_OBJECT;
+  return stream->close();
+}
+
+
+LIBLX_EXTERN
+int
+XMLInputStream_setIgnoreWhitespace (XMLInputStream_t *stream, int ignore)
+{
+  if (stream == NULL) return LIBLX_INVALID_OBJECT;
+  return stream->setIgnoreWhitespace(ignore != 0);
+}
+
+
+LIBLX_EXTERN
+int
+XMLInputStream_setTrackPositions (XMLInputStream_t *stream, int track)
+{
+  if (stream == NULL) return LIBLX_INVALID_OBJECT;
+  return stream->setTrackPositions(track != 0);
+}
+
+
+LIBLX_EXTERN
+size_t
+XMLInputStream_getByteOffset (XMLInputStream_t *stream)
+{
+  if (stream == NULL) return 0;
+  return stream->getByteOffset();
+}
+
+
 LIBLX_EXTERN
 int
 XMLInputStream_setErrorLog (XMLInputStream_t *stream, XMLErrorLog_t *log)
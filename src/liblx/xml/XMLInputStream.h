@@ -119,10 +119,13 @@
 #include <string>
 
 #include <liblx/xml/XMLTokenizer.h>
+#include <liblx/xml/XMLTokenTape.h>
 
 LIBLX_CPP_NAMESPACE_BEGIN
 
 class XMLErrorLog;
+class XMLElementFilter;
+class XMLStopCondition;
 class XMLParser;
 class XMLNamespaces;
 
@@ -235,6 +238,23 @@ public:
   XMLToken next ();
 
 
+  /**
+   * Returns a view of the next token on this XML input stream.
+   *
+   * The token is consumed in the process, exactly as with next(), but it
+   * is not copied: the returned reference points into storage owned by
+   * this stream.  The reference stays valid until the next call to
+   * nextView(); callers that need to keep the token longer must copy it.
+   *
+   * @return a reference to the next XMLToken, or to an EOF token (i.e.,
+   * <code>XMLToken.isEOF() == true</code>).
+   *
+   * @see next()
+   * @see peek()
+   */
+  const XMLToken& nextView ();
+
+
   /**
    * Returns the next token @em without consuming it.
    *
@@ -251,6 +271,14 @@ public:
    * Consume zero or more tokens up to and including the corresponding end
    * element or EOF.
    *
+   * @p element may be the start element just peeked at or read from this
+   * stream, or any enclosing element of this stream whose end has not
+   * been read yet.  Its end is then found by counting nested elements,
+   * and elements inside the skipped subtree are not turned into tokens,
+   * which makes skipping large subtrees about as cheap as scanning them.
+   * For any other element, tokens are consumed up to the first end
+   * element that matches its name.
+   *
    * @param element the element whose end will be sought in the input stream.
    */
   void skipPastEnd (const XMLToken& element);
@@ -263,6 +291,312 @@ public:
   void skipText ();
 
 
+  /**
+   * Sets the maximum number of bytes of character data delivered in a
+   * single text token.
+   *
+   * By default all the character data between two pieces of markup is
+   * collected into one text token, so a very large text node is held in
+   * memory in its entirety before it can be read.  With a non-zero chunk
+   * size, such text is delivered instead as a series of consecutive text
+   * tokens of at most @p size bytes each (chunks are split on UTF-8
+   * character boundaries and may therefore be slightly shorter).
+   * Consumers can then process the text piece by piece, either by calling
+   * next() or nextView() while peek().isText(), or by calling
+   * readCharacters().
+   *
+   * @param size the maximum number of bytes per text token, or @c 0 to
+   * disable chunking.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   *
+   * @note The setting affects text that has not been parsed yet.  Note also
+   * that XMLNode objects read from a chunked stream join the chunks back
+   * into a single text node.
+   */
+  int setCharacterChunkSize (unsigned int size);
+
+
+  /**
+   * Returns the maximum number of bytes of character data delivered in a
+   * single text token.
+   *
+   * @return the chunk size, or @c 0 if character data is not chunked.
+   *
+   * @see setCharacterChunkSize(unsigned int size)
+   */
+  unsigned int getCharacterChunkSize () const;
+
+
+  /**
+   * Consumes all the text tokens up to the next XML element or EOF,
+   * passing each one to @p handler as it is read.
+   *
+   * Combined with setCharacterChunkSize(), this delivers the content of
+   * an arbitrarily large text node through XMLHandler::characters() in
+   * bounded pieces, without the whole text ever being held in memory.
+   * Each token passed to the handler is only valid for the duration of
+   * the call.
+   *
+   * @param handler the XMLHandler that receives the character data.
+   *
+   * @return the total number of bytes of character data consumed.
+   */
+  size_t readCharacters (XMLHandler& handler);
+
+
+  /**
+   * Sets whether text that holds nothing but whitespace is dropped.
+   *
+   * In an indented document, about every other token is whitespace
+   * between two tags.  With @p ignore set to @c true, the tokenizer drops
+   * such text as it arrives from the parser, before a token is queued for
+   * it, so readers neither see it nor have to skip it.  Text that holds
+   * anything else is kept whole, including its leading and trailing
+   * whitespace.  This applies to text read from now on.
+   *
+   * @param ignore @c true to drop whitespace-only text, @c false to keep
+   * it (the default).
+   *
+   * @copydetails doc_returns_one_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   *
+   * @see XMLToken::isWhitespace()
+   */
+  int setIgnoreWhitespace (bool ignore);
+
+
+  /**
+   * @return @c true if whitespace-only text is dropped, @c false
+   * otherwise.
+   */
+  bool getIgnoreWhitespace () const;
+
+
+  /**
+   * Sets the filter that decides which elements are read.
+   *
+   * Each start element the parser reaches from now on is passed to @p
+   * filter before its attributes and namespaces are read.  Elements it
+   * rejects are dropped with their whole content, inside the parser,
+   * without building any tokens.  Tokens that are already queued are not
+   * affected.  The filter is not copied or owned by this stream, and must
+   * outlive it or be removed by passing @c NULL.
+   *
+   * @param filter the XMLElementFilter to use, or @c NULL to read all
+   * elements.
+   *
+   * @copydetails doc_returns_one_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   */
+  int setElementFilter (XMLElementFilter* filter);
+
+
+  /**
+   * Marks the current position in this stream, so that reading can go
+   * back to it later with rewind().
+   *
+   * From now on, every token read from this stream is also recorded on a
+   * compact tape: the strings of all tokens are kept in a single
+   * character arena, rather than as XMLToken objects.  After rewind(),
+   * the recorded tokens are read again from the tape, without parsing
+   * the document again, and then reading continues with the rest of the
+   * document.  This allows two passes over a subtree, for instance one
+   * that sizes a container and one that fills it, without building an
+   * XMLNode tree.
+   *
+   * Calling mark() again moves the mark to the current position.  While
+   * tokens are replayed, the structural queries such as
+   * determineNumberChildren() answer about the element being replayed,
+   * from the tape, and subtrees are skipped token by token.
+   *
+   * @copydetails doc_returns_one_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   *
+   * @see rewind()
+   * @see unmark()
+   */
+  int mark ();
+
+
+  /**
+   * Goes back to the position of the last call to mark().  The next token
+   * read is the one that was next when mark() was called.
+   *
+   * The mark stays in place, so rewind() can be called any number of
+   * times.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_XML_OPERATION, OperationReturnValues_t}
+   * if no mark is set.
+   *
+   * @see mark()
+   */
+  int rewind ();
+
+
+  /**
+   * Removes the mark and stops recording tokens.  Tokens that were
+   * rewound to but not read yet are still read from the tape; after that
+   * the tape is released.
+   *
+   * @copydetails doc_returns_one_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   *
+   * @see mark()
+   */
+  int unmark ();
+
+
+  /**
+   * @return @c true if a mark is set on this stream, @c false otherwise.
+   */
+  bool isMarked () const;
+
+
+  /**
+   * @return the XMLElementFilter set on this stream, or @c NULL if all
+   * elements are read.
+   */
+  XMLElementFilter* getElementFilter () const;
+
+
+  /**
+   * Limits how much of the document is read.
+   *
+   * The stream ends before the first start element that is deeper than
+   * @p depth, or that comes after @p elements start elements have been
+   * read from now on.  Elements dropped by an XMLElementFilter do not
+   * count.  A limit of @c 0 means no limit, so setReadLimit(1) reads the
+   * document element with its attributes and namespaces, and its text,
+   * but none of its child elements.
+   *
+   * When the limit is reached, the parser is halted in the middle of the
+   * chunk it is parsing and the file, along with any decompressor reading
+   * it, is closed at once.  The tokens read up to that point can still be
+   * consumed; after them isEOF() returns @c true.  Elements that were
+   * still open have no end token.  getByteOffset() then tells how much of
+   * the input was needed.
+   *
+   * @param depth the deepest level read, @c 1 being the document element.
+   * @param elements the number of start elements read.
+   *
+   * @copydetails doc_returns_one_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   *
+   * @see setStopCondition()
+   */
+  int setReadLimit (unsigned int depth, unsigned int elements = 0);
+
+
+  /**
+   * Sets a condition that decides where reading ends.
+   *
+   * Each start element the parser reaches from now on is passed to
+   * @p condition, with its attributes and namespaces.  Once it says stop,
+   * the stream ends just before that element, exactly as with
+   * setReadLimit().  The condition is not copied or owned by this stream,
+   * and must outlive it or be removed by passing @c NULL.
+   *
+   * @param condition the XMLStopCondition to use, or @c NULL.
+   *
+   * @copydetails doc_returns_one_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   */
+  int setStopCondition (XMLStopCondition* condition);
+
+
+  /**
+   * @return the XMLStopCondition set on this stream, or @c NULL.
+   */
+  XMLStopCondition* getStopCondition () const;
+
+
+  /**
+   * Stops reading the document.
+   *
+   * The file, and any decompressor reading it, is closed, and the tokens
+   * that were parsed but not read yet are dropped.  Tokens recorded
+   * since mark() can still be read again after rewind().  Apart from
+   * those, isEOF() returns @c true from now on.
+   *
+   * @copydetails doc_returns_one_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   */
+  int close ();
+
+
+  /**
+   * Returns how far into the document this stream has read, in bytes of
+   * the uncompressed input.
+   *
+   * If reading was ended by setReadLimit() or setStopCondition(), this is
+   * the position of the start element at which it ended (Expat), or the
+   * position just after its name and attributes (libxml2).  Otherwise it
+   * is the number of bytes handed to the parser so far.  With Xerces,
+   * which reads its input itself, it is @c 0.
+   *
+   * @return the byte offset reached in the input.
+   */
+  size_t getByteOffset () const;
+
+
+  /**
+   * Sets whether the line and column of every element are looked up
+   * while parsing.
+   *
+   * Looking them up is a noticeable part of the work done for each
+   * element, and most readers never use them unless they have an error to
+   * report.  With @p track set to @c false, start and end elements only
+   * get their byte offset in the input (see XMLToken::getOffset()), and
+   * getPosition() computes their line and column when they are needed,
+   * from an index of line starts built from the input as it is read.
+   * Errors reported by the parser itself still come with line and column
+   * numbers.  Xerces cannot report byte offsets, and always looks up
+   * positions.
+   *
+   * This has to be set before the first token is read.
+   *
+   * @param track @c true to look up positions (the default), @c false to
+   * record byte offsets.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_OPERATION_FAILED, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_XML_OPERATION, OperationReturnValues_t}
+   * if reading has already started.
+   */
+  int setTrackPositions (bool track);
+
+
+  /**
+   * @return @c true if the line and column of every element are looked up
+   * while parsing, @c false if only byte offsets are recorded.
+   */
+  bool getTrackPositions () const;
+
+
+  /**
+   * Returns the line and column at which a token read from this stream
+   * occurs, computing them from its byte offset if positions are not
+   * tracked.  Columns computed this way are counted in bytes.
+   *
+   * @param token the XMLToken, read from this stream.
+   * @param line set to the line of @p token.
+   * @param column set to the column of @p token.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_OPERATION_FAILED, OperationReturnValues_t}
+   */
+  int getPosition (const XMLToken& token,
+                   unsigned int& line, unsigned int& column) const;
+
+
   /**
    * Sets the XMLErrorLog this stream will use to log errors.
    *
@@ -414,6 +748,78 @@ protected:
   bool requeueToken ();
 
 
+  /**
+   * Parses the next chunk, unless reading has been stopped.  The input is
+   * closed as soon as the tokenizer stops.
+   */
+  bool parseNext ();
+
+
+  /**
+   * @return true if token is the start element element itself, not yet
+   * consumed.
+   */
+  static bool isSameStart (const XMLToken& token, const XMLToken& element);
+
+
+  /**
+   * Consumes the rest of the element whose start was read last, and of
+   * the depth elements enclosing it, up to and including the outermost
+   * end.
+   */
+  void skipToEnd (unsigned int depth = 0);
+
+
+  /**
+   * Parses until the end of the element being read has been queued.
+   */
+  void queueReadingElement ();
+
+
+  /**
+   * @return true while tokens are read back from mTape.
+   */
+  bool isReplaying ();
+
+
+  /**
+   * Appends the next queued token to mTape if a mark is set.
+   */
+  void record ();
+
+
+  /**
+   * Moves the next token of the document onto the end of mTape, to be
+   * replayed in turn.
+   *
+   * @return false at the end of the document.
+   */
+  bool recordAhead ();
+
+
+  /**
+   * While tokens are replayed, finds the end of the element being read
+   * on mTape, moving tokens of the document onto it as needed.
+   *
+   * @return the index of the end on mTape, or the size of mTape if the
+   * document ends first.
+   */
+  size_t replayReadingExtent ();
+
+
+  /**
+   * @return the number of children called name (or of all children, if
+   * name is empty) on mTape between the replay position and extent.
+   */
+  unsigned int countReplayChildren (size_t extent, const std::string& name);
+
+
+  /**
+   * Consumes the next token without handing it out.
+   */
+  void skipNext ();
+
+
   bool mIsError;
 
   XMLToken     mEOF;
@@ -422,6 +828,21 @@ protected:
 
   XMLNamespaces* mXMLns;
 
+  /*
+   * Tokens read since mark().  mTapePosition is the position of the next
+   * token to read; it is at the end of the tape unless rewind() moved it
+   * back to mMarkPosition.
+   */
+  XMLTokenTape mTape;
+  size_t       mTapePosition;
+  size_t       mMarkPosition;
+  bool         mRecording;
+  bool         mReplayPeeked;
+  XMLToken     mReplayPeek;
+  XMLToken     mReplayView;
+
+  friend class XMLPathMatcher;
+
   /** @endcond */
 };
 
@@ -568,6 +989,26 @@ XMLToken_t *
 XMLInputStream_next (XMLInputStream_t *stream);
 
 
+/**
+ * Returns a view of the next token in the given stream.
+ *
+ * The token is consumed in the process.  The returned structure is owned
+ * by the stream and remains valid until the next call to
+ * XMLInputStream_nextView(); it must not be freed by the caller.
+ *
+ * @param stream the XMLInputStream_t structure to examine.
+ *
+ * @return the token, as an XMLToken_t structure.
+ *
+ * @see XMLInputStream_next()
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+const XMLToken_t *
+XMLInputStream_nextView (XMLInputStream_t *stream);
+
+
 /**
  * Returns the next token @em without consuming it.
  *
@@ -591,6 +1032,11 @@ XMLInputStream_peek (XMLInputStream_t *stream);
  * Consume zero or more tokens up to and including the corresponding end
  * element or EOF.
  *
+ * If @p element is the start element just peeked at or read from the
+ * stream, or any enclosing element of the stream whose end has not been
+ * read yet, its end is found by counting nested elements; otherwise
+ * tokens are consumed up to the first end element that matches its name.
+ *
  * @param stream the XMLInputStream_t to act on.
  *
  * @param element the element whose end will be sought in the input stream.
@@ -616,6 +1062,184 @@ void
 XMLInputStream_skipText (XMLInputStream_t *stream);
 
 
+/**
+ * Sets the maximum number of bytes of character data delivered in a
+ * single text token; @c 0 disables chunking.
+ *
+ * @param stream XMLInputStream_t structure to act on.
+ *
+ * @param size the maximum number of bytes per text token.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+int
+XMLInputStream_setCharacterChunkSize (XMLInputStream_t *stream,
+                                      unsigned int size);
+
+
+/**
+ * Returns the maximum number of bytes of character data delivered in a
+ * single text token.
+ *
+ * @param stream XMLInputStream_t structure to be queried.
+ *
+ * @return the chunk size, or @c 0 if character data is not chunked or
+ * @p stream is @c NULL.
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLInputStream_getCharacterChunkSize (XMLInputStream_t *stream);
+
+
+/**
+ * Marks the current position in the stream, so that reading can go back
+ * to it with XMLInputStream_rewind().
+ *
+ * @param stream XMLInputStream_t structure to act on.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+int
+XMLInputStream_mark (XMLInputStream_t *stream);
+
+
+/**
+ * Goes back to the position of the last XMLInputStream_mark().
+ *
+ * @param stream XMLInputStream_t structure to act on.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_XML_OPERATION, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+int
+XMLInputStream_rewind (XMLInputStream_t *stream);
+
+
+/**
+ * Removes the mark set by XMLInputStream_mark().
+ *
+ * @param stream XMLInputStream_t structure to act on.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+int
+XMLInputStream_unmark (XMLInputStream_t *stream);
+
+
+/**
+ * Limits how much of the document is read: the stream ends before the
+ * first start element deeper than @p depth, or after @p elements start
+ * elements.  A limit of @c 0 means no limit.
+ *
+ * @param stream XMLInputStream_t structure to act on.
+ * @param depth the deepest level read, @c 1 being the document element.
+ * @param elements the number of start elements read.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+int
+XMLInputStream_setReadLimit (XMLInputStream_t *stream,
+                             unsigned int depth, unsigned int elements);
+
+
+/**
+ * Stops reading the document and closes the input.
+ *
+ * @param stream XMLInputStream_t structure to act on.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+int
+XMLInputStream_close (XMLInputStream_t *stream);
+
+
+/**
+ * Sets whether text that holds nothing but whitespace is dropped.
+ *
+ * @param stream XMLInputStream_t structure to act on.
+ * @param ignore nonzero to drop whitespace-only text, zero to keep it.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+int
+XMLInputStream_setIgnoreWhitespace (XMLInputStream_t *stream, int ignore);
+
+
+/**
+ * Sets whether the line and column of every element are looked up while
+ * parsing, or only their byte offset.  This has to be set before the
+ * first token is read.
+ *
+ * @param stream XMLInputStream_t structure to act on.
+ * @param track nonzero to look up positions (the default), zero to
+ * record byte offsets.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_OPERATION_FAILED, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_XML_OPERATION, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+int
+XMLInputStream_setTrackPositions (XMLInputStream_t *stream, int track);
+
+
+/**
+ * Returns how far into the document the stream has read, in bytes of the
+ * uncompressed input.
+ *
+ * @param stream the XMLInputStream_t structure to examine.
+ *
+ * @return the byte offset reached in the input, or @c 0 if @p stream
+ * is @c NULL.
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+size_t
+XMLInputStream_getByteOffset (XMLInputStream_t *stream);
+
+
 /**
  * Sets the XMLErrorLog this stream will use to log errors.
  *
@@ -0,0 +1,412 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLLocationPath.cpp
+ * @brief   Compiled location path shared by XMLPathMatcher and XMLNodeQuery
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ */
+
+#include <cctype>
+
+#include <liblx/xml/XMLAttributes.h>
+#include <liblx/xml/XMLLocationPath.h>
+#include <liblx/xml/XMLNamespaces.h>
+#include <liblx/xml/XMLToken.h>
+
+using namespace std;
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+/*
+ * Creates a new XMLLocationPath without any steps.
+ */
+XMLLocationPath::XMLLocationPath () :
+   mSource          ()
+ , mSteps           ()
+ , mAttribute       ()
+ , mSelectsAttribute( false )
+{
+}
+
+
+/*
+ * Compiles source, replacing what this path held.
+ */
+bool
+XMLLocationPath::compile (const std::string& source,
+                          const XMLNamespaces* namespaces)
+{
+  const size_t length = source.size();
+  size_t       pos    = 0;
+
+  clear();
+
+  if (length == 0 || source[0] != '/') return false;
+
+  vector<Step> steps;
+  NameTest     attribute;
+  bool         selectsAttribute = false;
+
+  while (pos < length)
+  {
+    if (source[pos] != '/') return false;
+    ++pos;
+
+    bool descendant = false;
+
+    if (pos < length && source[pos] == '/')
+    {
+      descendant = true;
+      ++pos;
+    }
+
+    if (pos < length && source[pos] == '@')
+    {
+      ++pos;
+
+      if (!compileNameTest(source, pos, namespaces, attribute)) return false;
+      if (pos != length) return false;
+
+      if (descendant)
+      {
+        Step any;
+        any.descendant = true;
+        any.positional = false;
+        steps.push_back(any);
+      }
+
+      selectsAttribute = true;
+      break;
+    }
+
+    Step step;
+    step.descendant = descendant;
+    step.positional = false;
+
+    if (!compileNameTest(source, pos, namespaces, step.test)) return false;
+
+    while (pos < length && source[pos] == '[')
+    {
+      Predicate predicate;
+
+      if (++pos >= length) return false;
+
+      if (isdigit(static_cast<unsigned char>(source[pos])))
+      {
+        if (step.positional) return false;
+
+        while (pos < length && isdigit(static_cast<unsigned char>(source[pos])))
+        {
+          predicate.position = 10 * predicate.position + (source[pos++] - '0');
+        }
+
+        if (predicate.position == 0) return false;
+        step.positional = true;
+      }
+      else
+      {
+        if (source[pos] != '@') return false;
+        ++pos;
+
+        if (!compileNameTest(source, pos, namespaces, predicate.attribute))
+          return false;
+
+        if (pos < length && source[pos] == '=')
+        {
+          if (++pos >= length) return false;
+
+          const char quote = source[pos];
+          if (quote != '\'' && quote != '"') return false;
+
+          const size_t close = source.find(quote, ++pos);
+          if (close == string::npos) return false;
+
+          predicate.value.assign(source, pos, close - pos);
+          predicate.hasValue = true;
+          pos = close + 1;
+        }
+      }
+
+      if (pos >= length || source[pos] != ']') return false;
+      ++pos;
+
+      step.predicates.push_back(predicate);
+    }
+
+    steps.push_back(step);
+  }
+
+  if (steps.empty()) return false;
+
+  mSource           = source;
+  mAttribute        = attribute;
+  mSelectsAttribute = selectsAttribute;
+  mSteps.swap(steps);
+
+  return true;
+}
+
+
+/*
+ * Removes the steps and the source of this path.
+ */
+void
+XMLLocationPath::clear ()
+{
+  mSource.clear();
+  mSteps.clear();
+  mAttribute        = NameTest();
+  mSelectsAttribute = false;
+}
+
+
+/*
+ * @return true if this path holds compiled steps.
+ */
+bool
+XMLLocationPath::isCompiled () const
+{
+  return !mSteps.empty();
+}
+
+
+/*
+ * @return the text this path was compiled from.
+ */
+const std::string&
+XMLLocationPath::getSource () const
+{
+  return mSource;
+}
+
+
+/*
+ * @return the number of element steps of this path.
+ */
+size_t
+XMLLocationPath::getNumSteps () const
+{
+  return mSteps.size();
+}
+
+
+/*
+ * @return the nth element step of this path.
+ */
+const XMLLocationPath::Step&
+XMLLocationPath::getStep (size_t n) const
+{
+  return mSteps[n];
+}
+
+
+/*
+ * @return true if the path ends with an attribute step.
+ */
+bool
+XMLLocationPath::selectsAttribute () const
+{
+  return mSelectsAttribute;
+}
+
+
+/*
+ * @return the name test of the final attribute step.
+ */
+const XMLLocationPath::NameTest&
+XMLLocationPath::getAttribute () const
+{
+  return mAttribute;
+}
+
+
+/*
+ * @return true if c may be part of a name in a path.
+ */
+static bool
+isNameChar (char c)
+{
+  switch (c)
+  {
+  case '/': case '[': case ']': case '@': case '=':
+  case '\'': case '"': case ':': case '*':
+    return false;
+  default:
+    return !isspace(static_cast<unsigned char>(c));
+  }
+}
+
+
+/*
+ * Compiles the name test at pos, which is left after it.
+ */
+bool
+XMLLocationPath::compileNameTest (const std::string& source, size_t& pos,
+                                  const XMLNamespaces* namespaces,
+                                  NameTest& test)
+{
+  const size_t length = source.size();
+
+  test = NameTest();
+
+  if (pos < length && source[pos] == '*')
+  {
+    ++pos;
+    return true;
+  }
+
+  size_t start = pos;
+  while (pos < length && isNameChar(source[pos])) ++pos;
+
+  if (pos == start) return false;
+
+  if (pos < length && source[pos] == ':')
+  {
+    test.prefix.assign(source, start, pos - start);
+
+    if (namespaces != NULL && namespaces->hasPrefix(test.prefix))
+    {
+      test.uri   = namespaces->getURI(test.prefix);
+      test.byURI = true;
+    }
+
+    if (++pos < length && source[pos] == '*')
+    {
+      ++pos;
+      return true;
+    }
+
+    start = pos;
+    while (pos < length && isNameChar(source[pos])) ++pos;
+
+    if (pos == start) return false;
+  }
+
+  test.name.assign(source, start, pos - start);
+  return true;
+}
+
+
+/*
+ * @return true if the name test accepts the given local name, prefix and
+ * namespace URI.
+ */
+bool
+XMLLocationPath::matches (const NameTest& test, const std::string& name,
+                          const std::string& prefix, const std::string& uri)
+{
+  if (!test.name.empty() && test.name != name) return false;
+
+  if (test.byURI) return test.uri == uri;
+
+  return test.prefix.empty() || test.prefix == prefix;
+}
+
+
+/*
+ * @return true if attributes satisfy the attribute predicate.
+ *
+ * A plain name is first looked up with XMLAttributes::getIndex(), which
+ * is hashed on wide elements; only if the attribute found has another
+ * value are the attributes scanned for a later one with the same local
+ * name and another prefix.
+ */
+bool
+XMLLocationPath::matches (const Predicate& predicate,
+                          const XMLAttributes& attributes)
+{
+  const NameTest& test = predicate.attribute;
+
+  if (!test.name.empty() && (test.byURI || test.prefix.empty()))
+  {
+    int index = test.byURI ? attributes.getIndex(test.name, test.uri)
+                           : attributes.getIndex(test.name);
+
+    if (index == -1) return false;
+
+    if (!predicate.hasValue || attributes.getValue(index) == predicate.value)
+      return true;
+
+    if (test.byURI) return false;
+  }
+
+  const int length = attributes.getLength();
+
+  for (int n = 0; n < length; ++n)
+  {
+    if (matches(test, attributes.getName(n), attributes.getPrefix(n),
+                attributes.getURI(n))
+        && (!predicate.hasValue || attributes.getValue(n) == predicate.value))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+/*
+ * @return true if element passes the name test and predicates of step.
+ */
+bool
+XMLLocationPath::matches (const Step& step, const XMLToken& element,
+                          unsigned int& count)
+{
+  if (!matches(step.test, element.getName(), element.getPrefix(),
+               element.getURI()))
+  {
+    return false;
+  }
+
+  for (size_t p = 0; p < step.predicates.size(); ++p)
+  {
+    const Predicate& predicate = step.predicates[p];
+
+    if (predicate.position > 0)
+    {
+      if (++count != predicate.position) return false;
+    }
+    else if (!matches(predicate, element.getAttributes()))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+LIBLX_CPP_NAMESPACE_END
+/** @endcond */
@@ -0,0 +1,226 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLLocationPath.h
+ * @brief   Compiled location path shared by XMLPathMatcher and XMLNodeQuery
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLLocationPath
+ * @sbmlbrief{core} A location path compiled into steps.
+ *
+ * XMLPathMatcher matches paths against a token stream and XMLNodeQuery
+ * against an XMLNode tree, but both accept the same subset of XPath,
+ * compiled here:
+ * <ul>
+ * <li> Each path starts with @c / (child) or @c // (descendant), and
+ * steps are separated by @c / or @c //.
+ * <li> A step is an element name, optionally with a prefix
+ * (<code>math:apply</code>), @c * for any element, or
+ * <code>prefix:*</code> for any element with that prefix.  A name
+ * without a prefix matches elements in any namespace.  A prefix that is
+ * bound in the XMLNamespaces passed to compile() matches elements in
+ * the namespace it is bound to, whatever their own prefix; any other
+ * prefix is compared with the prefix of the element.
+ * <li> A step may have predicates on attributes, named like elements:
+ * <code>[@@id]</code> requires the attribute to be present,
+ * <code>[@@id='value']</code> (or with double quotes) requires it to have
+ * the given value.
+ * <li> A step may have one position predicate <code>[n]</code>, which
+ * keeps the <code>n</code>th element (counting from 1) among the children
+ * of the same parent that pass the name test and the predicates before
+ * it.
+ * <li> The last step may be <code>@@name</code> or <code>@@*</code>, in
+ * which case the path selects attributes rather than elements.
+ * </ul>
+ *
+ * The matching of names, predicates and steps is shared as well; only
+ * the walk over the document differs between the two.
+ */
+
+#ifndef XMLLocationPath_h
+#define XMLLocationPath_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLAttributes;
+class XMLNamespaces;
+class XMLToken;
+
+
+class LIBLX_EXTERN XMLLocationPath
+{
+public:
+
+  /*
+   * A name test: a local name (empty for any name) and a prefix, or a
+   * namespace URI if byURI is true.
+   */
+  struct NameTest
+  {
+    std::string name;
+    std::string prefix;
+    std::string uri;
+    bool        byURI;
+
+    NameTest () : byURI(false) { }
+  };
+
+  /* An attribute predicate, or a position predicate if position > 0. */
+  struct Predicate
+  {
+    NameTest     attribute;
+    std::string  value;
+    bool         hasValue;
+    unsigned int position;
+
+    Predicate () : hasValue(false), position(0) { }
+  };
+
+  struct Step
+  {
+    NameTest               test;
+    std::vector<Predicate> predicates;
+    bool                   descendant;
+    bool                   positional;
+  };
+
+
+  /**
+   * Creates a new XMLLocationPath without any steps.
+   */
+  XMLLocationPath ();
+
+
+  /**
+   * Compiles source, replacing what this path held.  Prefixes bound in
+   * namespaces, if it is not NULL, select by namespace URI.
+   *
+   * @return true if source is a supported location path; otherwise this
+   * path is left without any steps.
+   */
+  bool compile (const std::string& source,
+                const XMLNamespaces* namespaces = NULL);
+
+
+  /**
+   * Removes the steps and the source of this path.
+   */
+  void clear ();
+
+
+  /**
+   * @return true if this path holds compiled steps.
+   */
+  bool isCompiled () const;
+
+
+  /**
+   * @return the text this path was compiled from.
+   */
+  const std::string& getSource () const;
+
+
+  /**
+   * @return the number of element steps of this path.
+   */
+  size_t getNumSteps () const;
+
+
+  /**
+   * @return the nth element step of this path.
+   */
+  const Step& getStep (size_t n) const;
+
+
+  /**
+   * @return true if the path ends with an attribute step, whose name test
+   * is then getAttribute().
+   */
+  bool selectsAttribute () const;
+
+
+  /**
+   * @return the name test of the final attribute step.
+   */
+  const NameTest& getAttribute () const;
+
+
+  /**
+   * @return true if the name test accepts the given local name, prefix
+   * and namespace URI.
+   */
+  static bool matches (const NameTest& test, const std::string& name,
+                       const std::string& prefix, const std::string& uri);
+
+
+  /**
+   * @return true if attributes satisfy the attribute predicate.
+   */
+  static bool matches (const Predicate& predicate,
+                       const XMLAttributes& attributes);
+
+
+  /**
+   * @return true if element passes the name test and predicates of step.
+   * count is the number of earlier children of the same parent that
+   * passed the predicates before the position predicate, and is updated.
+   */
+  static bool matches (const Step& step, const XMLToken& element,
+                       unsigned int& count);
+
+
+private:
+
+  static bool compileNameTest (const std::string& source, size_t& pos,
+                               const XMLNamespaces* namespaces,
+                               NameTest& test);
+
+  std::string       mSource;
+  std::vector<Step> mSteps;
+  NameTest          mAttribute;
+  bool              mSelectsAttribute;
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+#endif  /* XMLLocationPath_h */
+/** @endcond */
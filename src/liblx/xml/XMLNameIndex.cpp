@@ -0,0 +1,205 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLNameIndex.cpp
+ * @brief   Hashed index of the names in an attribute or namespace list
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ */
+
+#include <algorithm>
+
+#include <liblx/xml/XMLNameIndex.h>
+
+using namespace std;
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+const unsigned int XMLNameIndex::Threshold;
+
+
+/*
+ * Creates a new, empty index.
+ */
+XMLNameIndex::XMLNameIndex () :
+   mSlots()
+ , mSize ( 0 )
+{
+}
+
+
+/*
+ * Removes all positions from this index.
+ */
+void
+XMLNameIndex::clear ()
+{
+  mSlots.clear();
+  mSize = 0;
+}
+
+
+/*
+ * @return true if this index holds any positions.
+ */
+bool
+XMLNameIndex::isBuilt () const
+{
+  return mSize > 0;
+}
+
+
+/*
+ * @return the number of positions in this index.
+ */
+size_t
+XMLNameIndex::size () const
+{
+  return mSize;
+}
+
+
+/*
+ * Adds the next position under the given key hash.  The table is kept at
+ * most half full, so probe sequences stay short.
+ */
+void
+XMLNameIndex::insert (size_t hash)
+{
+  if (2 * (mSize + 1) > mSlots.size()) grow();
+
+  size_t mask = mSlots.size() - 1;
+  size_t slot = hash & mask;
+
+  while (mSlots[slot].index != -1)
+  {
+    slot = (slot + 1) & mask;
+  }
+
+  mSlots[slot].hash  = hash;
+  mSlots[slot].index = static_cast<int>(mSize);
+  ++mSize;
+}
+
+
+/*
+ * @return the slot at which to start probing for the given key hash.
+ */
+size_t
+XMLNameIndex::start (size_t hash) const
+{
+  return mSlots.empty() ? 0 : hash & (mSlots.size() - 1);
+}
+
+
+/*
+ * Returns the next position stored under the given key hash.
+ */
+int
+XMLNameIndex::next (size_t& slot, size_t hash) const
+{
+  if (mSlots.empty()) return -1;
+
+  size_t mask = mSlots.size() - 1;
+
+  while (mSlots[slot].index != -1)
+  {
+    const Slot& current = mSlots[slot];
+    slot = (slot + 1) & mask;
+
+    if (current.hash == hash) return current.index;
+  }
+
+  return -1;
+}
+
+
+/*
+ * @return the FNV-1a hash of the given key.
+ */
+size_t
+XMLNameIndex::hash (const std::string& key)
+{
+  size_t hash = static_cast<size_t>(2166136261u);
+
+  for (string::const_iterator it = key.begin(); it != key.end(); ++it)
+  {
+    hash ^= static_cast<unsigned char>(*it);
+    hash *= static_cast<size_t>(16777619u);
+  }
+
+  return hash;
+}
+
+
+/*
+ * Exchanges the contents of this index with those of other.
+ */
+void
+XMLNameIndex::swap (XMLNameIndex& other)
+{
+  mSlots.swap(other.mSlots);
+  std::swap(mSize, other.mSize);
+}
+
+
+/*
+ * Doubles the table and reinserts the positions in increasing order, so
+ * that equal keys are still met in list order when probing.
+ */
+void
+XMLNameIndex::grow ()
+{
+  size_t capacity = mSlots.empty() ? 2 * Threshold : 2 * mSlots.size();
+
+  vector<Slot> old(mSize);
+  for (size_t n = 0; n < mSlots.size(); ++n)
+  {
+    if (mSlots[n].index != -1) old[(size_t)mSlots[n].index] = mSlots[n];
+  }
+
+  Slot empty;
+  empty.hash  = 0;
+  empty.index = -1;
+  mSlots.assign(capacity, empty);
+  mSize = 0;
+
+  for (size_t n = 0; n < old.size(); ++n)
+  {
+    insert(old[n].hash);
+  }
+}
+
+
+LIBLX_CPP_NAMESPACE_END
+/** @endcond */
@@ -0,0 +1,167 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLNameIndex.h
+ * @brief   Hashed index of the names in an attribute or namespace list
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLNameIndex
+ * @sbmlbrief{core} Open-addressing index from names to list positions.
+ *
+ * XMLAttributes and XMLNamespaces keep their entries in insertion order,
+ * and are usually short enough that a linear scan is the fastest way to
+ * find one.  Elements with many attributes or namespace declarations,
+ * though, make every lookup and therefore every readInto() linear in the
+ * width of the element.  Once a list reaches Threshold entries it builds
+ * an XMLNameIndex over one of its keys, and looks names up by hash.
+ *
+ * The index maps the hash of a key to the positions holding that key,
+ * using linear probing in a power-of-two table.  Positions are inserted
+ * in increasing order and never removed (a list rebuilds its index when
+ * an entry is erased), so a probe meets the positions of equal keys in
+ * list order, and the first match is the one a linear scan would find.
+ *
+ * Walking the candidates for a key looks like this:
+ * @code
+ * size_t hash = XMLNameIndex::hash(name);
+ * size_t slot = index.start(hash);
+ * int    n;
+ *
+ * while ((n = index.next(slot, hash)) != -1)
+ * {
+ *   if (names[n] == name) return n;
+ * }
+ * @endcode
+ */
+
+#ifndef XMLNameIndex_h
+#define XMLNameIndex_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+class LIBLX_EXTERN XMLNameIndex
+{
+public:
+
+  /**
+   * The number of entries at which a list starts using an index.
+   */
+  static const unsigned int Threshold = 16;
+
+
+  /**
+   * Creates a new, empty index.
+   */
+  XMLNameIndex ();
+
+
+  /**
+   * Removes all positions from this index.
+   */
+  void clear ();
+
+
+  /**
+   * @return true if this index holds any positions.
+   */
+  bool isBuilt () const;
+
+
+  /**
+   * @return the number of positions in this index.
+   */
+  size_t size () const;
+
+
+  /**
+   * Adds the next position, size(), under the given key hash.
+   */
+  void insert (size_t hash);
+
+
+  /**
+   * @return the slot at which to start probing for the given key hash.
+   */
+  size_t start (size_t hash) const;
+
+
+  /**
+   * Returns the next position stored under the given key hash, advancing
+   * slot past it.  Positions of other keys that happen to share the hash
+   * are returned too, so the caller must compare the keys.
+   *
+   * @return the next candidate position, or -1 once there are no more.
+   */
+  int next (size_t& slot, size_t hash) const;
+
+
+  /**
+   * @return the hash of the given key.
+   */
+  static size_t hash (const std::string& key);
+
+
+  /**
+   * Exchanges the contents of this index with those of other.
+   */
+  void swap (XMLNameIndex& other);
+
+
+private:
+
+  struct Slot
+  {
+    size_t hash;
+    int    index;
+  };
+
+  void grow ();
+
+  std::vector<Slot> mSlots;
+  size_t            mSize;
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+#endif  /* XMLNameIndex_h */
+/** @endcond */
@@ -0,0 +1,190 @@
+/**
+ * @file    XMLNamespaceScope.cpp
+ * @brief   The XML namespaces in scope at an element
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <liblx/xml/XMLNamespaceScope.h>
+#include <liblx/xml/XMLThreads.h>
+
+using namespace std;
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+/*
+ * Creates a frame inside parent, holding a reference to it.
+ */
+XMLNamespaceScope::XMLNamespaceScope (const XMLNamespaceScope* parent,
+                                      const XMLNamespaces& declarations) :
+   mParent      ( parent       )
+ , mDeclarations( declarations )
+ , mRefs        ( 1            )
+{
+  ref(mParent);
+}
+
+
+/*
+ * Destroys this frame and releases its parent.
+ */
+XMLNamespaceScope::~XMLNamespaceScope ()
+{
+  unref(mParent);
+}
+
+
+/*
+ * @return the declarations made by the element that opened this frame.
+ */
+const XMLNamespaces&
+XMLNamespaceScope::getDeclarations () const
+{
+  return mDeclarations;
+}
+
+
+/*
+ * @return the frame that encloses this one, or NULL.
+ */
+const XMLNamespaceScope*
+XMLNamespaceScope::getParent () const
+{
+  return mParent;
+}
+
+
+/*
+ * @return the URI bound to prefix in this scope, or an empty string.
+ */
+std::string
+XMLNamespaceScope::getURI (const std::string& prefix) const
+{
+  int                      index = -1;
+  const XMLNamespaceScope* scope = find(prefix, index);
+
+  return (scope != NULL) ? scope->mDeclarations.getURI(index) : std::string();
+}
+
+
+/*
+ * @return true if prefix is bound in this scope, false otherwise.
+ */
+bool
+XMLNamespaceScope::hasPrefix (const std::string& prefix) const
+{
+  int index = -1;
+  return (find(prefix, index) != NULL);
+}
+
+
+/*
+ * @return all the declarations in effect in this scope, innermost first.
+ */
+XMLNamespaces
+XMLNamespaceScope::getNamespacesInScope () const
+{
+  XMLNamespaces result;
+
+  for (const XMLNamespaceScope* scope = this; scope != NULL;
+       scope = scope->mParent)
+  {
+    const XMLNamespaces& declarations = scope->mDeclarations;
+
+    for (int n = 0; n < declarations.getLength(); ++n)
+    {
+      const std::string prefix = declarations.getPrefix(n);
+      if (!result.hasPrefix(prefix))
+      {
+        result.add(declarations.getURI(n), prefix);
+      }
+    }
+  }
+
+  return result;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Creates a frame for an element that declares namespaces.
+ */
+const XMLNamespaceScope*
+XMLNamespaceScope::create (const XMLNamespaceScope* parent,
+                           const XMLNamespaces& declarations)
+{
+  return new XMLNamespaceScope(parent, declarations);
+}
+
+
+/*
+ * Adds a reference to scope.
+ */
+void
+XMLNamespaceScope::ref (const XMLNamespaceScope* scope)
+{
+  if (scope != NULL) XMLThreads::add(scope->mRefs, 1);
+}
+
+
+/*
+ * Releases a reference to scope, deleting it when it is the last one.
+ */
+void
+XMLNamespaceScope::unref (const XMLNamespaceScope* scope)
+{
+  if (scope != NULL && XMLThreads::add(scope->mRefs, -1) == 0)
+  {
+    delete scope;
+  }
+}
+
+
+/*
+ * @return the frame in which prefix is declared, setting index to its
+ * position there, or NULL.
+ */
+const XMLNamespaceScope*
+XMLNamespaceScope::find (const std::string& prefix, int& index) const
+{
+  for (const XMLNamespaceScope* scope = this; scope != NULL;
+       scope = scope->mParent)
+  {
+    index = scope->mDeclarations.getIndexByPrefix(prefix);
+    if (index >= 0) return scope;
+  }
+
+  return NULL;
+}
+/** @endcond */
+
+
+LIBLX_CPP_NAMESPACE_END
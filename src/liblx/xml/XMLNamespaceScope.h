@@ -0,0 +1,176 @@
+/**
+ * @file    XMLNamespaceScope.h
+ * @brief   The XML namespaces in scope at an element
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ *
+ * @class XMLNamespaceScope
+ * @sbmlbrief{core} The namespace declarations in effect at an element.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * The XMLNamespaces of an XMLToken only hold the declarations made on
+ * that element.  The prefixes that can be used inside it also include
+ * everything declared on its ancestors.  While reading a document, an
+ * XMLInputStream keeps a stack of XMLNamespaceScope frames, one for each
+ * element that declares namespaces, each linked to the frame that
+ * encloses it.  Start and end elements point to the frame in effect
+ * inside them (see XMLToken::getNamespaceScope()), so an in-scope prefix
+ * is resolved by walking a few frames instead of rebuilding the scope.
+ *
+ * Elements that declare nothing share the frame of their parent, so the
+ * number of frames is the number of elements with @c xmlns attributes,
+ * usually only a handful.  Frames never change once they are created,
+ * and are reference counted: a frame lives as long as a token, an
+ * XMLNode or a nested frame still points to it.  The reference counts
+ * are updated atomically, so tokens that share frames may be copied and
+ * destroyed on different threads at the same time.
+ */
+
+#ifndef XMLNamespaceScope_h
+#define XMLNamespaceScope_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+#include <string>
+#include <liblx/xml/XMLNamespaces.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+class LIBLX_EXTERN XMLNamespaceScope
+{
+public:
+
+  /**
+   * Returns the declarations made by the element that opened this frame.
+   *
+   * @return the XMLNamespaces declared on that element.
+   */
+  const XMLNamespaces& getDeclarations () const;
+
+
+  /**
+   * Returns the frame that encloses this one.
+   *
+   * @return the enclosing XMLNamespaceScope, or @c NULL for the outermost
+   * frame.
+   */
+  const XMLNamespaceScope* getParent () const;
+
+
+  /**
+   * Returns the URI bound to a prefix in this scope.  The innermost
+   * declaration of @p prefix wins.
+   *
+   * @param prefix the prefix to resolve, or the empty string for the
+   * default namespace.
+   *
+   * @return the URI bound to @p prefix, or an empty string if it is not
+   * declared in this scope.
+   */
+  std::string getURI (const std::string& prefix = "") const;
+
+
+  /**
+   * Predicate returning @c true if a prefix is declared in this scope.
+   *
+   * @param prefix the prefix to look for, or the empty string for the
+   * default namespace.
+   *
+   * @return @c true if @p prefix is bound in this scope, @c false
+   * otherwise.
+   */
+  bool hasPrefix (const std::string& prefix) const;
+
+
+  /**
+   * Returns all the declarations in effect in this scope, with inner
+   * declarations replacing outer ones for the same prefix.
+   *
+   * @return the XMLNamespaces in scope, innermost first.
+   */
+  XMLNamespaces getNamespacesInScope () const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Creates a frame for an element that declares @p declarations, inside
+   * @p parent (which may be @c NULL).  The new frame has one reference.
+   */
+  static const XMLNamespaceScope* create (const XMLNamespaceScope* parent,
+                                          const XMLNamespaces& declarations);
+
+
+  /**
+   * Adds a reference to @p scope, which may be @c NULL.
+   */
+  static void ref (const XMLNamespaceScope* scope);
+
+
+  /**
+   * Releases a reference to @p scope, which may be @c NULL, and deletes
+   * the frame once nothing points to it any more.
+   */
+  static void unref (const XMLNamespaceScope* scope);
+  /** @endcond */
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  XMLNamespaceScope (const XMLNamespaceScope* parent,
+                     const XMLNamespaces& declarations);
+  ~XMLNamespaceScope ();
+
+  XMLNamespaceScope (const XMLNamespaceScope&);
+  XMLNamespaceScope& operator= (const XMLNamespaceScope&);
+
+  /**
+   * @return the frame in which prefix is declared, or NULL.
+   */
+  const XMLNamespaceScope* find (const std::string& prefix, int& index) const;
+
+  const XMLNamespaceScope* mParent;
+  XMLNamespaces            mDeclarations;
+  mutable long             mRefs;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* XMLNamespaceScope_h */
@@ -78,6 +78,8 @@ XMLNamespaces::~XMLNamespaces ()
  */
 XMLNamespaces::XMLNamespaces(const XMLNamespaces& orig)
  : mNamespaces(orig.mNamespaces.begin(), orig.mNamespaces.end())
+ , mPrefixIndex(orig.mPrefixIndex)
+ , mURIIndex(orig.mURIIndex)
 {
 }
 
@@ -91,6 +93,8 @@ XMLNamespaces::operator=(const XMLNamespaces& rhs)
   if(&rhs!=this)
   {
     mNamespaces.assign( rhs.mNamespaces.begin(), rhs.mNamespaces.end() ); 
+    mPrefixIndex = rhs.mPrefixIndex;
+    mURIIndex    = rhs.mURIIndex;
   }
   
   return *this;
@@ -129,6 +133,7 @@ XMLNamespaces::add (const std::string& uri, const std::string prefix)
   if ( hasPrefix(prefix) ) remove(prefix);
 
   mNamespaces.push_back( make_pair(prefix, uri) );
+  indexLast();
   return LIBLX_OPERATION_SUCCESS;
 }
 
@@ -145,6 +150,7 @@ int XMLNamespaces::remove (int index)
 
   vector<PrefixURIPair>::iterator it = mNamespaces.begin() + index;
   mNamespaces.erase(it);
+  reindex();
 
   return LIBLX_OPERATION_SUCCESS;
 }
@@ -164,6 +170,7 @@ int XMLNamespaces::remove (const std::string& prefix)
 
   vector<PrefixURIPair>::iterator it = mNamespaces.begin() + index;
   mNamespaces.erase(it);
+  reindex();
 
   return LIBLX_OPERATION_SUCCESS;
 }
@@ -176,6 +183,8 @@ int
 XMLNamespaces::clear ()
 {
   mNamespaces.clear();
+  mPrefixIndex.clear();
+  mURIIndex.clear();
   if (mNamespaces.empty())
   {
     return LIBLX_OPERATION_SUCCESS;
@@ -195,9 +204,23 @@ XMLNamespaces::clear ()
 int
 XMLNamespaces::getIndex (const std::string& uri) const
 {
+  if (isIndexed())
+  {
+    size_t hash  = XMLNameIndex::hash(uri);
+    size_t slot  = mURIIndex.start(hash);
+    int    index;
+
+    while ((index = mURIIndex.next(slot, hash)) != -1)
+    {
+      if (mNamespaces[(size_t)index].second == uri) return index;
+    }
+
+    return -1;
+  }
+
   for (int index = 0; index < getLength(); ++index)
   {
-    if (getURI(index) == uri) return index;
+    if (mNamespaces[(size_t)index].second == uri) return index;
   }
   
   return -1;
@@ -220,9 +243,23 @@ XMLNamespaces::containsUri(const std::string& uri) const
 int
 XMLNamespaces::getIndexByPrefix (const std::string& prefix) const
 {
+  if (isIndexed())
+  {
+    size_t hash  = XMLNameIndex::hash(prefix);
+    size_t slot  = mPrefixIndex.start(hash);
+    int    index;
+
+    while ((index = mPrefixIndex.next(slot, hash)) != -1)
+    {
+      if (mNamespaces[(size_t)index].first == prefix) return index;
+    }
+
+    return -1;
+  }
+
   for (int index = 0; index < getLength(); ++index)
   {
-     if (getPrefix(index) == prefix) return index;
+     if (mNamespaces[(size_t)index].first == prefix) return index;
   }
   
   return -1;
@@ -292,12 +329,9 @@ XMLNamespaces::getURI (int index) const
 std::string
 XMLNamespaces::getURI (const std::string prefix) const
 {
-  for (int index = 0; index < getLength(); ++index)
-  {
-    if (getPrefix(index) == prefix) return getURI(index);
-  }
-  
-  return std::string();
+  int index = getIndexByPrefix(prefix);
+
+  return (index == -1) ? std::string() : mNamespaces[(size_t)index].second;
 }
 
 
@@ -368,6 +402,7 @@ XMLNamespaces::removeDefault ()
     if (i->first.empty())
     {
       mNamespaces.erase(i);
+      reindex();
       break;
     }
   }
@@ -410,6 +445,74 @@ bool XMLNamespaces::isURIReserved(const std::string& uri) //const
 }
 /** @endcond */
 
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Exchanges the declarations of this list with those of other.
+ */
+void
+XMLNamespaces::swap (XMLNamespaces& other)
+{
+  mNamespaces.swap(other.mNamespaces);
+  mPrefixIndex.swap(other.mPrefixIndex);
+  mURIIndex.swap(other.mURIIndex);
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Rebuilds the prefix and URI indexes from scratch, or drops them if
+ * this list has become short enough for linear scans.
+ */
+void
+XMLNamespaces::reindex ()
+{
+  mPrefixIndex.clear();
+  mURIIndex.clear();
+
+  if (mNamespaces.size() < XMLNameIndex::Threshold) return;
+
+  for (size_t n = 0; n < mNamespaces.size(); ++n)
+  {
+    mPrefixIndex.insert( XMLNameIndex::hash(mNamespaces[n].first ) );
+    mURIIndex   .insert( XMLNameIndex::hash(mNamespaces[n].second) );
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Adds the last declaration to the prefix and URI indexes.
+ */
+void
+XMLNamespaces::indexLast ()
+{
+  if (mPrefixIndex.size() + 1 == mNamespaces.size() && mPrefixIndex.isBuilt())
+  {
+    mPrefixIndex.insert( XMLNameIndex::hash(mNamespaces.back().first ) );
+    mURIIndex   .insert( XMLNameIndex::hash(mNamespaces.back().second) );
+  }
+  else if (mNamespaces.size() >= XMLNameIndex::Threshold)
+  {
+    reindex();
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return true if lookups can use the prefix and URI indexes.
+ */
+bool
+XMLNamespaces::isIndexed () const
+{
+  return mPrefixIndex.isBuilt() && mPrefixIndex.size() == mNamespaces.size();
+}
+/** @endcond */
+
 #ifndef SWIG
 
 /** @cond doxygenLibsbmlInternal */
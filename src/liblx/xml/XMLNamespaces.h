@@ -74,6 +74,8 @@
 #include <vector>
 #include <set>
 
+#include <liblx/xml/XMLNameIndex.h>
+
 LIBLX_CPP_NAMESPACE_BEGIN
 
 /** @cond doxygenLibsbmlInternal */
@@ -381,6 +383,17 @@ public:
    */
   static void addReservedURI(const std::string& uri);
 
+
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Exchanges the declarations held by this XMLNamespaces list with those
+   * of @p other without copying them.
+   *
+   * @param other the XMLNamespaces list to swap contents with.
+   */
+  void swap (XMLNamespaces& other);
+  /** @endcond */
+
 #ifndef SWIG
 
   /** @cond doxygenLibsbmlInternal */
@@ -425,9 +438,33 @@ protected:
 
   bool containIdenticalSetNS(XMLNamespaces* rhs);
 
+  /**
+   * Rebuilds the prefix and URI indexes after mNamespaces has been
+   * refilled; subclasses that fill mNamespaces directly must call this
+   * when they are done.
+   */
+  void reindex ();
+
+
+  /**
+   * Adds the last declaration to the indexes, building them once this
+   * list reaches XMLNameIndex::Threshold declarations.
+   */
+  void indexLast ();
+
+
+  /**
+   * @return true if lookups can use the prefix and URI indexes.
+   */
+  bool isIndexed () const;
+
+
   typedef std::pair<std::string, std::string> PrefixURIPair;
   std::vector<PrefixURIPair> mNamespaces;
 
+  XMLNameIndex mPrefixIndex;
+  XMLNameIndex mURIIndex;
+
   bool isURIReserved(const std::string& uri); //const;
   static std::set<std::string> reservedURIs;
 
@@ -43,6 +43,10 @@
 /** @endcond */
 
 #include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLIdIndex.h>
+#include <liblx/xml/XMLNameIndex.h>
+#include <liblx/xml/XMLNodeIterator.h>
+#include <liblx/xml/XMLThreads.h>
 #include <liblx/xml/sbmlMemoryStubs.h>
 #include <liblx/xml/operationReturnValues.h>
 
@@ -56,24 +60,54 @@ LIBLX_CPP_NAMESPACE_BEGIN
 #ifdef __cplusplus
 
 /*
- * @return s with whitespace removed from the beginning and end.
+ * An empty XMLNode object, which is neither start node, end node, nor
+ * text node, returned by getChild() if the given index or name is out of
+ * range.  It is created with the other static objects of the library,
+ * before any thread can ask for it, so that getChild() may be called
+ * from several threads at once.
  */
-static const string
-trim (const string& s)
+static const XMLNode OutOfRange;
+
+
+/*
+ * Serializes the computation of structural hashes, which getHash() caches
+ * on const nodes.
+ */
+static XMLMutex HashMutex;
+
+
+/*
+ * Mixes value into the hash seed.
+ */
+static size_t
+combineHash (size_t seed, size_t value)
 {
-  static const string whitespace(" \t\r\n");
+  return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
 
-  string::size_type begin = s.find_first_not_of(whitespace);
-  string::size_type end   = s.find_last_not_of (whitespace);
 
-  return (begin == string::npos) ? std::string() : s.substr(begin, end - begin + 1);
+/*
+ * Scrambles the bits of a hash that is summed with others, so that sums
+ * of different sets rarely agree.
+ */
+static size_t
+scrambleHash (size_t hash)
+{
+  hash = ((hash >> 16) ^ hash) * 0x45d9f3b;
+  hash = ((hash >> 16) ^ hash) * 0x45d9f3b;
+  return (hash >> 16) ^ hash;
 }
 
 
 /*
  * Creates a new empty XMLNode with no children.
  */
-XMLNode::XMLNode ()
+XMLNode::XMLNode () :
+   mParent( NULL )
+ , mIndex ( 0    )
+ , mIdIndex( NULL )
+ , mHashValid( 0 )
+ , mHashExact( false )
 {
 }
 
@@ -83,6 +117,9 @@ XMLNode::XMLNode ()
  */
 XMLNode::~XMLNode ()
 {
+  delete mIdIndex;
+  mIdIndex = NULL;
+
   removeChildren();
 }
 
@@ -90,7 +127,13 @@ XMLNode::~XMLNode ()
 /*
  * Creates a new XMLNode by copying token.
  */
-XMLNode::XMLNode (const XMLToken& token) : XMLToken(token)
+XMLNode::XMLNode (const XMLToken& token) :
+   XMLToken( token )
+ , mParent ( NULL  )
+ , mIndex  ( 0     )
+ , mIdIndex( NULL  )
+ , mHashValid( 0 )
+ , mHashExact( false )
 {
 }
 
@@ -105,6 +148,11 @@ XMLNode::XMLNode (  const XMLTriple&     triple
                   , const unsigned int   line
                   , const unsigned int   column) 
                   : XMLToken(triple, attributes, namespaces, line, column)
+                  , mParent( NULL )
+                  , mIndex ( 0    )
+                  , mIdIndex( NULL )
+                  , mHashValid( 0 )
+                  , mHashExact( false )
 {
 }
 
@@ -117,6 +165,11 @@ XMLNode::XMLNode (  const XMLTriple&      triple
                   , const unsigned int    line
                   , const unsigned int    column )
                   : XMLToken(triple, attributes, line, column)
+                  , mParent( NULL )
+                  , mIndex ( 0    )
+                  , mIdIndex( NULL )
+                  , mHashValid( 0 )
+                  , mHashExact( false )
 {
 }  
 
@@ -128,6 +181,11 @@ XMLNode::XMLNode (  const XMLTriple&   triple
                   , const unsigned int line
                   , const unsigned int column )
                   : XMLToken(triple, line, column)
+                  , mParent( NULL )
+                  , mIndex ( 0    )
+                  , mIdIndex( NULL )
+                  , mHashValid( 0 )
+                  , mHashExact( false )
 {
 }
 
@@ -139,6 +197,11 @@ XMLNode::XMLNode (  const std::string& chars
                   , const unsigned int line
                   , const unsigned int column )
                   : XMLToken(chars, line, column)
+                  , mParent( NULL )
+                  , mIndex ( 0    )
+                  , mIdIndex( NULL )
+                  , mHashValid( 0 )
+                  , mHashExact( false )
 {
 }
 
@@ -149,11 +212,49 @@ XMLNode::XMLNode (  const std::string& chars
  * be positioned on a start element (stream.peek().isStart() == true) and
  * will be read until the matching end element is found.
  */
-XMLNode::XMLNode (XMLInputStream& stream) : XMLToken( stream.next() )
+XMLNode::XMLNode (XMLInputStream& stream) :
+   XMLToken( stream.next() )
+ , mParent ( NULL )
+ , mIndex  ( 0    )
+ , mIdIndex( NULL )
+ , mHashValid( 0 )
+ , mHashExact( false )
 {
-  if ( isEnd() ) return;
+  readChildren(stream);
+}
 
-  std::string s;
+
+/*
+ * Creates a new XMLNode by reading XMLTokens from stream, indexing the
+ * elements read by the given identifier attributes.
+ */
+XMLNode::XMLNode (XMLInputStream& stream,
+                  const std::vector<std::string>& idAttributes) :
+   XMLToken( stream.next() )
+ , mParent ( NULL )
+ , mIndex  ( 0    )
+ , mIdIndex( new XMLIdIndex )
+ , mHashValid( 0 )
+ , mHashExact( false )
+{
+  for (size_t n = 0; n < idAttributes.size(); ++n)
+  {
+    mIdIndex->addAttribute(idAttributes[n]);
+  }
+
+  mIdIndex->add(*this);
+  readChildren(stream);
+}
+
+
+/*
+ * Reads the children of this start element from stream, up to and
+ * including the matching end element.
+ */
+void
+XMLNode::readChildren (XMLInputStream& stream)
+{
+  if ( isEnd() ) return;
 
   while ( stream.isGood() )
   {
@@ -162,15 +263,21 @@ XMLNode::XMLNode (XMLInputStream& stream) : XMLToken( stream.next() )
 
     if ( next.isStart() )
     {
-      addChild( XMLNode(stream) );
+      adoptChild( new XMLNode(stream), getNumChildren() );
     }
     else if ( next.isText() )
     {
-      s = trim(next.getCharacters());
-      if (s != "")
-        addChild( stream.next() );
-      else
-        stream.skipText();
+      XMLToken text = stream.next();
+
+      // a stream with a character chunk size set delivers one text node
+      // as several consecutive text tokens
+      while ( stream.isGood() && stream.peek().isText() )
+      {
+        text.append( stream.nextView().getCharacters() );
+      }
+
+      if (!text.isWhitespace())
+        addChild( text );
     }
     else if ( next.isEnd() )
     {
@@ -183,11 +290,28 @@ XMLNode::XMLNode (XMLInputStream& stream) : XMLToken( stream.next() )
 
 
 /*
- * Copy constructor; creates a copy of this XMLNode.
+ * Copy constructor; creates a copy of this XMLNode.  The copy is not
+ * attached to the parent of orig.
  */
 XMLNode::XMLNode(const XMLNode& orig):
       XMLToken (orig)
+    , mParent  (NULL)
+    , mIndex   (0)
+    , mIdIndex (NULL)
+    , mHashValid(0)
+    , mHashExact(false)
 {
+  if (orig.mIdIndex != NULL)
+  {
+    mIdIndex = new XMLIdIndex;
+    for (unsigned int n = 0; n < orig.mIdIndex->getNumAttributes(); ++n)
+    {
+      mIdIndex->addAttribute(orig.mIdIndex->getAttribute(n));
+    }
+
+    mIdIndex->add(*this);
+  }
+
   std::vector<XMLNode*>::const_iterator it = orig.mChildren.begin();
   while(it != orig.mChildren.end())
   {
@@ -195,17 +319,25 @@ XMLNode::XMLNode(const XMLNode& orig):
     addChild(*node);
     ++it;
   }
+
+  copyHash(orig);
 }
 
 
+/*
+ * Assignment operator; replaces the contents of this XMLNode, keeping its
+ * own place in its parent.
+ */
 XMLNode& 
 XMLNode::operator=(const XMLNode& rhs)
 {
   if(&rhs!=this)
   {
-    this->XMLToken::operator=(rhs);
     removeChildren();
 
+    this->XMLToken::operator=(rhs);
+    tokenChanged();
+
     std::vector<XMLNode*>::const_iterator it = rhs.mChildren.begin();
     while(it != rhs.mChildren.end())
     {
@@ -214,6 +346,7 @@ XMLNode::operator=(const XMLNode& rhs)
       ++it;
     }
 
+    copyHash(rhs);
   }
 
   return *this;
@@ -240,7 +373,7 @@ XMLNode::addChild (const XMLNode& node)
 
   if (isStart())
   {
-    mChildren.push_back(new XMLNode(node));
+    adoptChild(new XMLNode(node), getNumChildren());
     /* need to catch the case where this node is both a start and
     * an end element
     */
@@ -249,7 +382,7 @@ XMLNode::addChild (const XMLNode& node)
   }
   else if (isEOF())
   {
-    mChildren.push_back(new XMLNode(node));
+    adoptChild(new XMLNode(node), getNumChildren());
     // this causes strange things to happen when node is written out
     //   this->mIsStart = true;
     return LIBLX_OPERATION_SUCCESS;
@@ -272,11 +405,10 @@ XMLNode::insertChild (unsigned int n, const XMLNode& node)
 
   if ( (n >= size) || (size == 0) )
   {
-    mChildren.push_back(node.clone());
-    return *mChildren.back();
+    return *adoptChild(node.clone(), size);
   }
 
-  return **(mChildren.insert(mChildren.begin() + n, node.clone()));
+  return *adoptChild(node.clone(), n);
 }
 
 
@@ -294,7 +426,17 @@ XMLNode::removeChild(unsigned int n)
   if ( n < getNumChildren() )
   {
     rval = mChildren[n];
+
+    XMLIdIndex* ids = getIdIndex();
+    if (ids != NULL) ids->removeSubtree(*rval);
+
     mChildren.erase(mChildren.begin() + n);
+    renumberChildren(n);
+    unindexChild(n);
+    invalidateHash();
+
+    rval->mParent = NULL;
+    rval->mIndex  = 0;
   }
   
   return rval;
@@ -306,17 +448,355 @@ XMLNode::removeChild(unsigned int n)
 int
 XMLNode::removeChildren()
 {
+  XMLIdIndex* ids = getIdIndex();
+  if (ids != NULL && ids == mIdIndex)
+  {
+    // emptying the root: only its own identifiers remain
+    ids->clearEntries();
+    ids->add(*this);
+  }
+  else if (ids != NULL)
+  {
+    for (size_t n = 0; n < mChildren.size(); ++n)
+    {
+      ids->removeSubtree(*mChildren[n]);
+    }
+  }
+
   std::vector<XMLNode*>::iterator curIt = mChildren.begin();
     while(curIt != mChildren.end())
     {
+      (*curIt)->mParent = NULL;
       delete *curIt;    
       ++curIt;
       }
   mChildren.clear(); 
+  clearChildNameIndex();
+  invalidateHash();
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the parent of this XMLNode, or NULL if it is a root.
+ */
+XMLNode*
+XMLNode::getParent ()
+{
+  return mParent;
+}
+
+
+/*
+ * @return the parent of this XMLNode, or NULL if it is a root.
+ */
+const XMLNode*
+XMLNode::getParent () const
+{
+  return mParent;
+}
+
+
+/*
+ * @return the index of this XMLNode among the children of its parent.
+ */
+unsigned int
+XMLNode::getIndexInParent () const
+{
+  return mIndex;
+}
+
+
+/*
+ * @return the child of the parent of this XMLNode that follows it, or
+ * NULL if there is none.
+ */
+XMLNode*
+XMLNode::getNextSibling ()
+{
+  return const_cast<XMLNode*>( 
+            static_cast<const XMLNode&>(*this).getNextSibling()
+          );
+}
+
+
+/*
+ * @return the child of the parent of this XMLNode that follows it, or
+ * NULL if there is none.
+ */
+const XMLNode*
+XMLNode::getNextSibling () const
+{
+  if (mParent == NULL || mIndex + 1 >= mParent->getNumChildren()) return NULL;
+
+  return mParent->mChildren[mIndex + 1];
+}
+
+
+/*
+ * @return the child of the parent of this XMLNode that precedes it, or
+ * NULL if there is none.
+ */
+XMLNode*
+XMLNode::getPreviousSibling ()
+{
+  return const_cast<XMLNode*>( 
+            static_cast<const XMLNode&>(*this).getPreviousSibling()
+          );
+}
+
+
+/*
+ * @return the child of the parent of this XMLNode that precedes it, or
+ * NULL if there is none.
+ */
+const XMLNode*
+XMLNode::getPreviousSibling () const
+{
+  if (mParent == NULL || mIndex == 0) return NULL;
+
+  return mParent->mChildren[mIndex - 1];
+}
+
+
+/*
+ * Walks the tree rooted at this XMLNode, calling visitor on each node
+ * before and after its children.
+ */
+bool
+XMLNode::accept (XMLNodeVisitor& visitor) const
+{
+  const XMLNode* node  = this;
+  unsigned int   depth = 0;
+
+  for (;;)
+  {
+    XMLNodeVisit_t action = visitor.enter(*node, depth);
+
+    if (action == LIBLX_VISIT_STOP) return false;
+
+    if (action == LIBLX_VISIT_CONTINUE && node->getNumChildren() > 0)
+    {
+      node = node->mChildren[0];
+      ++depth;
+      continue;
+    }
+
+    // leave the node, and every ancestor whose last child it is
+    for (;;)
+    {
+      if (!visitor.leave(*node, depth)) return false;
+      if (node == this) return true;
+
+      const XMLNode* next = node->getNextSibling();
+
+      if (next != NULL)
+      {
+        node = next;
+        break;
+      }
+
+      node = node->mParent;
+      --depth;
+    }
+  }
+}
+
+
+/*
+ * Makes name an identifier attribute of the tree rooted at this XMLNode.
+ */
+int
+XMLNode::addIdAttribute (const std::string& name)
+{
+  if (mParent != NULL) return LIBLX_INVALID_XML_OPERATION;
+  if (name.empty()) return LIBLX_INVALID_ATTRIBUTE_VALUE;
+
+  if (mIdIndex == NULL) mIdIndex = new XMLIdIndex;
+
+  if (mIdIndex->addAttribute(name))
+  {
+    mIdIndex->clearEntries();
+    mIdIndex->addSubtree(*this);
+  }
+
   return LIBLX_OPERATION_SUCCESS;
 }
 
 
+/*
+ * @return the identifier index of the tree this XMLNode belongs to.
+ */
+XMLIdIndex*
+XMLNode::getIdIndex ()
+{
+  return const_cast<XMLIdIndex*>( 
+            static_cast<const XMLNode&>(*this).getIdIndex()
+          );
+}
+
+
+/*
+ * @return the identifier index of the tree this XMLNode belongs to.
+ */
+const XMLIdIndex*
+XMLNode::getIdIndex () const
+{
+  const XMLNode* root = this;
+  while (root->mParent != NULL) root = root->mParent;
+
+  return root->mIdIndex;
+}
+
+
+/*
+ * @return the element of this tree whose identifier attribute has the
+ * given value.
+ */
+XMLNode*
+XMLNode::getNodeById (const std::string& value)
+{
+  return const_cast<XMLNode*>( 
+            static_cast<const XMLNode&>(*this).getNodeById(value)
+          );
+}
+
+
+/*
+ * @return the element of this tree whose identifier attribute has the
+ * given value.
+ */
+const XMLNode*
+XMLNode::getNodeById (const std::string& value) const
+{
+  const XMLIdIndex* ids = getIdIndex();
+  return (ids != NULL) ? ids->getNode(value) : NULL;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Inserts child, which this XMLNode now owns, as its nth child and points
+ * it back at this node.
+ */
+XMLNode*
+XMLNode::adoptChild (XMLNode* child, unsigned int n)
+{
+  mChildren.insert(mChildren.begin() + n, child);
+  child->mParent = this;
+  renumberChildren(n);
+  invalidateHash();
+
+  XMLIdIndex* ids = getIdIndex();
+  if (ids != NULL) ids->addSubtree(*child);
+
+  indexChild(n);
+
+  return child;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return true if the child name index covers every child.
+ */
+bool
+XMLNode::hasChildNameIndex () const
+{
+  return mNameIndex.isBuilt() && mNameIndex.size() == mChildren.size();
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Adds the nth child, just inserted, to the child name index, if there is
+ * one, or builds the index once there are enough children.
+ */
+void
+XMLNode::indexChild (unsigned int n)
+{
+  if (mNameIndex.isBuilt() && mNameIndex.size() + 1 == mChildren.size())
+  {
+    mNameIndex.insert(mChildren, n);
+  }
+  else
+  {
+    updateChildNameIndex();
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Drops the nth child, just removed, from the child name index, or the
+ * whole index once there are too few children to need one.
+ */
+void
+XMLNode::unindexChild (unsigned int n)
+{
+  if (getNumChildren() >= XMLNameIndex::Threshold
+      && mNameIndex.isBuilt() && mNameIndex.size() == mChildren.size() + 1)
+  {
+    mNameIndex.remove(n);
+  }
+  else
+  {
+    updateChildNameIndex();
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Drops the child name index.
+ */
+void
+XMLNode::clearChildNameIndex ()
+{
+  mNameIndex.clear();
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Rebuilds the child name index if it does not cover the children, or
+ * drops it if there are too few children to need one.
+ */
+void
+XMLNode::updateChildNameIndex ()
+{
+  if (getNumChildren() >= XMLNameIndex::Threshold)
+  {
+    mNameIndex.build(mChildren);
+  }
+  else
+  {
+    clearChildNameIndex();
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Updates the parent index of the children from the nth on.
+ */
+void
+XMLNode::renumberChildren (unsigned int n)
+{
+  for (unsigned int size = getNumChildren(); n < size; ++n)
+  {
+    mChildren[n]->mIndex = n;
+  }
+}
+/** @endcond */
+
+
 /*
  * Returns the nth child of this XMLNode.
  */
@@ -335,8 +815,6 @@ XMLNode::getChild (unsigned int n)
 const XMLNode&
 XMLNode::getChild (unsigned int n) const
 {
-  static const XMLNode outOfRange;
-
   unsigned int size = getNumChildren();
   if ( (n < size) && (size > 0) )
   {
@@ -344,13 +822,7 @@ XMLNode::getChild (unsigned int n) const
   }
   else
   {
-    // An empty XMLNode object, which is neither start node, 
-    // end node, nor text node, returned if the given index 
-    // is out of range. 
-    // Currently, this object is allocated as a static object
-    // to avoid a memory leak.
-    // This may be fixed in the futrure release.
-    return outOfRange;
+    return OutOfRange;
   }
 }
 
@@ -384,7 +856,6 @@ XMLNode::getChild (const std::string&  name)
 const XMLNode& 
 XMLNode::getChild (const std::string&  name) const
 {
-  static const XMLNode outOfRange;
   int index = getIndex(name);
   if (index != -1)
   {
@@ -392,13 +863,7 @@ XMLNode::getChild (const std::string&  name) const
   }
   else 
   {
-    // An empty XMLNode object, which is neither start node, 
-    // end node, nor text node, returned if the given index 
-    // is out of range. 
-    // Currently, this object is allocated as a static object
-    // to avoid a memory leak.
-    // This may be fixed in the futrure release.
-    return outOfRange;
+    return OutOfRange;
   }
 
 }
@@ -415,14 +880,39 @@ XMLNode::getChild (const std::string&  name) const
 int
 XMLNode::getIndex (const std::string& name) const
 {
+  if (hasChildNameIndex()) return mNameIndex.find(mChildren, name);
+
   for (unsigned int index = 0; index < getNumChildren(); ++index)
   {
-    if (getChild(index).getName() == name) return index;
+    if (mChildren[index]->getName() == name) return index;
   }
   
   return -1;
 }
 
+
+/*
+ * Return the index of the next child after the nth that has the same
+ * name as the nth.
+ */
+int
+XMLNode::getNextIndex (unsigned int n) const
+{
+  unsigned int size = getNumChildren();
+  if (n >= size) return -1;
+
+  if (hasChildNameIndex()) return mNameIndex.next(n);
+
+  const std::string& name = mChildren[n]->getName();
+  for (unsigned int index = n + 1; index < size; ++index)
+  {
+    if (mChildren[index]->getName() == name) return index;
+  }
+
+  return -1;
+}
+
+
 /**
  * Compare this XMLNode against another XMLNode returning true if both nodes
  * represent the same XML tree, or false otherwise.
@@ -435,6 +925,13 @@ XMLNode::getIndex (const std::string& name) const
 bool 
 XMLNode::equals(const XMLNode& other, bool ignoreURI /*=false*/, bool ignoreAttributeValues /*=false*/) const
 {
+  // trees whose cached hashes differ are not equal
+  unsigned int variant = (ignoreURI ? 1 : 0) + (ignoreAttributeValues ? 2 : 0);
+  if (XMLThreads::load(mHashValid) != 0 && mHashExact
+    && XMLThreads::load(other.mHashValid) != 0 && other.mHashExact
+    && mHash[variant] != other.mHash[variant])
+    return false;
+
   bool equal;//=true;
   // check if the nodes have the same name,
   equal=getName()==other.getName();
@@ -481,6 +978,227 @@ XMLNode::equals(const XMLNode& other, bool ignoreURI /*=false*/, bool ignoreAttr
 }
 
 
+/*
+ * @return the structural hash of the tree rooted at this XMLNode.
+ */
+size_t
+XMLNode::getHash (bool ignoreURI, bool ignoreAttributeValues) const
+{
+  if (XMLThreads::load(mHashValid) == 0)
+  {
+    XMLMutexLock lock(HashMutex);
+
+    // the nodes whose hash is out of date, in pre-order; a node with an
+    // up-to-date hash has up-to-date hashes throughout its subtree
+    vector<const XMLNode*> stale;
+    if (mHashValid == 0) stale.push_back(this);
+
+    for (size_t n = 0; n < stale.size(); ++n)
+    {
+      const vector<XMLNode*>& children = stale[n]->mChildren;
+
+      for (size_t c = 0; c < children.size(); ++c)
+      {
+        if (children[c]->mHashValid == 0) stale.push_back(children[c]);
+      }
+    }
+
+    // in reverse pre-order, children come before their parent
+    for (size_t n = stale.size(); n > 0; --n)
+    {
+      stale[n - 1]->computeHash();
+    }
+  }
+
+  return mHash[(ignoreURI ? 1 : 0) + (ignoreAttributeValues ? 2 : 0)];
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Computes the hashes of this XMLNode from its name, URI and attributes
+ * and the hashes of its children, which must be up to date.  Attributes
+ * are summed, since equals() matches them in any order; text and
+ * namespace declarations are left out, since equals() ignores them.
+ * The content hash takes in everything, in order.
+ */
+void
+XMLNode::computeHash () const
+{
+  const XMLAttributes& attributes = getAttributes();
+  const int            length     = attributes.getLength();
+
+  size_t names  = 0;
+  size_t values = 0;
+  bool   exact  = true;
+
+  size_t content = (isStart() ? 1 : 0) + (isText() ? 2 : 0);
+  content = combineHash(content, XMLNameIndex::hash(getPrefix()));
+
+  // the counts keep attribute fields apart from namespace declarations
+  content = combineHash(content, (size_t)length);
+
+  for (int i = 0; i < length; ++i)
+  {
+    size_t name = XMLNameIndex::hash(attributes.getName(i));
+
+    content = combineHash(content, name);
+    content = combineHash(content, XMLNameIndex::hash(attributes.getURI(i)));
+    content = combineHash(content, XMLNameIndex::hash(attributes.getPrefix(i)));
+    content = combineHash(content, XMLNameIndex::hash(attributes.getValue(i)));
+
+    names  += scrambleHash(name);
+    values += scrambleHash(combineHash(name,
+                             XMLNameIndex::hash(attributes.getValue(i))));
+
+    for (int j = 0; exact && j < i; ++j)
+    {
+      exact = (attributes.getName(j) != attributes.getName(i));
+    }
+  }
+
+  size_t name = XMLNameIndex::hash(getName());
+  size_t uri  = XMLNameIndex::hash(getURI());
+
+  content = combineHash(content, (size_t)mNamespaces.getLength());
+
+  for (int i = 0; i < mNamespaces.getLength(); ++i)
+  {
+    content = combineHash(content, XMLNameIndex::hash(mNamespaces.getPrefix(i)));
+    content = combineHash(content, XMLNameIndex::hash(mNamespaces.getURI(i)));
+  }
+
+  content = combineHash(content, XMLNameIndex::hash(mChars));
+  content = combineHash(content, name);
+  content = combineHash(content, uri);
+
+  for (unsigned int variant = 0; variant < ContentHash; ++variant)
+  {
+    size_t hash = name;
+
+    if ((variant & 1) == 0) hash = combineHash(hash, uri);
+
+    hash = combineHash(hash, (variant & 2) ? names : values);
+    hash = combineHash(hash, (size_t)length);
+    hash = combineHash(hash, mChildren.size());
+
+    for (size_t c = 0; c < mChildren.size(); ++c)
+    {
+      hash = combineHash(hash, mChildren[c]->mHash[variant]);
+    }
+
+    mHash[variant] = hash;
+  }
+
+  content = combineHash(content, mChildren.size());
+
+  for (size_t c = 0; c < mChildren.size(); ++c)
+  {
+    content = combineHash(content, mChildren[c]->mHash[ContentHash]);
+  }
+
+  mHash[ContentHash] = content;
+
+  for (size_t c = 0; exact && c < mChildren.size(); ++c)
+  {
+    exact = mChildren[c]->mHashExact;
+  }
+
+  mHashExact = exact;
+  XMLThreads::store(mHashValid, 1);
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Takes over the hashes of orig, whose tree this XMLNode has just become
+ * a copy of, if they are up to date.
+ */
+void
+XMLNode::copyHash (const XMLNode& orig)
+{
+  if (XMLThreads::load(orig.mHashValid) == 0) return;
+
+  for (unsigned int variant = 0; variant <= ContentHash; ++variant)
+  {
+    mHash[variant] = orig.mHash[variant];
+  }
+
+  mHashExact = orig.mHashExact;
+  XMLThreads::store(mHashValid, 1);
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return the hash of everything the tree rooted at this XMLNode holds.
+ */
+size_t
+XMLNode::getContentHash () const
+{
+  getHash();
+  return mHash[ContentHash];
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Replaces the token of this XMLNode by token, keeping its children and
+ * its place in its parent.  A start element that has children cannot be
+ * an end element as well.
+ */
+void
+XMLNode::setToken (const XMLToken& token)
+{
+  this->XMLToken::operator=(token);
+  if (!mChildren.empty() && isEnd()) unsetEnd();
+  tokenChanged();
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Marks the hashes of this XMLNode and its ancestors out of date.  The
+ * walk stops at the first node already marked, whose ancestors are too.
+ */
+void
+XMLNode::invalidateHash ()
+{
+  for (XMLNode* node = this; node != NULL && node->mHashValid != 0;
+       node = node->mParent)
+  {
+    node->mHashValid = 0;
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * The name or the attributes of this XMLNode have changed.  Its
+ * identifier values are recorded again, and a renamed child moves to its
+ * new name in the child name index of its parent.
+ */
+void
+XMLNode::tokenChanged ()
+{
+  invalidateHash();
+
+  XMLIdIndex* ids = getIdIndex();
+  if (ids != NULL) ids->add(*this);
+
+  if (mParent != NULL && mParent->hasChildNameIndex())
+  {
+    mParent->mNameIndex.rename(mParent->mChildren, mIndex);
+  }
+}
+/** @endcond */
+
+
 /**
  * Return a boolean indicating whether this XMLNode has a child with the given name.
  *
@@ -908,6 +1626,69 @@ XMLNode_hasChild (const XMLNode_t *node, const char*  name)
   return static_cast<int>( node->hasChild(name) );
 }
 
+
+LIBLX_EXTERN
+int
+XMLNode_getNextIndex (const XMLNode_t *node, unsigned int n)
+{
+  if (node == NULL) return -1;
+  return node->getNextIndex(n);
+}
+
+
+LIBLX_EXTERN
+size_t
+XMLNode_getHash (const XMLNode_t *node)
+{
+  if (node == NULL) return 0;
+  return node->getHash();
+}
+
+
+LIBLX_EXTERN
+int
+XMLNode_addIdAttribute (XMLNode_t *node, const char* name)
+{
+  if (node == NULL || name == NULL) return LIBLX_INVALID_OBJECT;
+  return node->addIdAttribute(name);
+}
+
+
+LIBLX_EXTERN
+const XMLNode_t *
+XMLNode_getNodeById (const XMLNode_t *node, const char* value)
+{
+  if (node == NULL || value == NULL) return NULL;
+  return node->getNodeById(value);
+}
+
+
+LIBLX_EXTERN
+const XMLNode_t *
+XMLNode_getParent (const XMLNode_t *node)
+{
+  if (node == NULL) return NULL;
+  return node->getParent();
+}
+
+
+LIBLX_EXTERN
+const XMLNode_t *
+XMLNode_getNextSibling (const XMLNode_t *node)
+{
+  if (node == NULL) return NULL;
+  return node->getNextSibling();
+}
+
+
+LIBLX_EXTERN
+const XMLNode_t *
+XMLNode_getPreviousSibling (const XMLNode_t *node)
+{
+  if (node == NULL) return NULL;
+  return node->getPreviousSibling();
+}
+
 LIBLX_EXTERN
 int 
 XMLNode_equals(const XMLNode_t *node, const XMLNode_t* other)
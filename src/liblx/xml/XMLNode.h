@@ -146,6 +146,17 @@ else:
 @endcode
 @endif
  *
+ * @section xmlnode-threads Thread safety
+ *
+ * An XMLNode tree that no thread changes may be read by any number of
+ * threads at once: every @c const method, including getChild(),
+ * getIndex(), getNextIndex(), getNodeById() and accept(), only reads the
+ * tree, and copying nodes out of it is safe as well.  The indexes that
+ * speed up lookups are kept up to date by the methods that change the
+ * tree, never built on demand by the ones that read it.  The one
+ * exception, getHash(), fills its cache under a lock of its own.  Changing a tree
+ * while other threads read it, or changing it from several threads, needs
+ * locking by the caller.  XMLNodeParallel walks a tree on several threads.
  */
 
 #ifndef XMLNode_h
@@ -153,6 +164,7 @@ else:
 
 #include <liblx/xml/common/extern.h>
 #include <liblx/xml/XMLToken.h>
+#include <liblx/xml/XMLChildNameIndex.h>
 #include <liblx/xml/common/liblxfwd.h>
 
 
@@ -168,6 +180,9 @@ class XMLInputStream;
 class XMLOutputStream;
 /** @endcond */
 
+class XMLIdIndex;
+class XMLNodeVisitor;
+
 
 class LIBLX_EXTERN XMLNode : public XMLToken
 {
@@ -264,6 +279,24 @@ public:
   /** @endcond */
 
 
+  /**
+   * Creates a new XMLNode by reading XMLTokens from stream, and sets up
+   * an index of its elements by the given identifier attributes.
+   *
+   * The stream must be positioned on a start element.  Each element is
+   * entered in the index as it is read, so the returned tree can answer
+   * getNodeById() straight away.
+   *
+   * @param stream XMLInputStream from which XMLNode is to be created.
+   * @param idAttributes the local names of the attributes to index,
+   * e.g., @c id and @c metaid.
+   *
+   * @see addIdAttribute()
+   */
+  XMLNode (XMLInputStream& stream,
+           const std::vector<std::string>& idAttributes);
+
+
   /**
    * Destroys this XMLNode.
    */
@@ -420,6 +453,34 @@ public:
   int getIndex (const std::string& name) const;
 
 
+  /**
+   * Return the index of the next child of this XMLNode that has the same
+   * name as the <code>n</code>th child.
+   *
+   * Together with getIndex(const std::string& name), this visits every
+   * child with a given name without scanning the others:
+   * @code{.cpp}
+for (int i = node.getIndex("species"); i != -1; i = node.getNextIndex(i))
+{
+  const XMLNode& species = node.getChild(i);
+  ...
+}
+   * @endcode
+   *
+   * Nodes with many children answer getIndex(), getChild(name),
+   * hasChild() and getNextIndex() from an index of their child names.
+   * The index is updated when children are added, inserted, removed, or
+   * renamed, whether through XMLToken::setTriple() or assignment, so
+   * lookups never change the node.
+   *
+   * @param n an unsigned integer, the index of a child of this XMLNode.
+   *
+   * @return the index of the next child with the same name, or @c -1 if
+   * there is none or @p n is out of range.
+   */
+  int getNextIndex (unsigned int n) const;
+
+
   /**
    * Return a boolean indicating whether this XMLNode has a child with the
    * given name.
@@ -431,6 +492,154 @@ public:
    */
   bool hasChild (const std::string& name) const;
 
+
+  /**
+   * Returns the XMLNode that has this XMLNode as a child.
+   *
+   * Only nodes that belong to a tree have a parent: addChild() and
+   * insertChild() attach the copy they make, removeChild() detaches the
+   * node it returns, and copies of a node start out as roots.
+   *
+   * @return the parent of this XMLNode, or @c NULL if it is a root.
+   */
+  XMLNode* getParent ();
+
+
+  /**
+   * Returns the XMLNode that has this XMLNode as a child.
+   *
+   * @return the parent of this XMLNode, or @c NULL if it is a root.
+   */
+  const XMLNode* getParent () const;
+
+
+  /**
+   * Returns the position of this XMLNode among the children of its
+   * parent, so that <code>getParent()->getChild(getIndexInParent())</code>
+   * is this node.
+   *
+   * @return the index of this XMLNode in its parent, or @c 0 if it is a
+   * root.
+   */
+  unsigned int getIndexInParent () const;
+
+
+  /**
+   * Returns the child of the parent of this XMLNode that follows it.
+   *
+   * @return the next sibling of this XMLNode, or @c NULL if it is the
+   * last child or a root.
+   */
+  XMLNode* getNextSibling ();
+
+
+  /**
+   * Returns the child of the parent of this XMLNode that follows it.
+   *
+   * @return the next sibling of this XMLNode, or @c NULL if it is the
+   * last child or a root.
+   */
+  const XMLNode* getNextSibling () const;
+
+
+  /**
+   * Returns the child of the parent of this XMLNode that precedes it.
+   *
+   * @return the previous sibling of this XMLNode, or @c NULL if it is
+   * the first child or a root.
+   */
+  XMLNode* getPreviousSibling ();
+
+
+  /**
+   * Returns the child of the parent of this XMLNode that precedes it.
+   *
+   * @return the previous sibling of this XMLNode, or @c NULL if it is
+   * the first child or a root.
+   */
+  const XMLNode* getPreviousSibling () const;
+
+
+  /**
+   * Walks the tree rooted at this XMLNode, calling XMLNodeVisitor::enter()
+   * on each node before its children and XMLNodeVisitor::leave() after
+   * them.  The walk follows parent and sibling links rather than
+   * recursing, so it works on trees of any depth.
+   *
+   * @param visitor the visitor that receives the nodes.
+   *
+   * @return @c true if the whole tree was visited, @c false if the
+   * visitor ended the walk.
+   *
+   * @see XMLNodeIterator
+   */
+  bool accept (XMLNodeVisitor& visitor) const;
+
+
+  /**
+   * Makes @p name an identifier attribute of the tree rooted at this
+   * XMLNode.
+   *
+   * The first call gives the root an XMLIdIndex.  Every element in the
+   * tree whose attribute @p name is set is entered in the index under
+   * the attribute value, and the index then follows the subtrees added
+   * and removed anywhere in the tree, and the attributes changed on its
+   * elements.
+   *
+   * @param name the local name of the attribute, e.g., @c id.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_XML_OPERATION, OperationReturnValues_t}
+   *
+   * @note Only a root can own an index; on a node that has a parent this
+   * method fails with @sbmlconstant{LIBLX_INVALID_XML_OPERATION, OperationReturnValues_t}.
+   */
+  int addIdAttribute (const std::string& name);
+
+
+  /**
+   * Returns the identifier index of the tree this XMLNode belongs to.
+   *
+   * @return the XMLIdIndex of the root of this tree, or @c NULL if it has
+   * none.
+   */
+  XMLIdIndex* getIdIndex ();
+
+
+  /**
+   * Returns the identifier index of the tree this XMLNode belongs to.
+   *
+   * @return the XMLIdIndex of the root of this tree, or @c NULL if it has
+   * none.
+   */
+  const XMLIdIndex* getIdIndex () const;
+
+
+  /**
+   * Returns the element of the tree this XMLNode belongs to whose
+   * identifier attribute has the given value.
+   *
+   * @param value the identifier to look up.
+   *
+   * @return the element, or @c NULL if there is none or the tree has no
+   * identifier index.
+   */
+  XMLNode* getNodeById (const std::string& value);
+
+
+  /**
+   * Returns the element of the tree this XMLNode belongs to whose
+   * identifier attribute has the given value.
+   *
+   * @param value the identifier to look up.
+   *
+   * @return the element, or @c NULL if there is none or the tree has no
+   * identifier index.
+   */
+  const XMLNode* getNodeById (const std::string& value) const;
+
 	
   /**
    * Compare this XMLNode against another XMLNode returning true if both
@@ -448,6 +657,41 @@ public:
    * tree as another.
    */
   bool equals(const XMLNode& other, bool ignoreURI=false, bool ignoreAttributeValues=false) const;
+
+
+  /**
+   * Returns a structural hash of the tree rooted at this XMLNode, for the
+   * comparison equals() makes with the same options.
+   *
+   * The hash of a node combines its name, its namespace URI unless
+   * @p ignoreURI is @c true, the local names of its attributes and,
+   * unless @p ignoreAttributeValues is @c true, their values, in any
+   * order, and the hashes of its children, in order.  Like equals(), it
+   * ignores text content and namespace declarations.  Trees that
+   * equals() finds equal therefore have the same hash, and the hash and
+   * equals() can serve as the hash and equality functions of a hash
+   * container of nodes.
+   *
+   * Hashes are cached on every node of the tree and marked out of date,
+   * up to the root, whenever a node or its children change, so asking
+   * again for the hash of a tree that has only partly changed rehashes
+   * only the changed nodes and their ancestors.  While both nodes have
+   * up-to-date hashes, equals() returns @c false at once, without walking
+   * the trees, if their hashes differ.
+   *
+   * @param ignoreURI whether to leave namespace URIs out of the hash.
+   *
+   * @param ignoreAttributeValues whether to leave attribute values out of
+   * the hash.
+   *
+   * @return the hash.
+   *
+   * @note equals() matches attributes by local name only, so it may find
+   * an element with two attributes of the same local name equal to
+   * elements with different attributes and hashes.  It never relies on
+   * the hash of such a tree.
+   */
+  size_t getHash (bool ignoreURI=false, bool ignoreAttributeValues=false) const;
 	
 
   /**
@@ -545,7 +789,80 @@ public:
 
 protected:
   /** @cond doxygenLibsbmlInternal */
+
+  /**
+   * Reads the children of this start element from stream, up to and
+   * including its end element.
+   */
+  void readChildren (XMLInputStream& stream);
+
+
+  /**
+   * Inserts child, which this XMLNode takes ownership of, as its nth
+   * child.
+   *
+   * @return child.
+   */
+  XMLNode* adoptChild (XMLNode* child, unsigned int n);
+
+
+  /**
+   * Updates the index in parent of the children from the nth on.
+   */
+  void renumberChildren (unsigned int n);
+
+
+  /**
+   * Child name index: the children of each name, in order.  Kept up to
+   * date by every change to the children of a node with
+   * XMLNameIndex::Threshold or more of them, and by tokenChanged() when
+   * a child is renamed, so that lookups only read it.
+   */
+  bool hasChildNameIndex () const;
+  void indexChild (unsigned int n);
+  void unindexChild (unsigned int n);
+  void clearChildNameIndex ();
+  void updateChildNameIndex ();
+
+
+  /**
+   * Structural hash: mHash holds the hash for each combination of the
+   * options of getHash(), with ignoreURI as bit 0 and
+   * ignoreAttributeValues as bit 1, and at ContentHash a hash of all the
+   * tree holds (text, namespace declarations, attribute order and all),
+   * valid while mHashValid is nonzero.  The hashes of a node are only
+   * ever up to date if those of all its descendants are.  mHashExact is
+   * false if an element of the tree has two attributes with the same
+   * local name.
+   */
+  static const unsigned int ContentHash = 4;
+
+  void   computeHash () const;
+  void   copyHash (const XMLNode& orig);
+  void   invalidateHash ();
+  size_t getContentHash () const;
+  virtual void tokenChanged ();
+
+
+  /**
+   * Replaces the token of this XMLNode by token, keeping its children.
+   */
+  void setToken (const XMLToken& token);
+
+  friend class XMLCompactNode;
+  friend class XMLNodeDiff;
+
+
   std::vector<XMLNode*> mChildren;
+  XMLNode*              mParent;
+  unsigned int          mIndex;
+  XMLIdIndex*           mIdIndex;
+
+  XMLChildNameIndex     mNameIndex;
+
+  mutable size_t        mHash[ContentHash + 1];
+  mutable volatile long mHashValid;
+  mutable bool          mHashExact;
 
   /** @endcond */
 };
@@ -917,6 +1234,103 @@ LIBLX_EXTERN
 int
 XMLNode_hasChild (const XMLNode_t *node, const char*  name);
 
+
+/**
+ * Returns the parent of the XMLNode_t structure node.
+ *
+ * @param node XMLNode_t structure to be queried.
+ *
+ * @return the parent of node, or @c NULL if node is a root.
+ *
+ * @memberof XMLNode_t
+ */
+LIBLX_EXTERN
+const XMLNode_t *
+XMLNode_getParent (const XMLNode_t *node);
+
+
+/**
+ * Makes name an identifier attribute of the tree rooted at the XMLNode_t
+ * structure node.
+ *
+ * @param node XMLNode_t structure, the root of a tree.
+ * @param name the local name of the attribute.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_XML_OPERATION, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLNode_t
+ */
+LIBLX_EXTERN
+int
+XMLNode_addIdAttribute (XMLNode_t *node, const char* name);
+
+
+/**
+ * Returns the element of the tree the XMLNode_t structure node belongs to
+ * whose identifier attribute has the given value.
+ *
+ * @param node XMLNode_t structure to be queried.
+ * @param value the identifier to look up.
+ *
+ * @return the element, or @c NULL if there is none.
+ *
+ * @memberof XMLNode_t
+ */
+LIBLX_EXTERN
+const XMLNode_t *
+XMLNode_getNodeById (const XMLNode_t *node, const char* value);
+
+
+/**
+ * Return the index of the next child of the XMLNode_t structure node that
+ * has the same name as its nth child.
+ *
+ * @param node XMLNode_t structure to be queried.
+ * @param n the index of a child of node.
+ *
+ * @return the index of the next child with the same name, or @c -1 if
+ * there is none.
+ *
+ * @memberof XMLNode_t
+ */
+LIBLX_EXTERN
+int
+XMLNode_getNextIndex (const XMLNode_t *node, unsigned int n);
+
+
+/**
+ * Returns the child of the parent of the XMLNode_t structure node that
+ * follows node.
+ *
+ * @param node XMLNode_t structure to be queried.
+ *
+ * @return the next sibling of node, or @c NULL if there is none.
+ *
+ * @memberof XMLNode_t
+ */
+LIBLX_EXTERN
+const XMLNode_t *
+XMLNode_getNextSibling (const XMLNode_t *node);
+
+
+/**
+ * Returns the child of the parent of the XMLNode_t structure node that
+ * precedes node.
+ *
+ * @param node XMLNode_t structure to be queried.
+ *
+ * @return the previous sibling of node, or @c NULL if there is none.
+ *
+ * @memberof XMLNode_t
+ */
+LIBLX_EXTERN
+const XMLNode_t *
+XMLNode_getPreviousSibling (const XMLNode_t *node);
+
 /**
  * Compare one XMLNode against another XMLNode returning @c 1 (true) if both nodes
  * represent the same XML tree, or @c 0 (false) otherwise.
@@ -934,6 +1348,22 @@ LIBLX_EXTERN
 int
 XMLNode_equals(const XMLNode_t *node, const XMLNode_t* other);
 
+
+/**
+ * Returns the structural hash of the tree rooted at the XMLNode_t
+ * structure node, which is the same for all trees that XMLNode_equals()
+ * finds equal.
+ *
+ * @param node XMLNode_t structure to be queried.
+ *
+ * @return the hash, or @c 0 if node is @c NULL.
+ *
+ * @memberof XMLNode_t
+ */
+LIBLX_EXTERN
+size_t
+XMLNode_getHash (const XMLNode_t *node);
+
 /**
  * Returns the number of children for this XMLNode_t structure.
  *
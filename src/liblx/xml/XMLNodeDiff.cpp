@@ -0,0 +1,1047 @@
+/**
+ * @file    XMLNodeDiff.cpp
+ * @brief   Edit scripts between XMLNode trees
+ *
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <map>
+#include <new>
+
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLNodeDiff.h>
+#include <liblx/xml/operationReturnValues.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+#ifdef __cplusplus
+
+
+/*
+ * Creates a new XMLNodeEdit.
+ */
+XMLNodeEdit::XMLNodeEdit (XMLNodeEditType_t                type,
+                          const std::vector<unsigned int>& path,
+                          const XMLNode*                   node,
+                          const XMLTriple&                 attribute,
+                          const std::string&               value) :
+   mType     ( type )
+ , mPath     ( path )
+ , mNode     ( (node != NULL) ? new XMLNode(*node) : NULL )
+ , mAttribute( attribute )
+ , mValue    ( value )
+{
+}
+
+
+/*
+ * Copy constructor; creates a copy of this XMLNodeEdit.
+ */
+XMLNodeEdit::XMLNodeEdit (const XMLNodeEdit& orig) :
+   mType     ( orig.mType )
+ , mPath     ( orig.mPath )
+ , mNode     ( (orig.mNode != NULL) ? new XMLNode(*orig.mNode) : NULL )
+ , mAttribute( orig.mAttribute )
+ , mValue    ( orig.mValue )
+{
+}
+
+
+/*
+ * Assignment operator for XMLNodeEdit.
+ */
+XMLNodeEdit&
+XMLNodeEdit::operator= (const XMLNodeEdit& rhs)
+{
+  if (&rhs != this)
+  {
+    XMLNode* node = (rhs.mNode != NULL) ? new XMLNode(*rhs.mNode) : NULL;
+    delete mNode;
+
+    mType      = rhs.mType;
+    mPath      = rhs.mPath;
+    mNode      = node;
+    mAttribute = rhs.mAttribute;
+    mValue     = rhs.mValue;
+  }
+
+  return *this;
+}
+
+
+/*
+ * Destroys this XMLNodeEdit.
+ */
+XMLNodeEdit::~XMLNodeEdit ()
+{
+  delete mNode;
+}
+
+
+/*
+ * @return the kind of this edit.
+ */
+XMLNodeEditType_t
+XMLNodeEdit::getType () const
+{
+  return mType;
+}
+
+
+/*
+ * @return the child indices that lead from the root to the node edited.
+ */
+const std::vector<unsigned int>&
+XMLNodeEdit::getPath () const
+{
+  return mPath;
+}
+
+
+/*
+ * @return the subtree inserted, or the node whose contents replace those
+ * of the node updated, or NULL.
+ */
+const XMLNode*
+XMLNodeEdit::getNode () const
+{
+  return mNode;
+}
+
+
+/*
+ * @return the attribute set or removed.
+ */
+const XMLTriple&
+XMLNodeEdit::getAttribute () const
+{
+  return mAttribute;
+}
+
+
+/*
+ * @return the value of the attribute set.
+ */
+const std::string&
+XMLNodeEdit::getValue () const
+{
+  return mValue;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+
+/*
+ * The largest table, in entries, that matching the children of two
+ * elements by longest common subsequence may take; children that would
+ * need a larger one are paired in order instead.
+ */
+static const size_t MaxMatchCells = 1 << 20;
+
+
+/*
+ * What happens to a child when the children of two elements are matched.
+ */
+enum ChildStep
+{
+    KeepChild       /* identical subtrees */
+  , CompareChild    /* similar nodes, compared in turn */
+  , DeleteChild
+  , InsertChild
+};
+
+
+struct ChildMatch
+{
+  ChildStep    step;
+  unsigned int from;
+  unsigned int to;
+};
+
+
+/*
+ * Two elements whose children have been matched, and how many of the
+ * steps have been turned into edits.  position is the index of the next
+ * child in the tree as the edits so far leave it.
+ */
+struct DiffFrame
+{
+  const XMLNode*     from;
+  const XMLNode*     to;
+  vector<ChildMatch> steps;
+  size_t             next;
+  unsigned int       position;
+};
+
+
+static void
+addStep (vector<ChildMatch>& steps, ChildStep step,
+         unsigned int from, unsigned int to)
+{
+  ChildMatch match = { step, from, to };
+  steps.push_back(match);
+}
+
+
+/*
+ * @return true if to can be reached from from by edits to the node
+ * itself: both are text nodes, or elements with the same name and
+ * namespace.
+ */
+static bool
+isSimilar (const XMLNode& from, const XMLNode& to)
+{
+  if (from.isText() || to.isText()) return from.isText() && to.isText();
+
+  return from.isStart() == to.isStart()
+      && from.getName() == to.getName()
+      && from.getURI()  == to.getURI();
+}
+
+
+/*
+ * @return true if from and to are the same kind of node, with the same
+ * name, namespace declarations and text; attributes are compared apart.
+ */
+static bool
+isSameToken (const XMLNode& from, const XMLNode& to)
+{
+  if (from.isStart()        != to.isStart()
+   || from.isText()         != to.isText()
+   || from.getName()        != to.getName()
+   || from.getURI()         != to.getURI()
+   || from.getPrefix()      != to.getPrefix()
+   || from.getCharacters()  != to.getCharacters()
+   || from.getNamespacesLength() != to.getNamespacesLength())
+  {
+    return false;
+  }
+
+  for (int i = 0; i < from.getNamespacesLength(); ++i)
+  {
+    if (from.getNamespacePrefix(i) != to.getNamespacePrefix(i)
+     || from.getNamespaceURI(i)    != to.getNamespaceURI(i))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/*
+ * @return true if from and to have the same attributes, in the same
+ * order.
+ */
+static bool
+isSameAttributes (const XMLNode& from, const XMLNode& to)
+{
+  const XMLAttributes& fromAttributes = from.getAttributes();
+  const XMLAttributes& toAttributes   = to.getAttributes();
+
+  if (fromAttributes.getLength() != toAttributes.getLength()) return false;
+
+  for (int i = 0; i < fromAttributes.getLength(); ++i)
+  {
+    if (fromAttributes.getName(i)   != toAttributes.getName(i)
+     || fromAttributes.getURI(i)    != toAttributes.getURI(i)
+     || fromAttributes.getPrefix(i) != toAttributes.getPrefix(i)
+     || fromAttributes.getValue(i)  != toAttributes.getValue(i))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/*
+ * @return true if the subtrees rooted at from and to hold the same
+ * content, as their content hashes claim.  Hashes can collide, so a
+ * match is only trusted once the trees have been compared node by node,
+ * as XMLCompactTree does before sharing a subtree.
+ */
+static bool
+isSameTree (const XMLNode& from, const XMLNode& to)
+{
+  vector< pair<const XMLNode*, const XMLNode*> > pending;
+  pending.push_back(make_pair(&from, &to));
+
+  while (!pending.empty())
+  {
+    const XMLNode& a = *pending.back().first;
+    const XMLNode& b = *pending.back().second;
+    pending.pop_back();
+
+    if (!isSameToken(a, b) || !isSameAttributes(a, b)
+        || a.getNumChildren() != b.getNumChildren())
+    {
+      return false;
+    }
+
+    for (unsigned int n = 0; n < a.getNumChildren(); ++n)
+    {
+      pending.push_back(make_pair(&a.getChild(n), &b.getChild(n)));
+    }
+  }
+
+  return true;
+}
+
+
+/*
+ * Adds the step for children whose content hashes are equal: they are
+ * kept if they really are identical, and otherwise compared, or deleted
+ * and inserted, like the children of a gap.
+ */
+static void
+keepStep (const XMLNode& from, const XMLNode& to, vector<ChildMatch>& steps,
+          unsigned int fromIndex, unsigned int toIndex)
+{
+  const XMLNode& fromChild = from.getChild(fromIndex);
+  const XMLNode& toChild   = to.getChild(toIndex);
+
+  if (isSameTree(fromChild, toChild))
+  {
+    addStep(steps, KeepChild, fromIndex, toIndex);
+  }
+  else if (isSimilar(fromChild, toChild))
+  {
+    addStep(steps, CompareChild, fromIndex, toIndex);
+  }
+  else
+  {
+    addStep(steps, DeleteChild, fromIndex, 0);
+    addStep(steps, InsertChild, 0, toIndex);
+  }
+}
+
+
+/*
+ * Pairs the children of from and to left between two identical ones:
+ * similar children are compared, in order, and the rest deleted or
+ * inserted.
+ */
+static void
+matchGap (const XMLNode& from, const XMLNode& to,
+          const vector<unsigned int>& gapFrom,
+          const vector<unsigned int>& gapTo,
+          vector<ChildMatch>& steps)
+{
+  size_t x = 0;
+  size_t y = 0;
+
+  while (x < gapFrom.size() && y < gapTo.size())
+  {
+    if (isSimilar(from.getChild(gapFrom[x]), to.getChild(gapTo[y])))
+    {
+      addStep(steps, CompareChild, gapFrom[x++], gapTo[y++]);
+    }
+    else if (gapFrom.size() - x >= gapTo.size() - y)
+    {
+      addStep(steps, DeleteChild, gapFrom[x++], 0);
+    }
+    else
+    {
+      addStep(steps, InsertChild, 0, gapTo[y++]);
+    }
+  }
+
+  for (; x < gapFrom.size(); ++x) addStep(steps, DeleteChild, gapFrom[x], 0);
+  for (; y < gapTo.size();   ++y) addStep(steps, InsertChild, 0, gapTo[y]);
+}
+
+
+/*
+ * Pairs the children of from and to, in the ranges [fromBegin, fromEnd)
+ * and [toBegin, toEnd), that occur exactly once in each range with the
+ * same hash, and keeps the longest run of such pairs that are in the same
+ * order on both sides, as a patience diff does.
+ *
+ * @return the pairs, in order.
+ */
+static vector< pair<unsigned int, unsigned int> >
+findUniqueAnchors (const vector<size_t>& fromHashes,
+                   const vector<size_t>& toHashes,
+                   unsigned int fromBegin, unsigned int fromEnd,
+                   unsigned int toBegin, unsigned int toEnd)
+{
+  struct Occurrences
+  {
+    unsigned int fromCount;
+    unsigned int toCount;
+    unsigned int toPosition;
+  };
+
+  map<size_t, Occurrences> occurrences;
+  Occurrences none = { 0, 0, 0 };
+
+  for (unsigned int i = fromBegin; i < fromEnd; ++i)
+  {
+    map<size_t, Occurrences>::iterator it =
+      occurrences.insert(make_pair(fromHashes[i], none)).first;
+    ++it->second.fromCount;
+  }
+
+  for (unsigned int j = toBegin; j < toEnd; ++j)
+  {
+    map<size_t, Occurrences>::iterator it = occurrences.find(toHashes[j]);
+    if (it == occurrences.end()) continue;
+
+    ++it->second.toCount;
+    it->second.toPosition = j;
+  }
+
+  vector< pair<unsigned int, unsigned int> > unique;
+
+  for (unsigned int i = fromBegin; i < fromEnd; ++i)
+  {
+    const Occurrences& found = occurrences[fromHashes[i]];
+    if (found.fromCount == 1 && found.toCount == 1)
+    {
+      unique.push_back(make_pair(i, found.toPosition));
+    }
+  }
+
+  // longest increasing run of to positions: tails[k] ends the best run
+  // of length k + 1 found so far, and previous links each pair to the one
+  // before it in its run
+  vector<size_t> tails;
+  vector<size_t> previous(unique.size());
+
+  for (size_t n = 0; n < unique.size(); ++n)
+  {
+    size_t low  = 0;
+    size_t high = tails.size();
+
+    while (low < high)
+    {
+      size_t middle = (low + high) / 2;
+      if (unique[tails[middle]].second < unique[n].second) low = middle + 1;
+      else high = middle;
+    }
+
+    previous[n] = (low > 0) ? tails[low - 1] : n;
+    if (low == tails.size()) tails.push_back(n); else tails[low] = n;
+  }
+
+  vector< pair<unsigned int, unsigned int> > anchors(tails.size());
+
+  if (!tails.empty())
+  {
+    size_t n = tails.back();
+    for (size_t k = anchors.size(); k > 0; --k)
+    {
+      anchors[k - 1] = unique[n];
+      n = previous[n];
+    }
+  }
+
+  return anchors;
+}
+
+
+/*
+ * Matches the children of from and to in the ranges [fromBegin, fromEnd)
+ * and [toBegin, toEnd), given their subtree hashes: the leading and
+ * trailing children with the same hashes, then, in between, the longest
+ * common subsequence of hashes, and then similar children in the gaps
+ * left.  Where the table for the longest common subsequence would be too
+ * large, children whose hashes are unique on both sides serve as
+ * anchors instead, and the ranges between them are matched in turn.
+ * keepStep() checks each pair matched by hash before keeping it.
+ */
+static void
+matchRange (const XMLNode& from, const XMLNode& to,
+            const vector<size_t>& fromHashes,
+            const vector<size_t>& toHashes,
+            unsigned int fromBegin, unsigned int fromEnd,
+            unsigned int toBegin, unsigned int toEnd,
+            vector<ChildMatch>& steps)
+{
+  while (fromBegin < fromEnd && toBegin < toEnd
+         && fromHashes[fromBegin] == toHashes[toBegin])
+  {
+    keepStep(from, to, steps, fromBegin++, toBegin++);
+  }
+
+  unsigned int suffix = 0;
+  while (fromBegin < fromEnd - suffix && toBegin < toEnd - suffix
+         && fromHashes[fromEnd - suffix - 1] == toHashes[toEnd - suffix - 1])
+  {
+    ++suffix;
+  }
+
+  const unsigned int midFrom = fromEnd - suffix - fromBegin;
+  const unsigned int midTo   = toEnd   - suffix - toBegin;
+
+  vector<unsigned int> gapFrom;
+  vector<unsigned int> gapTo;
+  unsigned int i = 0;
+  unsigned int j = 0;
+
+  if (midFrom > 0 && midTo > 0
+      && (size_t)(midFrom + 1) * (midTo + 1) <= MaxMatchCells)
+  {
+    // lengths of the common subsequences of the remaining hashes
+    const size_t     width = midTo + 1;
+    vector<unsigned> common((midFrom + 1) * width, 0);
+
+    for (unsigned int a = midFrom; a > 0; --a)
+    {
+      for (unsigned int b = midTo; b > 0; --b)
+      {
+        size_t cell = (a - 1) * width + (b - 1);
+
+        if (fromHashes[fromBegin + a - 1] == toHashes[toBegin + b - 1])
+        {
+          common[cell] = common[cell + width + 1] + 1;
+        }
+        else
+        {
+          common[cell] = max(common[cell + width], common[cell + 1]);
+        }
+      }
+    }
+
+    while (i < midFrom && j < midTo)
+    {
+      if (fromHashes[fromBegin + i] == toHashes[toBegin + j])
+      {
+        matchGap(from, to, gapFrom, gapTo, steps);
+        gapFrom.clear();
+        gapTo.clear();
+        keepStep(from, to, steps, fromBegin + i++, toBegin + j++);
+      }
+      else if (common[(i + 1) * width + j] >= common[i * width + j + 1])
+      {
+        gapFrom.push_back(fromBegin + i++);
+      }
+      else
+      {
+        gapTo.push_back(toBegin + j++);
+      }
+    }
+  }
+  else if (midFrom > 0 && midTo > 0)
+  {
+    vector< pair<unsigned int, unsigned int> > anchors =
+      findUniqueAnchors(fromHashes, toHashes, fromBegin, fromBegin + midFrom,
+                        toBegin, toBegin + midTo);
+
+    for (size_t n = 0; n < anchors.size(); ++n)
+    {
+      matchRange(from, to, fromHashes, toHashes,
+                 fromBegin + i, anchors[n].first,
+                 toBegin + j, anchors[n].second, steps);
+      keepStep(from, to, steps, anchors[n].first, anchors[n].second);
+      i = anchors[n].first  + 1 - fromBegin;
+      j = anchors[n].second + 1 - toBegin;
+    }
+
+    if (!anchors.empty())
+    {
+      matchRange(from, to, fromHashes, toHashes,
+                 fromBegin + i, fromBegin + midFrom,
+                 toBegin + j, toBegin + midTo, steps);
+      i = midFrom;
+      j = midTo;
+    }
+  }
+
+  for (; i < midFrom; ++i) gapFrom.push_back(fromBegin + i);
+  for (; j < midTo;   ++j) gapTo.push_back(toBegin + j);
+  matchGap(from, to, gapFrom, gapTo, steps);
+
+  for (unsigned int n = suffix; n > 0; --n)
+  {
+    keepStep(from, to, steps, fromEnd - n, toEnd - n);
+  }
+}
+
+
+/*
+ * Starts a frame for the children of from and to.
+ */
+static void
+startFrame (DiffFrame& frame, const XMLNode& from, const XMLNode& to,
+            const vector<size_t>& fromHashes, const vector<size_t>& toHashes)
+{
+  frame.from     = &from;
+  frame.to       = &to;
+  frame.next     = 0;
+  frame.position = 0;
+  matchRange(from, to, fromHashes, toHashes,
+             0, (unsigned int)fromHashes.size(),
+             0, (unsigned int)toHashes.size(), frame.steps);
+}
+
+/** @endcond */
+
+
+/*
+ * Creates a new, empty XMLNodeDiff, which changes nothing.
+ */
+XMLNodeDiff::XMLNodeDiff () :
+   mEdits()
+{
+}
+
+
+/*
+ * Creates a new XMLNodeDiff holding the edits that turn the tree rooted
+ * at from into the tree rooted at to.
+ */
+XMLNodeDiff::XMLNodeDiff (const XMLNode& from, const XMLNode& to) :
+   mEdits()
+{
+  compute(from, to);
+}
+
+
+/*
+ * Copy constructor; creates a copy of this XMLNodeDiff.
+ */
+XMLNodeDiff::XMLNodeDiff (const XMLNodeDiff& orig) :
+   mEdits()
+{
+  for (size_t n = 0; n < orig.mEdits.size(); ++n)
+  {
+    mEdits.push_back(new XMLNodeEdit(*orig.mEdits[n]));
+  }
+}
+
+
+/*
+ * Assignment operator for XMLNodeDiff.
+ */
+XMLNodeDiff&
+XMLNodeDiff::operator= (const XMLNodeDiff& rhs)
+{
+  if (&rhs != this)
+  {
+    clear();
+
+    for (size_t n = 0; n < rhs.mEdits.size(); ++n)
+    {
+      mEdits.push_back(new XMLNodeEdit(*rhs.mEdits[n]));
+    }
+  }
+
+  return *this;
+}
+
+
+/*
+ * Destroys this XMLNodeDiff.
+ */
+XMLNodeDiff::~XMLNodeDiff ()
+{
+  clear();
+}
+
+
+/*
+ * @return the number of edits in this XMLNodeDiff.
+ */
+unsigned int
+XMLNodeDiff::getNumEdits () const
+{
+  return (unsigned int)mEdits.size();
+}
+
+
+/*
+ * @return the nth edit, or NULL if n is out of range.
+ */
+const XMLNodeEdit*
+XMLNodeDiff::getEdit (unsigned int n) const
+{
+  return (n < mEdits.size()) ? mEdits[n] : NULL;
+}
+
+
+/*
+ * @return true if this XMLNodeDiff changes nothing.
+ */
+bool
+XMLNodeDiff::isEmpty () const
+{
+  return mEdits.empty();
+}
+
+
+/*
+ * Appends an edit to this XMLNodeDiff.
+ */
+void
+XMLNodeDiff::addEdit (const XMLNodeEdit& edit)
+{
+  mEdits.push_back(new XMLNodeEdit(edit));
+}
+
+
+/*
+ * Applies the edits of this XMLNodeDiff, in order, to the tree rooted at
+ * root.
+ */
+int
+XMLNodeDiff::apply (XMLNode& root) const
+{
+  for (size_t n = 0; n < mEdits.size(); ++n)
+  {
+    int result = applyEdit(*mEdits[n], root);
+    if (result != LIBLX_OPERATION_SUCCESS) return result;
+  }
+
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Records the edits that turn from into to.  The pairs of elements whose
+ * children are matched are kept on a stack, so that deep trees need no
+ * recursion, and the edits come out in document order, each path
+ * reflecting the edits before it.
+ */
+void
+XMLNodeDiff::compute (const XMLNode& from, const XMLNode& to)
+{
+  if (from.getContentHash() == to.getContentHash() && isSameTree(from, to))
+  {
+    return;
+  }
+
+  vector<unsigned int> path;
+  vector<DiffFrame>    frames;
+  vector<size_t>       fromHashes;
+  vector<size_t>       toHashes;
+
+  compareTokens(from, to, path);
+  hashChildren(from, fromHashes);
+  hashChildren(to, toHashes);
+  frames.push_back(DiffFrame());
+  startFrame(frames.back(), from, to, fromHashes, toHashes);
+
+  while (!frames.empty())
+  {
+    DiffFrame& frame = frames.back();
+
+    if (frame.next == frame.steps.size())
+    {
+      frames.pop_back();
+
+      if (!frames.empty())
+      {
+        path.pop_back();
+        ++frames.back().position;
+      }
+      continue;
+    }
+
+    const ChildMatch match = frame.steps[frame.next++];
+
+    if (match.step == KeepChild)
+    {
+      ++frame.position;
+    }
+    else if (match.step == DeleteChild)
+    {
+      path.push_back(frame.position);
+      mEdits.push_back(new XMLNodeEdit(LIBLX_EDIT_DELETE_NODE, path));
+      path.pop_back();
+    }
+    else if (match.step == InsertChild)
+    {
+      path.push_back(frame.position++);
+      mEdits.push_back(new XMLNodeEdit(LIBLX_EDIT_INSERT_NODE, path,
+                                       &frame.to->getChild(match.to)));
+      path.pop_back();
+    }
+    else
+    {
+      const XMLNode& fromChild = frame.from->getChild(match.from);
+      const XMLNode& toChild   = frame.to->getChild(match.to);
+
+      path.push_back(frame.position);
+      compareTokens(fromChild, toChild, path);
+      hashChildren(fromChild, fromHashes);
+      hashChildren(toChild, toHashes);
+
+      // frame is not used past this point, as the push may move it
+      frames.push_back(DiffFrame());
+      startFrame(frames.back(), fromChild, toChild, fromHashes, toHashes);
+    }
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Records the edits that turn the node from itself, without its children,
+ * into to: the attributes set and removed if only they differ and those
+ * edits leave them in the order of to, or else an update of the whole
+ * node.
+ */
+void
+XMLNodeDiff::compareTokens (const XMLNode& from, const XMLNode& to,
+                            const std::vector<unsigned int>& path)
+{
+  if (!isSameToken(from, to))
+  {
+    XMLNode token(static_cast<const XMLToken&>(to));
+    mEdits.push_back(new XMLNodeEdit(LIBLX_EDIT_UPDATE_NODE, path, &token));
+    return;
+  }
+
+  if (!from.isStart()) return;
+
+  const XMLAttributes& fromAttributes = from.getAttributes();
+  const XMLAttributes& toAttributes   = to.getAttributes();
+
+  vector<XMLNodeEdit*> edits;
+  vector<int>          order;   // indices in to of the attributes left
+
+  for (int i = 0; i < fromAttributes.getLength(); ++i)
+  {
+    int j = toAttributes.getIndex(fromAttributes.getName(i),
+                                  fromAttributes.getURI(i));
+    if (j != -1)
+    {
+      order.push_back(j);
+      continue;
+    }
+
+    XMLTriple attribute(fromAttributes.getName(i), fromAttributes.getURI(i),
+                        fromAttributes.getPrefix(i));
+    edits.push_back(new XMLNodeEdit(LIBLX_EDIT_REMOVE_ATTRIBUTE, path, NULL,
+                                    attribute));
+  }
+
+  for (int j = 0; j < toAttributes.getLength(); ++j)
+  {
+    int i = fromAttributes.getIndex(toAttributes.getName(j),
+                                    toAttributes.getURI(j));
+    if (i == -1)
+    {
+      order.push_back(j);
+    }
+    else if (fromAttributes.getValue(i)  == toAttributes.getValue(j)
+          && fromAttributes.getPrefix(i) == toAttributes.getPrefix(j))
+    {
+      continue;
+    }
+
+    XMLTriple attribute(toAttributes.getName(j), toAttributes.getURI(j),
+                        toAttributes.getPrefix(j));
+    edits.push_back(new XMLNodeEdit(LIBLX_EDIT_SET_ATTRIBUTE, path, NULL,
+                                    attribute, toAttributes.getValue(j)));
+  }
+
+  bool inOrder = (order.size() == (size_t)toAttributes.getLength());
+  for (size_t n = 0; inOrder && n < order.size(); ++n)
+  {
+    inOrder = (order[n] == (int)n);
+  }
+
+  if (inOrder)
+  {
+    mEdits.insert(mEdits.end(), edits.begin(), edits.end());
+    return;
+  }
+
+  for (size_t n = 0; n < edits.size(); ++n)
+  {
+    delete edits[n];
+  }
+
+  XMLNode token(static_cast<const XMLToken&>(to));
+  mEdits.push_back(new XMLNodeEdit(LIBLX_EDIT_UPDATE_NODE, path, &token));
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Fills hashes with the content hashes of the children of node.
+ */
+void
+XMLNodeDiff::hashChildren (const XMLNode& node, std::vector<size_t>& hashes)
+{
+  hashes.resize(node.getNumChildren());
+
+  for (unsigned int n = 0; n < node.getNumChildren(); ++n)
+  {
+    hashes[n] = node.getChild(n).getContentHash();
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Deletes all edits.
+ */
+void
+XMLNodeDiff::clear ()
+{
+  for (size_t n = 0; n < mEdits.size(); ++n)
+  {
+    delete mEdits[n];
+  }
+
+  mEdits.clear();
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Applies edit to the tree rooted at root.
+ */
+int
+XMLNodeDiff::applyEdit (const XMLNodeEdit& edit, XMLNode& root)
+{
+  const vector<unsigned int>& path     = edit.getPath();
+  const XMLNodeEditType_t     type     = edit.getType();
+  const bool                  forChild = (type == LIBLX_EDIT_INSERT_NODE
+                                       || type == LIBLX_EDIT_DELETE_NODE);
+
+  if (forChild && path.empty()) return LIBLX_INVALID_XML_OPERATION;
+
+  // the node edited, or the parent of the child inserted or deleted
+  XMLNode* node  = &root;
+  size_t   depth = path.size() - (forChild ? 1 : 0);
+
+  for (size_t n = 0; n < depth; ++n)
+  {
+    if (path[n] >= node->getNumChildren()) return LIBLX_INVALID_XML_OPERATION;
+    node = &node->getChild(path[n]);
+  }
+
+  switch (type)
+  {
+  case LIBLX_EDIT_INSERT_NODE:
+    if (edit.getNode() == NULL || path.back() > node->getNumChildren())
+    {
+      return LIBLX_INVALID_XML_OPERATION;
+    }
+
+    if (path.back() == node->getNumChildren())
+    {
+      return node->addChild(*edit.getNode());
+    }
+
+    node->insertChild(path.back(), *edit.getNode());
+    return LIBLX_OPERATION_SUCCESS;
+
+  case LIBLX_EDIT_DELETE_NODE:
+    if (path.back() >= node->getNumChildren())
+    {
+      return LIBLX_INVALID_XML_OPERATION;
+    }
+
+    delete node->removeChild(path.back());
+    return LIBLX_OPERATION_SUCCESS;
+
+  case LIBLX_EDIT_UPDATE_NODE:
+    if (edit.getNode() == NULL) return LIBLX_INVALID_XML_OPERATION;
+
+    node->setToken(*edit.getNode());
+    return LIBLX_OPERATION_SUCCESS;
+
+  case LIBLX_EDIT_SET_ATTRIBUTE:
+    if (node->addAttr(edit.getAttribute(), edit.getValue())
+        != LIBLX_OPERATION_SUCCESS)
+    {
+      return LIBLX_INVALID_XML_OPERATION;
+    }
+    return LIBLX_OPERATION_SUCCESS;
+
+  case LIBLX_EDIT_REMOVE_ATTRIBUTE:
+    if (node->removeAttr(edit.getAttribute()) != LIBLX_OPERATION_SUCCESS)
+    {
+      return LIBLX_INVALID_XML_OPERATION;
+    }
+    return LIBLX_OPERATION_SUCCESS;
+
+  default:
+    return LIBLX_INVALID_XML_OPERATION;
+  }
+}
+/** @endcond */
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLNodeDiff_t *
+XMLNodeDiff_create (const XMLNode_t *from, const XMLNode_t *to)
+{
+  if (from == NULL || to == NULL) return NULL;
+  return new(nothrow) XMLNodeDiff(*from, *to);
+}
+
+
+LIBLX_EXTERN
+void
+XMLNodeDiff_free (XMLNodeDiff_t *diff)
+{
+  delete static_cast<XMLNodeDiff*>(diff);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLNodeDiff_getNumEdits (const XMLNodeDiff_t *diff)
+{
+  return (diff != NULL) ? diff->getNumEdits() : 0;
+}
+
+
+LIBLX_EXTERN
+int
+XMLNodeDiff_apply (const XMLNodeDiff_t *diff, XMLNode_t *root)
+{
+  if (diff == NULL || root == NULL) return LIBLX_INVALID_OBJECT;
+  return diff->apply(*root);
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,404 @@
+/**
+ * @file    XMLNodeDiff.h
+ * @brief   Edit scripts between XMLNode trees
+ *
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ *
+ * @class XMLNodeDiff
+ * @sbmlbrief{core} An edit script that turns one XMLNode tree into
+ * another.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * Keeping many versions of a large document whole, and comparing them by
+ * serializing and diffing the text, costs time and space in proportion to
+ * the size of the document.  An XMLNodeDiff computed between two trees
+ * instead holds only what differs between them, as a list of
+ * XMLNodeEdit objects: subtrees inserted or deleted, nodes whose name,
+ * namespaces, text or attributes changed, and attributes set or removed.
+ * apply() replays the edits on a copy of the first tree to turn it into
+ * the second:
+ * @code{.cpp}
+XMLNodeDiff diff(version1, version2);
+
+XMLNode copy(version1);
+diff.apply(copy);    // copy now equals version2
+@endcode
+ *
+ * The trees are compared through the hashes that XMLNode caches for each
+ * of its subtrees (see XMLNode::getHash()), over everything the nodes
+ * hold: names, namespace declarations, attributes in order, and text.
+ * Subtrees with different hashes are known to differ.  Subtrees with the
+ * same hash are compared node by node before they are taken to be
+ * identical, since two different subtrees can have the same hash; that
+ * walk compares without diffing, and the diff itself is only computed
+ * for the parts of the trees that do differ.
+ *
+ * Among the children of two elements that differ, those with the same
+ * subtree hash are matched first, in order, as in a line-based text diff;
+ * of the children left in between, elements with the same name and
+ * namespace, or two text nodes, are compared in turn, and the others are
+ * deleted or inserted whole.
+ */
+
+/**
+ * @class XMLNodeEdit
+ * @sbmlbrief{core} One step of an XMLNodeDiff.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * Each edit applies to the node reached from the root of the tree by
+ * following its path, a list of child indices.  For insertions and
+ * deletions the last index is the position, among the children of the
+ * node reached by the others, of the child to insert or delete.  Paths
+ * refer to the tree as earlier edits of the same XMLNodeDiff have left
+ * it.
+ */
+
+#ifndef XMLNodeDiff_h
+#define XMLNodeDiff_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+LIBLX_CPP_NAMESPACE_BEGIN
+BEGIN_C_DECLS
+
+/**
+ * @enum XMLNodeEditType_t
+ * The kinds of XMLNodeEdit.
+ */
+typedef enum
+{
+    LIBLX_EDIT_INSERT_NODE      = 0 /*!< Insert a copy of a subtree. */
+  , LIBLX_EDIT_DELETE_NODE          /*!< Delete a subtree. */
+  , LIBLX_EDIT_UPDATE_NODE          /*!< Replace the name, namespaces,
+                                     *   attributes or text of a node,
+                                     *   keeping its children. */
+  , LIBLX_EDIT_SET_ATTRIBUTE        /*!< Add an attribute to an element,
+                                     *   or change its value and prefix. */
+  , LIBLX_EDIT_REMOVE_ATTRIBUTE     /*!< Remove an attribute from an
+                                     *   element. */
+} XMLNodeEditType_t;
+
+END_C_DECLS
+LIBLX_CPP_NAMESPACE_END
+
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/XMLTriple.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLNode;
+
+
+class LIBLX_EXTERN XMLNodeEdit
+{
+public:
+
+  /**
+   * Creates a new XMLNodeEdit.
+   *
+   * @param type the kind of edit.
+   * @param path the child indices that lead from the root to the node
+   * edited.
+   * @param node for @sbmlconstant{LIBLX_EDIT_INSERT_NODE, XMLNodeEditType_t},
+   * the subtree to insert; for
+   * @sbmlconstant{LIBLX_EDIT_UPDATE_NODE, XMLNodeEditType_t}, a node whose
+   * name, namespaces, attributes and text replace those of the node
+   * edited (its children are ignored).  Otherwise @c NULL.  The edit keeps
+   * a copy.
+   * @param attribute the name, namespace URI and prefix of the attribute
+   * set or removed.
+   * @param value the value of the attribute set.
+   */
+  XMLNodeEdit (XMLNodeEditType_t                type,
+               const std::vector<unsigned int>& path,
+               const XMLNode*                   node      = NULL,
+               const XMLTriple&                 attribute = XMLTriple(),
+               const std::string&               value     = "");
+
+
+  /**
+   * Copy constructor; creates a copy of this XMLNodeEdit.
+   *
+   * @param orig the XMLNodeEdit instance to copy.
+   */
+  XMLNodeEdit (const XMLNodeEdit& orig);
+
+
+  /**
+   * Assignment operator for XMLNodeEdit.
+   *
+   * @param rhs the XMLNodeEdit object whose values are used as the basis
+   * of the assignment.
+   */
+  XMLNodeEdit& operator= (const XMLNodeEdit& rhs);
+
+
+  /**
+   * Destroys this XMLNodeEdit.
+   */
+  ~XMLNodeEdit ();
+
+
+  /**
+   * @return the kind of this edit.
+   */
+  XMLNodeEditType_t getType () const;
+
+
+  /**
+   * @return the child indices that lead from the root to the node edited.
+   */
+  const std::vector<unsigned int>& getPath () const;
+
+
+  /**
+   * @return the subtree inserted, or the node whose contents replace those
+   * of the node updated, or @c NULL for other edits.
+   */
+  const XMLNode* getNode () const;
+
+
+  /**
+   * @return the attribute set or removed.
+   */
+  const XMLTriple& getAttribute () const;
+
+
+  /**
+   * @return the value of the attribute set.
+   */
+  const std::string& getValue () const;
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  XMLNodeEditType_t         mType;
+  std::vector<unsigned int> mPath;
+  XMLNode*                  mNode;
+  XMLTriple                 mAttribute;
+  std::string               mValue;
+
+  /** @endcond */
+};
+
+
+class LIBLX_EXTERN XMLNodeDiff
+{
+public:
+
+  /**
+   * Creates a new, empty XMLNodeDiff, which changes nothing.
+   */
+  XMLNodeDiff ();
+
+
+  /**
+   * Creates a new XMLNodeDiff holding the edits that turn the tree rooted
+   * at @p from into the tree rooted at @p to.
+   *
+   * @param from the tree to start from.
+   * @param to the tree to arrive at.
+   */
+  XMLNodeDiff (const XMLNode& from, const XMLNode& to);
+
+
+  /**
+   * Copy constructor; creates a copy of this XMLNodeDiff.
+   *
+   * @param orig the XMLNodeDiff instance to copy.
+   */
+  XMLNodeDiff (const XMLNodeDiff& orig);
+
+
+  /**
+   * Assignment operator for XMLNodeDiff.
+   *
+   * @param rhs the XMLNodeDiff object whose values are used as the basis
+   * of the assignment.
+   */
+  XMLNodeDiff& operator= (const XMLNodeDiff& rhs);
+
+
+  /**
+   * Destroys this XMLNodeDiff.
+   */
+  ~XMLNodeDiff ();
+
+
+  /**
+   * @return the number of edits in this XMLNodeDiff.
+   */
+  unsigned int getNumEdits () const;
+
+
+  /**
+   * @return the <code>n</code>th edit, or @c NULL if @p n is out of range.
+   */
+  const XMLNodeEdit* getEdit (unsigned int n) const;
+
+
+  /**
+   * @return @c true if this XMLNodeDiff changes nothing.
+   */
+  bool isEmpty () const;
+
+
+  /**
+   * Appends an edit to this XMLNodeDiff.
+   *
+   * @param edit the edit.
+   */
+  void addEdit (const XMLNodeEdit& edit);
+
+
+  /**
+   * Applies the edits of this XMLNodeDiff, in order, to the tree rooted at
+   * @p root.
+   *
+   * @param root the root of the tree to change, which should be a copy of
+   * the tree this XMLNodeDiff was computed from.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_XML_OPERATION, OperationReturnValues_t}
+   *
+   * @note If an edit does not fit the tree, because a path leads nowhere
+   * or an attribute to remove is missing, this method stops there and
+   * fails, leaving the edits before it applied.
+   */
+  int apply (XMLNode& root) const;
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  void compute (const XMLNode& from, const XMLNode& to);
+
+  void compareTokens (const XMLNode& from, const XMLNode& to,
+                      const std::vector<unsigned int>& path);
+
+  void clear ();
+
+  static void hashChildren (const XMLNode& node, std::vector<size_t>& hashes);
+  static int  applyEdit (const XMLNodeEdit& edit, XMLNode& root);
+
+  std::vector<XMLNodeEdit*> mEdits;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+BEGIN_C_DECLS
+
+/**
+ * Creates a new XMLNodeDiff_t structure holding the edits that turn the
+ * tree rooted at @p from into the tree rooted at @p to.
+ *
+ * @param from the tree to start from.
+ * @param to the tree to arrive at.
+ *
+ * @return pointer to the new XMLNodeDiff_t structure, or @c NULL if
+ * either argument is @c NULL.
+ *
+ * @memberof XMLNodeDiff_t
+ */
+LIBLX_EXTERN
+XMLNodeDiff_t *
+XMLNodeDiff_create (const XMLNode_t *from, const XMLNode_t *to);
+
+
+/**
+ * Destroys this XMLNodeDiff_t structure.
+ *
+ * @param diff XMLNodeDiff_t structure to be freed.
+ *
+ * @memberof XMLNodeDiff_t
+ */
+LIBLX_EXTERN
+void
+XMLNodeDiff_free (XMLNodeDiff_t *diff);
+
+
+/**
+ * Returns the number of edits in the XMLNodeDiff_t structure diff.
+ *
+ * @param diff the XMLNodeDiff_t structure.
+ *
+ * @return the number of edits, or @c 0 if diff is @c NULL.
+ *
+ * @memberof XMLNodeDiff_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLNodeDiff_getNumEdits (const XMLNodeDiff_t *diff);
+
+
+/**
+ * Applies the edits of the XMLNodeDiff_t structure diff to the tree rooted
+ * at @p root.
+ *
+ * @param diff the XMLNodeDiff_t structure.
+ * @param root the root of the tree to change.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_XML_OPERATION, OperationReturnValues_t}
+ *
+ * @memberof XMLNodeDiff_t
+ */
+LIBLX_EXTERN
+int
+XMLNodeDiff_apply (const XMLNodeDiff_t *diff, XMLNode_t *root);
+
+END_C_DECLS
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLNodeDiff_h */
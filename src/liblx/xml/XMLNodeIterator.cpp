@@ -0,0 +1,365 @@
+/**
+ * @file    XMLNodeIterator.cpp
+ * @brief   Non-recursive traversal of XMLNode trees
+ *
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <new>
+
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLNodeIterator.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+#ifdef __cplusplus
+
+
+/*
+ * Creates a new XMLNodeIterator that is past the end of every tree.
+ */
+XMLNodeIterator::XMLNodeIterator () :
+   mRoot        ( NULL )
+ , mNode        ( NULL )
+ , mDepth       ( 0 )
+ , mOrder       ( LIBLX_PRE_ORDER )
+ , mSkipChildren( false )
+{
+}
+
+
+/*
+ * Creates a new XMLNodeIterator positioned at the first node of the tree
+ * rooted at root.
+ */
+XMLNodeIterator::XMLNodeIterator (const XMLNode& root, XMLNodeOrder_t order) :
+   mRoot        ( &root )
+ , mNode        ( &root )
+ , mDepth       ( 0 )
+ , mOrder       ( order )
+ , mSkipChildren( false )
+{
+  if (mOrder == LIBLX_POST_ORDER) moveToFirstLeaf(&root);
+}
+
+
+/*
+ * @return the current node.
+ */
+const XMLNode&
+XMLNodeIterator::operator* () const
+{
+  return *mNode;
+}
+
+
+/*
+ * @return the current node.
+ */
+const XMLNode*
+XMLNodeIterator::operator-> () const
+{
+  return mNode;
+}
+
+
+/*
+ * Moves to the next node.
+ *
+ * In pre-order the next node is the first child of the current one, or
+ * else the next sibling of the closest node, going up from the current
+ * one to the root, that has one.  In post-order it is the parent of the
+ * current node, unless the current node has a next sibling, in which case
+ * it is the first leaf below that sibling.
+ */
+XMLNodeIterator&
+XMLNodeIterator::operator++ ()
+{
+  if (mNode == NULL) return *this;
+
+  if (mOrder == LIBLX_POST_ORDER)
+  {
+    const XMLNode* next = (mNode == mRoot) ? NULL : mNode->getNextSibling();
+
+    if (next != NULL)
+    {
+      moveToFirstLeaf(next);
+    }
+    else
+    {
+      mNode = (mNode == mRoot) ? NULL : mNode->getParent();
+      if (mNode != NULL) --mDepth;
+    }
+
+    return *this;
+  }
+
+  if (!mSkipChildren && mNode->getNumChildren() > 0)
+  {
+    mNode = &mNode->getChild(0);
+    ++mDepth;
+    return *this;
+  }
+
+  mSkipChildren = false;
+
+  while (mNode != mRoot)
+  {
+    const XMLNode* next = mNode->getNextSibling();
+
+    if (next != NULL)
+    {
+      mNode = next;
+      return *this;
+    }
+
+    mNode = mNode->getParent();
+    --mDepth;
+  }
+
+  mNode = NULL;
+  return *this;
+}
+
+
+/*
+ * Moves to the next node.
+ */
+XMLNodeIterator
+XMLNodeIterator::operator++ (int)
+{
+  XMLNodeIterator previous(*this);
+  ++(*this);
+  return previous;
+}
+
+
+/*
+ * @return true if both iterators are at the same node.
+ */
+bool
+XMLNodeIterator::operator== (const XMLNodeIterator& other) const
+{
+  return mNode == other.mNode;
+}
+
+
+/*
+ * @return true if the iterators are at different nodes.
+ */
+bool
+XMLNodeIterator::operator!= (const XMLNodeIterator& other) const
+{
+  return mNode != other.mNode;
+}
+
+
+/*
+ * @return the current node, or NULL at the end.
+ */
+const XMLNode*
+XMLNodeIterator::getNode () const
+{
+  return mNode;
+}
+
+
+/*
+ * @return true if every node of the tree has been visited.
+ */
+bool
+XMLNodeIterator::isEnd () const
+{
+  return mNode == NULL;
+}
+
+
+/*
+ * @return the depth of the current node below the root.
+ */
+unsigned int
+XMLNodeIterator::getDepth () const
+{
+  return mDepth;
+}
+
+
+/*
+ * @return the order in which this iterator visits the nodes.
+ */
+XMLNodeOrder_t
+XMLNodeIterator::getOrder () const
+{
+  return mOrder;
+}
+
+
+/*
+ * Makes the next increment pass over the children of the current node.
+ */
+void
+XMLNodeIterator::skipChildren ()
+{
+  if (mOrder == LIBLX_PRE_ORDER && mNode != NULL) mSkipChildren = true;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Moves to the first leaf below node, which is at mDepth.
+ */
+void
+XMLNodeIterator::moveToFirstLeaf (const XMLNode* node)
+{
+  while (node->getNumChildren() > 0)
+  {
+    node = &node->getChild(0);
+    ++mDepth;
+  }
+
+  mNode = node;
+}
+/** @endcond */
+
+
+/*
+ * Creates a new XMLNodeRange over the tree rooted at root.
+ */
+XMLNodeRange::XMLNodeRange (const XMLNode& root, XMLNodeOrder_t order) :
+   mRoot ( &root )
+ , mOrder( order )
+{
+}
+
+
+/*
+ * @return an iterator at the first node of the tree.
+ */
+XMLNodeIterator
+XMLNodeRange::begin () const
+{
+  return XMLNodeIterator(*mRoot, mOrder);
+}
+
+
+/*
+ * @return an iterator past the last node of the tree.
+ */
+XMLNodeIterator
+XMLNodeRange::end () const
+{
+  return XMLNodeIterator();
+}
+
+
+/*
+ * Destroys this XMLNodeVisitor.
+ */
+XMLNodeVisitor::~XMLNodeVisitor ()
+{
+}
+
+
+/*
+ * Receive notification of a node, before its children.
+ *
+ * By default, do nothing and visit the children.
+ */
+XMLNodeVisit_t
+XMLNodeVisitor::enter (const XMLNode&, unsigned int)
+{
+  return LIBLX_VISIT_CONTINUE;
+}
+
+
+/*
+ * Receive notification of a node, after its children.
+ *
+ * By default, do nothing.
+ */
+bool
+XMLNodeVisitor::leave (const XMLNode&, unsigned int)
+{
+  return true;
+}
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLNodeIterator_t *
+XMLNodeIterator_create (const XMLNode_t *root, XMLNodeOrder_t order)
+{
+  if (root == NULL) return NULL;
+  return new(nothrow) XMLNodeIterator(*root, order);
+}
+
+
+LIBLX_EXTERN
+void
+XMLNodeIterator_free (XMLNodeIterator_t *iterator)
+{
+  delete static_cast<XMLNodeIterator*>(iterator);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLNodeIterator_next (XMLNodeIterator_t *iterator, const XMLNode_t **nodes,
+                      unsigned int *depths, unsigned int size)
+{
+  if (iterator == NULL || nodes == NULL) return 0;
+
+  unsigned int count = 0;
+
+  for (; count < size && !iterator->isEnd(); ++count, ++(*iterator))
+  {
+    nodes[count] = iterator->getNode();
+    if (depths != NULL) depths[count] = iterator->getDepth();
+  }
+
+  return count;
+}
+
+
+LIBLX_EXTERN
+int
+XMLNodeIterator_isEnd (const XMLNodeIterator_t *iterator)
+{
+  return (iterator == NULL || iterator->isEnd()) ? 1 : 0;
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,451 @@
+/**
+ * @file    XMLNodeIterator.h
+ * @brief   Non-recursive traversal of XMLNode trees
+ *
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ *
+ * @class XMLNodeIterator
+ * @sbmlbrief{core} Visits the nodes of an XMLNode tree in pre-order or
+ * post-order.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * Walking an XMLNode tree by recursing over XMLNode::getNumChildren()
+ * and XMLNode::getChild() costs a function call per node and stack space
+ * per level, and is awkward to stop half-way.  An XMLNodeIterator walks
+ * the tree rooted at a given node instead by following the parent and
+ * sibling links every XMLNode keeps (see XMLNode::getParent() and
+ * XMLNode::getNextSibling()), so it needs neither recursion nor a stack
+ * of its own, and is as cheap to copy as a pair of pointers.
+ *
+ * In pre-order (@sbmlconstant{LIBLX_PRE_ORDER, XMLNodeOrder_t}) each node
+ * comes before its children, in post-order
+ * (@sbmlconstant{LIBLX_POST_ORDER, XMLNodeOrder_t}) after them.  Text
+ * nodes are visited like elements.  In pre-order, skipChildren() makes
+ * the next increment pass over the children of the current node:
+ * @code{.cpp}
+for (XMLNodeIterator it(root); !it.isEnd(); ++it)
+{
+  if (it->getName() == "annotation")
+  {
+    it.skipChildren();
+    continue;
+  }
+  ...
+}
+@endcode
+ *
+ * XMLNodeRange provides begin() and end() for range-based @c for loops:
+ * @code{.cpp}
+for (const XMLNode& node : XMLNodeRange(root, LIBLX_POST_ORDER))
+{
+  ...
+}
+@endcode
+ *
+ * The tree must not be changed while it is being iterated, except for the
+ * contents (name, attributes, namespaces, text) of nodes already visited.
+ *
+ * @see XMLNodeVisitor
+ */
+
+/**
+ * @class XMLNodeRange
+ * @sbmlbrief{core} The nodes of an XMLNode tree, for range-based
+ * @c for loops.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * @see XMLNodeIterator
+ */
+
+/**
+ * @class XMLNodeVisitor
+ * @sbmlbrief{core} Receives the nodes of an XMLNode tree from
+ * XMLNode::accept().
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * XMLNode::accept() calls enter() on each node of a tree before its
+ * children and leave() after them, so one pass over the tree can do work
+ * on the way down and on the way back up.  As with XMLNodeIterator, the
+ * tree is walked without recursion.  enter() decides whether the
+ * children of a node are visited, and either method can end the walk:
+ * @code{.cpp}
+class Counter : public XMLNodeVisitor
+{
+public:
+  Counter () : elements(0) { }
+
+  virtual XMLNodeVisit_t enter (const XMLNode& node, unsigned int depth)
+  {
+    if (node.isElement()) ++elements;
+    return (node.getName() == "annotation") ? LIBLX_VISIT_SKIP_CHILDREN
+                                            : LIBLX_VISIT_CONTINUE;
+  }
+
+  unsigned int elements;
+};
+@endcode
+ */
+
+#ifndef XMLNodeIterator_h
+#define XMLNodeIterator_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+LIBLX_CPP_NAMESPACE_BEGIN
+BEGIN_C_DECLS
+
+/**
+ * @enum XMLNodeOrder_t
+ * The orders in which XMLNodeIterator visits the nodes of a tree.
+ */
+typedef enum
+{
+    LIBLX_PRE_ORDER  = 0 /*!< Each node comes before its children. */
+  , LIBLX_POST_ORDER     /*!< Each node comes after its children. */
+} XMLNodeOrder_t;
+
+
+/**
+ * @enum XMLNodeVisit_t
+ * What XMLNode::accept() does after XMLNodeVisitor::enter() returns.
+ */
+typedef enum
+{
+    LIBLX_VISIT_CONTINUE      = 0 /*!< Visit the children of the node. */
+  , LIBLX_VISIT_SKIP_CHILDREN     /*!< Do not visit the children of the
+                                   *   node; XMLNodeVisitor::leave() is
+                                   *   still called for it. */
+  , LIBLX_VISIT_STOP              /*!< End the walk at once. */
+} XMLNodeVisit_t;
+
+END_C_DECLS
+LIBLX_CPP_NAMESPACE_END
+
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <iterator>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLNode;
+
+
+class LIBLX_EXTERN XMLNodeIterator
+{
+public:
+
+  typedef std::forward_iterator_tag iterator_category;
+  typedef XMLNode                   value_type;
+  typedef std::ptrdiff_t            difference_type;
+  typedef const XMLNode*            pointer;
+  typedef const XMLNode&            reference;
+
+
+  /**
+   * Creates a new XMLNodeIterator that is past the end of every tree.
+   */
+  XMLNodeIterator ();
+
+
+  /**
+   * Creates a new XMLNodeIterator positioned at the first node, in the
+   * given order, of the tree rooted at @p root.
+   *
+   * @param root the root of the tree; it need not be the root of the
+   * whole document.
+   * @param order the order in which to visit the nodes.
+   */
+  explicit XMLNodeIterator (const XMLNode& root,
+                            XMLNodeOrder_t order = LIBLX_PRE_ORDER);
+
+
+  /**
+   * @return the current node.  The iterator must not be at the end.
+   */
+  const XMLNode& operator* () const;
+
+
+  /**
+   * @return the current node.  The iterator must not be at the end.
+   */
+  const XMLNode* operator-> () const;
+
+
+  /**
+   * Moves to the next node.
+   *
+   * @return this iterator.
+   */
+  XMLNodeIterator& operator++ ();
+
+
+  /**
+   * Moves to the next node.
+   *
+   * @return a copy of this iterator from before the move.
+   */
+  XMLNodeIterator operator++ (int);
+
+
+  /**
+   * @return true if both iterators are at the same node, or both at the
+   * end.
+   */
+  bool operator== (const XMLNodeIterator& other) const;
+
+
+  /**
+   * @return true if the iterators are at different nodes.
+   */
+  bool operator!= (const XMLNodeIterator& other) const;
+
+
+  /**
+   * @return the current node, or @c NULL at the end.
+   */
+  const XMLNode* getNode () const;
+
+
+  /**
+   * @return true if every node of the tree has been visited.
+   */
+  bool isEnd () const;
+
+
+  /**
+   * @return the depth of the current node below the root of the tree;
+   * the root itself is at depth 0.
+   */
+  unsigned int getDepth () const;
+
+
+  /**
+   * @return the order in which this iterator visits the nodes.
+   */
+  XMLNodeOrder_t getOrder () const;
+
+
+  /**
+   * Makes the next increment pass over the children of the current node,
+   * moving straight to its next sibling (or that of its closest ancestor
+   * that has one).  This has no effect in post-order, in which the
+   * children have been visited already.
+   */
+  void skipChildren ();
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  void moveToFirstLeaf (const XMLNode* node);
+
+  const XMLNode* mRoot;
+  const XMLNode* mNode;
+  unsigned int   mDepth;
+  XMLNodeOrder_t mOrder;
+  bool           mSkipChildren;
+
+  /** @endcond */
+};
+
+
+class LIBLX_EXTERN XMLNodeRange
+{
+public:
+
+  typedef XMLNodeIterator iterator;
+  typedef XMLNodeIterator const_iterator;
+
+
+  /**
+   * Creates a new XMLNodeRange over the tree rooted at @p root.
+   *
+   * @param root the root of the tree.
+   * @param order the order in which to visit the nodes.
+   */
+  explicit XMLNodeRange (const XMLNode& root,
+                         XMLNodeOrder_t order = LIBLX_PRE_ORDER);
+
+
+  /**
+   * @return an iterator at the first node of the tree.
+   */
+  XMLNodeIterator begin () const;
+
+
+  /**
+   * @return an iterator past the last node of the tree.
+   */
+  XMLNodeIterator end () const;
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  const XMLNode* mRoot;
+  XMLNodeOrder_t mOrder;
+
+  /** @endcond */
+};
+
+
+class LIBLX_EXTERN XMLNodeVisitor
+{
+public:
+
+  /**
+   * Destroys this XMLNodeVisitor.
+   */
+  virtual ~XMLNodeVisitor ();
+
+
+  /**
+   * Receive notification of a node, before its children.
+   *
+   * By default, do nothing and visit the children.
+   *
+   * @param node the node.
+   * @param depth the depth of @p node below the node on which
+   * XMLNode::accept() was called.
+   *
+   * @return @sbmlconstant{LIBLX_VISIT_CONTINUE, XMLNodeVisit_t} to visit
+   * the children of @p node,
+   * @sbmlconstant{LIBLX_VISIT_SKIP_CHILDREN, XMLNodeVisit_t} to pass
+   * over them, or @sbmlconstant{LIBLX_VISIT_STOP, XMLNodeVisit_t} to end
+   * the walk.
+   */
+  virtual XMLNodeVisit_t enter (const XMLNode& node, unsigned int depth);
+
+
+  /**
+   * Receive notification of a node, after its children.
+   *
+   * By default, do nothing.
+   *
+   * @param node the node.
+   * @param depth the depth of @p node below the node on which
+   * XMLNode::accept() was called.
+   *
+   * @return @c true to go on, or @c false to end the walk.
+   */
+  virtual bool leave (const XMLNode& node, unsigned int depth);
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+BEGIN_C_DECLS
+
+/**
+ * Creates a new XMLNodeIterator_t structure positioned at the first node,
+ * in the given order, of the tree rooted at @p root.
+ *
+ * @param root the root of the tree.
+ * @param order the order in which to visit the nodes.
+ *
+ * @return pointer to the new XMLNodeIterator_t structure, or @c NULL if
+ * @p root is @c NULL.
+ *
+ * @memberof XMLNodeIterator_t
+ */
+LIBLX_EXTERN
+XMLNodeIterator_t *
+XMLNodeIterator_create (const XMLNode_t *root, XMLNodeOrder_t order);
+
+
+/**
+ * Destroys this XMLNodeIterator_t structure.
+ *
+ * @param iterator XMLNodeIterator_t structure to be freed.
+ *
+ * @memberof XMLNodeIterator_t
+ */
+LIBLX_EXTERN
+void
+XMLNodeIterator_free (XMLNodeIterator_t *iterator);
+
+
+/**
+ * Copies the next nodes of the tree, up to @p size of them, to @p nodes
+ * and their depths to @p depths, and moves past them.  Walking a tree a
+ * batch at a time saves a call across a language binding per node.
+ *
+ * @param iterator the XMLNodeIterator_t structure.
+ * @param nodes an array of at least @p size elements to fill.
+ * @param depths an array of at least @p size elements to fill with the
+ * depths of the nodes below the root, or @c NULL.
+ * @param size the largest number of nodes to copy.
+ *
+ * @return the number of nodes copied; it is less than @p size only once
+ * the whole tree has been visited, and 0 after that.
+ *
+ * @memberof XMLNodeIterator_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLNodeIterator_next (XMLNodeIterator_t *iterator, const XMLNode_t **nodes,
+                      unsigned int *depths, unsigned int size);
+
+
+/**
+ * Predicate returning @c 1 (true) if every node of the tree has been
+ * visited.
+ *
+ * @param iterator the XMLNodeIterator_t structure.
+ *
+ * @return @c 1 (true) at the end of the tree or if @p iterator is
+ * @c NULL, @c 0 (false) otherwise.
+ *
+ * @memberof XMLNodeIterator_t
+ */
+LIBLX_EXTERN
+int
+XMLNodeIterator_isEnd (const XMLNodeIterator_t *iterator);
+
+
+END_C_DECLS
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLNodeIterator_h */
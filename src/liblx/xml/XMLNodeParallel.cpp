@@ -0,0 +1,295 @@
+/**
+ * @file    XMLNodeParallel.cpp
+ * @brief   Parallel traversal of read-only XMLNode trees
+ *
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <deque>
+
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLNodeParallel.h>
+#include <liblx/xml/XMLThreads.h>
+
+using namespace std;
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+/** @cond doxygenLibsbmlInternal */
+
+/*
+ * The children of parent from next up to (not including) end, which are
+ * still to be visited together with their subtrees.
+ */
+struct SiblingRange
+{
+  const XMLNode* parent;
+  unsigned int   next;
+  unsigned int   end;
+};
+
+
+/*
+ * The ranges a worker has set aside.  The worker takes them from the
+ * back, other workers from the front.
+ */
+struct WorkerQueue
+{
+  XMLMutex                 mutex;
+  std::deque<SiblingRange> ranges;
+};
+
+
+/*
+ * The state shared by the workers of one walk.  pending counts the
+ * ranges that are queued or being walked; the walk is over when it drops
+ * to 0.  waiting counts the workers looking for a range to take.
+ */
+struct ParallelWalk
+{
+  void (*visit) (void* worker, const XMLNode& node);
+
+  const std::vector<void*>*  workers;
+  std::vector<WorkerQueue*>  queues;
+  volatile long              pending;
+  volatile long              waiting;
+};
+
+
+/*
+ * Takes the newest range from the queue of worker.
+ *
+ * @return false if the queue is empty.
+ */
+static bool
+takeOwn (ParallelWalk& walk, unsigned int worker, SiblingRange& range)
+{
+  WorkerQueue& queue = *walk.queues[worker];
+  XMLMutexLock lock(queue.mutex);
+
+  if (queue.ranges.empty()) return false;
+
+  range = queue.ranges.back();
+  queue.ranges.pop_back();
+  return true;
+}
+
+
+/*
+ * Takes the oldest range from the queue of any worker but worker,
+ * trying them in turn.
+ *
+ * @return false if all queues are empty.
+ */
+static bool
+steal (ParallelWalk& walk, unsigned int worker, SiblingRange& range)
+{
+  const size_t count = walk.queues.size();
+
+  for (size_t n = 1; n < count; ++n)
+  {
+    WorkerQueue& queue = *walk.queues[(worker + n) % count];
+    XMLMutexLock lock(queue.mutex);
+
+    if (queue.ranges.empty()) continue;
+
+    range = queue.ranges.front();
+    queue.ranges.pop_front();
+    return true;
+  }
+
+  return false;
+}
+
+
+/*
+ * Gives a waiting worker something to take: unless the queue of worker
+ * still holds a range, the outermost range on stack that has two or more
+ * children left is split at its middle child, and the second half is
+ * queued.
+ */
+static void
+share (ParallelWalk& walk, unsigned int worker,
+       std::vector<SiblingRange>& stack)
+{
+  WorkerQueue& queue = *walk.queues[worker];
+  XMLMutexLock lock(queue.mutex);
+
+  if (!queue.ranges.empty()) return;
+
+  for (size_t n = 0; n < stack.size(); ++n)
+  {
+    SiblingRange& range = stack[n];
+
+    if (range.end - range.next < 2) continue;
+
+    SiblingRange half = range;
+    half.next = range.next + (range.end - range.next) / 2;
+    range.end = half.next;
+
+    XMLThreads::add(walk.pending, 1);
+    queue.ranges.push_back(half);
+    return;
+  }
+}
+
+
+/*
+ * Visits the nodes of range and their subtrees in pre-order.  stack
+ * holds the ranges being walked, one per level, from range down to the
+ * children of the node visited last.
+ */
+static void
+walkRange (ParallelWalk& walk, unsigned int worker, const SiblingRange& range,
+           std::vector<SiblingRange>& stack)
+{
+  void* state = (*walk.workers)[worker];
+
+  stack.clear();
+  stack.push_back(range);
+
+  while (!stack.empty())
+  {
+    if (XMLThreads::load(walk.waiting) > 0) share(walk, worker, stack);
+
+    SiblingRange& top = stack.back();
+
+    if (top.next == top.end)
+    {
+      stack.pop_back();
+      continue;
+    }
+
+    const XMLNode& node = top.parent->getChild(top.next++);
+
+    walk.visit(state, node);
+
+    if (node.getNumChildren() > 0)
+    {
+      SiblingRange children = { &node, 0, node.getNumChildren() };
+      stack.push_back(children);
+    }
+  }
+}
+
+
+/*
+ * The function run by each worker: walks ranges from its own queue, or
+ * taken from others, until no range is left anywhere.
+ */
+static void
+runWorker (void* data, unsigned int worker)
+{
+  ParallelWalk&        walk = *static_cast<ParallelWalk*>(data);
+  vector<SiblingRange> stack;
+  SiblingRange         range;
+
+  for (;;)
+  {
+    if (!takeOwn(walk, worker, range))
+    {
+      bool found;
+
+      XMLThreads::add(walk.waiting, 1);
+
+      while (!(found = steal(walk, worker, range))
+             && XMLThreads::load(walk.pending) > 0)
+      {
+        XMLThreads::yield();
+      }
+
+      XMLThreads::add(walk.waiting, -1);
+
+      if (!found) return;
+    }
+
+    walkRange(walk, worker, range, stack);
+    XMLThreads::add(walk.pending, -1);
+  }
+}
+
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return the number of workers to use for numThreads.
+ */
+unsigned int
+XMLNodeParallel::getNumWorkers (unsigned int numThreads)
+{
+  if (!XMLThreads::isEnabled()) return 1;
+
+  return (numThreads > 0) ? numThreads : XMLThreads::getNumProcessors();
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Calls visit with every node of the tree and one of workers.  The root
+ * is visited on the calling thread; its children form the first range,
+ * queued for worker 0, which is the calling thread as well.
+ */
+void
+XMLNodeParallel::run (const XMLNode& root, Visit visit,
+                      const std::vector<void*>& workers)
+{
+  visit(workers[0], root);
+
+  if (root.getNumChildren() == 0) return;
+
+  ParallelWalk walk;
+  walk.visit   = visit;
+  walk.workers = &workers;
+  walk.pending = 1;
+  walk.waiting = 0;
+
+  for (size_t n = 0; n < workers.size(); ++n)
+  {
+    walk.queues.push_back(new WorkerQueue);
+  }
+
+  SiblingRange all = { &root, 0, root.getNumChildren() };
+  walk.queues[0]->ranges.push_back(all);
+
+  XMLThreads::run((unsigned int)workers.size(), runWorker, &walk);
+
+  for (size_t n = 0; n < walk.queues.size(); ++n)
+  {
+    delete walk.queues[n];
+  }
+}
+/** @endcond */
+
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,205 @@
+/**
+ * @file    XMLNodeParallel.h
+ * @brief   Parallel traversal of read-only XMLNode trees
+ *
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ *
+ * @class XMLNodeParallel
+ * @sbmlbrief{core} Applies a function to every node of an XMLNode tree,
+ * on several threads.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * Counting, hashing or extracting over a large tree with XMLNodeIterator
+ * or XMLNode::accept() uses a single thread.  XMLNodeParallel::forEach()
+ * and XMLNodeParallel::reduce() visit the same nodes, each exactly once,
+ * but spread them over several threads.  The tree must not change while
+ * they run; see the section on thread safety in XMLNode.
+ *
+ * The tree is divided at child boundaries.  Each thread walks its share
+ * of the tree depth-first, keeping a queue of the sibling ranges it has
+ * not reached yet.  When a thread runs out of work it takes the oldest,
+ * and therefore usually largest, range from the queue of another thread,
+ * and while any thread is waiting, the others split the outermost range
+ * they are walking in half to give it something to take.  Trees of any
+ * shape are thus shared out without knowing their size in advance.
+ *
+ * forEach() calls one function object from all threads at once, so it
+ * must be safe to call concurrently:
+ * @code{.cpp}
+class Touch
+{
+public:
+  void operator() (const XMLNode& node) { ... }
+};
+
+Touch touch;
+XMLNodeParallel::forEach(root, touch);
+@endcode
+ *
+ * reduce() gives every thread a reducer of its own, and joins them at the
+ * end, so the reducer needs no locking:
+ * @code{.cpp}
+class ElementCount
+{
+public:
+  ElementCount () : count(0) { }
+
+  void operator() (const XMLNode& node) { if (node.isElement()) ++count; }
+
+  void join (const ElementCount& other) { count += other.count; }
+
+  unsigned long count;
+};
+
+ElementCount elements;
+XMLNodeParallel::reduce(root, elements);
+@endcode
+ *
+ * Which thread visits which node, and the order of the visits, is not
+ * specified.  A thread visits a node before the descendants of it that
+ * the same thread visits.
+ */
+
+#ifndef XMLNodeParallel_h
+#define XMLNodeParallel_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+#include <vector>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLNode;
+
+
+class LIBLX_EXTERN XMLNodeParallel
+{
+public:
+
+  /**
+   * Calls @p function with every node of the tree rooted at @p root,
+   * using up to @p numThreads threads, and returns once all nodes have
+   * been visited.
+   *
+   * @param root the root of the tree.
+   * @param function a function object callable as
+   * <code>function(const XMLNode&)</code>; it is called from several
+   * threads at once, and must not throw.
+   * @param numThreads the largest number of threads to use, or 0 for one
+   * per processor.
+   */
+  template <class Function>
+  static void forEach (const XMLNode& root, Function& function,
+                       unsigned int numThreads = 0)
+  {
+    std::vector<void*> workers(getNumWorkers(numThreads), &function);
+    run(root, visit<Function>, workers);
+  }
+
+
+  /**
+   * Calls a reducer with every node of the tree rooted at @p root, using
+   * up to @p numThreads threads, and leaves the combined result in
+   * @p reducer.
+   *
+   * The calling thread uses @p reducer itself; every other thread uses a
+   * default-constructed @c Reducer, which should therefore hold the
+   * neutral value of the reduction.  Once all nodes have been visited,
+   * these are passed to <code>reducer.join()</code> one by one.  The
+   * reduction must give the same result whatever nodes each reducer saw.
+   *
+   * @param root the root of the tree.
+   * @param reducer a function object callable as
+   * <code>reducer(const XMLNode&)</code>, with a method
+   * <code>join(const Reducer&)</code>.
+   * @param numThreads the largest number of threads to use, or 0 for one
+   * per processor.
+   */
+  template <class Reducer>
+  static void reduce (const XMLNode& root, Reducer& reducer,
+                      unsigned int numThreads = 0)
+  {
+    unsigned int         count = getNumWorkers(numThreads);
+    std::vector<Reducer> others(count - 1);
+    std::vector<void*>   workers(1, &reducer);
+
+    for (size_t n = 0; n < others.size(); ++n)
+    {
+      workers.push_back(&others[n]);
+    }
+
+    run(root, visit<Reducer>, workers);
+
+    for (size_t n = 0; n < others.size(); ++n)
+    {
+      reducer.join(others[n]);
+    }
+  }
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  /* Passes node to the function object of a worker. */
+  typedef void (*Visit) (void* worker, const XMLNode& node);
+
+  template <class Function>
+  static void visit (void* worker, const XMLNode& node)
+  {
+    (*static_cast<Function*>(worker))(node);
+  }
+
+  /*
+   * @return the number of workers to use for numThreads: 1 without
+   * thread support, getNumProcessors() for 0.
+   */
+  static unsigned int getNumWorkers (unsigned int numThreads);
+
+  /*
+   * Calls visit with every node of the tree and one of workers, on as
+   * many threads as there are workers.
+   */
+  static void run (const XMLNode& root, Visit visit,
+                   const std::vector<void*>& workers);
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* XMLNodeParallel_h */
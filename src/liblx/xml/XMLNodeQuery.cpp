@@ -0,0 +1,533 @@
+/**
+ * @file    XMLNodeQuery.cpp
+ * @brief   Compiled location paths evaluated over XMLNode trees
+ *
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLNodeQuery.h>
+#include <liblx/xml/XMLThreads.h>
+#include <liblx/xml/operationReturnValues.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+/** @cond doxygenLibsbmlInternal */
+
+/*
+ * The number of levels of a tree evaluateParallel() walks on the calling
+ * thread at most while looking for subtrees to hand out, and the number
+ * of subtrees per thread it looks for, so that threads that finish early
+ * can take over the remaining ones.
+ */
+static const unsigned int MaxSplitLevels    = 8;
+static const unsigned int SubtreesPerThread = 4;
+
+
+/*
+ * The subtrees of a tree being evaluated in parallel, shared by the
+ * threads, and the elements each subtree selects.
+ */
+struct XMLNodeQuery::ParallelWork
+{
+  const XMLNodeQuery*                       query;
+  std::vector<Part>*                        parts;
+  std::vector< std::vector<const XMLNode*> > results;
+  size_t                                    next;
+  XMLMutex                                  mutex;
+};
+
+
+/*
+ * Adds a state for step to states unless it is already there.
+ */
+template <typename State>
+static void
+addState (std::vector<State>& states, unsigned int step)
+{
+  for (size_t n = 0; n < states.size(); ++n)
+  {
+    if (states[n].step == step) return;
+  }
+
+  State state;
+  state.step  = step;
+  state.count = 0;
+
+  states.push_back(state);
+}
+
+/** @endcond */
+
+
+/*
+ * Creates a new XMLNodeQuery without a path.
+ */
+XMLNodeQuery::XMLNodeQuery () :
+   mPath()
+{
+}
+
+
+/*
+ * Compiles path, comparing prefixes literally.
+ */
+int
+XMLNodeQuery::compile (const std::string& path)
+{
+  return compilePath(path, NULL) ? LIBLX_OPERATION_SUCCESS
+                                 : LIBLX_INVALID_ATTRIBUTE_VALUE;
+}
+
+
+/*
+ * Compiles path, resolving the prefixes bound in namespaces.
+ */
+int
+XMLNodeQuery::compile (const std::string& path,
+                       const XMLNamespaces& namespaces)
+{
+  return compilePath(path, &namespaces) ? LIBLX_OPERATION_SUCCESS
+                                        : LIBLX_INVALID_ATTRIBUTE_VALUE;
+}
+
+
+/*
+ * @return true if this XMLNodeQuery holds a compiled path.
+ */
+bool
+XMLNodeQuery::isCompiled () const
+{
+  return mPath.isCompiled();
+}
+
+
+/*
+ * @return the path of this XMLNodeQuery.
+ */
+const std::string&
+XMLNodeQuery::getPath () const
+{
+  return mPath.getSource();
+}
+
+
+/*
+ * Fills result with the elements of the tree rooted at root that the
+ * path selects.
+ */
+unsigned int
+XMLNodeQuery::evaluate (const XMLNode& root,
+                        std::vector<const XMLNode*>& result) const
+{
+  result.clear();
+
+  if (!mPath.isCompiled()) return 0;
+
+  StateSet outer(1);
+  StateSet inner;
+
+  outer[0].step  = 0;
+  outer[0].count = 0;
+
+  if (visit(outer, root, inner)) result.push_back(&root);
+
+  if (!inner.empty())
+  {
+    Scratch scratch;
+    evaluateBelow(root, inner, scratch, result, false);
+  }
+
+  return (unsigned int)result.size();
+}
+
+
+/*
+ * Fills result with the elements of the tree rooted at root that the
+ * path selects.
+ */
+unsigned int
+XMLNodeQuery::evaluate (XMLNode& root, std::vector<XMLNode*>& result) const
+{
+  vector<const XMLNode*> found;
+  evaluate(static_cast<const XMLNode&>(root), found);
+
+  result.clear();
+  result.reserve(found.size());
+
+  for (size_t n = 0; n < found.size(); ++n)
+  {
+    result.push_back(const_cast<XMLNode*>(found[n]));
+  }
+
+  return (unsigned int)result.size();
+}
+
+
+/*
+ * @return the first element of the tree rooted at root that the path
+ * selects, or NULL.
+ */
+const XMLNode*
+XMLNodeQuery::evaluateFirst (const XMLNode& root) const
+{
+  if (!mPath.isCompiled()) return NULL;
+
+  StateSet outer(1);
+  StateSet inner;
+
+  outer[0].step  = 0;
+  outer[0].count = 0;
+
+  if (visit(outer, root, inner)) return &root;
+  if (inner.empty()) return NULL;
+
+  Scratch                scratch;
+  vector<const XMLNode*> found;
+
+  evaluateBelow(root, inner, scratch, found, true);
+
+  return found.empty() ? NULL : found[0];
+}
+
+
+/*
+ * Fills result with the elements of the tree rooted at root that the
+ * path selects, using up to numThreads threads.
+ *
+ * The top of the tree is split into a list of parts in document order:
+ * an element the path selects, the subtree below an element, or both.
+ * Starting from the root, each subtree in the list is replaced by the
+ * children of its element (which need the states of their parent, and
+ * must therefore be visited in order on one thread) until there are
+ * enough subtrees to keep the threads busy.  The threads then take the
+ * subtrees from the list one at a time.
+ */
+unsigned int
+XMLNodeQuery::evaluateParallel (const XMLNode& root,
+                                std::vector<const XMLNode*>& result,
+                                unsigned int numThreads) const
+{
+  if (numThreads == 0) numThreads = XMLThreads::getNumProcessors();
+
+  if (numThreads < 2 || !XMLThreads::isEnabled())
+  {
+    return evaluate(root, result);
+  }
+
+  result.clear();
+
+  if (!mPath.isCompiled()) return 0;
+
+  StateSet outer(1);
+  outer[0].step  = 0;
+  outer[0].count = 0;
+
+  vector<Part> parts(1);
+  parts[0].node     = &root;
+  parts[0].selected = visit(outer, root, parts[0].states);
+
+  const size_t wanted   = SubtreesPerThread * numThreads;
+  size_t       subtrees = parts[0].states.empty() ? 0 : 1;
+
+  for (unsigned int level = 0;
+       level < MaxSplitLevels && subtrees > 0 && subtrees < wanted; ++level)
+  {
+    vector<Part> split;
+    subtrees = 0;
+
+    for (size_t n = 0; n < parts.size(); ++n)
+    {
+      Part& part = parts[n];
+
+      if (part.states.empty())
+      {
+        split.push_back(part);
+        continue;
+      }
+
+      if (part.selected)
+      {
+        split.push_back(Part());
+        split.back().node     = part.node;
+        split.back().selected = true;
+      }
+
+      for (unsigned int c = 0; c < part.node->getNumChildren(); ++c)
+      {
+        Part child;
+        child.node     = &part.node->getChild(c);
+        child.selected = visit(part.states, *child.node, child.states);
+
+        if (!child.selected && child.states.empty()) continue;
+
+        if (!child.states.empty()) ++subtrees;
+        split.push_back(child);
+      }
+    }
+
+    parts.swap(split);
+  }
+
+  ParallelWork work;
+  work.query = this;
+  work.parts = &parts;
+  work.next  = 0;
+  work.results.resize(parts.size());
+
+  if (subtrees > 0)
+  {
+    XMLThreads::run((unsigned int)min(subtrees, (size_t)numThreads),
+                    runParallel, &work);
+  }
+
+  for (size_t n = 0; n < parts.size(); ++n)
+  {
+    if (parts[n].selected) result.push_back(parts[n].node);
+
+    result.insert(result.end(), work.results[n].begin(),
+                  work.results[n].end());
+  }
+
+  return (unsigned int)result.size();
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Compiles path into the steps of this query.  A query selects elements,
+ * so a path that ends with an attribute step is refused.
+ */
+bool
+XMLNodeQuery::compilePath (const std::string& path,
+                           const XMLNamespaces* namespaces)
+{
+  if (mPath.compile(path, namespaces) && !mPath.selectsAttribute())
+  {
+    return true;
+  }
+
+  mPath.clear();
+  return false;
+}
+
+
+/*
+ * Matches element, a child of the element that owns outer, against the
+ * states in outer, and fills inner with the states that apply to the
+ * children of element.  A descendant step stays alive, and a step the
+ * element matches either selects it (if it is the last one) or moves on
+ * to the next step.
+ *
+ * @return true if the path selects element.
+ */
+bool
+XMLNodeQuery::visit (StateSet& outer, const XMLNode& element,
+                     StateSet& inner) const
+{
+  inner.clear();
+
+  if (!element.isElement()) return false;
+
+  bool selected = false;
+
+  for (size_t n = 0; n < outer.size(); ++n)
+  {
+    State&      state = outer[n];
+    const Step& step  = mPath.getStep(state.step);
+
+    if (step.descendant) addState(inner, state.step);
+
+    if (!XMLLocationPath::matches(step, element, state.count)) continue;
+
+    if (state.step + 1 < mPath.getNumSteps())
+    {
+      addState(inner, state.step + 1);
+    }
+    else
+    {
+      selected = true;
+    }
+  }
+
+  return selected;
+}
+
+
+/*
+ * Appends to result the descendants of element that the path selects,
+ * given the states that apply to the children of element, stopping at
+ * the first one if first is true.
+ *
+ * scratch.frames holds the elements whose children are being visited,
+ * from element down to the current one, and scratch.states[d] the states
+ * for the children of the element at depth d below element.
+ *
+ * @return the number of elements appended.
+ */
+unsigned int
+XMLNodeQuery::evaluateBelow (const XMLNode& element, const StateSet& states,
+                             Scratch& scratch,
+                             std::vector<const XMLNode*>& result,
+                             bool first) const
+{
+  unsigned int found = 0;
+
+  if (scratch.states.empty()) scratch.states.resize(1);
+
+  scratch.states[0] = states;
+  scratch.frames.clear();
+
+  pushFrame(scratch, element, 0);
+
+  while (!scratch.frames.empty())
+  {
+    Frame& frame = scratch.frames.back();
+
+    if (frame.next < 0)
+    {
+      scratch.frames.pop_back();
+      continue;
+    }
+
+    const XMLNode&     parent = *frame.node;
+    const unsigned int index  = (unsigned int)frame.next;
+    const size_t       depth  = frame.depth;
+
+    if (frame.byName)
+    {
+      frame.next = parent.getNextIndex(index);
+    }
+    else
+    {
+      frame.next = (index + 1 < parent.getNumChildren()) ? (int)index + 1 : -1;
+    }
+
+    if (scratch.states.size() < depth + 2) scratch.states.resize(depth + 2);
+
+    const XMLNode& child = parent.getChild(index);
+
+    if (visit(scratch.states[depth], child, scratch.states[depth + 1]))
+    {
+      result.push_back(&child);
+      ++found;
+
+      if (first) break;
+    }
+
+    if (!scratch.states[depth + 1].empty() && child.getNumChildren() > 0)
+    {
+      pushFrame(scratch, child, depth + 1);
+    }
+  }
+
+  return found;
+}
+
+
+/*
+ * Starts visiting the children of element, whose states are in
+ * scratch.states[depth].  If every state is a child step with the same
+ * local name, no other child can match or lead to a match, and only the
+ * children with that name are visited.
+ */
+void
+XMLNodeQuery::pushFrame (Scratch& scratch, const XMLNode& element,
+                         size_t depth) const
+{
+  const StateSet&    states = scratch.states[depth];
+  const std::string& name   = mPath.getStep(states[0].step).test.name;
+
+  Frame frame;
+  frame.node   = &element;
+  frame.depth  = depth;
+  frame.byName = !name.empty();
+
+  for (size_t n = 0; n < states.size() && frame.byName; ++n)
+  {
+    const Step& step = mPath.getStep(states[n].step);
+    frame.byName = !step.descendant && step.test.name == name;
+  }
+
+  if (frame.byName)
+  {
+    frame.next = element.getIndex(name);
+  }
+  else
+  {
+    frame.next = (element.getNumChildren() > 0) ? 0 : -1;
+  }
+
+  scratch.frames.push_back(frame);
+}
+
+
+/*
+ * Evaluates the subtrees of a ParallelWork, one at a time, until none
+ * are left.
+ */
+void
+XMLNodeQuery::runParallel (void* data, unsigned int)
+{
+  ParallelWork&       work  = *static_cast<ParallelWork*>(data);
+  const vector<Part>& parts = *work.parts;
+  Scratch             scratch;
+
+  for (;;)
+  {
+    size_t n;
+
+    {
+      XMLMutexLock lock(work.mutex);
+
+      while (work.next < parts.size() && parts[work.next].states.empty())
+      {
+        ++work.next;
+      }
+
+      if (work.next == parts.size()) return;
+
+      n = work.next++;
+    }
+
+    work.query->evaluateBelow(*parts[n].node, parts[n].states, scratch,
+                              work.results[n], false);
+  }
+}
+/** @endcond */
+
+
+LIBLX_CPP_NAMESPACE_END
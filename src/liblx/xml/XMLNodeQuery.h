@@ -0,0 +1,303 @@
+/**
+ * @file    XMLNodeQuery.h
+ * @brief   Compiled location paths evaluated over XMLNode trees
+ *
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ *
+ * @class XMLNodeQuery
+ * @sbmlbrief{core} Selects the elements of an XMLNode tree that match a
+ * location path.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * XMLNode::getChild(const std::string&) and XMLNode::getIndex() find
+ * the children of a single element.  Anything deeper, such as all the
+ * @c species elements of a model, otherwise needs a hand-written walk of
+ * the tree.  An XMLNodeQuery compiles a location path once and can then
+ * be evaluated any number of times, on any number of trees:
+ * @code{.cpp}
+XMLNodeQuery query;
+query.compile("/sbml/model/listOfSpecies/species[@compartment='c']");
+
+std::vector<const XMLNode*> species;
+query.evaluate(root, species);
+@endcode
+ *
+ * The paths use the same subset of XPath as XMLPathMatcher, except that
+ * they select elements only, so a path cannot end with an attribute:
+ * <ul>
+ * <li> Each path starts with @c / (child) or @c // (descendant), and
+ * steps are separated by @c / or @c //.  The tree passed to evaluate()
+ * is treated as the only child of a document, so at its root element
+ * <code>/sbml</code> selects the root itself.
+ * <li> A step is an element name, optionally with a prefix
+ * (<code>math:apply</code>), @c * for any element, or
+ * <code>prefix:*</code> for any element with that prefix.  A name
+ * without a prefix matches elements in any namespace.  A prefix that is
+ * bound in the XMLNamespaces passed to compile() matches elements in
+ * the namespace it is bound to, whatever their own prefix; any other
+ * prefix is compared with the prefix of the element.
+ * <li> A step may have predicates on attributes, named like elements:
+ * <code>[@@id]</code> requires the attribute to be present,
+ * <code>[@@id='value']</code> (or with double quotes) requires it to have
+ * the given value.
+ * <li> A step may have one position predicate <code>[n]</code>, which
+ * keeps the <code>n</code>th element (counting from 1) among the children
+ * of the same parent that pass the name test and the predicates before
+ * it.  As in XPath, <code>//item[1]</code> selects every @c item that is
+ * the first @c item child of its parent.
+ * </ul>
+ *
+ * The elements selected are returned in document order, each once.
+ *
+ * Evaluation walks the tree once, without recursion, keeping for each
+ * level of the tree the steps that may still match below it; subtrees in
+ * which no step can match are not visited.  The working storage grows
+ * with the depth of the tree and is reused from one element to the next,
+ * so no memory is allocated per element or per step.  Where a step can
+ * only match children of a given name, they are found with
+ * XMLNode::getIndex() and XMLNode::getNextIndex(), which use the child
+ * name index that wide elements keep.
+ *
+ * A compiled XMLNodeQuery is not changed by evaluation, so one query may
+ * be evaluated by several threads at once.  evaluateParallel() spreads
+ * the evaluation of a single large tree over several threads.
+ */
+
+#ifndef XMLNodeQuery_h
+#define XMLNodeQuery_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/XMLLocationPath.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLNamespaces;
+class XMLNode;
+
+
+class LIBLX_EXTERN XMLNodeQuery
+{
+public:
+
+  /**
+   * Creates a new XMLNodeQuery without a path; it selects nothing until
+   * compile() succeeds.
+   */
+  XMLNodeQuery ();
+
+
+  /**
+   * Compiles @p path, replacing any path compiled before.  Prefixes in
+   * @p path are compared with the prefixes of elements and attributes.
+   *
+   * @param path the location path.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+   * if @p path is not a supported location path or selects attributes.
+   * The query is left without a path.
+   */
+  int compile (const std::string& path);
+
+
+  /**
+   * Compiles @p path, replacing any path compiled before.  Prefixes in
+   * @p path that are bound in @p namespaces select by namespace URI.
+   *
+   * @param path the location path.
+   * @param namespaces the prefixes that stand for namespaces.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+   * if @p path is not a supported location path or selects attributes.
+   * The query is left without a path.
+   */
+  int compile (const std::string& path, const XMLNamespaces& namespaces);
+
+
+  /**
+   * @return true if this XMLNodeQuery holds a compiled path.
+   */
+  bool isCompiled () const;
+
+
+  /**
+   * @return the path of this XMLNodeQuery, or an empty string if it has
+   * none.
+   */
+  const std::string& getPath () const;
+
+
+  /**
+   * Replaces the contents of @p result by the elements of the tree rooted
+   * at @p root that the path selects, in document order.
+   *
+   * @param root the root of the tree.
+   * @param result the vector to fill.
+   *
+   * @return the number of elements selected.
+   */
+  unsigned int evaluate (const XMLNode& root,
+                         std::vector<const XMLNode*>& result) const;
+
+
+  /**
+   * Replaces the contents of @p result by the elements of the tree rooted
+   * at @p root that the path selects, in document order.
+   *
+   * @param root the root of the tree.
+   * @param result the vector to fill.
+   *
+   * @return the number of elements selected.
+   */
+  unsigned int evaluate (XMLNode& root, std::vector<XMLNode*>& result) const;
+
+
+  /**
+   * @return the first element, in document order, of the tree rooted at
+   * @p root that the path selects, or @c NULL if there is none.  The
+   * walk stops at that element.
+   *
+   * @param root the root of the tree.
+   */
+  const XMLNode* evaluateFirst (const XMLNode& root) const;
+
+
+  /**
+   * Does the same as evaluate(const XMLNode&, std::vector<const XMLNode*>&)
+   * const, using up to @p numThreads threads.
+   *
+   * The top of the tree is walked on the calling thread until it has been
+   * split into enough independent subtrees; the subtrees are then
+   * evaluated by the threads as each becomes free, and their results are
+   * joined in document order.  This pays off for large trees in which
+   * the path selects from many subtrees.  Small trees, and libLX builds
+   * without thread support, are evaluated on the calling thread.
+   *
+   * The tree must not be changed while it is evaluated.
+   *
+   * @param root the root of the tree.
+   * @param result the vector to fill.
+   * @param numThreads the largest number of threads to use, or 0 for one
+   * per processor.
+   *
+   * @return the number of elements selected.
+   */
+  unsigned int evaluateParallel (const XMLNode& root,
+                                 std::vector<const XMLNode*>& result,
+                                 unsigned int numThreads = 0) const;
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  typedef XMLLocationPath::Step Step;
+
+  /*
+   * Step step may match the children of the element that owns the state;
+   * count is the number of them that passed the predicates before the
+   * position predicate.
+   */
+  struct State
+  {
+    unsigned int step;
+    unsigned int count;
+  };
+
+  typedef std::vector<State> StateSet;
+
+  /* An element whose children are still to be visited. */
+  struct Frame
+  {
+    const XMLNode* node;
+    size_t         depth;
+    int            next;
+    bool           byName;
+  };
+
+  /* The working storage of one evaluation. */
+  struct Scratch
+  {
+    std::vector<StateSet> states;
+    std::vector<Frame>    frames;
+  };
+
+  /*
+   * One entry of the top of a tree being evaluated in parallel: an
+   * element the path selects, or a subtree still to be evaluated.
+   */
+  struct Part
+  {
+    const XMLNode* node;
+    bool           selected;
+    StateSet       states;
+  };
+
+  struct ParallelWork;
+
+
+  bool compilePath (const std::string& path, const XMLNamespaces* namespaces);
+
+  bool visit (StateSet& outer, const XMLNode& element,
+              StateSet& inner) const;
+
+  unsigned int evaluateBelow (const XMLNode& element, const StateSet& states,
+                              Scratch& scratch,
+                              std::vector<const XMLNode*>& result,
+                              bool first) const;
+
+  void pushFrame (Scratch& scratch, const XMLNode& element,
+                  size_t depth) const;
+
+  static void runParallel (void* data, unsigned int worker);
+
+
+  XMLLocationPath mPath;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* XMLNodeQuery_h */
@@ -0,0 +1,501 @@
+/**
+ * @file    XMLNumberReader.cpp
+ * @brief   Reads whitespace-separated numbers from XML character data
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <cerrno>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#include <liblx/xml/XMLToken.h>
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLNumberReader.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+/** @cond doxygenLibsbmlInternal */
+
+/*
+ * @return true if c is XML whitespace.
+ */
+static inline bool
+isSpace (char c)
+{
+  return (c == ' ' || c == '\n' || c == '\t' || c == '\r');
+}
+
+
+static inline bool
+isDigit (char c)
+{
+  return (c >= '0' && c <= '9');
+}
+
+
+/*
+ * Powers of ten that are exactly representable as doubles.
+ */
+static const double sExactPowers[] =
+{
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+/*
+ * Converts the decimal number in [begin, end) without going through
+ * strtod, for the common case where that can be done exactly: at most 19
+ * significant digits forming an integer below 2^53, scaled by a power of
+ * ten that is itself exact (Clinger's fast path).  Both operands being
+ * exact, the single multiplication or division is correctly rounded.
+ *
+ * @return false if the number is not of this form, in which case the
+ * caller falls back to strtod.
+ */
+static bool
+parseFastDouble (const char* begin, const char* end, double& value)
+{
+  const char* p        = begin;
+  bool        negative = false;
+
+  if (p < end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  uint64_t mantissa    = 0;
+  int      significant = 0;
+  int      exponent    = 0;
+  bool     digits      = false;
+
+  for (; p < end && isDigit(*p); ++p)
+  {
+    digits = true;
+    if (mantissa == 0 && *p == '0') continue;
+    if (++significant > 19) return false;
+    mantissa = mantissa * 10 + (*p - '0');
+  }
+
+  if (p < end && *p == '.')
+  {
+    for (++p; p < end && isDigit(*p); ++p)
+    {
+      digits = true;
+      --exponent;
+      if (mantissa == 0 && *p == '0') continue;
+      if (++significant > 19) return false;
+      mantissa = mantissa * 10 + (*p - '0');
+    }
+  }
+
+  if (!digits) return false;
+
+  if (p < end && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+
+    bool negExp = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+      negExp = (*p == '-');
+      ++p;
+    }
+
+    if (p == end || !isDigit(*p)) return false;
+
+    int e = 0;
+    for (; p < end && isDigit(*p); ++p)
+    {
+      if (e > 10000) return false;
+      e = e * 10 + (*p - '0');
+    }
+
+    exponent += negExp ? -e : e;
+  }
+
+  if (p != end) return false;
+  if (mantissa > (static_cast<uint64_t>(1) << 53)) return false;
+
+  double result = static_cast<double>(mantissa);
+
+  if (mantissa != 0)
+  {
+    if (exponent < -22 || exponent > 22) return false;
+
+    if (exponent < 0)
+      result /= sExactPowers[-exponent];
+    else
+      result *= sExactPowers[exponent];
+  }
+
+  value = negative ? -result : result;
+  return true;
+}
+
+
+/*
+ * Converts the base-10 integer in [begin, end), rejecting anything that
+ * does not fit into 64 bits.
+ */
+static bool
+parseInteger (const char* begin, const char* end, int64_t& value)
+{
+  const char* p        = begin;
+  bool        negative = false;
+
+  if (p < end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  if (p == end) return false;
+
+  const uint64_t limit = negative
+    ? static_cast<uint64_t>(numeric_limits<int64_t>::max()) + 1
+    : static_cast<uint64_t>(numeric_limits<int64_t>::max());
+
+  uint64_t result = 0;
+
+  for (; p < end; ++p)
+  {
+    if (!isDigit(*p)) return false;
+
+    const unsigned int digit = *p - '0';
+    if (result > (limit - digit) / 10) return false;
+
+    result = result * 10 + digit;
+  }
+
+  value = negative ? static_cast<int64_t>(0 - result)
+                   : static_cast<int64_t>(result);
+  return true;
+}
+
+/** @endcond */
+
+
+/*
+ * Creates a new XMLNumberReader appending doubles to values.
+ */
+XMLNumberReader::XMLNumberReader (std::vector<double>& values,
+                                  XMLErrorLog* log) :
+   mDoubles  ( &values )
+ , mIntegers ( NULL    )
+ , mLog      ( log     )
+ , mLocaleSet( false   )
+ , mValid    ( true    )
+ , mLine     ( 0       )
+ , mColumn   ( 0       )
+{
+}
+
+
+/*
+ * Creates a new XMLNumberReader appending integers to values.
+ */
+XMLNumberReader::XMLNumberReader (std::vector<int64_t>& values,
+                                  XMLErrorLog* log) :
+   mDoubles  ( NULL    )
+ , mIntegers ( &values )
+ , mLog      ( log     )
+ , mLocaleSet( false   )
+ , mValid    ( true    )
+ , mLine     ( 0       )
+ , mColumn   ( 0       )
+{
+}
+
+
+/*
+ * Destroys this XMLNumberReader.
+ */
+XMLNumberReader::~XMLNumberReader ()
+{
+}
+
+
+/*
+ * Parses the next length characters of text.  Every number that is
+ * followed by whitespace within chars is converted in place; a number
+ * running up to the end of chars is kept in mPending until its end is
+ * seen.
+ */
+bool
+XMLNumberReader::append (const char* chars, size_t length)
+{
+  if (chars == NULL) return mValid;
+
+  const char* p   = chars;
+  const char* end = chars + length;
+
+  if (!mPending.empty())
+  {
+    const char* q = p;
+    while (q < end && !isSpace(*q)) ++q;
+
+    mPending.append(p, q - p);
+    p = q;
+
+    if (p == end) return mValid;
+
+    convert(mPending.data(), mPending.data() + mPending.size());
+    mPending.clear();
+  }
+
+  while (p < end)
+  {
+    while (p < end && isSpace(*p)) ++p;
+    if (p == end) break;
+
+    const char* start = p;
+    while (p < end && !isSpace(*p)) ++p;
+
+    if (p == end)
+    {
+      mPending.assign(start, p - start);
+      break;
+    }
+
+    // the token is followed by whitespace, which also stops strtod
+    convert(start, p);
+  }
+
+  if (mLocaleSet)
+  {
+    setlocale(LC_ALL, mLocale.empty() ? NULL : mLocale.c_str());
+    mLocaleSet = false;
+  }
+
+  return mValid;
+}
+
+
+/*
+ * Parses the characters in chars.
+ */
+bool
+XMLNumberReader::append (const std::string& chars)
+{
+  return append(chars.data(), chars.size());
+}
+
+
+/*
+ * Parses the characters of a text token.
+ */
+void
+XMLNumberReader::characters (const XMLToken& data)
+{
+  append(data.getCharacters());
+}
+
+
+/*
+ * Converts the last number, if it was not followed by whitespace.
+ */
+bool
+XMLNumberReader::finish ()
+{
+  if (!mPending.empty())
+  {
+    // mPending is NUL-terminated, so strtod stops at its end
+    convert(mPending.c_str(), mPending.c_str() + mPending.size());
+    mPending.clear();
+
+    if (mLocaleSet)
+    {
+      setlocale(LC_ALL, mLocale.empty() ? NULL : mLocale.c_str());
+      mLocaleSet = false;
+    }
+  }
+
+  return mValid;
+}
+
+
+bool
+XMLNumberReader::isValid () const
+{
+  return mValid;
+}
+
+
+void
+XMLNumberReader::setPosition (unsigned int line, unsigned int column)
+{
+  mLine   = line;
+  mColumn = column;
+}
+
+
+/*
+ * Appends the numbers in text to values.
+ */
+bool
+XMLNumberReader::readInto (const std::string&   text,
+                           std::vector<double>& values,
+                           XMLErrorLog*         log,
+                           unsigned int         line,
+                           unsigned int         column)
+{
+  XMLNumberReader reader(values, log);
+  reader.setPosition(line, column);
+
+  reader.append(text);
+  return reader.finish();
+}
+
+
+/*
+ * Appends the integers in text to values.
+ */
+bool
+XMLNumberReader::readInto (const std::string&    text,
+                           std::vector<int64_t>& values,
+                           XMLErrorLog*          log,
+                           unsigned int          line,
+                           unsigned int          column)
+{
+  XMLNumberReader reader(values, log);
+  reader.setPosition(line, column);
+
+  reader.append(text);
+  return reader.finish();
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Converts the token [begin, end) and appends it to the target vector.
+ * end must point at a character that stops strtod (whitespace or NUL).
+ */
+void
+XMLNumberReader::convert (const char* begin, const char* end)
+{
+  if (mIntegers != NULL)
+  {
+    int64_t value;
+
+    if (parseInteger(begin, end, value))
+      mIntegers->push_back(value);
+    else
+      numberError(begin, end);
+
+    return;
+  }
+
+  const size_t length = end - begin;
+  double       value;
+
+  if (length == 4 && strncmp(begin, "-INF", 4) == 0)
+  {
+    mDoubles->push_back(- numeric_limits<double>::infinity());
+  }
+  else if (length == 3 && strncmp(begin, "INF", 3) == 0)
+  {
+    mDoubles->push_back(numeric_limits<double>::infinity());
+  }
+  else if (length == 3 && strncmp(begin, "NaN", 3) == 0)
+  {
+    mDoubles->push_back(numeric_limits<double>::quiet_NaN());
+  }
+  else if (parseFastDouble(begin, end, value))
+  {
+    mDoubles->push_back(value);
+  }
+  else
+  {
+    // Ensure C locale, once per call of append()
+    if (!mLocaleSet)
+    {
+      char* ptr  = setlocale(LC_ALL, NULL);
+      mLocale    = (ptr) ? ptr : "";
+      mLocaleSet = true;
+      setlocale(LC_ALL, "C");
+    }
+
+    errno        = 0;
+    char* endptr = NULL;
+    value        = strtod(begin, &endptr);
+
+    if (endptr == end && errno != ERANGE)
+      mDoubles->push_back(value);
+    else
+      numberError(begin, end);
+  }
+}
+
+
+/*
+ * Logs the first invalid number seen by this reader.
+ */
+void
+XMLNumberReader::numberError (const char* begin, const char* end)
+{
+  if (!mValid) return;
+  mValid = false;
+
+  if (mLog == NULL) return;
+
+  ostringstream message;
+
+  message << "The text content must be a list of ";
+
+  if (mIntegers != NULL)
+  {
+    message << "integers (whole numbers) separated by whitespace.";
+  }
+  else
+  {
+    message << "doubles (decimal numbers) separated by whitespace.  To"
+      " represent infinity use \"INF\", negative infinity use \"-INF\","
+      " and not-a-number use \"NaN\".";
+  }
+
+  message << "  The value '" << string(begin, end) << "' is not valid.";
+
+  mLog->add( XMLError(XMLBadNumber, message.str(), mLine, mColumn) );
+}
+/** @endcond */
+
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,268 @@
+/**
+ * @file    XMLNumberReader.h
+ * @brief   Reads whitespace-separated numbers from XML character data
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ *
+ * @class XMLNumberReader
+ * @sbmlbrief{core} Reads arrays of numbers stored as XML text content.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * Large vectors are commonly stored as the text content of an element,
+ * as numbers separated by XML whitespace:
+ * @verbatim
+<data>0.5 1.25e-3 INF -INF NaN 42</data>
+@endverbatim
+ *
+ * An XMLNumberReader parses such text straight into a
+ * <code>std::vector&lt;double&gt;</code> or
+ * <code>std::vector&lt;int64_t&gt;</code>.  Values of type double follow
+ * the same rules as XMLAttributes::readInto(): "INF", "-INF" and "NaN"
+ * denote infinity, negative infinity and not-a-number, and anything else
+ * must be a complete number in the C locale.  Integer values must be
+ * complete base-10 numbers that fit into 64 bits.
+ *
+ * The text may be given all at once, using the static readInto()
+ * methods, or as a series of chunks passed to append(), in which case a
+ * number that is split across two chunks is handled transparently.  Since
+ * XMLNumberReader is an XMLHandler, it can also be passed to
+ * XMLInputStream::readCharacters(); together with
+ * XMLInputStream::setCharacterChunkSize(), a numeric array of any size
+ * can then be read without ever holding its text in memory:
+ * @code{.cpp}
+std::vector<double> values;
+XMLNumberReader     reader(values, stream.getErrorLog());
+
+stream.setCharacterChunkSize(65536);
+stream.next();                    // the <data> start element
+stream.readCharacters(reader);
+reader.finish();
+@endcode
+ *
+ * The first token that is not a valid number is reported to the
+ * XMLErrorLog (if any) as an @sbmlconstant{XMLBadNumber, XMLErrorCode_t}
+ * error.  Invalid tokens are skipped; the remaining numbers are still
+ * read.
+ *
+ * @see XMLOutputStream::writeArray()
+ */
+
+#ifndef XMLNumberReader_h
+#define XMLNumberReader_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <liblx/xml/XMLHandler.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLErrorLog;
+class XMLToken;
+
+
+class LIBLX_EXTERN XMLNumberReader : public XMLHandler
+{
+public:
+
+  /**
+   * Creates a new XMLNumberReader that appends the numbers it reads to
+   * @p values.
+   *
+   * @param values the vector to which the numbers read are appended.
+   * @param log an XMLErrorLog to which invalid numbers are reported.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLNumberReader (std::vector<double>& values, XMLErrorLog* log = NULL);
+
+
+  /**
+   * Creates a new XMLNumberReader that appends the integers it reads to
+   * @p values.
+   *
+   * @param values the vector to which the numbers read are appended.
+   * @param log an XMLErrorLog to which invalid numbers are reported.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLNumberReader (std::vector<int64_t>& values, XMLErrorLog* log = NULL);
+
+
+  /**
+   * Destroys this XMLNumberReader.
+   */
+  virtual ~XMLNumberReader ();
+
+
+  /**
+   * Parses the next @p length characters of text.  A number at the end of
+   * @p chars is not converted until the whitespace following it (or the
+   * end of the text, see finish()) has been seen.
+   *
+   * @param chars the characters to parse.
+   * @param length the number of characters to use from @p chars.
+   *
+   * @return @c true if no invalid number has been seen so far, @c false
+   * otherwise.
+   */
+  bool append (const char* chars, size_t length);
+
+
+  /**
+   * Parses the characters in @p chars.
+   *
+   * @param chars the characters to parse.
+   *
+   * @return @c true if no invalid number has been seen so far, @c false
+   * otherwise.
+   */
+  bool append (const std::string& chars);
+
+
+  /**
+   * Receive notification of character data; parses the characters of
+   * @p data.
+   */
+  virtual void characters (const XMLToken& data);
+
+
+  /**
+   * Signals the end of the text, converting the last number if it was
+   * not followed by whitespace.
+   *
+   * @return @c true if the whole text was a valid list of numbers,
+   * @c false otherwise.
+   */
+  bool finish ();
+
+
+  /**
+   * Returns @c true if no invalid number has been seen so far.
+   *
+   * @return @c true if all the numbers read so far were valid.
+   */
+  bool isValid () const;
+
+
+  /**
+   * Sets the line and column reported with errors.
+   *
+   * @param line the line number.
+   * @param column the column number.
+   */
+  void setPosition (unsigned int line, unsigned int column);
+
+
+  /**
+   * Appends the numbers in @p text to @p values.
+   *
+   * @param text the whitespace-separated numbers to read.
+   * @param values the vector to which the numbers are appended.
+   * @param log an XMLErrorLog to which an invalid number is reported.
+   * @param line the line number reported with errors.
+   * @param column the column number reported with errors.
+   *
+   * @return @c true if @p text was a valid list of numbers, @c false
+   * otherwise.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  static bool readInto (const std::string&   text,
+                        std::vector<double>& values,
+                        XMLErrorLog*         log    = NULL,
+                        unsigned int         line   = 0,
+                        unsigned int         column = 0);
+
+
+  /**
+   * Appends the integers in @p text to @p values.
+   *
+   * @param text the whitespace-separated integers to read.
+   * @param values the vector to which the numbers are appended.
+   * @param log an XMLErrorLog to which an invalid number is reported.
+   * @param line the line number reported with errors.
+   * @param column the column number reported with errors.
+   *
+   * @return @c true if @p text was a valid list of integers, @c false
+   * otherwise.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  static bool readInto (const std::string&    text,
+                        std::vector<int64_t>& values,
+                        XMLErrorLog*          log    = NULL,
+                        unsigned int          line   = 0,
+                        unsigned int          column = 0);
+
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  XMLNumberReader (const XMLNumberReader& orig);
+  XMLNumberReader& operator= (const XMLNumberReader& rhs);
+
+  /** @endcond */
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  void convert (const char* begin, const char* end);
+  void numberError (const char* begin, const char* end);
+
+  std::vector<double>*  mDoubles;
+  std::vector<int64_t>* mIntegers;
+  XMLErrorLog*          mLog;
+
+  std::string           mPending;
+  std::string           mLocale;
+  bool                  mLocaleSet;
+  bool                  mValid;
+
+  unsigned int          mLine;
+  unsigned int          mColumn;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+#endif  /* XMLNumberReader_h */
@@ -46,6 +46,7 @@
 #include <liblx/xml/XMLAttributes.h>
 #include <liblx/xml/XMLConstructorException.h>
 #include <liblx/xml/XMLNamespaces.h>
+#include <liblx/xml/XMLBase64.h>
 #include <liblx/xml/sbmlMemoryStubs.h>
 #include <liblx/xml/sbmlMemoryStubs.h>
 #include <liblx/xml/common/common.h>
@@ -880,7 +881,17 @@ void
 XMLOutputStream::writeValue (const double& value)
 {
   mStream << '=' << '"';
+  writeNumber(value);
+  mStream << '"';
+}
+
 
+/*
+ * Outputs the double value, or "INF", "-INF", or "NaN".
+ */
+void
+XMLOutputStream::writeNumber (const double& value)
+{
   if (value != value)
   {
     mStream << "NaN";
@@ -898,8 +909,6 @@ XMLOutputStream::writeValue (const double& value)
     mStream.precision(LIBLX_DOUBLE_PRECISION);
     mStream <<   value;
   }
-
-  mStream << '"';
 }
 
 
@@ -1069,6 +1078,84 @@ XMLOutputStream::operator<< (const long& value)
 }
 
 
+/*
+ * Writes the given numbers as space-separated text content.
+ */
+void
+XMLOutputStream::writeArray (const std::vector<double>& values)
+{
+  if (mInStart)
+  {
+    mInStart = false;
+    mStream << '>';
+  }
+
+  for (size_t n = 0; n < values.size(); ++n)
+  {
+    if (n > 0) mStream << ' ';
+    writeNumber(values[n]);
+  }
+
+  mInText = true;
+  mSkipNextIndent = true;
+}
+
+
+/*
+ * Writes the given integers as space-separated text content.
+ */
+void
+XMLOutputStream::writeArray (const std::vector<int64_t>& values)
+{
+  if (mInStart)
+  {
+    mInStart = false;
+    mStream << '>';
+  }
+
+  for (size_t n = 0; n < values.size(); ++n)
+  {
+    if (n > 0) mStream << ' ';
+    mStream << values[n];
+  }
+
+  mInText = true;
+  mSkipNextIndent = true;
+}
+
+
+/*
+ * Writes the base64 encoding of the given bytes as text content.
+ */
+void
+XMLOutputStream::writeBase64 (const void* data, size_t length)
+{
+  XMLBase64Encoder encoder(*this);
+
+  encoder.append(data, length);
+  encoder.finish();
+}
+
+
+/*
+ * Writes characters that need no escaping as text content.
+ */
+void
+XMLOutputStream::writeUnescapedChars (const char* chars, size_t length)
+{
+  if (mInStart)
+  {
+    mInStart = false;
+    mStream << '>';
+  }
+
+  mStream.write(chars, length);
+
+  mInText = true;
+  mSkipNextIndent = true;
+}
+
+
 /**
  * Outputs a single character to the underlying stream.
  */
@@ -229,6 +229,8 @@ on yyyy-MM-dd HH:mm with libSBML version <libsbml version>. -->
 #include <limits>
 #include <locale>
 #include <string>
+#include <vector>
+#include <stdint.h>
 #include <time.h>
 #include <liblx/xml/common/liblx-version.h>
 
@@ -677,6 +679,41 @@ on yyyy-MM-dd HH:mm with libSBML version <libsbml version>. -->
   XMLOutputStream& operator<< (const char& c);
 
 
+  /**
+   * Writes the given numbers as text content, separated by single spaces.
+   *
+   * Infinity, negative infinity and not-a-number are written as "INF",
+   * "-INF" and "NaN", and other values with the same precision as
+   * attribute values, so that the text can be read back with
+   * XMLNumberReader.
+   *
+   * @param values the numbers to write.
+   */
+  void writeArray (const std::vector<double>& values);
+
+
+  /**
+   * Writes the given integers as text content, separated by single
+   * spaces.
+   *
+   * @param values the numbers to write.
+   */
+  void writeArray (const std::vector<int64_t>& values);
+
+
+  /**
+   * Writes the base64 encoding of the given bytes as text content.
+   *
+   * The encoding is written straight to the underlying stream, without
+   * building an intermediate string.  Use an XMLBase64Encoder to write
+   * data that arrives in pieces.
+   *
+   * @param data the bytes to encode.
+   * @param length the number of bytes to use from @p data.
+   */
+  void writeBase64 (const void* data, size_t length);
+
+
   /**
    * Decreases the indentation level for this XMLOutputStream.
    *
@@ -699,6 +736,13 @@ on yyyy-MM-dd HH:mm with libSBML version <libsbml version>. -->
 
   /** @cond doxygenLibsbmlInternal */
   bool getStringStream();
+
+
+  /**
+   * Writes length characters as text content, without escaping them.
+   * Only for characters known not to need escaping.
+   */
+  void writeUnescapedChars (const char* chars, size_t length);
   /** @endcond */
 
 
@@ -851,6 +895,12 @@ protected:
   void writeValue (const double& value);
 
 
+  /**
+   * Outputs the double value without quotes, or "INF", "-INF", or "NaN".
+   */
+  void writeNumber (const double& value);
+
+
   /**
    * Outputs the long value in quotes.
    */
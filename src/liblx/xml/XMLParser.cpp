@@ -38,6 +38,8 @@
  * also available online as http://sbml.org/software/libsbml/license.html
  * ---------------------------------------------------------------------- -->*/
 
+#include <algorithm>
+#include <cstring>
 
 #ifdef USE_EXPAT
 #include <liblx/xml/ExpatParser.h>
@@ -64,7 +66,10 @@ LIBLX_CPP_NAMESPACE_BEGIN
  * Creates a new XMLParser.  The parser will notify the given XMLHandler
  * of parse events and errors.
  */
-XMLParser::XMLParser () : mErrorLog(NULL)
+XMLParser::XMLParser () :
+   mErrorLog  ( NULL )
+ , mByteOffset( 0    )
+ , mTrackPositions( true )
 {
 }
 
@@ -119,6 +124,77 @@ XMLParser::getErrorLog ()
 }
 
 
+/*
+ * @return the byte offset reached by the parser.
+ */
+size_t
+XMLParser::getByteOffset () const
+{
+  return mByteOffset;
+}
+
+
+/*
+ * Sets whether the line and column of every element are looked up while
+ * parsing.
+ */
+void
+XMLParser::setTrackPositions (bool track)
+{
+  mTrackPositions = track;
+}
+
+
+/*
+ * @return true if the line and column of every element are looked up
+ * while parsing.
+ */
+bool
+XMLParser::getTrackPositions () const
+{
+  return mTrackPositions;
+}
+
+
+/*
+ * Turns a byte offset in the input into a line and column number.
+ */
+bool
+XMLParser::getPosition (size_t offset,
+                        unsigned int& line, unsigned int& column) const
+{
+  if (mTrackPositions || offset > mByteOffset) return false;
+
+  // mLineStarts holds the start of every line but the first
+  std::vector<size_t>::const_iterator it =
+    std::upper_bound(mLineStarts.begin(), mLineStarts.end(), offset);
+
+  const size_t start = (it == mLineStarts.begin()) ? 0 : *(it - 1);
+
+  line   = static_cast<unsigned int>(it - mLineStarts.begin()) + 1;
+  column = static_cast<unsigned int>(offset - start) + 1;
+
+  return true;
+}
+
+
+/*
+ * Records the line starts in the next length bytes of the input.
+ */
+void
+XMLParser::indexLines (const char* chunk, size_t length)
+{
+  const char* end = chunk + length;
+  const char* p   = chunk;
+
+  while ((p = static_cast<const char*>(memchr(p, '\n', end - p))) != NULL)
+  {
+    ++p;
+    mLineStarts.push_back(mByteOffset + (p - chunk));
+  }
+}
+
+
 /*
  * Sets the XMLErrorLog this parser will use to log errors.
  */
@@ -50,6 +50,7 @@
 #ifdef __cplusplus
 
 #include <string>
+#include <vector>
 #include <liblx/xml/common/extern.h>
 
 LIBLX_CPP_NAMESPACE_BEGIN
@@ -153,6 +154,55 @@ public:
   virtual unsigned int getLine () const = 0;
 
 
+  /**
+   * Returns how far into the document the parser has got, in bytes of the
+   * uncompressed input.  After a start element made the XMLHandler stop
+   * the parser (see XMLHandler::isStopped()), this is the position of
+   * that element with Expat, and the position just after its name and
+   * attributes with libxml2; otherwise it is the number of bytes read so
+   * far.  Parsers that read their input themselves report @c 0.
+   *
+   * @return the byte offset reached by the parser.
+   */
+  size_t getByteOffset () const;
+
+
+  /**
+   * Sets whether the line and column of every element are looked up
+   * while parsing.
+   *
+   * When they are not, the parser front ends give each start and end
+   * element its byte offset instead (see XMLToken::getOffset()), which
+   * costs next to nothing, and the parser records where each line of the
+   * input starts.  getPosition() then turns offsets into line and column
+   * numbers when they are needed.  Errors reported by the parser itself
+   * keep their line and column numbers.  Parsers that cannot report byte
+   * offsets keep looking up positions.
+   *
+   * @param track @c true to look up positions (the default), @c false to
+   * record byte offsets.
+   */
+  virtual void setTrackPositions (bool track);
+
+
+  /**
+   * @return @c true if the line and column of every element are looked up
+   * while parsing.
+   */
+  bool getTrackPositions () const;
+
+
+  /**
+   * Turns a byte offset in the input into a line and column number.  The
+   * column is counted in bytes.  This only works for parts of the input
+   * that were read while positions were not tracked.
+   *
+   * @return @c true if @p offset could be located, @c false otherwise.
+   */
+  bool getPosition (size_t offset,
+                    unsigned int& line, unsigned int& column) const;
+
+
   /**
    * Returns an XMLErrorLog which can be used to log XML parse errors and
    * other validation errors (and messages).
@@ -183,7 +233,18 @@ protected:
    */
   XMLParser ();
 
+  /**
+   * Records the line starts in the next length bytes of the input, which
+   * begin at mByteOffset.
+   */
+  void indexLines (const char* chunk, size_t length);
+
+
   XMLErrorLog* mErrorLog;
+  size_t       mByteOffset;
+
+  bool                mTrackPositions;
+  std::vector<size_t> mLineStarts;
 };
 
 
@@ -0,0 +1,340 @@
+/**
+ * @file    XMLPathMatcher.cpp
+ * @brief   Streaming matcher for simple location paths
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <liblx/xml/XMLToken.h>
+#include <liblx/xml/XMLAttributes.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLPathMatcher.h>
+#include <liblx/xml/operationReturnValues.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+/*
+ * Destroys this XMLPathHandler.
+ */
+XMLPathHandler::~XMLPathHandler ()
+{
+}
+
+
+/*
+ * Receive notification of an element selected by a path.
+ *
+ * By default, do nothing.
+ */
+void
+XMLPathHandler::element (unsigned int, const XMLToken&, XMLInputStream&)
+{
+}
+
+
+/*
+ * Receive notification of an attribute selected by a path.
+ *
+ * By default, do nothing.
+ */
+void
+XMLPathHandler::attribute (unsigned int, const XMLToken&, int)
+{
+}
+
+
+/*
+ * Creates a new XMLPathMatcher without any paths.
+ */
+XMLPathMatcher::XMLPathMatcher ()
+{
+}
+
+
+/*
+ * Destroys this XMLPathMatcher.
+ */
+XMLPathMatcher::~XMLPathMatcher ()
+{
+}
+
+
+/*
+ * Compiles path and adds it to the set of paths to match.
+ */
+int
+XMLPathMatcher::addPath (const std::string& path)
+{
+  return addCompiled(path, NULL);
+}
+
+
+/*
+ * Compiles path, resolving the prefixes bound in namespaces, and adds it
+ * to the set of paths to match.
+ */
+int
+XMLPathMatcher::addPath (const std::string& path,
+                         const XMLNamespaces& namespaces)
+{
+  return addCompiled(path, &namespaces);
+}
+
+
+/*
+ * @return the number of paths in this XMLPathMatcher.
+ */
+unsigned int
+XMLPathMatcher::getNumPaths () const
+{
+  return static_cast<unsigned int>( mPaths.size() );
+}
+
+
+/*
+ * @return the text of the nth path, or an empty string.
+ */
+std::string
+XMLPathMatcher::getPath (unsigned int n) const
+{
+  return (n < mPaths.size()) ? mPaths[n].getSource() : "";
+}
+
+
+/*
+ * Removes all paths.
+ */
+void
+XMLPathMatcher::clear ()
+{
+  mPaths.clear();
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+
+/*
+ * Adds state to states unless it is already there.
+ */
+template <typename State>
+static void
+addState (std::vector<State>& states, unsigned int path, unsigned int step)
+{
+  for (size_t n = 0; n < states.size(); ++n)
+  {
+    if (states[n].path == path && states[n].step == step) return;
+  }
+
+  State state;
+  state.path  = path;
+  state.step  = step;
+  state.count = 0;
+
+  states.push_back(state);
+}
+
+/** @endcond */
+
+
+/*
+ * Reads stream up to the end of the enclosing element and reports the
+ * matches to handler.
+ *
+ * mStates[d] holds the (path, step) pairs that are still alive inside
+ * the current element at depth d.  A start element derives its own set
+ * from its parent's: a descendant step stays alive, and a step the
+ * element matches either reports a match (if it is the last one) or
+ * moves on to the next step.  An element that leaves no state alive
+ * cannot contain a match and is skipped without tokenizing it.
+ */
+unsigned int
+XMLPathMatcher::match (XMLInputStream& stream, XMLPathHandler& handler)
+{
+  unsigned int found = 0;
+  unsigned int depth = 0;
+
+  if (mStates.empty()) mStates.resize(1);
+
+  mStates[0].clear();
+  for (unsigned int p = 0; p < mPaths.size(); ++p)
+  {
+    addState(mStates[0], p, 0);
+  }
+
+  while ( stream.isGood() )
+  {
+    const XMLToken& next = stream.peek();
+
+    if (next.isEOF()) break;
+
+    if (!next.isStart())
+    {
+      if (next.isEnd())
+      {
+        // the end of the element in which reading started is left alone
+        if (depth == 0) break;
+        --depth;
+      }
+
+      stream.nextView();
+      continue;
+    }
+
+    const XMLToken& element = stream.nextView();
+    const bool      empty   = element.isEnd();
+
+    if (mStates.size() < depth + 2) mStates.resize(depth + 2);
+
+    StateSet& outer = mStates[depth];
+    StateSet& inner = mStates[depth + 1];
+
+    inner.clear();
+
+    mMatched.clear();
+
+    for (size_t n = 0; n < outer.size(); ++n)
+    {
+      State&      state = outer[n];
+      const Path& path  = mPaths[state.path];
+      const Step& step  = path.getStep(state.step);
+
+      if (step.descendant) addState(inner, state.path, state.step);
+
+      if (!XMLLocationPath::matches(step, element, state.count)) continue;
+
+      if (state.step + 1 < path.getNumSteps())
+      {
+        addState(inner, state.path, state.step + 1);
+      }
+      else if (path.selectsAttribute())
+      {
+        found += report(path, state.path, element, stream, handler);
+      }
+      else
+      {
+        mMatched.push_back(state.path);
+      }
+    }
+
+    if (mMatched.size() == 1)
+    {
+      found += report(mPaths[mMatched[0]], mMatched[0], element, stream,
+                      handler);
+    }
+    else if (mMatched.size() > 1)
+    {
+      // a handler that reads text replaces the token element refers to,
+      // so the later handlers get a copy
+      mElement = element;
+
+      for (size_t n = 0; n < mMatched.size(); ++n)
+      {
+        found += report(mPaths[mMatched[n]], mMatched[n], mElement, stream,
+                        handler);
+      }
+    }
+
+    if (empty) continue;
+
+    if (inner.empty())
+    {
+      stream.skipToEnd();
+    }
+    else
+    {
+      ++depth;
+    }
+  }
+
+  return found;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Compiles path and adds it to the set of paths to match.
+ */
+int
+XMLPathMatcher::addCompiled (const std::string& path,
+                             const XMLNamespaces* namespaces)
+{
+  Path compiled;
+
+  if (!compiled.compile(path, namespaces))
+  {
+    return LIBLX_INVALID_ATTRIBUTE_VALUE;
+  }
+
+  mPaths.push_back(compiled);
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * Reports the element, or its attributes, selected by path to handler.
+ *
+ * @return the number of matches reported.
+ */
+unsigned int
+XMLPathMatcher::report (const Path& path, unsigned int index,
+                        const XMLToken& element, XMLInputStream& stream,
+                        XMLPathHandler& handler)
+{
+  if (!path.selectsAttribute())
+  {
+    handler.element(index, element, stream);
+    return 1;
+  }
+
+  const XMLAttributes& attributes = element.getAttributes();
+  const int            length     = attributes.getLength();
+  unsigned int         found      = 0;
+
+  for (int n = 0; n < length; ++n)
+  {
+    if (XMLLocationPath::matches(path.getAttribute(), attributes.getName(n),
+                                 attributes.getPrefix(n), attributes.getURI(n)))
+    {
+      handler.attribute(index, element, n);
+      ++found;
+    }
+  }
+
+  return found;
+}
+/** @endcond */
+
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,291 @@
+/**
+ * @file    XMLPathMatcher.h
+ * @brief   Streaming matcher for simple location paths
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ *
+ * @class XMLPathMatcher
+ * @sbmlbrief{core} Picks the elements and attributes at given paths out of
+ * an XMLInputStream.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * Often only a few values are needed from a large document, for example
+ * the identifiers of all reactions in a model.  An XMLPathMatcher reads
+ * the token stream once and reports only the elements and attributes
+ * selected by a set of location paths, without building an XMLNode tree.
+ * Subtrees in which none of the paths can match are skipped with
+ * XMLInputStream::skipPastEnd(), so they are never turned into tokens.
+ * The memory used depends on the nesting depth of the document and the
+ * number of paths, not on the size of the document.
+ *
+ * The paths use a small subset of XPath:
+ * <ul>
+ * <li> Each path starts with @c / (child) or @c // (descendant), and
+ * steps are separated by @c / or @c //.
+ * <li> A step is an element name, optionally with a prefix
+ * (<code>math:apply</code>), @c * for any element, or
+ * <code>prefix:*</code> for any element with that prefix.  A name
+ * without a prefix matches elements in any namespace.  A prefix that is
+ * bound in the XMLNamespaces passed to addPath() matches elements in the
+ * namespace it is bound to, whatever their own prefix; any other prefix
+ * is compared with the prefix of the element.
+ * <li> A step may have predicates on attributes, named like elements:
+ * <code>[@@id]</code> requires the attribute to be present,
+ * <code>[@@id='value']</code> (or with double quotes) requires it to have
+ * the given value.
+ * <li> A step may have one position predicate <code>[n]</code>, which
+ * keeps the <code>n</code>th element (counting from 1) among the children
+ * of the same parent that pass the name test and the predicates before
+ * it.
+ * <li> The last step may be <code>@@name</code> or <code>@@*</code>, in
+ * which case the path selects attributes rather than elements.
+ * </ul>
+ *
+ * For example:
+ * @code{.cpp}
+class Ids : public XMLPathHandler
+{
+public:
+  virtual void attribute (unsigned int path, const XMLToken& element,
+                          int index)
+  {
+    ids.push_back(element.getAttrValue(index));
+  }
+
+  std::vector<std::string> ids;
+};
+
+XMLPathMatcher matcher;
+matcher.addPath("/sbml/model/listOfReactions/reaction/@id");
+
+Ids ids;
+matcher.match(stream, ids);
+@endcode
+ *
+ * Paths are relative to the position at which match() starts reading:
+ * at the start of the document, <code>/sbml</code> selects the root
+ * element.
+ */
+
+#ifndef XMLPathMatcher_h
+#define XMLPathMatcher_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/XMLToken.h>
+#include <liblx/xml/XMLLocationPath.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLInputStream;
+class XMLNamespaces;
+
+
+class LIBLX_EXTERN XMLPathHandler
+{
+public:
+
+  /**
+   * Destroys this XMLPathHandler.
+   */
+  virtual ~XMLPathHandler ();
+
+
+  /**
+   * Receive notification of an element selected by a path.
+   *
+   * The handler may read the character data at the start of the element
+   * with XMLInputStream::readCharacters() (unless the element is empty,
+   * i.e., @p element.isEnd() is @c true).  It must not consume any other
+   * tokens from @p stream.  If several paths select the same element,
+   * the handler is called once for each of them, in the order of the
+   * paths, and text read in one call is gone in the next.
+   *
+   * By default, do nothing.
+   *
+   * @param path the index of the path that matched, in the order in which
+   * the paths were added.
+   * @param element the start element.
+   * @param stream the stream being read.
+   */
+  virtual void element (unsigned int path, const XMLToken& element,
+                        XMLInputStream& stream);
+
+
+  /**
+   * Receive notification of an attribute selected by a path.
+   *
+   * By default, do nothing.
+   *
+   * @param path the index of the path that matched, in the order in which
+   * the paths were added.
+   * @param element the start element that carries the attribute.
+   * @param index the index of the attribute in @p element.
+   */
+  virtual void attribute (unsigned int path, const XMLToken& element,
+                          int index);
+};
+
+
+class LIBLX_EXTERN XMLPathMatcher
+{
+public:
+
+  /**
+   * Creates a new XMLPathMatcher without any paths.
+   */
+  XMLPathMatcher ();
+
+
+  /**
+   * Destroys this XMLPathMatcher.
+   */
+  ~XMLPathMatcher ();
+
+
+  /**
+   * Compiles @p path and adds it to the set of paths to match.  The paths
+   * are numbered in the order in which they are added, starting with 0.
+   *
+   * @param path the location path.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+   * if @p path is not a supported location path.  The path is not added.
+   */
+  int addPath (const std::string& path);
+
+
+  /**
+   * Compiles @p path and adds it to the set of paths to match.  Prefixes
+   * in @p path that are bound in @p namespaces select by namespace URI.
+   *
+   * @param path the location path.
+   * @param namespaces the prefixes that stand for namespaces.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+   * if @p path is not a supported location path.  The path is not added.
+   */
+  int addPath (const std::string& path, const XMLNamespaces& namespaces);
+
+
+  /**
+   * @return the number of paths in this XMLPathMatcher.
+   */
+  unsigned int getNumPaths () const;
+
+
+  /**
+   * @return the text of the <code>n</code>th path, or an empty string if
+   * there is no such path.
+   *
+   * @param n the index of the path.
+   */
+  std::string getPath (unsigned int n) const;
+
+
+  /**
+   * Removes all paths.
+   */
+  void clear ();
+
+
+  /**
+   * Reads @p stream up to the end of the element it is positioned in (or
+   * to the end of the document) and reports the matching elements and
+   * attributes to @p handler, in document order.
+   *
+   * @param stream the stream to read.
+   * @param handler the handler that receives the matches.
+   *
+   * @return the number of matches reported.
+   */
+  unsigned int match (XMLInputStream& stream, XMLPathHandler& handler);
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  typedef XMLLocationPath Path;
+  typedef XMLLocationPath::Step Step;
+
+  /*
+   * Path path has matched its first step elements; count is the number
+   * of children of the element that owns the state that passed the
+   * predicates of the next step before its position predicate.
+   */
+  struct State
+  {
+    unsigned int path;
+    unsigned int step;
+    unsigned int count;
+  };
+
+  typedef std::vector<State> StateSet;
+
+
+  int addCompiled (const std::string& path, const XMLNamespaces* namespaces);
+
+  unsigned int report (const Path& path, unsigned int index,
+                       const XMLToken& element, XMLInputStream& stream,
+                       XMLPathHandler& handler);
+
+
+  std::vector<Path>     mPaths;
+
+  /*
+   * mStates[d] holds the states inside the element at depth d; entries
+   * are reused from one element to the next.
+   */
+  std::vector<StateSet> mStates;
+
+  /* Paths selecting the current element, and a copy of it if needed. */
+  std::vector<unsigned int> mMatched;
+  XMLToken                  mElement;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* XMLPathMatcher_h */
@@ -0,0 +1,104 @@
+/**
+ * @file    XMLStopCondition.h
+ * @brief   Decides where an XMLInputStream stops reading a document
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ *
+ * @class XMLStopCondition
+ * @sbmlbrief{core} Decides where reading a document ends.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * An XMLStopCondition installed with XMLInputStream::setStopCondition()
+ * is asked about every start element the parser reaches, with its
+ * attributes and namespaces already read.  When stop() returns @c true,
+ * the element is not delivered and the stream ends just before it: the
+ * tokens read so far can still be consumed, after which the stream
+ * reports EOF.  The file, or the decompressor reading it, is closed as
+ * soon as the condition fires.
+ *
+ * A scan that only wants the metadata held in the first level of a
+ * model can stop at the first element below it:
+ * @code{.cpp}
+class FirstLevelOnly : public XMLStopCondition
+{
+public:
+  virtual bool stop (const XMLToken& element, unsigned int depth)
+  {
+    return depth > 2;
+  }
+};
+@endcode
+ *
+ * Plain depth and element count limits are available through
+ * XMLInputStream::setReadLimit() and need no subclass.
+ */
+
+#ifndef XMLStopCondition_h
+#define XMLStopCondition_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLToken;
+
+
+class LIBLX_EXTERN XMLStopCondition
+{
+public:
+
+  /**
+   * Destroys this XMLStopCondition.
+   */
+  virtual ~XMLStopCondition ();
+
+
+  /**
+   * Decides whether reading ends before an element.
+   *
+   * @param element the start element, with its attributes and namespaces.
+   * @param depth the depth of the element, @c 1 for the document element.
+   *
+   * @return @c true to end the stream before @p element, @c false to
+   * keep reading.
+   */
+  virtual bool stop (const XMLToken& element, unsigned int depth) = 0;
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* XMLStopCondition_h */
@@ -0,0 +1,332 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLThreads.cpp
+ * @brief   Minimal threading support for parallel traversals
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ */
+
+#include <vector>
+
+#include <liblx/xml/XMLThreads.h>
+
+#if defined(USE_THREADS)
+#  if defined(_WIN32)
+#    include <windows.h>
+#  else
+#    include <pthread.h>
+#    include <sched.h>
+#    include <unistd.h>
+#  endif
+#endif
+
+using namespace std;
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+#if defined(USE_THREADS) && defined(_WIN32)
+typedef CRITICAL_SECTION MutexHandle;
+#elif defined(USE_THREADS)
+typedef pthread_mutex_t  MutexHandle;
+#endif
+
+
+/*
+ * Creates a new, unlocked mutex.
+ */
+XMLMutex::XMLMutex () :
+   mHandle( NULL )
+{
+#if defined(USE_THREADS)
+  MutexHandle* handle = new MutexHandle;
+#  if defined(_WIN32)
+  InitializeCriticalSection(handle);
+#  else
+  pthread_mutex_init(handle, NULL);
+#  endif
+  mHandle = handle;
+#endif
+}
+
+
+/*
+ * Destroys this mutex.
+ */
+XMLMutex::~XMLMutex ()
+{
+#if defined(USE_THREADS)
+  MutexHandle* handle = static_cast<MutexHandle*>(mHandle);
+#  if defined(_WIN32)
+  DeleteCriticalSection(handle);
+#  else
+  pthread_mutex_destroy(handle);
+#  endif
+  delete handle;
+#endif
+}
+
+
+/*
+ * Waits until no other thread holds this mutex, and takes it.
+ */
+void
+XMLMutex::lock ()
+{
+#if defined(USE_THREADS)
+#  if defined(_WIN32)
+  EnterCriticalSection(static_cast<MutexHandle*>(mHandle));
+#  else
+  pthread_mutex_lock(static_cast<MutexHandle*>(mHandle));
+#  endif
+#endif
+}
+
+
+/*
+ * Releases this mutex.
+ */
+void
+XMLMutex::unlock ()
+{
+#if defined(USE_THREADS)
+#  if defined(_WIN32)
+  LeaveCriticalSection(static_cast<MutexHandle*>(mHandle));
+#  else
+  pthread_mutex_unlock(static_cast<MutexHandle*>(mHandle));
+#  endif
+#endif
+}
+
+
+/*
+ * @return true if libLX was built with thread support.
+ */
+bool
+XMLThreads::isEnabled ()
+{
+#if defined(USE_THREADS)
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+/*
+ * @return the number of processors available.
+ */
+unsigned int
+XMLThreads::getNumProcessors ()
+{
+#if defined(USE_THREADS) && defined(_WIN32)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return (info.dwNumberOfProcessors > 0) ? info.dwNumberOfProcessors : 1;
+#elif defined(USE_THREADS) && defined(_SC_NPROCESSORS_ONLN)
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return (count > 0) ? (unsigned int)count : 1;
+#else
+  return 1;
+#endif
+}
+
+
+/*
+ * The arguments of one worker thread.
+ */
+struct WorkerCall
+{
+  XMLThreads::Function function;
+  void*                data;
+  unsigned int         worker;
+};
+
+
+#if defined(USE_THREADS) && defined(_WIN32)
+static DWORD WINAPI
+runWorker (LPVOID argument)
+{
+  WorkerCall* call = static_cast<WorkerCall*>(argument);
+  call->function(call->data, call->worker);
+  return 0;
+}
+#elif defined(USE_THREADS)
+extern "C" {
+static void*
+runWorker (void* argument)
+{
+  WorkerCall* call = static_cast<WorkerCall*>(argument);
+  call->function(call->data, call->worker);
+  return NULL;
+}
+}
+#endif
+
+
+/*
+ * Calls function with data on numWorkers workers and waits for them.
+ */
+unsigned int
+XMLThreads::run (unsigned int numWorkers, Function function, void* data)
+{
+  if (numWorkers == 0) numWorkers = getNumProcessors();
+
+#if defined(USE_THREADS)
+  vector<WorkerCall> calls(numWorkers);
+  unsigned int       started = 1;
+
+#  if defined(_WIN32)
+  vector<HANDLE>     threads;
+#  else
+  vector<pthread_t>  threads;
+#  endif
+
+  for (unsigned int n = 1; n < numWorkers; ++n)
+  {
+    calls[n].function = function;
+    calls[n].data     = data;
+    calls[n].worker   = n;
+
+#  if defined(_WIN32)
+    HANDLE thread = CreateThread(NULL, 0, runWorker, &calls[n], 0, NULL);
+    if (thread == NULL) continue;
+#  else
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, runWorker, &calls[n]) != 0) continue;
+#  endif
+
+    threads.push_back(thread);
+    ++started;
+  }
+
+  function(data, 0);
+
+  for (size_t n = 0; n < threads.size(); ++n)
+  {
+#  if defined(_WIN32)
+    WaitForSingleObject(threads[n], INFINITE);
+    CloseHandle(threads[n]);
+#  else
+    pthread_join(threads[n], NULL);
+#  endif
+  }
+
+  return started;
+#else
+  function(data, 0);
+  return 1;
+#endif
+}
+
+
+/*
+ * Guards the counters of add() and store() where the compiler offers no
+ * atomic builtins.
+ */
+#if defined(USE_THREADS) && !defined(_WIN32) && !defined(__GNUC__)
+static XMLMutex CounterMutex;
+#endif
+
+
+/*
+ * Atomically adds delta to value.
+ */
+long
+XMLThreads::add (volatile long& value, long delta)
+{
+#if defined(USE_THREADS) && defined(_WIN32)
+  return InterlockedExchangeAdd(&value, delta) + delta;
+#elif defined(USE_THREADS) && defined(__GNUC__)
+  return __sync_add_and_fetch(&value, delta);
+#elif defined(USE_THREADS)
+  XMLMutexLock lock(CounterMutex);
+  return value += delta;
+#else
+  return value += delta;
+#endif
+}
+
+
+/*
+ * @return value, read atomically.
+ */
+long
+XMLThreads::load (volatile long& value)
+{
+#if defined(USE_THREADS) && defined(__ATOMIC_ACQUIRE)
+  return __atomic_load_n(&value, __ATOMIC_ACQUIRE);
+#else
+  return add(value, 0);
+#endif
+}
+
+
+/*
+ * Atomically sets value to newValue.
+ */
+void
+XMLThreads::store (volatile long& value, long newValue)
+{
+#if defined(USE_THREADS) && defined(__ATOMIC_RELEASE)
+  __atomic_store_n(&value, newValue, __ATOMIC_RELEASE);
+#elif defined(USE_THREADS) && defined(_WIN32)
+  InterlockedExchange(&value, newValue);
+#elif defined(USE_THREADS) && defined(__GNUC__)
+  __sync_synchronize();
+  value = newValue;
+#elif defined(USE_THREADS)
+  XMLMutexLock lock(CounterMutex);
+  value = newValue;
+#else
+  value = newValue;
+#endif
+}
+
+
+/*
+ * Lets other threads run before the calling one continues.
+ */
+void
+XMLThreads::yield ()
+{
+#if defined(USE_THREADS) && defined(_WIN32)
+  SwitchToThread();
+#elif defined(USE_THREADS)
+  sched_yield();
+#endif
+}
+
+
+LIBLX_CPP_NAMESPACE_END
+/** @endcond */
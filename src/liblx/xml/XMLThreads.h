@@ -0,0 +1,199 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLThreads.h
+ * @brief   Minimal threading support for parallel traversals
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLThreads
+ * @sbmlbrief{core} Runs a function on several threads and waits for it.
+ *
+ * The parallel traversals of XMLNode trees need only a few things from
+ * the platform: a way to run the same function on a few threads and wait
+ * for all of them, a mutex to protect the work they share, and atomic
+ * counters.  libLX is written in C++98, so these are provided here on
+ * top of POSIX threads, the Windows API and the atomic builtins of the
+ * compiler.  When libLX is built without thread support (see the
+ * @c WITH_THREADS option), run() calls the function on the calling
+ * thread only, XMLMutex does nothing and the counters are plain
+ * integers, so callers need no conditional code.
+ *
+ * Workers are expected to pull their work from a shared queue rather
+ * than assume a fixed share of it: a worker that cannot be started is
+ * simply not run, and the remaining ones must then do all the work.
+ */
+
+#ifndef XMLThreads_h
+#define XMLThreads_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+class LIBLX_EXTERN XMLMutex
+{
+public:
+
+  /**
+   * Creates a new, unlocked mutex.
+   */
+  XMLMutex ();
+
+
+  /**
+   * Destroys this mutex, which must not be locked.
+   */
+  ~XMLMutex ();
+
+
+  /**
+   * Waits until no other thread holds this mutex, and takes it.
+   */
+  void lock ();
+
+
+  /**
+   * Releases this mutex.
+   */
+  void unlock ();
+
+
+private:
+
+  XMLMutex (const XMLMutex&);
+  XMLMutex& operator= (const XMLMutex&);
+
+  void* mHandle;
+};
+
+
+/*
+ * Holds an XMLMutex for as long as it exists.
+ */
+class LIBLX_EXTERN XMLMutexLock
+{
+public:
+
+  XMLMutexLock (XMLMutex& mutex) : mMutex(mutex) { mMutex.lock(); }
+
+  ~XMLMutexLock () { mMutex.unlock(); }
+
+
+private:
+
+  XMLMutexLock (const XMLMutexLock&);
+  XMLMutexLock& operator= (const XMLMutexLock&);
+
+  XMLMutex& mMutex;
+};
+
+
+class LIBLX_EXTERN XMLThreads
+{
+public:
+
+  /**
+   * The function run by each worker.  @p worker is the number of the
+   * worker, from 0 to one less than the number requested from run().
+   */
+  typedef void (*Function) (void* data, unsigned int worker);
+
+
+  /**
+   * @return true if libLX was built with thread support.
+   */
+  static bool isEnabled ();
+
+
+  /**
+   * @return the number of processors available, or 1 if it cannot be
+   * determined or libLX was built without thread support.
+   */
+  static unsigned int getNumProcessors ();
+
+
+  /**
+   * Calls @p function with @p data on @p numWorkers workers and returns
+   * once all of them have finished.  Worker 0 runs on the calling thread;
+   * each of the others runs on a thread of its own if one can be started,
+   * and is skipped otherwise.
+   *
+   * @param numWorkers the number of workers, or 0 for
+   * getNumProcessors().
+   * @param function the function to run.
+   * @param data the argument passed to every worker.
+   *
+   * @return the number of workers that were run.
+   */
+  static unsigned int run (unsigned int numWorkers, Function function,
+                           void* data);
+
+
+  /**
+   * Atomically adds @p delta to @p value.
+   *
+   * @return the new value.
+   */
+  static long add (volatile long& value, long delta);
+
+
+  /**
+   * @return @p value, read atomically.  Writes made by other threads
+   * before they last changed it through add() are visible afterwards.
+   */
+  static long load (volatile long& value);
+
+
+  /**
+   * Atomically sets @p value to @p newValue.  Writes made by the calling
+   * thread before are visible to threads that read the new value through
+   * load().
+   */
+  static void store (volatile long& value, long newValue);
+
+
+  /**
+   * Lets other threads run before the calling one continues.
+   */
+  static void yield ();
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+#endif  /* XMLThreads_h */
+/** @endcond */
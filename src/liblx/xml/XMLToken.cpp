@@ -34,7 +34,10 @@
  * also available online as http://sbml.org/software/libsbml/license.html
  * ---------------------------------------------------------------------- -->*/
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
+#include <stdint.h>
 
 /** @cond doxygenLibsbmlInternal */
 #include <liblx/xml/XMLOutputStream.h>
@@ -42,6 +45,7 @@
 #include <liblx/xml/sbmlMemoryStubs.h>
 /** @endcond */
 #include <liblx/xml/XMLToken.h>
+#include <liblx/xml/XMLNamespaceScope.h>
 
 #include <liblx/xml/operationReturnValues.h>
 
@@ -53,6 +57,55 @@ using namespace std;
 LIBLX_CPP_NAMESPACE_BEGIN
 #ifdef __cplusplus
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return a word with the high bit set in every byte of v that is zero,
+ * and no other bits set.
+ */
+static inline uint64_t
+zeroBytes (uint64_t v)
+{
+  const uint64_t low7 = 0x7F7F7F7F7F7F7F7FULL;
+  return ~(((v & low7) + low7) | v | low7);
+}
+
+
+/*
+ * @return true if the length bytes at chars are all XML whitespace.
+ * Eight bytes are tested at a time: a byte is whitespace if XOR-ing it
+ * with one of ' ', '\t', '\n' or '\r' gives zero.
+ */
+static bool
+isAllWhitespace (const char* chars, size_t length)
+{
+  const uint64_t ones = 0x0101010101010101ULL;
+  const uint64_t high = 0x8080808080808080ULL;
+  size_t         pos  = 0;
+
+  for (; pos + 8 <= length; pos += 8)
+  {
+    uint64_t word;
+    memcpy(&word, chars + pos, 8);
+
+    const uint64_t blank = zeroBytes(word ^ (ones * ' '))
+                         | zeroBytes(word ^ (ones * '\t'))
+                         | zeroBytes(word ^ (ones * '\n'))
+                         | zeroBytes(word ^ (ones * '\r'));
+
+    if (blank != high) return false;
+  }
+
+  for (; pos < length; ++pos)
+  {
+    const char c = chars[pos];
+    if (c != ' ' && c != '\t' && c != '\n' && c != '\r') return false;
+  }
+
+  return true;
+}
+/** @endcond */
+
+
 /*
  * Creates a new empty XMLToken.
  */
@@ -62,6 +115,8 @@ XMLToken::XMLToken () :
  , mIsText    ( false )
  , mLine      ( 0     )
  , mColumn    ( 0     )
+ , mOffset    ( 0     )
+ , mScope     ( NULL  )
 {
 }
 
@@ -83,6 +138,8 @@ XMLToken::XMLToken (  const XMLTriple&      triple
  , mIsText    ( false      )
  , mLine      ( line       )
  , mColumn    ( column     )
+ , mOffset    ( 0          )
+ , mScope     ( NULL  )
 {
 }
 
@@ -101,6 +158,8 @@ XMLToken::XMLToken (  const XMLTriple&      triple
  , mIsText    ( false      )
  , mLine      ( line       )
  , mColumn    ( column     )
+ , mOffset    ( 0          )
+ , mScope     ( NULL  )
 {
 }
 
@@ -117,6 +176,8 @@ XMLToken::XMLToken (  const XMLTriple&    triple
  , mIsText    ( false  )
  , mLine      ( line   )
  , mColumn    ( column )
+ , mOffset    ( 0      )
+ , mScope     ( NULL  )
 
 {
 }
@@ -134,6 +195,8 @@ XMLToken::XMLToken (  const std::string&  chars
  , mIsText    ( true   )
  , mLine      ( line   )
  , mColumn    ( column )
+ , mOffset    ( 0      )
+ , mScope     ( NULL  )
 {
 }
 
@@ -143,6 +206,7 @@ XMLToken::XMLToken (  const std::string&  chars
  */
 XMLToken::~XMLToken ()
 {
+  XMLNamespaceScope::unref(mScope);
 }
 
 
@@ -159,7 +223,11 @@ XMLToken::XMLToken(const XMLToken& orig)
  , mIsText (orig.mIsText)
  , mLine (orig.mLine)
  , mColumn (orig.mColumn)
+ , mOffset (orig.mOffset)
+ , mScope (orig.mScope)
 {
+  XMLNamespaceScope::ref(mScope);
+
   if (!orig.mTriple.isEmpty())
     mTriple = XMLTriple(orig.getName(), orig.getURI(), orig.getPrefix());
   
@@ -180,22 +248,12 @@ XMLToken::operator=(const XMLToken& rhs)
 {
   if(&rhs!=this)
   {
-    if (rhs.mTriple.isEmpty())
-      mTriple = XMLTriple();
-    else
-      mTriple = XMLTriple(rhs.getName(), rhs.getURI(), rhs.getPrefix());
-    
-    if (rhs.mAttributes.isEmpty())
-      mAttributes = XMLAttributes();
-    else
-      mAttributes = XMLAttributes(rhs.getAttributes());
-    
-    if (rhs.mNamespaces.isEmpty())
-      mNamespaces = XMLNamespaces();
-    else
-      mNamespaces = XMLNamespaces(rhs.getNamespaces());
-
-    mChars = rhs.mChars;
+    // assign member-wise so that the storage already held by this token
+    // (string and vector capacity) is reused rather than reallocated
+    mTriple     = rhs.mTriple;
+    mAttributes = rhs.mAttributes;
+    mNamespaces = rhs.mNamespaces;
+    mChars      = rhs.mChars;
 
     mIsStart = rhs.mIsStart;
     mIsEnd = rhs.mIsEnd;
@@ -203,6 +261,9 @@ XMLToken::operator=(const XMLToken& rhs)
 
     mLine = rhs.mLine;
     mColumn = rhs.mColumn;
+    mOffset = rhs.mOffset;
+
+    setNamespaceScope(rhs.mScope);
   }
 
   return *this;
@@ -233,6 +294,7 @@ XMLToken::append (const std::string& chars)
   else
   {
     mChars.append(chars);
+    tokenChanged();
     return LIBLX_OPERATION_SUCCESS;
   }
 }
@@ -259,6 +321,7 @@ XMLToken::setCharacters(const std::string& chars)
   else
   {
     mChars = chars;
+    tokenChanged();
     return LIBLX_OPERATION_SUCCESS;
   }
 }
@@ -283,6 +346,43 @@ XMLToken::getLine () const
 }
 
 
+/*
+ * @return the namespace declarations in effect inside this element, or
+ * NULL.
+ */
+const XMLNamespaceScope*
+XMLToken::getNamespaceScope () const
+{
+  return mScope;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Points this token to scope, which may be NULL.
+ */
+void
+XMLToken::setNamespaceScope (const XMLNamespaceScope* scope)
+{
+  if (scope == mScope) return;
+
+  XMLNamespaceScope::ref(scope);
+  XMLNamespaceScope::unref(mScope);
+  mScope = scope;
+}
+/** @endcond */
+
+
+/*
+ * @return the byte offset at which this XMLToken occurred, or 0.
+ */
+size_t
+XMLToken::getOffset () const
+{
+  return mOffset;
+}
+
+
 /*
  * @return the XMLAttributes of this XML element.
  */
@@ -313,6 +413,7 @@ XMLToken::setAttributes(const XMLAttributes& attributes)
     try
     {
       mAttributes = attributes;
+      tokenChanged();
       return LIBLX_OPERATION_SUCCESS;
     }
     catch (...)
@@ -360,7 +461,9 @@ XMLToken::addAttr (  const std::string& name
 {
   if (mIsStart) 
   {
-    return mAttributes.add(name, value, namespaceURI, prefix);
+    int result = mAttributes.add(name, value, namespaceURI, prefix);
+    tokenChanged();
+    return result;
   }
   else
   {
@@ -385,7 +488,9 @@ XMLToken::addAttr ( const XMLTriple& triple, const std::string& value)
 {
   if (mIsStart) 
   {
-    return mAttributes.add(triple, value);
+    int result = mAttributes.add(triple, value);
+    tokenChanged();
+    return result;
   }
   else
   {
@@ -406,7 +511,9 @@ XMLToken::removeAttr (int n)
 {
   if (mIsStart) 
   {
-    return mAttributes.remove(n);
+    int result = mAttributes.remove(n);
+    tokenChanged();
+    return result;
   }
   else
   {
@@ -428,7 +535,9 @@ XMLToken::removeAttr (const std::string& name, const std::string uri)
 {
   if (mIsStart) 
   {
-    return mAttributes.remove(name, uri);
+    int result = mAttributes.remove(name, uri);
+    tokenChanged();
+    return result;
   }
   else
   {
@@ -449,7 +558,9 @@ XMLToken::removeAttr (const XMLTriple& triple)
 {
   if (mIsStart) 
   {
-    return mAttributes.remove(triple);
+    int result = mAttributes.remove(triple);
+    tokenChanged();
+    return result;
   }
   else
   {
@@ -467,7 +578,9 @@ XMLToken::clearAttributes()
 {
   if (mIsStart) 
   {
-    return mAttributes.clear();
+    int result = mAttributes.clear();
+    tokenChanged();
+    return result;
   }
   else
   {
@@ -780,6 +893,7 @@ XMLToken::setNamespaces(const XMLNamespaces& namespaces)
     try
     {
       mNamespaces = namespaces;
+      tokenChanged();
       return LIBLX_OPERATION_SUCCESS;
     }
     catch (...)
@@ -808,6 +922,7 @@ XMLToken::addNamespace (const std::string& uri, const std::string prefix)
    if (mIsStart)  
    {
      mNamespaces.add(uri, prefix);
+     tokenChanged();
      return LIBLX_OPERATION_SUCCESS;
    }
   else
@@ -829,7 +944,9 @@ XMLToken::removeNamespace (int index)
 {
    if (mIsStart) 
    {
-     return mNamespaces.remove(index);
+     int result = mNamespaces.remove(index);
+     tokenChanged();
+     return result;
    }
   else
   {
@@ -849,7 +966,9 @@ XMLToken::removeNamespace (const std::string& prefix)
 {
   if (mIsStart)  
   {
-    return mNamespaces.remove(prefix);
+    int result = mNamespaces.remove(prefix);
+    tokenChanged();
+    return result;
   }
   else
   {
@@ -868,7 +987,9 @@ XMLToken::clearNamespaces ()
 {
    if (mIsStart) 
    {
-     return mNamespaces.clear();
+     int result = mNamespaces.clear();
+     tokenChanged();
+     return result;
   }
   else
   {
@@ -1051,6 +1172,7 @@ XMLToken::setTriple(const XMLTriple& triple)
     try
     {
       mTriple = triple;
+      tokenChanged();
       return LIBLX_OPERATION_SUCCESS;
     }
     catch (...)
@@ -1167,6 +1289,16 @@ XMLToken::isText () const
 }
 
 
+/*
+ * @return true if this XMLToken is whitespace-only text, false otherwise.
+ */
+bool
+XMLToken::isWhitespace () const
+{
+  return mIsText && isAllWhitespace(mChars.data(), mChars.size());
+}
+
+
 /*
  * Declares this XML start element is also an end element.
  */
@@ -1204,6 +1336,7 @@ XMLToken::setEOF ()
   mIsStart = false;
   mIsEnd   = false;
   mIsText  = false;
+  tokenChanged();
 
   if (isEOF())
     return LIBLX_OPERATION_SUCCESS;
@@ -1234,6 +1367,133 @@ XMLToken::write (XMLOutputStream& stream) const
 /** @endcond */
 
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Exchanges the contents of this XMLToken with those of other.
+ */
+void
+XMLToken::swap (XMLToken& other)
+{
+  if (&other == this) return;
+
+  mTriple    .swap(other.mTriple);
+  mAttributes.swap(other.mAttributes);
+  mNamespaces.swap(other.mNamespaces);
+  mChars     .swap(other.mChars);
+
+  std::swap(mIsStart, other.mIsStart);
+  std::swap(mIsEnd,   other.mIsEnd);
+  std::swap(mIsText,  other.mIsText);
+  std::swap(mLine,    other.mLine);
+  std::swap(mColumn,  other.mColumn);
+  std::swap(mOffset,  other.mOffset);
+  std::swap(mScope,   other.mScope);
+}
+
+
+/*
+ * Turns this XMLToken into a start element, reusing its storage.
+ */
+void
+XMLToken::assignStart (const XMLTriple&     triple,
+                       const XMLAttributes& attributes,
+                       const XMLNamespaces& namespaces,
+                       const unsigned int   line,
+                       const unsigned int   column,
+                       const size_t         offset)
+{
+  mTriple     = triple;
+  mAttributes = attributes;
+  mNamespaces = namespaces;
+  mChars.clear();
+
+  mIsStart = true;
+  mIsEnd   = false;
+  mIsText  = false;
+
+  mLine    = line;
+  mColumn  = column;
+  mOffset  = offset;
+
+  setNamespaceScope(NULL);
+}
+
+
+/*
+ * Turns this XMLToken into an end element, reusing its storage.
+ */
+void
+XMLToken::assignEnd (const XMLTriple&   triple,
+                     const unsigned int line,
+                     const unsigned int column,
+                     const size_t       offset)
+{
+  mTriple = triple;
+  mAttributes.clear();
+  mNamespaces.clear();
+  mChars.clear();
+
+  mIsStart = false;
+  mIsEnd   = true;
+  mIsText  = false;
+
+  mLine    = line;
+  mColumn  = column;
+  mOffset  = offset;
+
+  setNamespaceScope(NULL);
+}
+
+
+/*
+ * Turns this XMLToken into a text node, reusing its storage.
+ */
+void
+XMLToken::assignText (const char*        chars,
+                      const size_t       length,
+                      const unsigned int line,
+                      const unsigned int column,
+                      const size_t       offset)
+{
+  mTriple.assign(NULL, NULL, NULL);
+  mAttributes.clear();
+  mNamespaces.clear();
+  if (chars != NULL) mChars.assign(chars, length); else mChars.clear();
+
+  mIsStart = false;
+  mIsEnd   = false;
+  mIsText  = true;
+
+  mLine    = line;
+  mColumn  = column;
+  mOffset  = offset;
+
+  setNamespaceScope(NULL);
+}
+
+
+/*
+ * Appends length characters of chars to the text of this XMLToken.
+ */
+void
+XMLToken::appendText (const char* chars, const size_t length)
+{
+  if (chars != NULL) mChars.append(chars, length);
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Called after the contents of this XMLToken have changed.
+ */
+void
+XMLToken::tokenChanged ()
+{
+}
+/** @endcond */
+
+
 /*
  * Prints a string representation of the underlying token stream, for
  * debugging purposes.
@@ -1398,6 +1658,15 @@ XMLToken_getLine (const XMLToken_t *token)
 }    
 
 
+LIBLX_EXTERN
+size_t
+XMLToken_getOffset (const XMLToken_t *token)
+{
+  if (token == NULL) return 0;
+  return token->getOffset();
+}
+
+
 
 LIBLX_EXTERN
 const XMLAttributes_t *
@@ -135,6 +135,7 @@ LIBLX_CPP_NAMESPACE_BEGIN
 
 /** @cond doxygenLibsbmlInternal */
 class XMLOutputStream;
+class XMLNamespaceScope;
 /** @endcond */
 
 
@@ -1007,6 +1008,34 @@ public:
   unsigned int getLine () const;
 
 
+  /**
+   * Returns the byte offset at which this token occurs in the input.
+   *
+   * Only start and end elements read by an XMLInputStream that does not
+   * track line and column numbers carry an offset (see
+   * XMLInputStream::setTrackPositions()); XMLInputStream::getPosition()
+   * turns it into a line and column when they are needed.
+   *
+   * @return the byte offset at which this XMLToken occurred, or @c 0.
+   */
+  size_t getOffset () const;
+
+
+  /**
+   * Returns the namespace declarations in effect inside this element.
+   *
+   * Start and end elements read from an XMLInputStream point to a shared
+   * frame of the stream's namespace scope stack.  Unlike getNamespaces(),
+   * which only holds the declarations made on this element, the frame
+   * also resolves the prefixes declared on its ancestors.
+   *
+   * @return the XMLNamespaceScope of this element, or @c NULL if the
+   * token was not read from a stream or no namespaces are declared.
+   */
+  const XMLNamespaceScope* getNamespaceScope () const;
+
+
+
   /**
    * Returns @c true if this token represents an XML element.
    *
@@ -1092,6 +1121,21 @@ public:
   bool isText () const;
 
 
+  /**
+   * Returns @c true if this token is an XML text element holding nothing
+   * but whitespace (spaces, tabs, carriage returns and line feeds).
+   *
+   * Such text usually only indents the elements of a document, and
+   * carries no content.
+   *
+   * @return @c true if this XMLToken is whitespace-only text, @c false
+   * otherwise.
+   *
+   * @see XMLInputStream::setIgnoreWhitespace()
+   */
+  bool isWhitespace () const;
+
+
   /**
    * Declares that this token represents an XML element end tag.
    *
@@ -1138,6 +1182,69 @@ public:
   /** @endcond */
 
 
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Exchanges the contents of this XMLToken with those of @p other.
+   *
+   * Unlike assignment, no strings, attributes or namespace declarations
+   * are copied; the storage owned by each token simply changes hands.
+   *
+   * @param other the XMLToken to swap contents with.
+   */
+  void swap (XMLToken& other);
+
+
+  /**
+   * Turns this XMLToken into a start element with the given triple,
+   * attributes and namespaces.  The strings and vectors already owned
+   * by this token are reused, so a token that is refilled over and over
+   * (e.g., by a parser handler) stops allocating once it has grown to
+   * the size of the largest element seen.
+   */
+  void assignStart (const XMLTriple&     triple,
+                    const XMLAttributes& attributes,
+                    const XMLNamespaces& namespaces,
+                    const unsigned int   line   = 0,
+                    const unsigned int   column = 0,
+                    const size_t         offset = 0);
+
+
+  /**
+   * Turns this XMLToken into an end element, reusing its storage.
+   */
+  void assignEnd (const XMLTriple&   triple,
+                  const unsigned int line   = 0,
+                  const unsigned int column = 0,
+                  const size_t       offset = 0);
+
+
+  /**
+   * Turns this XMLToken into a text node holding the first @p length
+   * characters of @p chars, reusing its storage.
+   */
+  void assignText (const char*        chars,
+                   const size_t       length,
+                   const unsigned int line   = 0,
+                   const unsigned int column = 0,
+                   const size_t       offset = 0);
+
+
+  /**
+   * Appends the first @p length characters of @p chars to this token's
+   * text, without going through a temporary string.
+   */
+  void appendText (const char* chars, const size_t length);
+
+
+  /**
+   * Points this token to @p scope (which may be @c NULL), holding a
+   * reference to it.  assignStart(), assignEnd() and assignText() reset
+   * the scope.
+   */
+  void setNamespaceScope (const XMLNamespaceScope* scope);
+  /** @endcond */
+
+
   /**
    * Prints a string representation of the underlying token stream.
    *
@@ -1171,6 +1278,14 @@ public:
 
 protected:
   /** @cond doxygenLibsbmlInternal */
+
+  /**
+   * Called after the name, attributes, namespaces, text or kind of this
+   * XMLToken have been changed through its public methods, so that
+   * subclasses can update what they derive from them.
+   */
+  virtual void tokenChanged ();
+
   XMLTriple     mTriple;
   XMLAttributes mAttributes;
   XMLNamespaces mNamespaces;
@@ -1183,6 +1298,9 @@ protected:
 
   unsigned int mLine;
   unsigned int mColumn;
+  size_t       mOffset;
+
+  const XMLNamespaceScope* mScope;
 
   /** @endcond */
 };
@@ -1374,6 +1492,22 @@ unsigned int
 XMLToken_getLine (const XMLToken_t *token);
 
 
+/**
+ * Returns the byte offset at which this XMLToken_t structure occurred,
+ * when it was read without line and column numbers.
+ *
+ * @param token XMLToken_t structure to be queried.
+ *
+ * @return the byte offset at which this XMLToken_t structure occurred,
+ * or @c 0.
+ *
+ * @memberof XMLToken_t
+ */
+LIBLX_EXTERN
+size_t
+XMLToken_getOffset (const XMLToken_t *token);
+
+
 /**
  * Returns the attributes of this element.
  *
@@ -0,0 +1,260 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLTokenPool.cpp
+ * @brief   A recycling FIFO of XMLToken objects used by XMLTokenizer
+ * 
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <stdexcept>
+
+#include <liblx/xml/XMLTokenPool.h>
+
+using namespace std;
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+/*
+ * Creates a new empty XMLTokenPool.
+ */
+XMLTokenPool::XMLTokenPool () :
+   mHead( 0 )
+ , mSize( 0 )
+{
+}
+
+
+/*
+ * Copy Constructor.
+ */
+XMLTokenPool::XMLTokenPool (const XMLTokenPool& orig) :
+   mHead( 0 )
+ , mSize( 0 )
+{
+  for (size_t n = 0; n < orig.size(); ++n)
+  {
+    push_back( orig[n] );
+  }
+}
+
+
+/*
+ * Assignment operator.
+ */
+XMLTokenPool&
+XMLTokenPool::operator= (const XMLTokenPool& rhs)
+{
+  if (&rhs != this)
+  {
+    clear();
+
+    for (size_t n = 0; n < rhs.size(); ++n)
+    {
+      push_back( rhs[n] );
+    }
+  }
+
+  return *this;
+}
+
+
+/*
+ * Destroys this XMLTokenPool and all the slots it owns.
+ */
+XMLTokenPool::~XMLTokenPool ()
+{
+  for (size_t n = 0; n < mSlots.size(); ++n)
+  {
+    delete mSlots[n];
+  }
+}
+
+
+/*
+ * Appends a (recycled) slot to the end of the queue and returns it.
+ */
+XMLToken&
+XMLTokenPool::acquire ()
+{
+  if (mSize == mSlots.size())
+  {
+    grow();
+  }
+
+  ++mSize;
+
+  return back();
+}
+
+
+/*
+ * Appends a copy of token to the end of the queue.
+ */
+void
+XMLTokenPool::push_back (const XMLToken& token)
+{
+  acquire() = token;
+}
+
+
+/*
+ * Removes the token at the front of the queue, keeping its slot.
+ */
+void
+XMLTokenPool::pop_front ()
+{
+  if (mSize == 0) return;
+
+  mHead = (mHead + 1) % mSlots.size();
+  --mSize;
+}
+
+
+/*
+ * Removes all tokens from the queue, keeping their slots.
+ */
+void
+XMLTokenPool::clear ()
+{
+  mHead = 0;
+  mSize = 0;
+}
+
+
+size_t
+XMLTokenPool::size () const
+{
+  return mSize;
+}
+
+
+bool
+XMLTokenPool::empty () const
+{
+  return (mSize == 0);
+}
+
+
+size_t
+XMLTokenPool::getCapacity () const
+{
+  return mSlots.size();
+}
+
+
+XMLToken&
+XMLTokenPool::front ()
+{
+  return *mSlots[mHead];
+}
+
+
+const XMLToken&
+XMLTokenPool::front () const
+{
+  return *mSlots[mHead];
+}
+
+
+XMLToken&
+XMLTokenPool::back ()
+{
+  return (*this)[mSize - 1];
+}
+
+
+const XMLToken&
+XMLTokenPool::back () const
+{
+  return (*this)[mSize - 1];
+}
+
+
+XMLToken&
+XMLTokenPool::operator[] (size_t n)
+{
+  return *mSlots[(mHead + n) % mSlots.size()];
+}
+
+
+const XMLToken&
+XMLTokenPool::operator[] (size_t n) const
+{
+  return *mSlots[(mHead + n) % mSlots.size()];
+}
+
+
+XMLToken&
+XMLTokenPool::at (size_t n)
+{
+  if (n >= mSize) throw out_of_range("XMLTokenPool::at");
+  return (*this)[n];
+}
+
+
+const XMLToken&
+XMLTokenPool::at (size_t n) const
+{
+  if (n >= mSize) throw out_of_range("XMLTokenPool::at");
+  return (*this)[n];
+}
+
+
+/*
+ * Doubles the number of slots.  The queue is full when this is called, so
+ * the new (empty) slots are inserted just before the front of the queue,
+ * i.e., immediately after its end, and the ring order is preserved.
+ */
+void
+XMLTokenPool::grow ()
+{
+  size_t count = mSlots.size();
+  if (count < 8) count = 8;
+
+  vector<XMLToken*> fresh(count);
+  for (size_t n = 0; n < count; ++n)
+  {
+    fresh[n] = new XMLToken();
+  }
+
+  mSlots.insert(mSlots.begin() + mHead, fresh.begin(), fresh.end());
+
+  if (mSize > 0)
+  {
+    mHead += count;
+  }
+}
+
+
+LIBLX_CPP_NAMESPACE_END
+
+/** @endcond */
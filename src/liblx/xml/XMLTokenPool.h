@@ -0,0 +1,196 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLTokenPool.h
+ * @brief   A recycling FIFO of XMLToken objects used by XMLTokenizer
+ * 
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLTokenPool
+ * @sbmlbrief{core} First-in first-out queue of XMLToken objects whose
+ * storage is recycled.
+ *
+ * @ifnot clike @internal @endif@~
+ *
+ * XMLTokenizer buffers the tokens produced by the parser in an
+ * XMLTokenPool until XMLInputStream consumes them.  A slot that has been
+ * consumed is not destroyed; it keeps the strings, attribute and
+ * namespace vectors it owned and is handed back out by acquire() the next
+ * time a token is queued.  Once the queue has grown to the largest
+ * lookahead needed by the document, and each slot has grown to the size
+ * of the largest token it held, queueing and consuming tokens no longer
+ * touches the allocator.
+ */
+
+#ifndef XMLTokenPool_h
+#define XMLTokenPool_h
+
+#ifdef __cplusplus
+
+#include <vector>
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/XMLToken.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class LIBLX_EXTERN XMLTokenPool
+{
+public:
+
+  /**
+   * Creates a new empty XMLTokenPool.
+   */
+  XMLTokenPool ();
+
+
+  /**
+   * Copy Constructor.
+   *
+   * Only the queued tokens are copied, not the spare slots of @p orig.
+   *
+   * @param orig the instance to copy.
+   */
+  XMLTokenPool (const XMLTokenPool& orig);
+
+
+  /**
+   * Assignment operator.
+   *
+   * @param rhs the object whose values are used as the basis of the
+   * assignment.
+   */
+  XMLTokenPool& operator= (const XMLTokenPool& rhs);
+
+
+  /**
+   * Destroys this XMLTokenPool and all the slots it owns.
+   */
+  ~XMLTokenPool ();
+
+
+  /**
+   * Appends a slot to the end of the queue and returns it.  The slot is
+   * a recycled token: its contents are unspecified, but whatever storage
+   * it holds may be reused by assigning to or swapping with it.
+   *
+   * @return the token at the end of the queue.
+   */
+  XMLToken& acquire ();
+
+
+  /**
+   * Appends a copy of @p token to the end of the queue, reusing the
+   * storage of a recycled slot.
+   */
+  void push_back (const XMLToken& token);
+
+
+  /**
+   * Removes the token at the front of the queue.  Its slot is kept for
+   * reuse by acquire().
+   */
+  void pop_front ();
+
+
+  /**
+   * Removes all tokens from the queue, keeping their slots for reuse.
+   */
+  void clear ();
+
+
+  /**
+   * @return the number of tokens in the queue.
+   */
+  size_t size () const;
+
+
+  /**
+   * @return @c true if there are no tokens in the queue.
+   */
+  bool empty () const;
+
+
+  /**
+   * @return the number of slots owned by this pool, queued or spare.
+   */
+  size_t getCapacity () const;
+
+
+  /**
+   * @return the token at the front of the queue.
+   */
+  XMLToken& front ();
+  const XMLToken& front () const;
+
+
+  /**
+   * @return the token at the end of the queue.
+   */
+  XMLToken& back ();
+  const XMLToken& back () const;
+
+
+  /**
+   * @return the token at position @p n, counting from the front of the
+   * queue.  No range checking is performed.
+   */
+  XMLToken& operator[] (size_t n);
+  const XMLToken& operator[] (size_t n) const;
+
+
+  /**
+   * @return the token at position @p n, counting from the front of the
+   * queue.
+   *
+   * @throws std::out_of_range if @p n is not less than size().
+   */
+  XMLToken& at (size_t n);
+  const XMLToken& at (size_t n) const;
+
+
+protected:
+
+  void grow ();
+
+  std::vector<XMLToken*> mSlots;
+  size_t                 mHead;
+  size_t                 mSize;
+
+};
+
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+#endif  /* XMLTokenPool_h */
+/** @endcond */
@@ -0,0 +1,335 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLTokenTape.cpp
+ * @brief   Compact append-only record of XMLToken objects
+ * 
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <liblx/xml/XMLTokenTape.h>
+#include <liblx/xml/XMLNamespaceScope.h>
+
+using namespace std;
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+/*
+ * Creates a new empty XMLTokenTape.  Offset 0 of the arena always holds
+ * the empty string.
+ */
+XMLTokenTape::XMLTokenTape () :
+  mArena( 1, '\0' )
+{
+}
+
+
+/*
+ * Destroys this XMLTokenTape.
+ */
+XMLTokenTape::~XMLTokenTape ()
+{
+  clear();
+}
+
+
+/*
+ * Appends a copy of token to this XMLTokenTape.
+ */
+void
+XMLTokenTape::append (const XMLToken& token)
+{
+  Entry entry;
+
+  entry.kind          = 0;
+  entry.name          = 0;
+  entry.uri           = 0;
+  entry.prefix        = 0;
+  entry.chars         = 0;
+  entry.length        = 0;
+  entry.attributes    = mAttributes.size();
+  entry.namespaces    = mNamespaces.size();
+  entry.numAttributes = 0;
+  entry.numNamespaces = 0;
+  entry.line          = token.getLine();
+  entry.column        = token.getColumn();
+  entry.offset        = token.getOffset();
+  entry.scope         = token.getNamespaceScope();
+
+  XMLNamespaceScope::ref(entry.scope);
+
+  if (token.isText())
+  {
+    entry.kind   = Text;
+    entry.chars  = store( token.getCharacters() );
+    entry.length = token.getCharacters().size();
+  }
+  else
+  {
+    if (token.isStart()) entry.kind |= Start;
+    if (token.isEnd()  ) entry.kind |= End;
+
+    entry.name   = store( token.getName()   );
+    entry.uri    = store( token.getURI()    );
+    entry.prefix = store( token.getPrefix() );
+  }
+
+  if (token.isStart())
+  {
+    const XMLAttributes& attributes = token.getAttributes();
+    const XMLNamespaces& namespaces = token.getNamespaces();
+
+    entry.numAttributes = static_cast<unsigned int>( attributes.getLength() );
+    entry.numNamespaces = static_cast<unsigned int>( namespaces.getLength() );
+
+    for (int n = 0; n < attributes.getLength(); ++n)
+    {
+      Attribute attribute;
+
+      attribute.name   = store( attributes.getName  (n) );
+      attribute.uri    = store( attributes.getURI   (n) );
+      attribute.prefix = store( attributes.getPrefix(n) );
+      attribute.value  = store( attributes.getValue (n) );
+
+      mAttributes.push_back(attribute);
+    }
+
+    for (int n = 0; n < namespaces.getLength(); ++n)
+    {
+      Namespace ns;
+
+      ns.prefix = store( namespaces.getPrefix(n) );
+      ns.uri    = store( namespaces.getURI   (n) );
+
+      mNamespaces.push_back(ns);
+    }
+  }
+
+  mEntries.push_back(entry);
+}
+
+
+/*
+ * Rebuilds the token at index into token, reusing its storage.
+ */
+void
+XMLTokenTape::get (size_t index, XMLToken& token)
+{
+  const Entry& entry = mEntries[index];
+  const char*  arena = mArena.data();
+
+  if (entry.kind == Text)
+  {
+    token.assignText(arena + entry.chars, entry.length,
+                     entry.line, entry.column, entry.offset);
+    return;
+  }
+
+  mTriple.assign(arena + entry.name, arena + entry.uri, arena + entry.prefix);
+
+  if (entry.kind & Start)
+  {
+    const Attribute* attributes = mAttributes.empty() ? NULL
+                              : &mAttributes[0] + entry.attributes;
+    const Namespace* namespaces = mNamespaces.empty() ? NULL
+                              : &mNamespaces[0] + entry.namespaces;
+
+    mScratchAttributes.reset(arena, attributes, entry.numAttributes);
+    mScratchNamespaces.reset(arena, namespaces, entry.numNamespaces);
+
+    token.assignStart(mTriple, mScratchAttributes, mScratchNamespaces,
+                      entry.line, entry.column, entry.offset);
+
+    if (entry.kind & End) token.setEnd();
+  }
+  else
+  {
+    token.assignEnd(mTriple, entry.line, entry.column, entry.offset);
+  }
+
+  token.setNamespaceScope(entry.scope);
+}
+
+
+/*
+ * @return true if the token at index is a start element.
+ */
+bool
+XMLTokenTape::isStart (size_t index) const
+{
+  return (mEntries[index].kind & Start) != 0;
+}
+
+
+/*
+ * @return true if the token at index is an end element.
+ */
+bool
+XMLTokenTape::isEnd (size_t index) const
+{
+  return (mEntries[index].kind & End) != 0;
+}
+
+
+/*
+ * @return true if the token at index is a text node.
+ */
+bool
+XMLTokenTape::isText (size_t index) const
+{
+  return mEntries[index].kind == Text;
+}
+
+
+/*
+ * @return the local name of the element token at index; text entries
+ * point at the empty string at the start of the arena.
+ */
+const char*
+XMLTokenTape::getName (size_t index) const
+{
+  return mArena.c_str() + mEntries[index].name;
+}
+
+
+/*
+ * @return the number of tokens on this XMLTokenTape.
+ */
+size_t
+XMLTokenTape::size () const
+{
+  return mEntries.size();
+}
+
+
+/*
+ * @return true if this XMLTokenTape holds no tokens.
+ */
+bool
+XMLTokenTape::empty () const
+{
+  return mEntries.empty();
+}
+
+
+/*
+ * Removes all tokens, keeping the memory for reuse.
+ */
+void
+XMLTokenTape::clear ()
+{
+  for (size_t n = 0; n < mEntries.size(); ++n)
+  {
+    XMLNamespaceScope::unref( mEntries[n].scope );
+  }
+
+  mArena.resize(1);
+  mEntries.clear();
+  mAttributes.clear();
+  mNamespaces.clear();
+}
+
+
+/*
+ * @return the number of bytes of character data held in the arena.
+ */
+size_t
+XMLTokenTape::getArenaSize () const
+{
+  return mArena.size();
+}
+
+
+/*
+ * Copies chars, NUL-terminated, to the end of the arena.  All empty
+ * strings share offset 0.
+ */
+size_t
+XMLTokenTape::store (const std::string& chars)
+{
+  if (chars.empty()) return 0;
+
+  const size_t offset = mArena.size();
+
+  mArena.append(chars);
+  mArena.push_back('\0');
+
+  return offset;
+}
+
+
+/*
+ * Refills these attributes from size tape entries.
+ */
+void
+XMLTokenTape::Attributes::reset (const char*      arena,
+                                 const Attribute* attributes,
+                                 unsigned int     size)
+{
+  mNames .resize(size);
+  mValues.resize(size);
+
+  for (unsigned int n = 0; n < size; ++n)
+  {
+    const Attribute& attribute = attributes[n];
+
+    mNames [n].assign( arena + attribute.name, arena + attribute.uri,
+                       arena + attribute.prefix );
+    mValues[n].assign( arena + attribute.value );
+  }
+
+  reindex();
+}
+
+
+/*
+ * Refills these namespace declarations from size tape entries.
+ */
+void
+XMLTokenTape::Namespaces::reset (const char*      arena,
+                                 const Namespace* namespaces,
+                                 unsigned int     size)
+{
+  mNamespaces.resize(size);
+
+  for (unsigned int n = 0; n < size; ++n)
+  {
+    mNamespaces[n].first .assign( arena + namespaces[n].prefix );
+    mNamespaces[n].second.assign( arena + namespaces[n].uri    );
+  }
+
+  reindex();
+}
+
+
+LIBLX_CPP_NAMESPACE_END
+/** @endcond */
@@ -0,0 +1,230 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLTokenTape.h
+ * @brief   Compact append-only record of XMLToken objects
+ * 
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLTokenTape
+ * @sbmlbrief{core} Append-only sequence of tokens stored without XMLToken
+ * objects.
+ *
+ * @ifnot clike @internal @endif@~
+ *
+ * XMLInputStream records the tokens read after XMLInputStream::mark() on
+ * an XMLTokenTape, so that they can be read again after
+ * XMLInputStream::rewind().  All the strings of all the tokens are kept
+ * in one character arena, and a token is stored as a small fixed-size
+ * entry of offsets into it, plus one entry per attribute and namespace
+ * declaration.  Tokens are only rebuilt, into storage that is reused,
+ * when they are read back with get().
+ */
+
+#ifndef XMLTokenTape_h
+#define XMLTokenTape_h
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/XMLToken.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class LIBLX_EXTERN XMLTokenTape
+{
+public:
+
+  /**
+   * Creates a new empty XMLTokenTape.
+   */
+  XMLTokenTape ();
+
+
+  /**
+   * Destroys this XMLTokenTape.
+   */
+  ~XMLTokenTape ();
+
+
+  /**
+   * Appends a copy of token to this XMLTokenTape.
+   */
+  void append (const XMLToken& token);
+
+
+  /**
+   * Rebuilds the token at index into token, reusing its storage.
+   */
+  void get (size_t index, XMLToken& token);
+
+
+  /**
+   * @return @c true if the token at index is a start element, without
+   * rebuilding it.
+   */
+  bool isStart (size_t index) const;
+
+
+  /**
+   * @return @c true if the token at index is an end element, without
+   * rebuilding it.
+   */
+  bool isEnd (size_t index) const;
+
+
+  /**
+   * @return @c true if the token at index is a text node, without
+   * rebuilding it.
+   */
+  bool isText (size_t index) const;
+
+
+  /**
+   * @return the local name of the element token at index, or the empty
+   * string for a text node.
+   */
+  const char* getName (size_t index) const;
+
+
+  /**
+   * @return the number of tokens on this XMLTokenTape.
+   */
+  size_t size () const;
+
+
+  /**
+   * @return @c true if this XMLTokenTape holds no tokens.
+   */
+  bool empty () const;
+
+
+  /**
+   * Removes all tokens, keeping the memory for reuse.
+   */
+  void clear ();
+
+
+  /**
+   * @return the number of bytes of character data held in the arena.
+   */
+  size_t getArenaSize () const;
+
+
+protected:
+
+  enum Kind { Start = 1, End = 2, Text = 4 };
+
+  /* A token; strings are offsets of NUL-terminated strings in mArena. */
+  struct Entry
+  {
+    unsigned int kind;
+    size_t       name;
+    size_t       uri;
+    size_t       prefix;
+    size_t       chars;
+    size_t       length;
+    size_t       attributes;
+    size_t       namespaces;
+    unsigned int numAttributes;
+    unsigned int numNamespaces;
+    unsigned int line;
+    unsigned int column;
+    size_t       offset;
+
+    const XMLNamespaceScope* scope;
+  };
+
+  struct Attribute
+  {
+    size_t name;
+    size_t uri;
+    size_t prefix;
+    size_t value;
+  };
+
+  struct Namespace
+  {
+    size_t prefix;
+    size_t uri;
+  };
+
+
+  /* XMLAttributes and XMLNamespaces refilled in place from the tape. */
+  class Attributes : public XMLAttributes
+  {
+  public:
+    void reset (const char* arena, const Attribute* attributes,
+                unsigned int size);
+  };
+
+  class Namespaces : public XMLNamespaces
+  {
+  public:
+    void reset (const char* arena, const Namespace* namespaces,
+                unsigned int size);
+  };
+
+
+  /**
+   * Copies chars into the arena.
+   *
+   * @return the offset of the copy.
+   */
+  size_t store (const std::string& chars);
+
+
+  std::string            mArena;
+  std::vector<Entry>     mEntries;
+  std::vector<Attribute> mAttributes;
+  std::vector<Namespace> mNamespaces;
+
+  XMLTriple              mTriple;
+  Attributes             mScratchAttributes;
+  Namespaces             mScratchNamespaces;
+
+
+private:
+
+  XMLTokenTape (const XMLTokenTape& orig);
+  XMLTokenTape& operator= (const XMLTokenTape& rhs);
+};
+
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+#endif  /* XMLTokenTape_h */
+/** @endcond */
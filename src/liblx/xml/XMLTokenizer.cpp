@@ -39,6 +39,9 @@
 #include <sstream>
 
 #include <liblx/xml/XMLToken.h>
+#include <liblx/xml/XMLElementFilter.h>
+#include <liblx/xml/XMLNamespaceScope.h>
+#include <liblx/xml/XMLStopCondition.h>
 #include <liblx/xml/XMLTokenizer.h>
 
 using namespace std;
@@ -52,6 +55,17 @@ XMLTokenizer::XMLTokenizer () :
    mInChars( false )
  , mInStart( false )
  , mEOFSeen( false )
+ , mChunkSize( 0 )
+ , mSkipDepth( 0 )
+ , mFilter( NULL )
+ , mReadDepth( 0 )
+ , mReadElements( 0 )
+ , mNumElements( 0 )
+ , mStopCondition( NULL )
+ , mStopped( false )
+ , mIgnoreWhitespace( false )
+ , mInText( false )
+ , mFrontNumber( 0 )
 {
 }
 
@@ -65,9 +79,32 @@ XMLTokenizer::XMLTokenizer (const XMLTokenizer& other)
   , mEOFSeen(other.mEOFSeen)
   , mEncoding(other.mEncoding)
   , mVersion(other.mVersion)
+  , mChunkSize(other.mChunkSize)
+  , mSkipDepth(other.mSkipDepth)
+  , mFilter(other.mFilter)
+  , mReadDepth(other.mReadDepth)
+  , mReadElements(other.mReadElements)
+  , mNumElements(other.mNumElements)
+  , mStopCondition(other.mStopCondition)
+  , mStopped(other.mStopped)
+  , mIgnoreWhitespace(other.mIgnoreWhitespace)
+  , mInText(other.mInText)
+  , mBlank(other.mBlank)
   , mCurrent(other.mCurrent)
+  , mView(other.mView)
   , mTokens(other.mTokens)
+  , mTokenElement(other.mTokenElement)
+  , mElements(other.mElements)
+  , mFreeElements(other.mFreeElements)
+  , mOpen(other.mOpen)
+  , mReading(other.mReading)
+  , mFrontNumber(other.mFrontNumber)
+  , mScopes(other.mScopes)
 {
+  for (size_t n = 0; n < mScopes.size(); ++n)
+  {
+    XMLNamespaceScope::ref( mScopes[n] );
+  }
 }
 
 
@@ -76,6 +113,7 @@ XMLTokenizer::XMLTokenizer (const XMLTokenizer& other)
  */
 XMLTokenizer::~XMLTokenizer ()
 {
+  popScopes( mScopes.size() );
 }
 
 
@@ -133,13 +171,29 @@ XMLTokenizer::isEOF () const
 XMLToken
 XMLTokenizer::next ()
 {
-  XMLToken token( peek() );
-  mTokens.pop_front();
+  XMLToken token;
+  popFront(&token);
 
   return token;
 }
 
 
+/*
+ * Consume the next XMLToken and return a view of it that remains valid
+ * until the next call to nextView().
+ *
+ * @return a reference to the token just consumed.
+ */
+const XMLToken&
+XMLTokenizer::nextView ()
+{
+  // the previous view's storage goes back into the pool with the slot
+  popFront(&mView);
+
+  return mView;
+}
+
+
 /*
  * Returns the next XMLToken without consuming it.  A subsequent call to
  * either peek() or next() will return the same token.
@@ -189,13 +243,52 @@ XMLTokenizer::XML (const string& version, const string& encoding)
 void
 XMLTokenizer::startElement (const XMLToken& element)
 {
+  if (mSkipDepth > 0)
+  {
+    skipStartElement();
+    return;
+  }
+
+  if (mReadDepth > 0 || mReadElements > 0 || mStopCondition != NULL)
+  {
+    // the pending start element is not on mOpen yet
+    const unsigned int depth = (unsigned int)
+                               (mOpen.size() + (mInStart ? 1 : 0) + 1);
+
+    if (   (mReadDepth    > 0 && depth > mReadDepth)
+        || (mReadElements > 0 && mNumElements >= mReadElements)
+        || (mStopCondition != NULL && mStopCondition->stop(element, depth)))
+    {
+      stop();
+      return;
+    }
+
+    ++mNumElements;
+  }
 
   if (mInChars || mInStart)
   {
     mInChars = false;
-    mTokens.push_back( mCurrent );
+    pushCurrent();
   }
 
+  mBlank.clear();
+  mInText = false;
+
+  // elements that declare nothing share the frame they are in
+  const XMLNamespaceScope* scope = mScopes.empty() ? NULL : mScopes.back();
+
+  if (element.getNamespaces().isEmpty())
+  {
+    XMLNamespaceScope::ref(scope);
+  }
+  else
+  {
+    scope = XMLNamespaceScope::create(scope, element.getNamespaces());
+  }
+
+  mScopes.push_back(scope);
+
   //
   // We delay pushing element onto mTokens until we see either an end
   // elment (in which case we can collapse start and end elements into a
@@ -203,6 +296,7 @@ XMLTokenizer::startElement (const XMLToken& element)
   //
   mInStart = true;
   mCurrent = element;
+  mCurrent.setNamespaceScope(scope);
 }
 
 
@@ -222,22 +316,34 @@ XMLTokenizer::endDocument ()
 void
 XMLTokenizer::endElement (const XMLToken& element)
 {
+  if (mSkipDepth > 0)
+  {
+    skipEndElement();
+    return;
+  }
+
   if (mInChars)
   {
     mInChars = false;
-    mTokens.push_back( mCurrent );
+    pushCurrent();
   }
 
+  mBlank.clear();
+  mInText = false;
+
   if (mInStart)
   {
     mInStart = false;
     mCurrent.setEnd();
-    mTokens.push_back( mCurrent );
+    pushCurrent();
   }
   else
   {
-    mTokens.push_back(element);
+    pushToken(element);
+    if (!mScopes.empty()) mTokens.back().setNamespaceScope( mScopes.back() );
   }
+
+  popScopes(1);
 }
 
 
@@ -247,418 +353,641 @@ XMLTokenizer::endElement (const XMLToken& element)
 void
 XMLTokenizer::characters (const XMLToken& data)
 {
+  if (mSkipDepth > 0) return;
 
   if (mInStart)
   {
     mInStart = false;
-    mTokens.push_back( mCurrent );
+    pushCurrent();
   }
 
-  if (mInChars)
+  if (mIgnoreWhitespace && !mInText)
   {
-    mCurrent.append( data.getCharacters() );
+    if (data.isWhitespace())
+    {
+      mBlank.append( data.getCharacters() );
+      return;
+    }
+
+    if (!mBlank.empty())
+    {
+      // not blank after all, so the whitespace before belongs to the text
+      appendText( mBlank );
+      mBlank.clear();
+    }
+
+    mInText = true;
   }
-  else
+
+  if (mChunkSize == 0 && !mInChars)
   {
     mInChars = true;
     mCurrent = data;
   }
+  else
+  {
+    appendText( data.getCharacters() );
+  }
 }
 
-unsigned int
-XMLTokenizer::determineNumberChildren(bool & valid, const std::string element)
+
+/*
+ * Adds chars to the text node in mCurrent, starting one if needed.
+ */
+void
+XMLTokenizer::appendText (const string& chars)
 {
-  valid = false;
-  unsigned int numChildren = 0;
-  std::string closingTag = element;
-  bool forcedElement = true;
-  if (closingTag.empty() == true) 
+  if (mChunkSize > 0)
   {
-    closingTag = "apply";
-    forcedElement = false;
+    appendChunked( chars );
   }
-
-  // if there is only one token there cannot be any children 
-  size_t size = mTokens.size();
-  if (size < 2)
+  else if (mInChars)
+  {
+    mCurrent.append( chars );
+  }
+  else
   {
-    return numChildren;
+    mInChars = true;
+    mCurrent.assignText( chars.data(), chars.size() );
   }
+}
 
-  // we assume that the first unread token is a 
-  // function and that at some point in the
-  // list of tokens we will hit the end of the 
-  // element for that function
-  // need to count the number of starts
 
-  unsigned int index = 0;
-  XMLToken firstUnread = mTokens.at(index);
-  while (firstUnread.isText() && index < size - 1)
+/*
+ * Sets the maximum number of bytes of character data per text token.
+ */
+void
+XMLTokenizer::setCharacterChunkSize (size_t size)
+{
+  mChunkSize = size;
+}
+
+
+/*
+ * @return the maximum number of bytes of character data per text token.
+ */
+size_t
+XMLTokenizer::getCharacterChunkSize () const
+{
+  return mChunkSize;
+}
+
+/*
+ * Asks the element filter, if any, whether to read element.
+ */
+bool
+XMLTokenizer::acceptElement (const XMLTriple& element)
+{
+  return (mFilter == NULL || mFilter->accept(element));
+}
+
+
+/*
+ * Sets the filter consulted by acceptElement().
+ */
+void
+XMLTokenizer::setElementFilter (XMLElementFilter* filter)
+{
+  mFilter = filter;
+}
+
+
+/*
+ * @return the filter consulted by acceptElement(), or NULL.
+ */
+XMLElementFilter*
+XMLTokenizer::getElementFilter () const
+{
+  return mFilter;
+}
+
+
+/*
+ * @return @c true while a subtree is being skipped.
+ */
+bool
+XMLTokenizer::isSkipping () const
+{
+  return (mSkipDepth > 0 || mStopped);
+}
+
+
+/*
+ * Receive notification of the start of an element that is being skipped.
+ */
+void
+XMLTokenizer::skipStartElement ()
+{
+  ++mSkipDepth;
+}
+
+
+/*
+ * Receive notification of the end of an element that is being skipped.
+ */
+void
+XMLTokenizer::skipEndElement ()
+{
+  if (mSkipDepth > 0) --mSkipDepth;
+}
+
+
+/*
+ * Discards the document up to and including the end of the depth-th
+ * enclosing element.  A start element still waiting in mCurrent has not
+ * been closed yet, so it adds one more level to skip.
+ */
+void
+XMLTokenizer::startSkipping (unsigned int depth)
+{
+  if (depth == 0) return;
+
+  // nothing is queued, so the elements being read are exactly the ones
+  // open at the parser; their ends will never be pushed
+  for (unsigned int n = 0; n < depth && !mReading.empty(); ++n)
   {
-    // skip any text
-    index++;
-    firstUnread = mTokens.at(index);
+    releaseElement( mReading.back() );
+    mReading.pop_back();
+    if (!mOpen.empty()) mOpen.pop_back();
   }
 
+  if (mInStart) ++depth;
 
-  // if we have an apply the firstToken should be a function
-  // that is both a start and an end
-  // unless we are reading a user function
-  // or a csymbol
-  // if the tag is not a start and an end this is an error
-  // we want to exit
-  // but be happy that the read is ok
-  // and the error gets logged elsewhere
-  if (closingTag == "apply")
-  {
-    std::string firstName = firstUnread.getName();
+  popScopes(depth);
 
-    if (firstName != "ci" && firstName != "csymbol")
-    {
-      if (firstUnread.isStart() != true 
-        || (firstUnread.isStart() == true &&  firstUnread.isEnd() != true))
-      {
-        valid = true;
-        return numChildren;
-      }
-    }
+  mInStart   = false;
+  mInChars   = false;
+  mSkipDepth = depth;
+  mBlank.clear();
+  mInText = false;
+}
+
+
+/*
+ * Sets whether text that holds nothing but whitespace is dropped.
+ */
+void
+XMLTokenizer::setIgnoreWhitespace (bool ignore)
+{
+  mIgnoreWhitespace = ignore;
+}
+
+
+/*
+ * @return true if whitespace-only text is dropped.
+ */
+bool
+XMLTokenizer::getIgnoreWhitespace () const
+{
+  return mIgnoreWhitespace;
+}
+
+
+/*
+ * Ends the document before the first start element that is deeper than
+ * depth or that would exceed elements start elements.
+ */
+void
+XMLTokenizer::setReadLimit (unsigned int depth, unsigned int elements)
+{
+  mReadDepth    = depth;
+  mReadElements = elements;
+  mNumElements  = 0;
+}
+
+
+/*
+ * Sets the condition asked about every start element.
+ */
+void
+XMLTokenizer::setStopCondition (XMLStopCondition* condition)
+{
+  mStopCondition = condition;
+}
+
+
+/*
+ * @return the condition set with setStopCondition(), or NULL.
+ */
+XMLStopCondition*
+XMLTokenizer::getStopCondition () const
+{
+  return mStopCondition;
+}
+
+
+/*
+ * Ends the document here.  isSkipping() stays true from now on, so the
+ * parser front ends drop the rest of the document.
+ */
+void
+XMLTokenizer::stop (bool discard)
+{
+  if (!discard && (mInChars || mInStart))
+  {
+    pushCurrent();
   }
 
-  index = 1;
-  if (forcedElement == true)
+  mInStart  = false;
+  mInChars  = false;
+  mStopped  = true;
+  mBlank.clear();
+  mInText = false;
+  mEOFSeen  = true;
+}
+
+
+/*
+ * @return @c true once the document has been ended by stop().
+ */
+bool
+XMLTokenizer::isStopped () const
+{
+  return mStopped;
+}
+
+
+/*
+ * Leaves the namespace scope of the count innermost open elements.
+ */
+void
+XMLTokenizer::popScopes (size_t count)
+{
+  for (size_t n = 0; n < count && !mScopes.empty(); ++n)
   {
-    index = 0;
+    XMLNamespaceScope::unref( mScopes.back() );
+    mScopes.pop_back();
   }
+}
+
+
+/*
+ * Moves mCurrent onto the end of mTokens.  Swapping rather than copying
+ * leaves mCurrent holding the storage of a recycled slot, which the next
+ * start element or text node is then assigned into.
+ */
+void
+XMLTokenizer::pushCurrent ()
+{
+  mTokens.acquire().swap( mCurrent );
+  noteQueued();
+}
+
 
-  unsigned int depth = 0;
-  std::string name;
-  bool cleanBreak = false;
-  XMLToken next = mTokens.at(index);
-  while (index < size-2)
+/*
+ * Pushes element onto the end of mTokens.
+ */
+void
+XMLTokenizer::pushToken (const XMLToken& element)
+{
+  mTokens.push_back(element);
+  noteQueued();
+}
+
+
+const size_t XMLTokenizer::npos = static_cast<size_t>(-1);
+
+
+/*
+ * Records the structure of the token just pushed: a start element counts
+ * as a child of the innermost open element and, unless it is empty, opens
+ * an element of its own; an end element closes the innermost open one.
+ */
+void
+XMLTokenizer::noteQueued ()
+{
+  const XMLToken& token   = mTokens.back();
+  size_t          element = npos;
+
+  if (token.isStart())
   {
-    // skip any text elements
-    while(next.isText() == true && index < size-1)
-    {
-      index++;
-      next = mTokens.at(index);
-    }
-    if (next.isEnd() == true && next.getName() == closingTag)
-    {
-      valid = true;
-      break;
-    }
-    // iterate to first start element
-    while (next.isStart() == false && index < size-1)
-    {
-      index++;
-      next = mTokens.at(index);
-    }
+    if (!mOpen.empty()) ++mElements[ mOpen.back() ].children;
 
-    // check we have not reached the end
-    // this would be a bad place if we have so set num children to zero
-    if (index == size)
+    if (!token.isEnd())
     {
-      numChildren = 0;
-      break;
-    }
+      element = allocateElement();
+      mOpen.push_back(element);
 
-    // record the name of the start element
-    name = next.getName();
-    numChildren++;
+      ElementInfo& info = mElements[element];
 
- //   index++;
-    // check we have not reached the end
-    if (index + 1 == size)
-    {
-      numChildren = 0;
-      break;
-    }
-    else if (next.isEnd() == false)
-    {
-      index++;
-      if (index < size)
-      {
-        next = mTokens.at(index);
-      }
-      else
-      {
-        break;
-      }
+      info.name   = token.getName();
+      info.line   = token.getLine();
+      info.column = token.getColumn();
+      info.offset = token.getOffset();
     }
+  }
+  else if (token.isEnd() && !mOpen.empty())
+  {
+    ElementInfo& info = mElements[ mOpen.back() ];
 
-    // iterate to the end of </name>
-    // checking that we have not got a nested element <name></name>
-    cleanBreak = false;
-    while (index < size-1)
-    {
-      if (next.isStart() == true && next.isEnd() == false && next.getName() == name)
-      {
-        depth++;
-      }
+    info.closed = true;
+    info.end    = mFrontNumber + mTokens.size() - 1;
 
-      if (next.isEnd() == true && next.getName() == name)
-      {
-        if (depth == 0)
-        {
-          cleanBreak = true;
-          break;
-        }
-        else
-        {
-          depth--;
-        }
-      }
+    mOpen.pop_back();
+  }
 
-      index++;
-      next = mTokens.at(index);
-    }
+  mTokenElement.push_back(element);
+}
 
-    index++;
-    if (index < size)
-    {
-      next = mTokens.at(index);
-    }
-  } 
 
-  // we might have hit the end of the loop and the end of the correct tag
-  // but the loop hits before it can record that it was valid
-  if (valid == false && cleanBreak == true)
+/*
+ * Removes the front of mTokens.  Consuming a start element counts it as a
+ * consumed child of the element being read, and, if it is open, makes it
+ * the element being read; consuming an end element finishes it.
+ */
+void
+XMLTokenizer::popFront (XMLToken* into)
+{
+  const XMLToken& token   = mTokens.front();
+  const size_t    element = mTokenElement.front();
+
+  if (token.isStart() && !mReading.empty())
   {
-  if (index >= size-2 && next.isEnd() == true && next.getName() == closingTag)
+    ++mElements[ mReading.back() ].consumed;
+  }
+
+  if (element != npos)
   {
-      valid = true;
+    mReading.push_back(element);
   }
+  else if (token.isEnd() && !token.isStart() && !mReading.empty())
+  {
+    releaseElement( mReading.back() );
+    mReading.pop_back();
   }
 
-  return numChildren;
+  if (into != NULL) into->swap( mTokens.front() );
+
+  mTokens.pop_front();
+  mTokenElement.pop_front();
+  ++mFrontNumber;
 }
 
-unsigned int
-XMLTokenizer::determineNumSpecificChildren(bool & valid, 
-                                           const std::string& qualifier, 
-                                        const std::string& container)
+
+/*
+ * @return the index in mElements of a new, empty ElementInfo.
+ */
+size_t
+XMLTokenizer::allocateElement ()
 {
-  valid = false;
-  unsigned int numQualifiers = 0;
+  size_t element;
 
-  size_t size = mTokens.size();
-  if (size < 2)
+  if (mFreeElements.empty())
   {
-    return numQualifiers;
+    element = mElements.size();
+    mElements.push_back( ElementInfo() );
   }
-
-  unsigned int depth = 0;
-  unsigned int index = 0;
-  std::string name;
-  std::string prevName = "";
-  std::string rogueTag = "";
-  
-  XMLToken next = mTokens.at(index);
-  name = next.getName();
-  if (next.isStart() == true && next.isEnd() == true && 
-    name == qualifier && index < size)
+  else
   {
-    numQualifiers++;
-    index++;
-    next = mTokens.at(index);
+    element = mFreeElements.back();
+    mFreeElements.pop_back();
   }
-  bool cleanBreak = false;
 
-  while (index < size-2)
+  ElementInfo& info = mElements[element];
+
+  info.children = 0;
+  info.consumed = 0;
+  info.closed   = false;
+  info.end      = 0;
+
+  return element;
+}
+
+
+/*
+ * Returns the ElementInfo at index element to the free list.
+ */
+void
+XMLTokenizer::releaseElement (size_t element)
+{
+  mFreeElements.push_back(element);
+}
+
+
+/*
+ * @return true if c is a UTF-8 continuation byte, i.e., not the first
+ * byte of a character.
+ */
+static bool
+isContinuation (char c)
+{
+  return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+
+/*
+ * Appends chars to the text token being collected in mCurrent, pushing it
+ * onto mTokens every time it holds mChunkSize bytes.  Chunks end on a
+ * character boundary, so they may be slightly shorter than mChunkSize.
+ */
+void
+XMLTokenizer::appendChunked (const string& chars)
+{
+  const char*  data   = chars.data();
+  const size_t length = chars.size();
+  size_t       pos    = 0;
+
+  while (pos < length)
   {
-    // skip any text elements
-    while(next.isText() == true && index < size-1)
+    if (!mInChars)
     {
-      index++;
-      next = mTokens.at(index);
+      mInChars = true;
+      mCurrent.assignText(NULL, 0);
     }
 
-    if (next.isEnd() == true)
-    {
-      if (next.getName() == container)
-      {
-        valid = true;
-        break;
-      }
-      //else if (!rogueTag.empty() && next.getName() == rogueTag)
-      //{
-      //  index++;
-      //  next = mTokens.at(index);
-      //  break;
-      //}
-    }
-    // iterate to first start element
-    while (next.isStart() == false && index < size-1)
-    {
-      index++;
-      next = mTokens.at(index);
-    }
+    const size_t used = mCurrent.getCharacters().size();
+    size_t       n    = (used < mChunkSize) ? mChunkSize - used : 0;
 
-    if (next.isStart() == true && next.isEnd() == true)
-    {
-      if (qualifier.empty() == true)
-      {
-        // if we are not looking for a specifc element then
-        // we may have a child that is a start and end
-        // such as <true/>
-        numQualifiers++;
-      }
-      index++;
-      if (index < size)
-      {
-        next = mTokens.at(index);
-        continue;
-      }
-    }
-    // check we have not reached the end
-    // this would be a bad place if we have so set num children to zero
-    if (index == size)
-    {
-      numQualifiers = 0;
-      break;
-    }
+    if (n > length - pos) n = length - pos;
 
-    // record the name of the start element
-    name = next.getName();
-
-    // need to deal with the weird situation where someone has used a tag
-    // after the piece but before the next correct element
-    //if (container == "piecewise")
-    //{
-    //  if (prevName == "piece")
-    //  {
-    //    if (name != "piece" && name != "otherwise")
-    //    {
-    //      rogueTag = name;
-    //      index++;
-    //      next = mTokens.at(index);
-    //      continue;
-    //    }
-    //  }
-    //}
-    if (qualifier.empty() == true || name == qualifier)
-    {
-      numQualifiers++;
-    }
+    while (n > 0 && pos + n < length && isContinuation(data[pos + n])) --n;
 
-//    index++;
-    // check we have not reached the end
-    if (index+1 == size)
+    if (n == 0 && used == 0)
     {
-      numQualifiers = 0;
-      break;
+      // the chunk size is smaller than this one character; keep it whole
+      n = 1;
+      while (pos + n < length && isContinuation(data[pos + n])) ++n;
     }
-    else
+
+    mCurrent.appendText(data + pos, n);
+    pos += n;
+
+    if (pos < length || mCurrent.getCharacters().size() >= mChunkSize)
     {
-      index++;
-      next = mTokens.at(index);
+      mInChars = false;
+      pushCurrent();
     }
+  }
+}
 
-    // iterate to the end of </name>
-    // checking that we have not got a nested element <name></name>
-    cleanBreak = false;
-    while (index < size-1)
-    {
-      if (next.isStart() == true && next.getName() == name)
-      {
-        depth++;
-      }
 
-      if (next.isEnd() == true && next.getName() == name)
-      {
-        if (depth == 0)
-        {
-          cleanBreak = true;
-          break;
-        }
-        else
-        {
-          depth--;
-        }
-      }
+/*
+ * Counts the child elements of the element whose content is being read
+ * that have not been consumed yet.  The counts are kept up to date as
+ * the children are pushed and consumed, so they only have to be looked
+ * up.  With no element name, or "apply", the element is taken to be a
+ * MathML apply whose first unread child names the function; with no
+ * element name, that child is not counted.
+ */
+unsigned int
+XMLTokenizer::determineNumberChildren(bool & valid, const std::string element)
+{
+  valid = true;
 
-      index++;
-      if (index < size)
-      {
-        next = mTokens.at(index);
-      }
-    }
+  if (mReading.empty()) return 0;
 
-    prevName = name;
-    index++;
-    if (index < size)
+  const ElementInfo& info = mElements[ mReading.back() ];
+
+  valid = info.closed;
+
+  unsigned int numChildren = info.children - info.consumed;
+
+  if (element.empty() || element == "apply")
+  {
+    // the function should be an empty element unless it is a user
+    // function (ci) or a csymbol; if not, the error is logged elsewhere
+    size_t index = 0;
+    while (index < mTokens.size() && mTokens[index].isText()) ++index;
+
+    if (index == mTokens.size()) return 0;
+
+    const XMLToken&    function = mTokens[index];
+    const std::string& name     = function.getName();
+
+    if (name != "ci" && name != "csymbol"
+        && !(function.isStart() && function.isEnd()))
     {
-      next = mTokens.at(index);
+      valid = true;
+      return 0;
     }
-  }  
 
-  // we might have hit the end of the loop and the end of the correct tag
-  if (valid == false && cleanBreak == true)
+    if (element.empty() && numChildren > 0) --numChildren;
+  }
+
+  return numChildren;
+}
+
+
+/*
+ * Counts the child elements called qualifier (or all child elements, if
+ * qualifier is empty) of the element whose content is being read.  The
+ * children are visited directly, jumping over their content.
+ */
+unsigned int
+XMLTokenizer::determineNumSpecificChildren(bool & valid, 
+                                           const std::string& qualifier, 
+                                           const std::string& )
+{
+  valid = true;
+
+  if (mReading.empty()) return 0;
+
+  valid = mElements[ mReading.back() ].closed;
+
+  const size_t extent        = readingExtent();
+  unsigned int numQualifiers = 0;
+  size_t       index         = 0;
+
+  while (index < extent)
   {
-    if (index >= size-2 && next.isEnd() == true && next.getName() == container)
+    const XMLToken& next = mTokens[index];
+
+    if (next.isStart())
     {
-        valid = true;
+      if (qualifier.empty() || next.getName() == qualifier) ++numQualifiers;
+
+      const size_t child = mTokenElement[index];
+
+      if (child != npos)
+      {
+        if (!mElements[child].closed) break;
+
+        index = mElements[child].end - mFrontNumber;
+      }
     }
+
+    ++index;
   }
 
   return numQualifiers;
 }
 
+
+/*
+ * Returns true if an element called qualifier occurs anywhere inside the
+ * element whose content is being read.
+ */
 bool
 XMLTokenizer::containsChild(bool & valid, 
                             const std::string& qualifier, 
-                            const std::string& container)
+                            const std::string& )
 {
-  valid = false;
-  //unsigned int numQualifiers = 0;
-  
+  valid = true;
 
-  size_t size = mTokens.size();
-  if (size < 2)
+  if (mReading.empty()) return false;
+
+  const size_t extent = readingExtent();
+
+  for (size_t index = 0; index < extent; ++index)
   {
-    return false;
+    if (mTokens[index].getName() == qualifier) return true;
   }
 
-  unsigned int index = 0;
-  //unsigned int depth = 0;
-  std::string name;
-  
-  XMLToken next = mTokens.at(index);
-  name = next.getName();
+  valid = mElements[ mReading.back() ].closed;
 
-  while (index < size-2)
-  {
-    // skip any text elements
-    while(next.isText() == true && index < size-1)
-    {
-      index++;
-      next = mTokens.at(index);
-    }
+  return false;
+}
 
-    if (next.getName() == qualifier)
-    {
-      valid = true;
-      return true;
-    }
 
-    index++;
-    if (index < size)
-    {
-      next = mTokens.at(index);
-    }
-  }  
+/*
+ * @return true if the end of the element being read has been queued.
+ */
+bool
+XMLTokenizer::isReadingElementQueued () const
+{
+  return mReading.empty() || mElements[ mReading.back() ].closed;
+}
 
-  // we might have hit the end of the loop and the end of the correct tag
-  if (valid == false && index >= size-2)
+
+/*
+ * @return the number of queued tokens that precede the end of the element
+ * being read.
+ */
+size_t
+XMLTokenizer::readingExtent () const
+{
+  const ElementInfo& info = mElements[ mReading.back() ];
+
+  return info.closed ? info.end - mFrontNumber : mTokens.size();
+}
+
+
+/*
+ * @return how many elements being read lie inside the one started by
+ * element, searching from the innermost outwards, or npos.
+ */
+size_t
+XMLTokenizer::getReadingLevel (const XMLToken& element) const
+{
+  if (!element.isStart() || element.isEnd()) return npos;
+
+  for (size_t n = mReading.size(); n > 0; --n)
   {
-    valid = true;
+    const ElementInfo& info = mElements[ mReading[n - 1] ];
+
+    if (info.line   == element.getLine  () &&
+        info.column == element.getColumn() &&
+        info.offset == element.getOffset() &&
+        info.name   == element.getName  ())
+    {
+      return mReading.size() - n;
+    }
   }
 
-  return false;
+  return npos;
 }
 
 
-
 LIBLX_CPP_NAMESPACE_END
 
 /** @endcond */
@@ -48,13 +48,18 @@
 #ifdef __cplusplus
 
 #include <deque>
+#include <vector>
 
 #include <liblx/xml/common/extern.h>
 #include <liblx/xml/XMLHandler.h>
+#include <liblx/xml/XMLTokenPool.h>
 
 LIBLX_CPP_NAMESPACE_BEGIN
 
 class LIBLX_EXTERN XMLToken;
+class XMLElementFilter;
+class XMLStopCondition;
+class XMLNamespaceScope;
 
 class LIBLX_EXTERN XMLTokenizer : public XMLHandler
 {
@@ -125,6 +130,18 @@ public:
   XMLToken next ();
 
 
+  /**
+   * Consume the next XMLToken and return a view of it.
+   *
+   * The token is moved (not copied) out of the queue into storage owned
+   * by this XMLTokenizer.  The returned reference remains valid until the
+   * next call to nextView().
+   *
+   * @return a reference to the token just consumed.
+   */
+  const XMLToken& nextView ();
+
+
   /**
    * Returns the next XMLToken without consuming it.  A subsequent call to
    * either peek() or next() will return the same token.
@@ -172,6 +189,119 @@ public:
   virtual void characters (const XMLToken& data);
 
 
+  /**
+   * Sets the maximum number of bytes of character data collected into a
+   * single text token.  Longer runs of text are delivered as several
+   * consecutive text tokens, split on UTF-8 character boundaries.  A size
+   * of @c 0 (the default) joins all character data between two markup
+   * events into one token.
+   */
+  void setCharacterChunkSize (size_t size);
+
+
+  /**
+   * @return the maximum number of bytes of character data per text token,
+   * or @c 0 if text is not split.
+   */
+  size_t getCharacterChunkSize () const;
+
+
+  /**
+   * Asks the element filter, if any, whether to read element.
+   */
+  virtual bool acceptElement (const XMLTriple& element);
+
+
+  /**
+   * Sets the filter consulted by acceptElement().  The filter is not
+   * owned by this XMLTokenizer.
+   */
+  void setElementFilter (XMLElementFilter* filter);
+
+
+  /**
+   * @return the filter consulted by acceptElement(), or @c NULL.
+   */
+  XMLElementFilter* getElementFilter () const;
+
+
+  /**
+   * @return @c true while a subtree is being skipped.
+   */
+  virtual bool isSkipping () const;
+
+
+  /**
+   * Receive notification of the start of an element that is being skipped.
+   */
+  virtual void skipStartElement ();
+
+
+  /**
+   * Receive notification of the end of an element that is being skipped.
+   */
+  virtual void skipEndElement ();
+
+
+  /**
+   * Discards the rest of the document up to and including the end of the
+   * depth-th enclosing element, counting from the element the parser is
+   * currently in.  Tokens already queued are not affected; pending
+   * character data or a pending start element is dropped.  The parser
+   * front ends stop building tokens until the last end element has been
+   * seen.
+   */
+  void startSkipping (unsigned int depth);
+
+
+  /**
+   * Sets whether text that holds nothing but whitespace is dropped.
+   */
+  void setIgnoreWhitespace (bool ignore);
+
+
+  /**
+   * @return true if whitespace-only text is dropped.
+   */
+  bool getIgnoreWhitespace () const;
+
+
+  /**
+   * Ends the document before the first start element that is deeper than
+   * depth or that would exceed elements start elements.  A limit of 0
+   * means no limit.
+   */
+  void setReadLimit (unsigned int depth, unsigned int elements);
+
+
+  /**
+   * Sets the condition asked about every start element; when it says
+   * stop, the document ends before that element.
+   */
+  void setStopCondition (XMLStopCondition* condition);
+
+
+  /**
+   * @return the condition set with setStopCondition(), or NULL.
+   */
+  XMLStopCondition* getStopCondition () const;
+
+
+  /**
+   * Ends the document here.  The rest of it is skipped as a subtree that
+   * never closes, so the parser front ends report nothing more.  Unless
+   * discard is true, a pending start element or text node is queued
+   * first.
+   */
+  void stop (bool discard = false);
+
+
+  /**
+   * @return @c true once the document has been ended by stop().
+   */
+  virtual bool isStopped () const;
+
+
 protected:
 
   unsigned int determineNumberChildren(bool & valid, 
@@ -183,6 +313,13 @@ protected:
   bool containsChild(bool & valid, 
                const std::string& qualifier,  const std::string& container);
 
+  /**
+   * @return @c true if the end of the element whose content is being
+   * read has been queued (or no element is being read), i.e., the
+   * queries above can be answered without parsing further.
+   */
+  bool isReadingElementQueued () const;
+
   bool mInChars;
   bool mInStart;
   bool mEOFSeen;
@@ -190,8 +327,124 @@ protected:
   std::string mEncoding;
   std::string mVersion;
 
-  XMLToken             mCurrent;
-  std::deque<XMLToken> mTokens;
+  /**
+   * Moves mCurrent onto the end of mTokens, leaving mCurrent with the
+   * storage of a recycled token.
+   */
+  void pushCurrent ();
+
+  /**
+   * Appends chars to mCurrent, pushing it whenever it reaches mChunkSize.
+   */
+  void appendChunked (const std::string& chars);
+
+  /**
+   * Adds chars to the text node in mCurrent, starting one if needed.
+   */
+  void appendText (const std::string& chars);
+
+  /**
+   * Pushes element onto the end of mTokens.
+   */
+  void pushToken (const XMLToken& element);
+
+  /**
+   * Removes the front of mTokens, keeping track of the element whose
+   * content is being read.  If into is not @c NULL, the token is swapped
+   * into it first.
+   */
+  void popFront (XMLToken* into = NULL);
+
+  /**
+   * Records the structure of the token just pushed onto mTokens.
+   */
+  void noteQueued ();
+
+  /**
+   * @return the number of tokens in mTokens that belong to the content of
+   * the element being read, i.e., that precede its end.
+   */
+  size_t readingExtent () const;
+
+  /**
+   * @return the number of elements being read that are nested inside the
+   * one started by element, i.e., 0 for the innermost, or npos if element
+   * did not start any of them.
+   */
+  size_t getReadingLevel (const XMLToken& element) const;
+
+
+  /*
+   * The structure of an element whose end has not been consumed yet:
+   * the number of child elements pushed so far and how many of them have
+   * been consumed, and whether its end has been pushed, as token number
+   * end.  The name and position of its start tell it apart from other
+   * elements.
+   */
+  struct ElementInfo
+  {
+    unsigned int children;
+    unsigned int consumed;
+    bool         closed;
+    size_t       end;
+    std::string  name;
+    unsigned int line;
+    unsigned int column;
+    size_t       offset;
+  };
+
+  static const size_t npos;
+
+  size_t allocateElement ();
+  void   releaseElement (size_t element);
+
+  size_t       mChunkSize;
+  unsigned int mSkipDepth;
+
+  XMLElementFilter* mFilter;
+
+  unsigned int      mReadDepth;
+  unsigned int      mReadElements;
+  unsigned int      mNumElements;
+  XMLStopCondition* mStopCondition;
+  bool              mStopped;
+
+  /*
+   * With mIgnoreWhitespace, whitespace at the start of a text node is held
+   * in mBlank until the node turns out to have other content (mInText);
+   * otherwise it is dropped when the next element starts or ends.
+   */
+  bool              mIgnoreWhitespace;
+  bool              mInText;
+  std::string       mBlank;
+
+  XMLToken     mCurrent;
+  XMLToken     mView;
+  XMLTokenPool mTokens;
+
+  /*
+   * Structural lookahead, updated as tokens are pushed and consumed.
+   *
+   * mTokenElement runs parallel to mTokens and holds, for each open start
+   * element, the index of its ElementInfo in mElements (npos for other
+   * tokens).  mOpen lists the elements whose start has been pushed but
+   * not their end; mReading lists the elements whose start has been
+   * consumed but not their end.  mFrontNumber is the document-wide
+   * number of mTokens.front().
+   */
+  std::deque<size_t>       mTokenElement;
+  std::vector<ElementInfo> mElements;
+  std::vector<size_t>      mFreeElements;
+  std::vector<size_t>      mOpen;
+  std::vector<size_t>      mReading;
+  size_t                   mFrontNumber;
+
+  /*
+   * The namespace scope inside each element open at the parser, each
+   * holding a reference.  popScopes() leaves the innermost ones.
+   */
+  std::vector<const XMLNamespaceScope*> mScopes;
+  void popScopes (size_t count);
 
   friend class XMLInputStream;
 
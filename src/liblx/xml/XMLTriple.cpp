@@ -34,6 +34,8 @@
  * also available online as http://sbml.org/software/libsbml/license.html
  * ---------------------------------------------------------------------- -->*/
 
+#include <cstring>
+
 #include <liblx/xml/XMLTriple.h>
 #include <liblx/xml/XMLAttributes.h>
 #include <liblx/xml/XMLConstructorException.h>
@@ -198,6 +200,73 @@ XMLTriple::isEmpty () const
 }
 
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Exchanges the contents of this XMLTriple with those of other.
+ */
+void
+XMLTriple::swap (XMLTriple& other)
+{
+  mName  .swap(other.mName);
+  mURI   .swap(other.mURI);
+  mPrefix.swap(other.mPrefix);
+}
+
+
+/*
+ * Replaces the contents of this XMLTriple with the parts of triplet,
+ * keeping the capacity of the existing strings.
+ */
+void
+XMLTriple::setTriplet (const char* triplet, const char sepchar)
+{
+  if (triplet == NULL)
+  {
+    assign(NULL, NULL, NULL);
+    return;
+  }
+
+  const char* first  = strchr(triplet, sepchar);
+
+  if (first == NULL)
+  {
+    mName.assign(triplet);
+    mURI.clear();
+    mPrefix.clear();
+    return;
+  }
+
+  const char* second = strchr(first + 1, sepchar);
+
+  mURI.assign(triplet, first - triplet);
+
+  if (second != NULL)
+  {
+    mName  .assign(first + 1, second - first - 1);
+    mPrefix.assign(second + 1);
+  }
+  else
+  {
+    mName.assign(first + 1);
+    mPrefix.clear();
+  }
+}
+
+
+/*
+ * Replaces the name, URI and prefix of this XMLTriple, keeping the
+ * capacity of the existing strings.
+ */
+void
+XMLTriple::assign (const char* name, const char* uri, const char* prefix)
+{
+  if (name   != NULL) mName  .assign(name);   else mName  .clear();
+  if (uri    != NULL) mURI   .assign(uri);    else mURI   .clear();
+  if (prefix != NULL) mPrefix.assign(prefix); else mPrefix.clear();
+}
+/** @endcond */
+
+
 /*
  * Comparison (equal-to) operator for XMLTriple.
  *
@@ -199,6 +199,36 @@ public:
   bool isEmpty () const;
 
 
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Exchanges the contents of this XMLTriple with those of @p other
+   * without copying the underlying strings.
+   *
+   * @param other the XMLTriple to swap contents with.
+   */
+  void swap (XMLTriple& other);
+
+
+  /**
+   * Replaces the contents of this XMLTriple with the parts of
+   * @p triplet (see the corresponding constructor), reusing the
+   * storage already held by this object.
+   *
+   * @param triplet a string representing the triplet.
+   * @param sepchar a character, the sepchar used in the triplet.
+   */
+  void setTriplet (const char* triplet, const char sepchar = ' ');
+
+
+  /**
+   * Replaces the name, URI and prefix of this XMLTriple, reusing the
+   * storage already held by this object.  A @c NULL argument is
+   * treated as the empty string.
+   */
+  void assign (const char* name, const char* uri, const char* prefix);
+  /** @endcond */
+
+
 private:
   /** @cond doxygenLibsbmlInternal */
   std::string  mName;
@@ -77,6 +77,8 @@ XercesAttributes::XercesAttributes (const Attributes& attrs,
     }
   }
 
+  reindex();
+
   mElementName = elementName;
 }
 
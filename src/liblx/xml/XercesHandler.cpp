@@ -132,11 +132,24 @@ XercesHandler::startElement (  const XMLCh* const  uri
                              , const XMLCh* const  qname
                              , const Attributes&   attrs )
 {
+  if (mHandler.isSkipping())
+  {
+    mHandler.skipStartElement();
+    return;
+  }
+
   const string nsuri  = XercesTranscode( uri       );
   const string name   = XercesTranscode( localname );
   const string prefix = getPrefix( XercesTranscode(qname) );
 
   const XMLTriple         triple    ( name, nsuri, prefix );
+
+  if (!mHandler.acceptElement(triple))
+  {
+    mHandler.skipStartElement();
+    return;
+  }
+
   const XercesAttributes  attributes( attrs, name );
   const XercesNamespaces  namespaces( attrs );
   const XMLToken          element   ( triple, attributes, namespaces,
@@ -168,6 +181,12 @@ XercesHandler::endElement (  const XMLCh* const  uri
                            , const XMLCh* const  localname
                            , const XMLCh* const  qname )
 {
+  if (mHandler.isSkipping())
+  {
+    mHandler.skipEndElement();
+    return;
+  }
+
   const string nsuri  = XercesTranscode( uri       );
   const string name   = XercesTranscode( localname );
   const string prefix = getPrefix( XercesTranscode(qname) );
@@ -189,6 +208,8 @@ void
 XercesHandler::characters (  const XMLCh* const  chars
                            , const XercesSize_t  length )
 {
+  if (mHandler.isSkipping()) return;
+
   const string   transcoded = XercesTranscode(chars);
   const XMLToken data(transcoded);
 
@@ -685,6 +685,15 @@ XercesParser::parseNext ()
 }
 
 
+/**
+ * Xerces does not report byte offsets, so positions are always looked up.
+ */
+void
+XercesParser::setTrackPositions (bool /*track*/)
+{
+}
+
+
 /**
  * Resets the progressive parser.  Call between the last call to
  * parseNext() and the next call to parseFirst().
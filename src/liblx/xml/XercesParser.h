@@ -130,6 +130,13 @@ public:
   virtual unsigned int getLine () const;
 
 
+  /**
+   * Xerces does not report byte offsets, so positions are always looked
+   * up and this does nothing.
+   */
+  virtual void setTrackPositions (bool track);
+
+
 protected:
 
   /**
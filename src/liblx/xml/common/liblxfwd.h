@@ -79,6 +79,24 @@ typedef CLASS_OR_STRUCT XMLErrorLog               XMLErrorLog_t;
  */
 typedef CLASS_OR_STRUCT XMLNode                   XMLNode_t;
 
+/**
+ * @var typedef class XMLNodeIterator XMLNodeIterator_t
+ * @copydoc XMLNodeIterator
+ */
+typedef CLASS_OR_STRUCT XMLNodeIterator           XMLNodeIterator_t;
+
+/**
+ * @var typedef class XMLNodeDiff XMLNodeDiff_t
+ * @copydoc XMLNodeDiff
+ */
+typedef CLASS_OR_STRUCT XMLNodeDiff               XMLNodeDiff_t;
+
+/**
+ * @var typedef class XMLCompactTree XMLCompactTree_t
+ * @copydoc XMLCompactTree
+ */
+typedef CLASS_OR_STRUCT XMLCompactTree            XMLCompactTree_t;
+
 /**
  * @var typedef class XMLAttributes XMLAttributes_t
  * @copydoc XMLAttributes
@@ -57,6 +57,13 @@ Suite *create_suite_XMLError (void);
 Suite *create_suite_XMLError_C (void);
 Suite *create_suite_XMLErrorLog (void);
 Suite *create_suite_XMLInputStream (void);
+Suite *create_suite_XMLInputStream_streaming (void);
+Suite *create_suite_XMLNumberReader (void);
+Suite *create_suite_XMLBase64 (void);
+Suite *create_suite_XMLPathMatcher (void);
+Suite *create_suite_XMLNodeDiff (void);
+Suite *create_suite_XMLCompactTree (void);
+Suite *create_suite_XMLNodeQuery (void);
 Suite *create_suite_XMLOutputStream (void);
 Suite *create_suite_XMLAttributes_C (void);
 Suite *create_suite_XMLExceptions (void);
@@ -78,6 +85,13 @@ main (int argc, char* argv[])
   srunner_add_suite(runner, create_suite_XMLError_C());
   srunner_add_suite(runner, create_suite_XMLErrorLog());
   srunner_add_suite(runner, create_suite_XMLInputStream());
+  srunner_add_suite(runner, create_suite_XMLInputStream_streaming());
+  srunner_add_suite(runner, create_suite_XMLNumberReader());
+  srunner_add_suite(runner, create_suite_XMLBase64());
+  srunner_add_suite(runner, create_suite_XMLPathMatcher());
+  srunner_add_suite(runner, create_suite_XMLNodeDiff());
+  srunner_add_suite(runner, create_suite_XMLCompactTree());
+  srunner_add_suite(runner, create_suite_XMLNodeQuery());
   srunner_add_suite(runner, create_suite_XMLOutputStream());
   srunner_add_suite(runner, create_suite_XMLAttributes_C());
   srunner_add_suite(runner, create_suite_XMLExceptions());
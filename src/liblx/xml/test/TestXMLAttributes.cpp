@@ -39,7 +39,10 @@
 #include <iostream>
 #include <check.h>
 #include <XMLAttributes.h>
+#include <XMLAttributeSchema.h>
+#include <XMLErrorLog.h>
 #include <string>
+#include <sstream>
 
 
 /** @cond doxygenIgnored */
@@ -361,6 +364,138 @@ START_TEST(test_XMLAttributes_add_removeResource)
 END_TEST
 
 
+START_TEST(test_XMLAttributes_wide)
+{
+  XMLAttributes attr;
+  const int n = 3 * (int)XMLNameIndex::Threshold;
+
+  for (int i = 0; i < n; ++i)
+  {
+    ostringstream name;
+    name << "a" << i;
+    attr.add(name.str(), name.str(), (i % 2) ? "http://foo.org/" : "");
+  }
+
+  attr.add("a0", "other", "http://bar.org/", "bar");
+  fail_unless( attr.getLength() == n + 1 );
+
+  for (int i = 0; i < n; ++i)
+  {
+    ostringstream name;
+    name << "a" << i;
+    fail_unless( attr.getIndex(name.str()) == i );
+    fail_unless( attr.getIndex(name.str(), (i % 2) ? "http://foo.org/" : "") == i );
+  }
+
+  fail_unless( attr.getIndex("a0", "http://bar.org/") == n );
+  fail_unless( attr.getIndex(XMLTriple("a0", "http://bar.org/", "bar")) == n );
+  fail_unless( attr.getIndex("a0", "http://foo.org/") == -1 );
+  fail_unless( attr.getIndex("missing") == -1 );
+
+  attr.add("a1", "replaced", "http://foo.org/");
+  fail_unless( attr.getLength() == n + 1 );
+  fail_unless( attr.getValue("a1") == "replaced" );
+
+  attr.remove(0);
+  fail_unless( attr.getIndex("a0") == n - 1 );
+  fail_unless( attr.getIndex("a1") == 0 );
+  fail_unless( attr.getValue("a2") == "a2" );
+
+  XMLAttributes copy(attr);
+  fail_unless( copy.getIndex("a2") == 1 );
+
+  attr.clear();
+  fail_unless( attr.getIndex("a2") == -1 );
+  fail_unless( copy.getIndex("a2") == 1 );
+}
+END_TEST
+
+
+struct SchemaTarget
+{
+  std::string  id;
+  double       amount;
+  bool         constant;
+  int          count;
+  unsigned int size;
+  long         total;
+};
+
+
+START_TEST(test_XMLAttributes_schema)
+{
+  static const XMLAttributeField<SchemaTarget> fields[] =
+  {
+    XMLAttributeField<SchemaTarget>("id",       &SchemaTarget::id,       true),
+    XMLAttributeField<SchemaTarget>("amount",   &SchemaTarget::amount        ),
+    XMLAttributeField<SchemaTarget>("constant", &SchemaTarget::constant, true),
+    XMLAttributeField<SchemaTarget>("count",    &SchemaTarget::count         ),
+    XMLAttributeField<SchemaTarget>("size",     &SchemaTarget::size,     true),
+    XMLAttributeField<SchemaTarget>("total",    &SchemaTarget::total         )
+  };
+  static const XMLAttributeSchema<SchemaTarget> schema(fields);
+
+  fail_unless( schema.getNumFields() == 6 );
+  fail_unless( schema.getFieldIndex("size") == 4 );
+  fail_unless( schema.getFieldIndex("other") == -1 );
+
+  XMLAttributes attr;
+  attr.add("total", " 42 ");
+  attr.add("other", "x");
+  attr.add("amount", "2.5");
+  attr.add("count", "many");
+  attr.add("id", "s1");
+  attr.add("constant", "true", "http://foo.org/", "foo");
+
+  SchemaTarget target;
+  target.count = 7;
+  target.size  = 9;
+
+  XMLErrorLog log;
+  fail_unless( schema.read(attr, target, &log, 3, 4) == false );
+
+  fail_unless( target.id       == "s1" );
+  fail_unless( target.amount   == 2.5  );
+  fail_unless( target.constant == true );
+  fail_unless( target.count    == 7    );
+  fail_unless( target.size     == 9    );
+  fail_unless( target.total    == 42   );
+
+  /* the same errors as reading the fields one by one */
+  XMLErrorLog expected;
+  std::string id;
+  double amount;
+  bool constant;
+  int count;
+  unsigned int size;
+  long total;
+  attr.readInto("id",       id,       &expected, true,  3, 4);
+  attr.readInto("amount",   amount,   &expected, false, 3, 4);
+  attr.readInto("constant", constant, &expected, true,  3, 4);
+  attr.readInto("count",    count,    &expected, false, 3, 4);
+  attr.readInto("size",     size,     &expected, true,  3, 4);
+  attr.readInto("total",    total,    &expected, false, 3, 4);
+
+  fail_unless( log.getNumErrors() == 2 );
+  fail_unless( log.getNumErrors() == expected.getNumErrors() );
+  for (unsigned int n = 0; n < log.getNumErrors(); ++n)
+  {
+    fail_unless( log.getError(n)->getErrorId() ==
+                 expected.getError(n)->getErrorId() );
+    fail_unless( log.getError(n)->getMessage() ==
+                 expected.getError(n)->getMessage() );
+    fail_unless( log.getError(n)->getLine() == 3 );
+  }
+
+  attr.add("count", "5");
+  attr.add("size", "11");
+  fail_unless( schema.read(attr, target) == true );
+  fail_unless( target.count == 5 );
+  fail_unless( target.size  == 11 );
+}
+END_TEST
+
+
 Suite *
 create_suite_XMLAttributes (void)
 {
@@ -376,6 +511,8 @@ create_suite_XMLAttributes (void)
   tcase_add_test( tcase, test_XMLAttributes_assignment      );
   tcase_add_test( tcase, test_XMLAttributes_clone           );
   tcase_add_test( tcase, test_XMLAttributes_add_removeResource);
+  tcase_add_test( tcase, test_XMLAttributes_wide            );
+  tcase_add_test( tcase, test_XMLAttributes_schema          );
 
   suite_add_tcase(suite, tcase);
 
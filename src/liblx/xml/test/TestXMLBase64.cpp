@@ -0,0 +1,277 @@
+/**
+ * @file    TestXMLBase64.cpp
+ * @brief   XMLBase64Decoder and XMLBase64Encoder unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLBase64.h>
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLOutputStream.h>
+#include <liblx/xml/XMLTriple.h>
+
+#include <check.h>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+/** @endcond */
+
+
+/*
+ * Returns the decoded text, or "<invalid>" if the text is rejected with
+ * exactly one logged error.
+ */
+static string
+decodeString (const string& text)
+{
+  vector<unsigned char> bytes;
+  XMLErrorLog           log;
+
+  if (!XMLBase64Decoder::decode(text, bytes, &log))
+    return (log.getNumErrors() == 1) ? "<invalid>" : "<wrong error count>";
+
+  if (log.getNumErrors() != 0) return "<wrong error count>";
+
+  return string(bytes.begin(), bytes.end());
+}
+
+
+static string
+encodeString (const string& data)
+{
+  ostringstream   oss;
+  XMLOutputStream stream(oss, "UTF-8", false);
+
+  stream.writeBase64(data.data(), data.size());
+
+  return oss.str();
+}
+
+
+CK_CPPSTART
+
+
+START_TEST (test_XMLBase64_rfc4648)
+{
+  fail_unless( decodeString(""        ) == ""       );
+  fail_unless( decodeString("Zg=="    ) == "f"      );
+  fail_unless( decodeString("Zm8="    ) == "fo"     );
+  fail_unless( decodeString("Zm9v"    ) == "foo"    );
+  fail_unless( decodeString("Zm9vYg==") == "foob"   );
+  fail_unless( decodeString("Zm9vYmE=") == "fooba"  );
+  fail_unless( decodeString("Zm9vYmFy") == "foobar" );
+
+  fail_unless( encodeString(""      ) == ""         );
+  fail_unless( encodeString("f"     ) == "Zg=="     );
+  fail_unless( encodeString("fo"    ) == "Zm8="     );
+  fail_unless( encodeString("foo"   ) == "Zm9v"     );
+  fail_unless( encodeString("foob"  ) == "Zm9vYg==" );
+  fail_unless( encodeString("fooba" ) == "Zm9vYmE=" );
+  fail_unless( encodeString("foobar") == "Zm9vYmFy" );
+}
+END_TEST
+
+
+START_TEST (test_XMLBase64_whitespace)
+{
+  fail_unless( decodeString("  Zm9v\n  YmFy\r\n") == "foobar" );
+  fail_unless( decodeString("Z m 9 v Y g = =\t")  == "foob"   );
+  fail_unless( decodeString("Zm9vYg\n==\n")       == "foob"   );
+
+  // padding may be left out
+  fail_unless( decodeString("Zm9vYg") == "foob"  );
+  fail_unless( decodeString("Zm9vYmE") == "fooba" );
+}
+END_TEST
+
+
+START_TEST (test_XMLBase64_invalid)
+{
+  fail_unless( decodeString("Zm9v*mFy") == "<invalid>" );
+  fail_unless( decodeString("Zm9vY") == "<invalid>" );
+  fail_unless( decodeString("Z===") == "<invalid>" );
+  fail_unless( decodeString("Zg==Zg==") == "<invalid>" );
+  fail_unless( decodeString("Zg===") == "<invalid>" );
+  fail_unless( decodeString("Zm-v") == "<invalid>" );
+
+  vector<unsigned char> bytes;
+  XMLErrorLog           log;
+
+  fail_unless( !XMLBase64Decoder::decode("Zm9v!!", bytes, &log, 3, 7) );
+  fail_unless( log.getNumErrors() == 1 );
+  fail_unless( log.getError(0)->getErrorId() == UninterpretableXMLContent );
+  fail_unless( log.getError(0)->getLine()   == 3 );
+  fail_unless( log.getError(0)->getColumn() == 7 );
+
+  // without a log the result is still reported
+  bytes.clear();
+  fail_unless( !XMLBase64Decoder::decode("Zm9v!!", bytes) );
+  fail_unless( bytes.size() == 3 );
+}
+END_TEST
+
+
+START_TEST (test_XMLBase64_chunks)
+{
+  const string text = "TWFu IGlz IGRp\nc3Rpbmd1aXNoZWQ=";
+  const string data = "Man is distinguished";
+
+  for (size_t size = 1; size <= text.size(); ++size)
+  {
+    vector<unsigned char> bytes;
+    XMLBase64Decoder      decoder(bytes);
+
+    for (size_t n = 0; n < text.size(); n += size)
+      fail_unless( decoder.append(text.data() + n,
+                                  min(size, text.size() - n)) );
+
+    fail_unless( decoder.finish() );
+    fail_unless( string(bytes.begin(), bytes.end()) == data );
+  }
+}
+END_TEST
+
+
+START_TEST (test_XMLBase64_allBytes)
+{
+  string data;
+  for (unsigned int n = 0; n < 3 * 256 + 1; ++n)
+    data += static_cast<char>(n * 7);
+
+  const string text = encodeString(data);
+
+  fail_unless( text.size() == (data.size() + 2) / 3 * 4 );
+  fail_unless( decodeString(text) == data );
+}
+END_TEST
+
+
+START_TEST (test_XMLBase64_stream)
+{
+  string data;
+  for (unsigned int n = 0; n < 20000; ++n)
+    data += static_cast<char>(n % 251);
+
+  string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<data>";
+  const string text = encodeString(data);
+
+  for (size_t n = 0; n < text.size(); n += 76)
+    xml += text.substr(n, 76) + "\n";
+  xml += "</data>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+  stream.setCharacterChunkSize(101);
+  stream.next();
+
+  vector<unsigned char> bytes;
+  XMLBase64Decoder      decoder(bytes, stream.getErrorLog());
+
+  stream.readCharacters(decoder);
+
+  fail_unless( decoder.finish() );
+  fail_unless( string(bytes.begin(), bytes.end()) == data );
+  fail_unless( stream.peek().isEnd() );
+}
+END_TEST
+
+
+START_TEST (test_XMLBase64_encoder)
+{
+  XMLTriple data("data", "", "");
+  const string payload = "Man is distinguished";
+
+  for (size_t size = 1; size <= payload.size(); ++size)
+  {
+    ostringstream   oss;
+    XMLOutputStream stream(oss, "UTF-8", false);
+
+    stream.startElement(data);
+    {
+      XMLBase64Encoder encoder(stream);
+
+      for (size_t n = 0; n < payload.size(); n += size)
+        encoder.append(payload.data() + n, min(size, payload.size() - n));
+
+      encoder.finish();
+    }
+    stream.endElement(data);
+
+    fail_unless( oss.str() ==
+                 "<data>TWFuIGlzIGRpc3Rpbmd1aXNoZWQ=</data>" );
+  }
+
+  // more than one buffer of output
+  string large(10000, 'x');
+  ostringstream   oss;
+  XMLOutputStream stream(oss, "UTF-8", false);
+
+  stream.startElement(data);
+  stream.writeBase64(large.data(), large.size());
+  stream.endElement(data);
+
+  const string out  = oss.str();
+  const string text = out.substr(6, out.size() - 13);
+
+  fail_unless( out.compare(0, 6, "<data>") == 0 );
+  fail_unless( decodeString(text) == large );
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLBase64 (void)
+{
+  Suite *suite = suite_create("XMLBase64");
+  TCase *tcase = tcase_create("XMLBase64");
+
+  tcase_add_test( tcase, test_XMLBase64_rfc4648  );
+  tcase_add_test( tcase, test_XMLBase64_whitespace  );
+  tcase_add_test( tcase, test_XMLBase64_invalid  );
+  tcase_add_test( tcase, test_XMLBase64_chunks  );
+  tcase_add_test( tcase, test_XMLBase64_allBytes  );
+  tcase_add_test( tcase, test_XMLBase64_stream  );
+  tcase_add_test( tcase, test_XMLBase64_encoder  );
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
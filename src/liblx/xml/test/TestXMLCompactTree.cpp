@@ -0,0 +1,269 @@
+/**
+ * @file    TestXMLCompactTree.cpp
+ * @brief   XMLCompactTree unit tests
+ *
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/operationReturnValues.h>
+#include <liblx/xml/XMLCompactTree.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+
+#include <check.h>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+/** @endcond */
+
+
+CK_CPPSTART
+
+
+static const string Document =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<model xmlns=\"http://a\">"
+  "<unit id=\"u1\"><annotation><note kind=\"x\">same</note></annotation></unit>"
+  "<unit id=\"u2\"><annotation><note kind=\"x\">same</note></annotation></unit>"
+  "<unit id=\"u3\"><annotation><note kind=\"y\">same</note></annotation></unit>"
+  "<math><ci>x</ci><ci>x</ci></math>"
+  "</model>";
+
+
+/*
+ * @return the number of nodes in the tree rooted at node.
+ */
+static size_t
+countNodes (const XMLNode& node)
+{
+  size_t count = 1;
+  for (unsigned int n = 0; n < node.getNumChildren(); ++n)
+  {
+    count += countNodes(node.getChild(n));
+  }
+  return count;
+}
+
+
+START_TEST (test_XMLCompactTree_shared)
+{
+  XMLInputStream stream(Document.c_str(), false);
+  XMLNode        model(stream);
+  XMLCompactTree tree(model);
+
+  const XMLCompactNode* root = tree.getRoot();
+  fail_unless( root != NULL );
+  fail_unless( root->getName() == "model" );
+  fail_unless( root->getNamespacesLength() == 1 );
+  fail_unless( root->getNumChildren() == 4 );
+
+  // the annotations of u1 and u2 are stored once, that of u3 apart
+  const XMLCompactNode& u1 = root->getChild(0);
+  const XMLCompactNode& u2 = root->getChild(1);
+  const XMLCompactNode& u3 = root->getChild(2);
+  fail_unless( u1.getAttrValue("id") == "u1" );
+  fail_unless( &u1 != &u2 );
+  fail_unless( &u1.getChild(0) == &u2.getChild(0) );
+  fail_unless( &u1.getChild(0) != &u3.getChild(0) );
+  fail_unless( u1.getChild(0).getHash() == u2.getChild(0).getHash() );
+  fail_unless( &u1.getChild("annotation") == &u1.getChild(0) );
+  fail_unless( u1.getChild(0).getChild(0).getChild(0).getCharacters() == "same" );
+
+  // so are the text nodes and the two ci elements
+  const XMLCompactNode& math = root->getChild("math");
+  fail_unless( math.getNumChildren() == 2 );
+  fail_unless( &math.getChild(0) == &math.getChild(1) );
+  fail_unless( math.getIndex("ci") == 0 );
+  fail_unless( math.hasChild("ci") );
+  fail_unless( !math.hasChild("cn") );
+  fail_unless( math.getIndex("cn") == -1 );
+  fail_unless( math.getChild(5).getName() == "" );
+  fail_unless( math.getChild(5).getNumChildren() == 0 );
+
+  fail_unless( tree.getNumNodes() == countNodes(model) );
+  fail_unless( tree.getNumNodes() == 18 );
+  fail_unless( tree.getNumUniqueNodes() == 12 );
+
+  // the tree reads back as it was
+  fail_unless( root->toXMLString() == model.toXMLString() );
+
+  XMLNode* copy = tree.toXMLNode();
+  fail_unless( copy->equals(model) );
+  fail_unless( copy->toXMLString() == model.toXMLString() );
+  fail_unless( copy->getChild(1).getChild(0).getParent() == &copy->getChild(1) );
+  delete copy;
+
+  XMLCompactTree empty;
+  fail_unless( empty.getRoot() == NULL );
+  fail_unless( empty.getNumNodes() == 0 );
+  fail_unless( empty.toXMLNode() == NULL );
+}
+END_TEST
+
+
+START_TEST (test_XMLCompactTree_stream)
+{
+  XMLInputStream  stream(Document.c_str(), false);
+  XMLCompactTree  tree(stream);
+  XMLInputStream  again(Document.c_str(), false);
+  XMLNode         model(again);
+
+  fail_unless( tree.getRoot() != NULL );
+  fail_unless( tree.getRoot()->toXMLString() == model.toXMLString() );
+  fail_unless( tree.getNumNodes() == countNodes(model) );
+  fail_unless( tree.getNumUniqueNodes() == XMLCompactTree(model).getNumUniqueNodes() );
+
+  XMLNode* copy = tree.toXMLNode();
+  fail_unless( copy->equals(model) );
+  delete copy;
+
+  // a deep chain is stored and copied back without recursion
+  XMLNode  deep(XMLTriple("n", "", ""), XMLAttributes());
+  XMLNode* node = &deep;
+  for (unsigned int n = 0; n < 5000; ++n)
+  {
+    node->addChild(XMLNode(XMLTriple("n", "", ""), XMLAttributes()));
+    node = &node->getChild(0);
+  }
+
+  XMLCompactTree chain(deep);
+  fail_unless( chain.getNumNodes() == 5001 );
+  fail_unless( chain.getNumUniqueNodes() == 5001 );
+
+  copy = chain.toXMLNode();
+  fail_unless( copy->equals(deep) );
+  delete copy;
+}
+END_TEST
+
+
+START_TEST (test_XMLCompactTree_replace)
+{
+  XMLInputStream stream(Document.c_str(), false);
+  XMLNode        model(stream);
+  XMLCompactTree tree(model);
+
+  const unsigned int unique = tree.getNumUniqueNodes();
+
+  // change the shared note under u2 through a private copy
+  vector<unsigned int> path;
+  path.push_back(1);
+  path.push_back(0);
+  path.push_back(0);
+
+  XMLNode* note = tree.getRoot()->getChild(1).getChild(0).getChild(0).toXMLNode();
+  note->addAttr("extra", "1");
+
+  fail_unless( tree.replace(path, *note) == LIBLX_OPERATION_SUCCESS );
+  model.getChild(1).getChild(0).getChild(0).addAttr("extra", "1");
+
+  const XMLCompactNode* root = tree.getRoot();
+  fail_unless( root->toXMLString() == model.toXMLString() );
+  fail_unless( root->getChild(1).getChild(0).getChild(0).getAttrValue("extra") == "1" );
+  fail_unless( root->getChild(0).getChild(0).getChild(0).getAttrValue("extra") == "" );
+  fail_unless( &root->getChild(0).getChild(0) != &root->getChild(1).getChild(0) );
+  fail_unless( tree.getNumNodes() == countNodes(model) );
+
+  // new note, annotation, unit and model; the old unit and model freed
+  fail_unless( tree.getNumUniqueNodes() == unique + 2 );
+
+  // changing it back shares the annotation again
+  note->removeAttr("extra");
+  fail_unless( tree.replace(path, *note) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( tree.getNumUniqueNodes() == unique );
+  root = tree.getRoot();
+  fail_unless( &root->getChild(0).getChild(0) == &root->getChild(1).getChild(0) );
+  delete note;
+
+  // paths that lead nowhere change nothing
+  path[0] = 7;
+  fail_unless( tree.replace(path, model) == LIBLX_INVALID_XML_OPERATION );
+  fail_unless( tree.getRoot() == root );
+
+  XMLCompactTree empty;
+  fail_unless( empty.replace(vector<unsigned int>(), model) == LIBLX_INVALID_XML_OPERATION );
+
+  // an empty path replaces the whole tree
+  XMLNode text("text");
+  fail_unless( tree.replace(vector<unsigned int>(), text) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( tree.getNumNodes() == 1 );
+  fail_unless( tree.getNumUniqueNodes() == 1 );
+  fail_unless( tree.getRoot()->getCharacters() == "text" );
+}
+END_TEST
+
+
+START_TEST (test_XMLCompactTree_C)
+{
+  XMLInputStream stream(Document.c_str(), false);
+  XMLNode        model(stream);
+
+  fail_unless( XMLCompactTree_create(NULL) == NULL );
+  fail_unless( XMLCompactTree_getNumUniqueNodes(NULL) == 0 );
+  fail_unless( XMLCompactTree_toXMLNode(NULL) == NULL );
+  XMLCompactTree_free(NULL);
+
+  XMLCompactTree_t* tree = XMLCompactTree_create(&model);
+  fail_unless( XMLCompactTree_getNumUniqueNodes(tree) == 12 );
+
+  XMLNode_t* copy = XMLCompactTree_toXMLNode(tree);
+  fail_unless( copy->equals(model) );
+
+  delete copy;
+  XMLCompactTree_free(tree);
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLCompactTree (void)
+{
+  Suite *suite = suite_create("XMLCompactTree");
+  TCase *tcase = tcase_create("XMLCompactTree");
+
+  tcase_add_test( tcase, test_XMLCompactTree_shared  );
+  tcase_add_test( tcase, test_XMLCompactTree_stream  );
+  tcase_add_test( tcase, test_XMLCompactTree_replace );
+  tcase_add_test( tcase, test_XMLCompactTree_C       );
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
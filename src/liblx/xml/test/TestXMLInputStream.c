@@ -115,6 +115,138 @@ START_TEST (test_XMLInputStream_next_peek)
 END_TEST
 
 
+START_TEST (test_XMLInputStream_nextView)
+{
+  const char* text = 
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<sbml "
+    "xmlns=\"http://www.sbml.org/sbml/level2\" "
+    "level=\"2\" version=\"1\">"
+    "<model id=\"Branch\"/>"
+    "</sbml>";
+
+  XMLInputStream_t *stream = XMLInputStream_create(text, 0, "");
+
+  fail_unless(stream != NULL);
+
+  const XMLToken_t *view = XMLInputStream_nextView(stream);
+
+  fail_unless(strcmp(XMLToken_getName(view), "sbml") == 0);
+  fail_unless(XMLToken_isStart(view) == 1);
+  fail_unless(XMLToken_getNamespacesLength(view) == 1);
+
+  view = XMLInputStream_nextView(stream);
+
+  fail_unless(strcmp(XMLToken_getName(view), "model") == 0);
+  fail_unless(XMLToken_isStart(view) == 1);
+  fail_unless(XMLToken_isEnd(view) == 1);
+
+  const XMLToken_t *next0 = XMLInputStream_peek(stream);
+
+  fail_unless(strcmp(XMLToken_getName(next0), "sbml") == 0);
+  fail_unless(XMLToken_isEnd(next0) == 1);
+  fail_unless(strcmp(XMLToken_getName(view), "model") == 0);
+
+  view = XMLInputStream_nextView(stream);
+
+  fail_unless(strcmp(XMLToken_getName(view), "sbml") == 0);
+  fail_unless(XMLToken_isEnd(view) == 1);
+
+  view = XMLInputStream_nextView(stream);
+
+  fail_unless(XMLToken_isEOF(view) == 1);
+
+  XMLInputStream_free(stream);
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_recycledTokens)
+{
+  const unsigned int count = 3000;
+  char  element[64];
+  char  value[16];
+  char* attr;
+  char* text = (char*) malloc(count * 64 + 128);
+
+  strcpy(text, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<list>");
+
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    if (n % 3 == 0)
+      sprintf(element, "<s id=\"s%u\" name=\"n%u\" c=\"1\"/>", n, n);
+    else if (n % 3 == 1)
+      sprintf(element, "<s id=\"s%u\"/>", n);
+    else
+      sprintf(element, "<s>%u</s>", n);
+
+    strcat(text, element);
+  }
+
+  strcat(text, "</list>");
+
+  XMLInputStream_t *stream = XMLInputStream_create(text, 0, "");
+  const XMLToken_t *view   = XMLInputStream_nextView(stream);
+
+  fail_unless(strcmp(XMLToken_getName(view), "list") == 0);
+
+  /* tokens are recycled once consumed; none may leak stale contents */
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    view = XMLInputStream_nextView(stream);
+
+    fail_unless(strcmp(XMLToken_getName(view), "s") == 0);
+    fail_unless(XMLToken_isStart(view) == 1);
+
+    if (n % 3 == 0)
+    {
+      sprintf(value, "n%u", n);
+      fail_unless(XMLToken_isEnd(view) == 1);
+      fail_unless(XMLToken_getAttributesLength(view) == 3);
+
+      attr = XMLToken_getAttrValue(view, 1);
+      fail_unless(strcmp(attr, value) == 0);
+      free(attr);
+    }
+    else if (n % 3 == 1)
+    {
+      sprintf(value, "s%u", n);
+      fail_unless(XMLToken_isEnd(view) == 1);
+      fail_unless(XMLToken_getAttributesLength(view) == 1);
+
+      attr = XMLToken_getAttrValue(view, 0);
+      fail_unless(strcmp(attr, value) == 0);
+      free(attr);
+    }
+    else
+    {
+      sprintf(value, "%u", n);
+      fail_unless(XMLToken_isEnd(view) == 0);
+      fail_unless(XMLToken_getAttributesLength(view) == 0);
+
+      view = XMLInputStream_nextView(stream);
+
+      fail_unless(XMLToken_isText(view) == 1);
+      fail_unless(strcmp(XMLToken_getCharacters(view), value) == 0);
+
+      view = XMLInputStream_nextView(stream);
+
+      fail_unless(XMLToken_isEnd(view) == 1);
+      fail_unless(XMLToken_getAttributesLength(view) == 0);
+    }
+  }
+
+  view = XMLInputStream_nextView(stream);
+
+  fail_unless(strcmp(XMLToken_getName(view), "list") == 0);
+  fail_unless(XMLToken_isEnd(view) == 1);
+
+  XMLInputStream_free(stream);
+  free(text);
+}
+END_TEST
+
+
 START_TEST (test_XMLInputStream_skip)
 {
   const char* text = 
@@ -207,8 +339,17 @@ START_TEST (test_XMLInputStream_accessWithNULL)
   fail_unless (XMLInputStream_isError(NULL) == 0);
   fail_unless (XMLInputStream_isGood(NULL) == 0);
   fail_unless (XMLInputStream_next(NULL) == NULL);
+  fail_unless (XMLInputStream_nextView(NULL) == NULL);
   fail_unless (XMLInputStream_peek(NULL) == NULL);
   fail_unless (XMLInputStream_setErrorLog(NULL, NULL) == LIBLX_OPERATION_FAILED);
+  fail_unless (XMLInputStream_mark(NULL) == LIBLX_INVALID_OBJECT);
+  fail_unless (XMLInputStream_rewind(NULL) == LIBLX_INVALID_OBJECT);
+  fail_unless (XMLInputStream_unmark(NULL) == LIBLX_INVALID_OBJECT);
+  fail_unless (XMLInputStream_setReadLimit(NULL, 1, 0) == LIBLX_INVALID_OBJECT);
+  fail_unless (XMLInputStream_close(NULL) == LIBLX_INVALID_OBJECT);
+  fail_unless (XMLInputStream_setTrackPositions(NULL, 0) == LIBLX_INVALID_OBJECT);
+  fail_unless (XMLInputStream_setIgnoreWhitespace(NULL, 1) == LIBLX_INVALID_OBJECT);
+  fail_unless (XMLInputStream_getByteOffset(NULL) == 0);
 
   XMLInputStream_skipPastEnd(NULL, NULL);
   XMLInputStream_skipText(NULL);  
@@ -223,6 +364,8 @@ create_suite_XMLInputStream (void)
 
   tcase_add_test( tcase, test_XMLInputStream_create  );
   tcase_add_test( tcase, test_XMLInputStream_next_peek  );
+  tcase_add_test( tcase, test_XMLInputStream_nextView  );
+  tcase_add_test( tcase, test_XMLInputStream_recycledTokens  );
   tcase_add_test( tcase, test_XMLInputStream_skip  );
   tcase_add_test( tcase, test_XMLInputStream_setErrorLog  );
   tcase_add_test( tcase, test_XMLInputStream_accessWithNULL );
@@ -0,0 +1,1146 @@
+/**
+ * @file    TestXMLInputStream_streaming.cpp
+ * @brief   XMLInputStream streaming unit tests, C++ version
+ * 
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/operationReturnValues.h>
+#include <liblx/xml/XMLToken.h>
+#include <liblx/xml/XMLTriple.h>
+#include <liblx/xml/XMLAttributes.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLHandler.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLElementFilter.h>
+#include <liblx/xml/XMLStopCondition.h>
+#include <liblx/xml/XMLNamespaceScope.h>
+
+#include <check.h>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+/** @endcond */
+
+
+CK_CPPSTART
+
+
+/*
+ * Collects the character data passed to it and counts the calls.
+ */
+class TextCollector : public XMLHandler
+{
+public:
+
+  TextCollector () : mCalls(0), mLongest(0) { }
+
+  virtual void characters (const XMLToken& data)
+  {
+    ++mCalls;
+    mText += data.getCharacters();
+    if (data.getCharacters().size() > mLongest)
+      mLongest = data.getCharacters().size();
+  }
+
+  string       mText;
+  unsigned int mCalls;
+  size_t       mLongest;
+};
+
+
+/*
+ * Returns a document whose <data> element holds count copies of piece.
+ */
+static string
+makeDocument (const string& piece, unsigned int count, string& text)
+{
+  text.clear();
+  for (unsigned int n = 0; n < count; ++n) text += piece;
+
+  return "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+         "<doc><data>" + text + "</data><tail/></doc>";
+}
+
+
+/*
+ * Rejects the elements with a given local name.
+ */
+class RejectFilter : public XMLElementFilter
+{
+public:
+
+  RejectFilter (const string& name) : mName(name), mCalls(0) { }
+
+  virtual bool accept (const XMLTriple& element)
+  {
+    ++mCalls;
+    return element.getName() != mName;
+  }
+
+  string       mName;
+  unsigned int mCalls;
+};
+
+
+START_TEST (test_XMLInputStream_chunkSize_default)
+{
+  string text;
+  string xml = makeDocument("0123456789 ", 2000, text);
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  fail_unless( stream.getCharacterChunkSize() == 0 );
+
+  stream.next();
+  stream.next();
+
+  const XMLToken& data = stream.nextView();
+
+  fail_unless( data.isText() );
+  fail_unless( data.getCharacters() == text );
+  fail_unless( stream.peek().isEnd() );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_chunkSize_pull)
+{
+  string text;
+  string xml = makeDocument("0123456789 ", 2000, text);
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  fail_unless( stream.setCharacterChunkSize(100) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( stream.getCharacterChunkSize() == 100 );
+
+  stream.next();
+  stream.next();
+
+  string       joined;
+  unsigned int chunks = 0;
+
+  while ( stream.peek().isText() )
+  {
+    const XMLToken& chunk = stream.nextView();
+
+    fail_unless( chunk.getCharacters().size() <= 100 );
+    joined += chunk.getCharacters();
+    ++chunks;
+  }
+
+  fail_unless( joined == text );
+  fail_unless( chunks == 220 );
+
+  const XMLToken& end = stream.nextView();
+
+  fail_unless( end.isEnd() );
+  fail_unless( end.getName() == "data" );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_chunkSize_utf8)
+{
+  // U+00E9 and U+20AC, two and three bytes in UTF-8
+  string text;
+  string xml = makeDocument("a\xC3\xA9\xE2\x82\xAC", 500, text);
+
+  XMLInputStream stream(xml.c_str(), false, "");
+  stream.setCharacterChunkSize(4);
+
+  stream.next();
+  stream.next();
+
+  string joined;
+
+  while ( stream.peek().isText() )
+  {
+    const string& chunk = stream.nextView().getCharacters();
+
+    fail_unless( chunk.size() <= 4 );
+    fail_unless( (static_cast<unsigned char>(chunk[0]) & 0xC0) != 0x80 );
+    joined += chunk;
+  }
+
+  fail_unless( joined == text );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_readCharacters)
+{
+  string text;
+  string xml = makeDocument("1.5 2.5 3.5 ", 5000, text);
+
+  XMLInputStream stream(xml.c_str(), false, "");
+  stream.setCharacterChunkSize(1024);
+
+  stream.next();
+  stream.next();
+
+  TextCollector collector;
+
+  fail_unless( stream.readCharacters(collector) == text.size() );
+  fail_unless( collector.mText == text );
+  fail_unless( collector.mCalls > 1 );
+  fail_unless( collector.mLongest <= 1024 );
+
+  fail_unless( stream.next().isEnd() );
+  fail_unless( stream.readCharacters(collector) == 0 );
+  fail_unless( stream.next().getName() == "tail" );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_chunkSize_XMLNode)
+{
+  string text;
+  string xml = makeDocument("x ", 3000, text);
+
+  XMLInputStream stream(xml.c_str(), false, "");
+  stream.setCharacterChunkSize(64);
+
+  XMLNode doc(stream);
+
+  fail_unless( doc.getNumChildren() == 2 );
+  fail_unless( doc.getChild(0).getNumChildren() == 1 );
+  fail_unless( doc.getChild(0).getChild(0).getCharacters() == text );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_skipPastEnd_nested)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<doc><a><a x=\"1\"><a/>text<b/></a><a>more</a></a>"
+    "<c y=\"2\">tail</c></doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  stream.next();
+
+  XMLToken a = stream.next();
+  fail_unless( a.getName() == "a" );
+
+  stream.skipPastEnd(a);
+
+  const XMLToken& c = stream.nextView();
+
+  fail_unless( c.getName() == "c" );
+  fail_unless( c.isStart() );
+  fail_unless( c.getAttributes().getValue("y") == "2" );
+  fail_unless( stream.nextView().getCharacters() == "tail" );
+  fail_unless( stream.isGood() );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_skipPastEnd_peeked)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<doc><a><b/><b>x</b></a><c/></doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  stream.next();
+
+  // the element is passed without having been consumed
+  stream.skipPastEnd(stream.peek());
+
+  fail_unless( stream.peek().getName() == "c" );
+
+  XMLToken c = stream.peek();
+  stream.skipPastEnd(c);
+
+  fail_unless( stream.peek().getName() == "c" );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_skipPastEnd_outer)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<r><a><b><c/></b><d/></a><e/></r>";
+
+  for (unsigned int track = 0; track < 2; ++track)
+  {
+    XMLInputStream stream(xml.c_str(), false, "");
+    stream.setTrackPositions(track == 1);
+
+    stream.next();
+    XMLToken a = stream.next();
+    stream.next();
+
+    // a encloses the element being read
+    stream.skipPastEnd(a);
+
+    fail_unless( stream.peek().getName() == "e" );
+    fail_unless( stream.peek().isStart() );
+    fail_unless( !stream.isError() );
+  }
+
+  // an element that was not read from the stream ends at its end tag
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  stream.next();
+  stream.next();
+  stream.skipPastEnd(XMLToken(XMLTriple("b", "", ""), XMLAttributes()));
+
+  fail_unless( stream.peek().getName() == "d" );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_skipPastEnd_large)
+{
+  string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               "<doc><ext xmlns:e=\"http://example.org/ext\">";
+
+  for (unsigned int n = 0; n < 20000; ++n)
+  {
+    xml += "<e:item e:id=\"i\" value=\"1\" xmlns:f=\"http://example.org/f\">"
+           "some text<e:sub/></e:item>";
+  }
+
+  xml += "</ext><after id=\"x\"/></doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  stream.next();
+  XMLToken ext = stream.next();
+
+  stream.skipPastEnd(ext);
+
+  const XMLToken& after = stream.nextView();
+
+  fail_unless( after.getName() == "after" );
+  fail_unless( after.getAttributes().getValue("id") == "x" );
+  fail_unless( stream.peek().isEndFor(XMLToken(XMLTriple("doc", "", ""),
+                                               XMLAttributes())) );
+
+  stream.next();
+  fail_unless( stream.peek().isEOF() );
+  fail_unless( !stream.isError() );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_elementFilter)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<doc><skip a=\"1\"><x><y/></x>text</skip>"
+    "<keep b=\"2\">kept<skip/></keep><skip/></doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+  RejectFilter   filter("skip");
+
+  fail_unless( stream.getElementFilter() == NULL );
+  fail_unless( stream.setElementFilter(&filter) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( stream.getElementFilter() == &filter );
+
+  XMLNode doc(stream);
+
+  fail_unless( doc.getName() == "doc" );
+  fail_unless( doc.getNumChildren() == 1 );
+  fail_unless( doc.getChild(0).getName() == "keep" );
+  fail_unless( doc.getChild(0).getAttrValue("b") == "2" );
+  fail_unless( doc.getChild(0).getNumChildren() == 1 );
+  fail_unless( doc.getChild(0).getChild(0).getCharacters() == "kept" );
+
+  // the elements inside a rejected one are never looked at
+  fail_unless( filter.mCalls == 5 );
+  fail_unless( !stream.isError() );
+
+  stream.setElementFilter(NULL);
+  fail_unless( stream.getElementFilter() == NULL );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_elementFilter_large)
+{
+  string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<doc>";
+
+  for (unsigned int n = 0; n < 5000; ++n)
+  {
+    xml += "<math xmlns=\"http://www.w3.org/1998/Math/MathML\"><apply>"
+           "<plus/><ci>x</ci><cn>1</cn></apply></math><item/>";
+  }
+  xml += "</doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+  RejectFilter   filter("math");
+
+  stream.setElementFilter(&filter);
+  stream.next();
+
+  unsigned int items = 0;
+
+  while ( stream.isGood() && stream.peek().isStart() )
+  {
+    const XMLToken& token = stream.nextView();
+    fail_unless( token.getName() == "item" );
+    ++items;
+  }
+
+  fail_unless( items == 5000 );
+  fail_unless( filter.mCalls == 10001 );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_determineNumberChildren)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<math xmlns=\"http://www.w3.org/1998/Math/MathML\">\n"
+    "  <apply>\n"
+    "    <plus/>\n"
+    "    <ci> x </ci>\n"
+    "    <apply> <times/> <cn> 2 </cn> <ci> y </ci> </apply>\n"
+    "    <cn> 1 </cn>\n"
+    "  </apply>\n"
+    "  <piecewise>\n"
+    "    <piece> <cn> 1 </cn> <true/> </piece>\n"
+    "    <piece> <cn> 2 </cn> <false/> </piece>\n"
+    "    <otherwise> <cn> 3 </cn> </otherwise>\n"
+    "  </piecewise>\n"
+    "</math>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  stream.next();
+  stream.skipText();
+
+  fail_unless( stream.determineNumberChildren("math") == 2 );
+
+  stream.next();
+  stream.skipText();
+
+  // the function (plus) is not counted
+  fail_unless( stream.determineNumberChildren() == 3 );
+  fail_unless( stream.determineNumSpecificChildren("ci", "apply") == 1 );
+  fail_unless( stream.determineNumSpecificChildren("", "apply") == 4 );
+  fail_unless( stream.containsChild("times", "apply") );
+  fail_unless( !stream.containsChild("piece", "apply") );
+
+  // nothing has been consumed by the queries
+  fail_unless( stream.peek().getName() == "plus" );
+
+  // an apply named explicitly has its function checked, but counted
+  fail_unless( stream.determineNumberChildren("apply") == 4 );
+
+  // only the children not read yet are counted
+  stream.next();
+  stream.skipText();
+  fail_unless( stream.determineNumberChildren("apply") == 3 );
+  fail_unless( stream.determineNumberChildren() == 2 );
+
+  // a nested apply cannot be the function
+  stream.next();
+  stream.next();
+  stream.next();
+  stream.skipText();
+  fail_unless( stream.peek().getName() == "apply" );
+  fail_unless( stream.determineNumberChildren("apply") == 0 );
+  fail_unless( stream.determineNumberChildren() == 0 );
+
+  while ( stream.isGood() && stream.peek().getName() != "piecewise" )
+    stream.next();
+
+  stream.next();
+
+  fail_unless( stream.determineNumSpecificChildren("piece", "piecewise") == 2 );
+  fail_unless( stream.determineNumSpecificChildren("otherwise", "piecewise")
+               == 1 );
+  fail_unless( stream.determineNumberChildren("piecewise") == 3 );
+  fail_unless( stream.containsChild("true", "piecewise") );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_determineNumberChildren_large)
+{
+  string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<list>";
+
+  for (unsigned int n = 0; n < 20000; ++n)
+  {
+    xml += "<item><list><item/></list></item>";
+  }
+  xml += "<other/></list>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+  stream.next();
+
+  fail_unless( stream.determineNumberChildren("list") == 20001 );
+  fail_unless( stream.determineNumSpecificChildren("item", "list") == 20000 );
+  fail_unless( stream.containsChild("other", "list") );
+
+  // the children of the first item are counted once it is being read
+  stream.next();
+  fail_unless( stream.determineNumberChildren("item") == 1 );
+  stream.next();
+  fail_unless( stream.determineNumberChildren("list") == 1 );
+}
+END_TEST
+
+
+/*
+ * Reads the remaining tokens up to the end of the current element and
+ * returns their names and text, e.g. "a(1)[x]/a".
+ */
+static string
+readContent (XMLInputStream& stream)
+{
+  string       out;
+  unsigned int depth = 0;
+
+  while ( stream.isGood() )
+  {
+    const XMLToken& token = stream.nextView();
+
+    if (token.isText())
+    {
+      out += "[" + token.getCharacters() + "]";
+    }
+    else if (token.isStart())
+    {
+      out += token.getName();
+      if (token.getAttributes().getLength() > 0)
+        out += "(" + token.getAttrValue(0) + ")";
+      if (token.isEnd()) out += "/";
+      else ++depth;
+    }
+    else if (token.isEnd())
+    {
+      if (depth == 0) break;
+      --depth;
+      out += "/" + token.getName();
+    }
+  }
+
+  return out;
+}
+
+
+START_TEST (test_XMLInputStream_markRewind)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<doc><list xmlns:p=\"urn:p\">"
+    "<a id=\"1\">x</a><p:b id=\"2\"/><a id=\"3\"><c/></a>"
+    "</list><tail/></doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  fail_unless( !stream.isMarked() );
+  fail_unless( stream.rewind() == LIBLX_INVALID_XML_OPERATION );
+
+  stream.next();
+  XMLToken list = stream.next();
+
+  fail_unless( stream.mark() == LIBLX_OPERATION_SUCCESS );
+  fail_unless( stream.isMarked() );
+
+  const string first = readContent(stream);
+  fail_unless( first == "a(1)[x]/ab(2)/a(3)c//a" );
+
+  fail_unless( stream.rewind() == LIBLX_OPERATION_SUCCESS );
+
+  // the replayed tokens carry everything the parsed ones did
+  const XMLToken& a = stream.peek();
+  fail_unless( a.getName() == "a" && a.isStart() );
+  fail_unless( a.getAttrValue("id") == "1" );
+
+  stream.next();
+  stream.next();
+  stream.next();
+
+  const XMLToken b = stream.next();
+  fail_unless( b.getPrefix() == "p" );
+  fail_unless( b.getURI() == "urn:p" );
+  fail_unless( b.isStart() && b.isEnd() );
+
+  fail_unless( stream.rewind() == LIBLX_OPERATION_SUCCESS );
+  fail_unless( readContent(stream) == first );
+
+  // skipping a replayed subtree
+  fail_unless( stream.rewind() == LIBLX_OPERATION_SUCCESS );
+  stream.skipPastEnd(list);
+  fail_unless( stream.peek().getName() == "tail" );
+
+  fail_unless( stream.unmark() == LIBLX_OPERATION_SUCCESS );
+  fail_unless( !stream.isMarked() );
+  fail_unless( stream.rewind() == LIBLX_INVALID_XML_OPERATION );
+
+  fail_unless( stream.next().getName() == "tail" );
+  fail_unless( stream.next().getName() == "doc" );
+  fail_unless( stream.peek().isEOF() );
+  fail_unless( !stream.isError() );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_markRewind_unmark)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<doc><a/><b/><c/><d/></doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  stream.next();
+  stream.mark();
+  stream.next();
+  stream.next();
+  stream.rewind();
+
+  // the rewound tokens are still read after unmark()
+  stream.unmark();
+  fail_unless( stream.next().getName() == "a" );
+
+  // a mark set while replaying keeps the rest of the tape
+  stream.mark();
+  fail_unless( stream.next().getName() == "b" );
+  fail_unless( stream.next().getName() == "c" );
+  stream.rewind();
+  fail_unless( stream.next().getName() == "b" );
+  fail_unless( stream.next().getName() == "c" );
+  fail_unless( stream.next().getName() == "d" );
+  stream.rewind();
+  fail_unless( readContent(stream) == "b/c/d/" );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_markRewind_queries)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<doc><a><x/><x/><y><x/></y></a><tail/></doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  stream.next();
+  stream.mark();
+  stream.skipPastEnd(stream.next());
+  fail_unless( stream.peek().getName() == "tail" );
+
+  // sizing a replayed element answers about it, not the live position
+  stream.rewind();
+  fail_unless( stream.next().getName() == "a" );
+  fail_unless( stream.determineNumberChildren("a") == 3 );
+  fail_unless( stream.determineNumSpecificChildren("x", "a") == 2 );
+  fail_unless( stream.containsChild("x", "a") );
+  fail_unless( !stream.containsChild("z", "a") );
+  fail_unless( readContent(stream) == "x/x/yx//y" );
+  fail_unless( stream.peek().getName() == "tail" );
+
+  stream.rewind();
+  stream.next();
+  stream.next();
+  stream.next();
+  fail_unless( stream.next().getName() == "y" );
+  fail_unless( stream.determineNumberChildren("y") == 1 );
+
+  // an element only partly on the tape is read on for the answer
+  XMLInputStream partial(xml.c_str(), false, "");
+
+  partial.next();
+  partial.mark();
+  partial.next();
+  partial.next();
+  partial.rewind();
+  fail_unless( partial.next().getName() == "a" );
+  fail_unless( partial.determineNumberChildren("a") == 3 );
+  fail_unless( partial.determineNumSpecificChildren("x", "a") == 2 );
+
+  partial.unmark();
+  fail_unless( readContent(partial) == "x/x/yx//y" );
+  fail_unless( partial.next().getName() == "tail" );
+  fail_unless( partial.next().getName() == "doc" );
+  fail_unless( partial.peek().isEOF() );
+  fail_unless( !partial.isError() );
+}
+END_TEST
+
+
+/*
+ * Stops at the first element with the given name.
+ */
+class StopAt : public XMLStopCondition
+{
+public:
+  StopAt (const string& name) : mName(name), mDeepest(0) {}
+
+  virtual bool stop (const XMLToken& element, unsigned int depth)
+  {
+    if (depth > mDeepest) mDeepest = depth;
+    return element.getName() == mName;
+  }
+
+  string       mName;
+  unsigned int mDeepest;
+};
+
+
+START_TEST (test_XMLInputStream_readLimit_header)
+{
+  string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               "<model xmlns=\"urn:m\" xmlns:p=\"urn:p\" id=\"m1\" "
+               "p:level=\"3\">\n  <list>";
+  const size_t first = xml.size() - 6;
+
+  for (unsigned int n = 0; n < 20000; ++n)
+  {
+    xml += "<item id=\"i\">text</item>";
+  }
+
+  // everything after the header is never parsed, so this is not an error
+  xml += "</model>< broken";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  fail_unless( stream.setReadLimit(1) == LIBLX_OPERATION_SUCCESS );
+
+  XMLToken model = stream.next();
+
+  fail_unless( model.getName() == "model" );
+  fail_unless( model.getAttrValue("id") == "m1" );
+  fail_unless( model.getAttrValue("level", "urn:p") == "3" );
+  fail_unless( model.getNamespaces().getLength() == 2 );
+
+  fail_unless( stream.next().isText() );
+  fail_unless( stream.peek().isEOF() );
+  fail_unless( stream.isEOF() );
+  fail_unless( !stream.isError() );
+
+  // reading stopped at <list>
+  fail_unless( stream.getByteOffset() >= first );
+  fail_unless( stream.getByteOffset() <= first + 6 );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_readLimit_elements)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<doc><a><b/><c/></a><d/></doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  stream.setReadLimit(0, 3);
+
+  fail_unless( stream.next().getName() == "doc" );
+  fail_unless( stream.next().getName() == "a" );
+
+  const XMLToken b = stream.next();
+  fail_unless( b.getName() == "b" && b.isEnd() );
+
+  fail_unless( stream.peek().isEOF() );
+  fail_unless( !stream.isError() );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_stopCondition)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<doc><info><title>t</title></info><body><x/></body></doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+  StopAt         condition("body");
+
+  stream.setStopCondition(&condition);
+  fail_unless( stream.getStopCondition() == &condition );
+
+  XMLNode doc(stream);
+
+  fail_unless( doc.getName() == "doc" );
+  fail_unless( doc.getNumChildren() == 1 );
+  fail_unless( doc.getChild(0).getName() == "info" );
+  fail_unless( doc.getChild(0).getChild(0).getChild(0).getCharacters() == "t" );
+  fail_unless( condition.mDeepest == 3 );
+  fail_unless( stream.isEOF() );
+
+  stream.setStopCondition(NULL);
+  fail_unless( stream.getStopCondition() == NULL );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_close)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<doc><a/><b/><c/></doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  fail_unless( stream.next().getName() == "doc" );
+  stream.mark();
+  fail_unless( stream.next().getName() == "a" );
+
+  fail_unless( stream.close() == LIBLX_OPERATION_SUCCESS );
+  fail_unless( stream.peek().isEOF() );
+  fail_unless( !stream.isError() );
+
+  // the recorded tokens are still there
+  stream.rewind();
+  fail_unless( stream.next().getName() == "a" );
+  fail_unless( stream.peek().isEOF() );
+  fail_unless( stream.getByteOffset() == xml.size() );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_trackPositions)
+{
+  string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               "<doc>\n";
+
+  for (unsigned int n = 0; n < 5000; ++n)
+  {
+    xml += "  <item id=\"i\">text</item>\n";
+  }
+
+  xml += "  <last/>\n</doc>\n";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  fail_unless( stream.getTrackPositions() );
+  fail_unless( stream.setTrackPositions(false) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( !stream.getTrackPositions() );
+
+  const XMLToken doc = stream.next();
+  fail_unless( doc.getLine() == 0 && doc.getColumn() == 0 );
+  fail_unless( doc.getOffset() > 0 );
+
+  fail_unless( stream.setTrackPositions(true) == LIBLX_INVALID_XML_OPERATION );
+
+  XMLToken last;
+  while ( stream.isGood() )
+  {
+    const XMLToken& token = stream.nextView();
+    if (token.isStart() && token.getName() == "last") last = token;
+  }
+
+  fail_unless( !stream.isError() );
+  fail_unless( last.getName() == "last" );
+  fail_unless( last.getOffset() > 5000 * 27 );
+
+  unsigned int line   = 0;
+  unsigned int column = 0;
+
+  fail_unless( stream.getPosition(doc, line, column)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( line == 2 );
+
+  fail_unless( stream.getPosition(last, line, column)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( line == 5003 );
+  fail_unless( column >= 3 && column <= 9 );
+
+  // text read again after rewind() keeps its offset
+  XMLInputStream replay(xml.c_str(), false, "");
+  replay.setTrackPositions(false);
+  replay.next();
+  replay.mark();
+
+  XMLToken text = replay.next();
+  while (!text.isText() || text.isWhitespace()) text = replay.next();
+  fail_unless( text.getCharacters() == "text" );
+  fail_unless( text.getOffset() > 0 );
+
+  fail_unless( replay.rewind() == LIBLX_OPERATION_SUCCESS );
+
+  XMLToken again = replay.next();
+  while (!again.isText() || again.isWhitespace()) again = replay.next();
+  fail_unless( again.getOffset() == text.getOffset() );
+  fail_unless( replay.getPosition(again, line, column)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( line == 3 );
+
+  // tokens with a line number are passed through
+  XMLToken tracked(XMLTriple("x", "", ""), XMLAttributes(), 7, 4);
+  fail_unless( stream.getPosition(tracked, line, column)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( line == 7 && column == 4 );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_isWhitespace)
+{
+  const string blank = " \t\r\n  \n\n\t\t    \r\n   ";
+
+  fail_unless( XMLToken(blank).isWhitespace() );
+  fail_unless( XMLToken("").isWhitespace() );
+  fail_unless( !XMLToken(XMLTriple("a", "", ""), XMLAttributes()).isWhitespace() );
+
+  // a single other character anywhere makes the text count
+  for (size_t n = 0; n < blank.size(); ++n)
+  {
+    string text = blank;
+    text[n] = (n % 2) ? 'x' : '\v';
+    fail_unless( !XMLToken(text).isWhitespace() );
+  }
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_ignoreWhitespace)
+{
+  string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               "<doc>\n  <a>  some text\n  </a>\n\n"
+               "  <b>\n\n\n\t\t</b>\n";
+
+  for (unsigned int n = 0; n < 1000; ++n)
+  {
+    xml += "  <c>\n    <d/>\n  </c>\n";
+  }
+
+  xml += "</doc>\n";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+
+  fail_unless( !stream.getIgnoreWhitespace() );
+  fail_unless( stream.setIgnoreWhitespace(true) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( stream.getIgnoreWhitespace() );
+
+  stream.setCharacterChunkSize(4);
+
+  fail_unless( stream.next().getName() == "doc" );
+  fail_unless( stream.next().getName() == "a" );
+
+  // text with content is kept whole, in chunks
+  string text;
+  while ( stream.peek().isText() ) text += stream.next().getCharacters();
+
+  fail_unless( text == "  some text\n  " );
+  fail_unless( stream.next().isEnd() );
+
+  const XMLToken b = stream.next();
+  fail_unless( b.getName() == "b" && !b.isEnd() );
+  fail_unless( stream.next().isEnd() );
+
+  unsigned int tokens = 0;
+  while ( stream.isGood() )
+  {
+    const XMLToken& token = stream.nextView();
+    if (token.isEOF()) break;
+
+    fail_unless( !token.isText() );
+    ++tokens;
+  }
+
+  fail_unless( tokens == 1000 * 3 + 1 );
+  fail_unless( !stream.isError() );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_ignoreWhitespace_XMLNode)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<doc>\n  <a> x </a>\n  <b/>\n</doc>\n";
+
+  XMLInputStream plain(xml.c_str(), false, "");
+  XMLInputStream dropping(xml.c_str(), false, "");
+
+  dropping.setIgnoreWhitespace(true);
+
+  const XMLNode first(plain);
+  const XMLNode second(dropping);
+
+  fail_unless( first.getNumChildren() == 2 );
+  fail_unless( second.getNumChildren() == 2 );
+  fail_unless( second.getChild(0).getChild(0).getCharacters() == " x " );
+  fail_unless( first.toXMLString() == second.toXMLString() );
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_namespaceScope)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<doc xmlns=\"urn:d\" xmlns:a=\"urn:a\">"
+    "<plain><inner xmlns:a=\"urn:a2\" xmlns:b=\"urn:b\"><leaf/></inner>"
+    "<skipped xmlns:c=\"urn:c\"><x/></skipped>"
+    "<after/></plain></doc>";
+
+  XMLNode* first = NULL;
+  XMLToken inner;
+
+  {
+    XMLInputStream stream(xml.c_str(), false, "");
+
+    const XMLToken doc = stream.next();
+    const XMLNamespaceScope* outer = doc.getNamespaceScope();
+
+    fail_unless( outer != NULL );
+    fail_unless( outer->getParent() == NULL );
+    fail_unless( outer->getURI() == "urn:d" );
+    fail_unless( outer->getURI("a") == "urn:a" );
+    fail_unless( !outer->hasPrefix("b") );
+
+    // elements that declare nothing share the enclosing frame
+    const XMLToken plain = stream.next();
+    fail_unless( plain.getNamespaceScope() == outer );
+
+    inner = stream.next();
+    const XMLNamespaceScope* scope = inner.getNamespaceScope();
+
+    fail_unless( scope->getParent() == outer );
+    fail_unless( scope->getDeclarations().getLength() == 2 );
+    fail_unless( scope->getURI("a") == "urn:a2" );
+    fail_unless( scope->getURI("b") == "urn:b" );
+    fail_unless( scope->getURI("") == "urn:d" );
+    fail_unless( scope->getURI("c") == "" );
+
+    const XMLNamespaces all = scope->getNamespacesInScope();
+    fail_unless( all.getLength() == 3 );
+    fail_unless( all.getURI("a") == "urn:a2" );
+
+    fail_unless( stream.next().getNamespaceScope() == scope );
+
+    const XMLToken innerEnd = stream.next();
+    fail_unless( innerEnd.isEnd() && innerEnd.getName() == "inner" );
+    fail_unless( innerEnd.getNamespaceScope() == scope );
+
+    // skipping a subtree leaves the scope stack in order
+    const XMLToken skipped = stream.next();
+    fail_unless( skipped.getNamespaceScope()->hasPrefix("c") );
+    stream.skipPastEnd(skipped);
+
+    const XMLToken after = stream.next();
+    fail_unless( after.getName() == "after" );
+    fail_unless( after.getNamespaceScope() == outer );
+
+    const XMLToken plainEnd = stream.next();
+    fail_unless( plainEnd.getNamespaceScope() == outer );
+
+    first = new XMLNode(doc);
+  }
+
+  // frames outlive the stream that made them
+  fail_unless( inner.getNamespaceScope()->getURI("a") == "urn:a2" );
+  fail_unless( first->getNamespaceScope()->getURI("a") == "urn:a" );
+
+  XMLToken copy(inner);
+  fail_unless( copy.getNamespaceScope() == inner.getNamespaceScope() );
+
+  inner = XMLToken();
+  fail_unless( inner.getNamespaceScope() == NULL );
+  fail_unless( copy.getNamespaceScope()->getURI("b") == "urn:b" );
+
+  delete first;
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_namespaceScope_XMLNode)
+{
+  const string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<doc xmlns:p=\"urn:p\"><a><p:b/></a></doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+  stream.mark();
+
+  const XMLNode doc(stream);
+  const XMLNode& b = doc.getChild(0).getChild(0);
+
+  fail_unless( b.getNamespaceScope()->getURI(b.getPrefix()) == "urn:p" );
+
+  // replayed tokens keep their scope
+  stream.rewind();
+  stream.next();
+  stream.next();
+  fail_unless( stream.next().getNamespaceScope()->getURI("p") == "urn:p" );
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLInputStream_streaming (void)
+{
+  Suite *suite = suite_create("XMLInputStream_streaming");
+  TCase *tcase = tcase_create("XMLInputStream_streaming");
+
+  tcase_add_test( tcase, test_XMLInputStream_chunkSize_default  );
+  tcase_add_test( tcase, test_XMLInputStream_chunkSize_pull  );
+  tcase_add_test( tcase, test_XMLInputStream_chunkSize_utf8  );
+  tcase_add_test( tcase, test_XMLInputStream_readCharacters  );
+  tcase_add_test( tcase, test_XMLInputStream_chunkSize_XMLNode  );
+  tcase_add_test( tcase, test_XMLInputStream_skipPastEnd_nested  );
+  tcase_add_test( tcase, test_XMLInputStream_skipPastEnd_peeked  );
+  tcase_add_test( tcase, test_XMLInputStream_skipPastEnd_outer  );
+  tcase_add_test( tcase, test_XMLInputStream_skipPastEnd_large  );
+  tcase_add_test( tcase, test_XMLInputStream_elementFilter  );
+  tcase_add_test( tcase, test_XMLInputStream_elementFilter_large  );
+  tcase_add_test( tcase, test_XMLInputStream_determineNumberChildren  );
+  tcase_add_test( tcase, test_XMLInputStream_determineNumberChildren_large  );
+  tcase_add_test( tcase, test_XMLInputStream_markRewind  );
+  tcase_add_test( tcase, test_XMLInputStream_markRewind_unmark  );
+  tcase_add_test( tcase, test_XMLInputStream_markRewind_queries );
+  tcase_add_test( tcase, test_XMLInputStream_readLimit_header  );
+  tcase_add_test( tcase, test_XMLInputStream_readLimit_elements  );
+  tcase_add_test( tcase, test_XMLInputStream_stopCondition  );
+  tcase_add_test( tcase, test_XMLInputStream_close  );
+  tcase_add_test( tcase, test_XMLInputStream_trackPositions  );
+  tcase_add_test( tcase, test_XMLInputStream_isWhitespace  );
+  tcase_add_test( tcase, test_XMLInputStream_ignoreWhitespace  );
+  tcase_add_test( tcase, test_XMLInputStream_ignoreWhitespace_XMLNode  );
+  tcase_add_test( tcase, test_XMLInputStream_namespaceScope  );
+  tcase_add_test( tcase, test_XMLInputStream_namespaceScope_XMLNode  );
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
@@ -541,6 +541,43 @@ START_TEST (test_XMLNamespaces_accessWithNULL)
 }
 END_TEST
 
+START_TEST (test_XMLNamespaces_wide)
+{
+  char uri[32];
+  char prefix[16];
+  int  i;
+
+  for (i = 0; i < 40; ++i)
+  {
+    sprintf(uri, "http://test%d.org/", i);
+    sprintf(prefix, "test%d", i);
+    XMLNamespaces_add(NS, uri, prefix);
+  }
+
+  XMLNamespaces_add(NS, "http://test7.org/", "");
+  fail_unless( XMLNamespaces_getLength(NS) == 41 );
+
+  for (i = 0; i < 40; ++i)
+  {
+    sprintf(uri, "http://test%d.org/", i);
+    sprintf(prefix, "test%d", i);
+    fail_unless( XMLNamespaces_getIndex(NS, uri) == i );
+    fail_unless( XMLNamespaces_getIndexByPrefix(NS, prefix) == i );
+  }
+
+  fail_unless( XMLNamespaces_getIndexByPrefix(NS, "") == 40 );
+  fail_unless( XMLNamespaces_getIndex(NS, "http://missing.org/") == -1 );
+
+  XMLNamespaces_add(NS, "http://other.org/", "test3");
+  fail_unless( XMLNamespaces_getLength(NS) == 41 );
+  fail_unless( XMLNamespaces_getIndexByPrefix(NS, "test3") == 40 );
+  fail_unless( XMLNamespaces_getIndexByPrefix(NS, "test4") == 3 );
+  fail_unless( XMLNamespaces_getIndex(NS, "http://test7.org/") == 6 );
+  fail_unless( XMLNamespaces_getIndex(NS, "http://test3.org/") == -1 );
+}
+END_TEST
+
+
 Suite *
 create_suite_XMLNamespaces (void)
 {
@@ -561,6 +598,7 @@ create_suite_XMLNamespaces (void)
   tcase_add_test( tcase, test_XMLNamespaces_remove1          );
   tcase_add_test( tcase, test_XMLNamespaces_clear            );
   tcase_add_test( tcase, test_XMLNamespaces_accessWithNULL   );
+  tcase_add_test( tcase, test_XMLNamespaces_wide             );
   
   suite_add_tcase(suite, tcase);
 
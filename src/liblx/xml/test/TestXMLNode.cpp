@@ -39,6 +39,15 @@
 #include <liblx/xml/XMLToken.h>
 #include <liblx/xml/XMLNode.h>
 #include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLIdIndex.h>
+#include <liblx/xml/XMLNameIndex.h>
+#include <liblx/xml/XMLNodeIterator.h>
+#include <liblx/xml/XMLNodeParallel.h>
+#include <liblx/xml/XMLThreads.h>
+#include <liblx/xml/operationReturnValues.h>
+
+#include <algorithm>
+#include <vector>
 
 #include <check.h>
 using namespace std;
@@ -1616,6 +1625,556 @@ START_TEST(test_XMLNode_attribute_set_clear)
 }
 END_TEST
 
+START_TEST (test_XMLNode_parentLinks)
+{
+  XMLNode* root = XMLNode::convertStringToXMLNode("<a><b/><c/><d/></a>");
+  fail_unless( root != NULL );
+  fail_unless( root->getParent() == NULL );
+
+  XMLNode& b = root->getChild(0);
+  XMLNode& c = root->getChild(1);
+  XMLNode& d = root->getChild(2);
+
+  fail_unless( b.getParent() == root );
+  fail_unless( c.getIndexInParent() == 1 );
+  fail_unless( b.getPreviousSibling() == NULL );
+  fail_unless( b.getNextSibling() == &c );
+  fail_unless( d.getPreviousSibling() == &c );
+  fail_unless( d.getNextSibling() == NULL );
+
+  XMLNode& e = root->insertChild(1, XMLNode(XMLTriple("e", "", ""), XMLAttributes()));
+  fail_unless( e.getParent() == root );
+  fail_unless( e.getIndexInParent() == 1 );
+  fail_unless( b.getNextSibling() == &e );
+  fail_unless( c.getIndexInParent() == 2 );
+  fail_unless( d.getIndexInParent() == 3 );
+
+  XMLNode* removed = root->removeChild(0);
+  fail_unless( removed == &b );
+  fail_unless( removed->getParent() == NULL );
+  fail_unless( removed->getNextSibling() == NULL );
+  fail_unless( e.getIndexInParent() == 0 );
+  fail_unless( e.getPreviousSibling() == NULL );
+  fail_unless( d.getPreviousSibling() == &c );
+  delete removed;
+
+  e.addChild(XMLNode("text"));
+  fail_unless( e.getChild(0).getParent() == &e );
+  fail_unless( XMLNode_getParent(&e.getChild(0)) == &e );
+  fail_unless( XMLNode_getNextSibling(&e) == &c );
+  fail_unless( XMLNode_getPreviousSibling(&c) == &e );
+
+  XMLNode copy(*root);
+  fail_unless( copy.getParent() == NULL );
+  fail_unless( copy.getChild(0).getParent() == &copy );
+  fail_unless( copy.getChild(0).getChild(0).getParent() == &copy.getChild(0) );
+  fail_unless( copy.getChild(2).getPreviousSibling() == &copy.getChild(1) );
+
+  copy.getChild(1) = *root;
+  fail_unless( copy.getChild(1).getParent() == &copy );
+  fail_unless( copy.getChild(1).getIndexInParent() == 1 );
+  fail_unless( copy.getChild(1).getChild(0).getParent() == &copy.getChild(1) );
+
+  delete root;
+}
+END_TEST
+
+
+START_TEST (test_XMLNode_childNameIndex)
+{
+  XMLNode root(XMLTriple("root", "", ""), XMLAttributes());
+  XMLAttributes attr;
+
+  for (unsigned int i = 0; i < 3 * XMLNameIndex::Threshold; ++i)
+  {
+    root.addChild(XMLNode(XMLTriple((i % 3) ? "b" : "a", "", ""), attr));
+  }
+
+  unsigned int count = 0;
+  int last = -1;
+  for (int i = root.getIndex("a"); i != -1; i = root.getNextIndex(i))
+  {
+    fail_unless( i % 3 == 0 );
+    fail_unless( i > last );
+    last = i;
+    ++count;
+  }
+  fail_unless( count == XMLNameIndex::Threshold );
+  fail_unless( root.getIndex("b") == 1 );
+  fail_unless( root.getNextIndex(1) == 2 );
+  fail_unless( root.getNextIndex(2) == 4 );
+  fail_unless( root.hasChild("c") == false );
+
+  root.addChild(XMLNode(XMLTriple("c", "", ""), attr));
+  fail_unless( root.getIndex("c") == (int)(3 * XMLNameIndex::Threshold) );
+  fail_unless( root.getNextIndex(last) == -1 );
+
+  root.insertChild(0, XMLNode(XMLTriple("c", "", ""), attr));
+  fail_unless( root.getIndex("c") == 0 );
+  fail_unless( root.getIndex("a") == 1 );
+  fail_unless( root.getNextIndex(0) == (int)(3 * XMLNameIndex::Threshold) + 1 );
+
+  delete root.removeChild(0);
+  fail_unless( root.getIndex("a") == 0 );
+
+  root.getChild(3).setTriple(XMLTriple("d", "", ""));
+  fail_unless( root.getIndex("d") == 3 );
+  fail_unless( root.getNextIndex(0) == 6 );
+
+  root.getChild(6) = XMLNode(XMLTriple("e", "", ""), attr);
+  fail_unless( root.getIndex("e") == 6 );
+  fail_unless( root.getNextIndex(0) == 9 );
+
+  fail_unless( root.getChild("b").getIndexInParent() == 1 );
+  fail_unless( root.getNextIndex(root.getNumChildren()) == -1 );
+  fail_unless( XMLNode_getNextIndex(&root, 1) == 2 );
+
+  XMLToken& token = root.getChild(12);
+  token.setTriple(XMLTriple("d", "", ""));
+  fail_unless( root.getIndex("d") == 3 );
+  fail_unless( root.getNextIndex(3) == 12 );
+  fail_unless( root.getNextIndex(9) == 15 );
+
+  XMLTriple_t* triple = XMLTriple_createWith("a", "", "");
+  XMLToken_setTriple(&root.getChild(3), triple);
+  XMLTriple_free(triple);
+  fail_unless( root.getIndex("d") == 12 );
+  fail_unless( root.getNextIndex(0) == 3 );
+  fail_unless( root.getNextIndex(3) == 9 );
+
+  root.getChild(12).setTriple(XMLTriple("a", "", ""));
+  root.getChild(6).setTriple(XMLTriple("a", "", ""));
+  fail_unless( root.hasChild("d") == false );
+  fail_unless( root.hasChild("e") == false );
+
+  count = 0;
+  for (int i = root.getIndex("a"); i != -1; i = root.getNextIndex(i))
+  {
+    fail_unless( i % 3 == 0 );
+    fail_unless( i == 3 * (int)count );
+    ++count;
+  }
+  fail_unless( count == XMLNameIndex::Threshold );
+
+  root.insertChild(4, XMLNode(XMLTriple("a", "", ""), attr));
+  fail_unless( root.getNextIndex(3) == 4 );
+  fail_unless( root.getNextIndex(4) == 7 );
+  fail_unless( root.getNextIndex(2) == 5 );
+  fail_unless( root.getIndex("c") == (int)(3 * XMLNameIndex::Threshold) + 1 );
+
+  delete root.removeChild(4);
+  fail_unless( root.getNextIndex(3) == 6 );
+  fail_unless( root.getNextIndex(2) == 4 );
+  fail_unless( root.getIndex("c") == (int)(3 * XMLNameIndex::Threshold) );
+}
+END_TEST
+
+
+START_TEST (test_XMLNode_idIndex)
+{
+  const char* xmlstr = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                       "<model id=\"m\">"
+                       "<species id=\"s1\"/>"
+                       "<species id=\"s2\" metaid=\"_s2\"><note id=\"n\"/></species>"
+                       "<reaction name=\"r\"/>"
+                       "</model>";
+
+  std::vector<std::string> ids;
+  ids.push_back("id");
+  ids.push_back("metaid");
+
+  XMLInputStream stream(xmlstr, false);
+  XMLNode root(stream, ids);
+
+  fail_unless( root.getIdIndex() != NULL );
+  fail_unless( root.getIdIndex()->getNumEntries() == 5 );
+  fail_unless( root.getNodeById("m") == &root );
+  fail_unless( root.getNodeById("s1") == &root.getChild(0) );
+  fail_unless( root.getNodeById("_s2") == &root.getChild(1) );
+  fail_unless( root.getChild(0).getNodeById("n") == &root.getChild(1).getChild(0) );
+  fail_unless( root.getNodeById("r") == NULL );
+
+  XMLNode* removed = root.removeChild(1);
+  fail_unless( root.getNodeById("s2") == NULL );
+  fail_unless( root.getNodeById("n") == NULL );
+  fail_unless( removed->getIdIndex() == NULL );
+  fail_unless( root.getIdIndex()->getNumEntries() == 2 );
+
+  root.getChild(1).addChild(*removed);
+  fail_unless( root.getNodeById("n") == &root.getChild(1).getChild(0).getChild(0) );
+  delete removed;
+
+  fail_unless( root.getChild(0).addIdAttribute("name") == LIBLX_INVALID_XML_OPERATION );
+  fail_unless( root.addIdAttribute("name") == LIBLX_OPERATION_SUCCESS );
+  fail_unless( root.getNodeById("r") == &root.getChild(1) );
+
+  XMLNode copy(root);
+  fail_unless( copy.getNodeById("s1") == &copy.getChild(0) );
+  fail_unless( copy.getNodeById("n") == &copy.getChild(1).getChild(0).getChild(0) );
+
+  root.getChild(0) = XMLNode(XMLTriple("species", "", ""), XMLAttributes());
+  fail_unless( root.getNodeById("s1") == NULL );
+
+  root.removeChildren();
+  fail_unless( root.getIdIndex()->getNumEntries() == 1 );
+  fail_unless( root.getNodeById("m") == &root );
+  fail_unless( copy.getNodeById("s2") != NULL );
+}
+END_TEST
+
+
+START_TEST (test_XMLNode_idIndex_changedAttributes)
+{
+  XMLNode root(XMLTriple("model", "", ""), XMLAttributes());
+  XMLAttributes attr;
+  attr.add("id", "a");
+
+  fail_unless( root.addIdAttribute("id") == LIBLX_OPERATION_SUCCESS );
+  root.addChild(XMLNode(XMLTriple("species", "", ""), attr));
+  fail_unless( root.getNodeById("a") == &root.getChild(0) );
+
+  root.getChild(0).addAttr("id", "b");
+  fail_unless( root.getNodeById("a") == NULL );
+  fail_unless( root.getNodeById("b") == &root.getChild(0) );
+  fail_unless( root.getIdIndex()->getNumEntries() == 1 );
+
+  delete root.removeChild(0);
+  fail_unless( root.getNodeById("a") == NULL );
+  fail_unless( root.getNodeById("b") == NULL );
+  fail_unless( root.getIdIndex()->getNumEntries() == 0 );
+
+  root.addChild(XMLNode(XMLTriple("species", "", ""), attr));
+  XMLAttributes other;
+  other.add("id", "c");
+  root.getChild(0).setAttributes(other);
+  fail_unless( root.getNodeById("c") == &root.getChild(0) );
+
+  XMLToken_removeAttrByName(&root.getChild(0), "id");
+  fail_unless( root.getNodeById("c") == NULL );
+  fail_unless( root.getIdIndex()->getNumEntries() == 0 );
+
+  delete root.removeChild(0);
+  fail_unless( root.getNodeById("c") == NULL );
+}
+END_TEST
+
+
+/*
+ * Returns the names of the nodes from it to the end, with their depths.
+ */
+static std::string
+walk (XMLNodeIterator it)
+{
+  std::string names;
+
+  for (; it != XMLNodeIterator(); ++it)
+  {
+    names += it->getName();
+    names += (char)('0' + it.getDepth());
+  }
+
+  return names;
+}
+
+
+START_TEST (test_XMLNode_iterator)
+{
+  const char* xmlstr = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                       "<a><b><d/><e/></b><c><f/></c></a>";
+
+  XMLInputStream stream(xmlstr, false);
+  XMLNode root(stream);
+  const XMLNode& b = root.getChild(0);
+  const XMLNode& c = root.getChild(1);
+
+  fail_unless( walk(XMLNodeIterator(root)) == "a0b1d2e2c1f2" );
+  fail_unless( walk(XMLNodeIterator(root, LIBLX_POST_ORDER)) == "d2e2b1f2c1a0" );
+  fail_unless( walk(XMLNodeIterator(b)) == "b0d1e1" );
+  fail_unless( walk(XMLNodeIterator(c, LIBLX_POST_ORDER)) == "f1c0" );
+  fail_unless( walk(XMLNodeIterator(c.getChild(0))) == "f0" );
+
+  XMLNodeIterator it(root);
+  ++it;
+  fail_unless( &*it == &b );
+  it.skipChildren();
+  fail_unless( (it++)->getName() == "b" );
+  fail_unless( &*it == &c );
+  it.skipChildren();
+  fail_unless( (++it).isEnd() );
+  fail_unless( it.getNode() == NULL );
+
+  XMLNodeRange range(root, LIBLX_POST_ORDER);
+  std::string  names;
+  for (XMLNodeRange::iterator node = range.begin(); node != range.end(); ++node)
+  {
+    names += node->getName();
+  }
+  fail_unless( names == "debfca" );
+
+  const XMLNode* nodes[4];
+  unsigned int   depths[4];
+
+  XMLNodeIterator_t* batch = XMLNodeIterator_create(&root, LIBLX_PRE_ORDER);
+  fail_unless( XMLNodeIterator_next(batch, nodes, depths, 4) == 4 );
+  fail_unless( nodes[3] == &b.getChild(1) && depths[3] == 2 );
+  fail_unless( !XMLNodeIterator_isEnd(batch) );
+  fail_unless( XMLNodeIterator_next(batch, nodes, NULL, 4) == 2 );
+  fail_unless( nodes[1] == &c.getChild(0) );
+  fail_unless( XMLNodeIterator_isEnd(batch) );
+  fail_unless( XMLNodeIterator_next(batch, nodes, depths, 4) == 0 );
+  XMLNodeIterator_free(batch);
+}
+END_TEST
+
+
+/*
+ * Records "+name" on entering and "-name" on leaving a node, skipping the
+ * children of skip and stopping on entering stop.
+ */
+class Recorder : public XMLNodeVisitor
+{
+public:
+
+  Recorder (const std::string& skip, const std::string& stop)
+    : mSkip(skip), mStop(stop) { }
+
+  virtual XMLNodeVisit_t enter (const XMLNode& node, unsigned int /*depth*/)
+  {
+    if (node.getName() == mStop) return LIBLX_VISIT_STOP;
+
+    mEvents += "+" + node.getName();
+    return (node.getName() == mSkip) ? LIBLX_VISIT_SKIP_CHILDREN
+                                     : LIBLX_VISIT_CONTINUE;
+  }
+
+  virtual bool leave (const XMLNode& node, unsigned int /*depth*/)
+  {
+    mEvents += "-" + node.getName();
+    return true;
+  }
+
+  std::string mSkip;
+  std::string mStop;
+  std::string mEvents;
+};
+
+
+START_TEST (test_XMLNode_visitor)
+{
+  const char* xmlstr = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                       "<a><b><d/><e/></b><c><f/></c></a>";
+
+  XMLInputStream stream(xmlstr, false);
+  XMLNode root(stream);
+
+  Recorder all("", "");
+  fail_unless( root.accept(all) );
+  fail_unless( all.mEvents == "+a+b+d-d+e-e-b+c+f-f-c-a" );
+
+  Recorder skip("b", "");
+  fail_unless( root.accept(skip) );
+  fail_unless( skip.mEvents == "+a+b-b+c+f-f-c-a" );
+
+  Recorder stop("", "e");
+  fail_unless( !root.accept(stop) );
+  fail_unless( stop.mEvents == "+a+b+d-d" );
+
+  Recorder subtree("", "");
+  fail_unless( root.getChild(1).accept(subtree) );
+  fail_unless( subtree.mEvents == "+c+f-f-c" );
+
+  XMLNode  deep(XMLTriple("n", "", ""), XMLAttributes());
+  XMLNode* node = &deep;
+  for (unsigned int n = 0; n < 2000; ++n)
+  {
+    node->addChild(XMLNode(XMLTriple("n", "", ""), XMLAttributes()));
+    node = &node->getChild(0);
+  }
+
+  Recorder chain("", "");
+  fail_unless( deep.accept(chain) );
+  fail_unless( chain.mEvents.size() == 2 * 2001 * 2 );
+
+  XMLNodeIterator last(deep, LIBLX_POST_ORDER);
+  fail_unless( &*last == node && last.getDepth() == 2000 );
+}
+END_TEST
+
+
+/*
+ * Counts the nodes it is called with, from any number of threads.
+ */
+class NodeCounter
+{
+public:
+
+  NodeCounter () : mCount(0) { }
+
+  void operator() (const XMLNode&) { XMLThreads::add(mCount, 1); }
+
+  volatile long mCount;
+};
+
+
+/*
+ * Collects the nodes it is called with.
+ */
+class NodeCollector
+{
+public:
+
+  void operator() (const XMLNode& node) { mNodes.push_back(&node); }
+
+  void join (const NodeCollector& other)
+  {
+    mNodes.insert(mNodes.end(), other.mNodes.begin(), other.mNodes.end());
+  }
+
+  std::vector<const XMLNode*> mNodes;
+};
+
+
+START_TEST (test_XMLNode_parallel)
+{
+  XMLNode root(XMLTriple("root", "", ""), XMLAttributes());
+
+  for (unsigned int i = 0; i < 40; ++i)
+  {
+    XMLNode child(XMLTriple("c", "", ""), XMLAttributes());
+    for (unsigned int j = 0; j < i; ++j)
+    {
+      XMLNode grandchild(XMLTriple("g", "", ""), XMLAttributes());
+      grandchild.addChild(XMLNode("text"));
+      child.addChild(grandchild);
+    }
+    root.addChild(child);
+  }
+
+  XMLNode* node = &root.getChild(7);
+  for (unsigned int n = 0; n < 500; ++n)
+  {
+    node->addChild(XMLNode(XMLTriple("n", "", ""), XMLAttributes()));
+    node = &node->getChild(node->getNumChildren() - 1);
+  }
+
+  std::vector<const XMLNode*> expected;
+  XMLNodeRange range(root);
+  for (XMLNodeRange::iterator it = range.begin(); it != range.end(); ++it)
+  {
+    expected.push_back(&*it);
+  }
+  std::sort(expected.begin(), expected.end());
+
+  unsigned int threads[] = { 1, 2, 3, 8, 0 };
+  for (unsigned int t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+  {
+    NodeCounter counter;
+    XMLNodeParallel::forEach(root, counter, threads[t]);
+    fail_unless( counter.mCount == (long)expected.size() );
+
+    NodeCollector collector;
+    XMLNodeParallel::reduce(root, collector, threads[t]);
+    std::sort(collector.mNodes.begin(), collector.mNodes.end());
+    fail_unless( collector.mNodes == expected );
+  }
+
+  NodeCollector leaf;
+  XMLNodeParallel::reduce(*node, leaf, 4);
+  fail_unless( leaf.mNodes.size() == 1 && leaf.mNodes[0] == node );
+}
+END_TEST
+
+
+/*
+ * Asks every node it is called with for its hash.
+ */
+class NodeHasher
+{
+public:
+
+  void operator() (const XMLNode& node) { node.getHash(); }
+};
+
+
+START_TEST (test_XMLNode_hash)
+{
+  const char* xml1 = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                     "<a xmlns=\"http://a\"><b x=\"1\" y=\"2\"><d/></b><c/></a>";
+  const char* xml2 = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                     "<a xmlns=\"http://a\"><b y=\"2\" x=\"1\"><d/></b><c/></a>";
+  const char* xml3 = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                     "<a xmlns=\"http://z\"><b x=\"1\" y=\"3\"><d/></b><c/></a>";
+
+  XMLInputStream stream1(xml1, false);
+  XMLInputStream stream2(xml2, false);
+  XMLInputStream stream3(xml3, false);
+  XMLNode root1(stream1);
+  XMLNode root2(stream2);
+  XMLNode root3(stream3);
+
+  fail_unless( root1.getHash() == root2.getHash() );
+  fail_unless( root1.equals(root2) );
+  fail_unless( root1.getHash() != root3.getHash() );
+  fail_unless( root1.getHash(true, false) != root3.getHash(true, false) );
+  fail_unless( root1.getHash(false, true) != root3.getHash(false, true) );
+  fail_unless( root1.getHash(true, true) == root3.getHash(true, true) );
+  fail_unless( !root1.equals(root3) );
+  fail_unless( root1.equals(root3, true, true) );
+
+  // changes anywhere below a node change its hash, and changing back
+  // restores it
+  size_t hash = root1.getHash();
+  XMLNode& b = root1.getChild(0);
+  b.addAttr("y", "3");
+  fail_unless( root1.getHash() != hash );
+  fail_unless( !root1.equals(root2) );
+  b.addAttr("y", "2");
+  fail_unless( root1.getHash() == hash );
+
+  b.getChild(0).setTriple(XMLTriple("e", "http://a", ""));
+  fail_unless( root1.getHash() != hash );
+  b.getChild(0).setTriple(XMLTriple("d", "http://a", ""));
+  fail_unless( root1.getHash() == hash );
+
+  delete b.removeChild(0);
+  fail_unless( root1.getHash() != hash );
+  b.addChild(XMLNode(XMLTriple("d", "http://a", ""), XMLAttributes()));
+  fail_unless( root1.getHash() == hash );
+
+  root1.getChild(1) = XMLNode(XMLTriple("f", "http://a", ""), XMLAttributes());
+  fail_unless( root1.getHash() != hash );
+  root1.getChild(1) = root2.getChild(1);
+  fail_unless( root1.getHash() == hash );
+
+  XMLNode copy(root1);
+  fail_unless( copy.getHash() == hash );
+  copy.getChild(1).addAttr("z", "1");
+  fail_unless( copy.getHash() != hash );
+  fail_unless( root1.getHash() == hash );
+  fail_unless( XMLNode_getHash(&root2) == hash );
+
+  // hashes may be asked for from several threads at once
+  b.addAttr("w", "1");
+  NodeHasher hasher;
+  XMLNodeParallel::forEach(root1, hasher, 4);
+  fail_unless( root1.getHash() != hash );
+
+  // equals() matches attributes by local name only
+  XMLAttributes twice;
+  twice.add("id", "1", "http://x", "x");
+  twice.add("id", "1");
+  XMLAttributes once;
+  once.add("id", "1");
+  once.add("k", "2");
+  XMLNode dup(XMLTriple("a", "http://x", ""), twice);
+  XMLNode other(XMLTriple("a", "http://x", ""), once);
+  dup.getHash();
+  other.getHash();
+  fail_unless( dup.equals(other) );
+}
+END_TEST
+
+
 //
 //START_TEST(test_XMLInputStream_assignment)
 //{
@@ -1660,6 +2219,14 @@ create_suite_XMLNode (void)
   tcase_add_test( tcase, test_XMLNode_namespace_set_clear );
   tcase_add_test( tcase, test_XMLNode_attribute_add_remove);
   tcase_add_test( tcase, test_XMLNode_attribute_set_clear);
+  tcase_add_test( tcase, test_XMLNode_parentLinks);
+  tcase_add_test( tcase, test_XMLNode_childNameIndex);
+  tcase_add_test( tcase, test_XMLNode_idIndex);
+  tcase_add_test( tcase, test_XMLNode_idIndex_changedAttributes);
+  tcase_add_test( tcase, test_XMLNode_iterator);
+  tcase_add_test( tcase, test_XMLNode_visitor);
+  tcase_add_test( tcase, test_XMLNode_parallel);
+  tcase_add_test( tcase, test_XMLNode_hash);
   suite_add_tcase(suite, tcase);
 
   return suite;
@@ -0,0 +1,288 @@
+/**
+ * @file    TestXMLNodeDiff.cpp
+ * @brief   XMLNodeDiff unit tests
+ *
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/operationReturnValues.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLNodeDiff.h>
+
+#include <check.h>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+/** @endcond */
+
+
+CK_CPPSTART
+
+
+/*
+ * Parses the document body, which must have a single root element.
+ */
+static XMLNode*
+parse (const string& body)
+{
+  string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" + body;
+  XMLInputStream stream(xml.c_str(), false);
+  return new XMLNode(stream);
+}
+
+
+/*
+ * Diffs from against to, applies the edits to a copy of from, and
+ * returns the number of edits, or -1 if the copy does not come out the
+ * same as to.
+ */
+static int
+roundTrip (const string& from, const string& to)
+{
+  XMLNode* source = parse(from);
+  XMLNode* target = parse(to);
+
+  XMLNodeDiff diff(*source, *target);
+  XMLNode     copy(*source);
+
+  int result = (int)diff.getNumEdits();
+  if (diff.apply(copy) != LIBLX_OPERATION_SUCCESS
+      || copy.toXMLString() != target->toXMLString()
+      || !copy.equals(*target))
+  {
+    result = -1;
+  }
+
+  delete source;
+  delete target;
+  return result;
+}
+
+
+START_TEST (test_XMLNodeDiff_roundTrip)
+{
+  const string doc =
+    "<doc xmlns=\"http://a\" xmlns:b=\"http://b\">"
+    "<list id=\"l1\"><item id=\"i1\" kind=\"x\"/><item id=\"i2\"/>"
+    "<b:item id=\"i3\">text</b:item></list>"
+    "<other id=\"o1\"><item id=\"i4\"/></other>"
+    "</doc>";
+
+  fail_unless( roundTrip(doc, doc) == 0 );
+
+  // attributes changed, removed and added
+  fail_unless( roundTrip(doc,
+    "<doc xmlns=\"http://a\" xmlns:b=\"http://b\">"
+    "<list id=\"l1\"><item id=\"i1\" kind=\"y\"/><item id=\"i2\" new=\"1\"/>"
+    "<b:item>text</b:item></list>"
+    "<other id=\"o1\"><item id=\"i4\"/></other>"
+    "</doc>") == 3 );
+
+  // attributes reordered
+  fail_unless( roundTrip(doc,
+    "<doc xmlns=\"http://a\" xmlns:b=\"http://b\">"
+    "<list id=\"l1\"><item kind=\"x\" id=\"i1\"/><item id=\"i2\"/>"
+    "<b:item id=\"i3\">text</b:item></list>"
+    "<other id=\"o1\"><item id=\"i4\"/></other>"
+    "</doc>") == 1 );
+
+  // text and namespace declarations changed
+  fail_unless( roundTrip(doc,
+    "<doc xmlns=\"http://a\" xmlns:c=\"http://b\">"
+    "<list id=\"l1\"><item id=\"i1\" kind=\"x\"/><item id=\"i2\"/>"
+    "<c:item id=\"i3\">other text</c:item></list>"
+    "<other id=\"o1\"><item id=\"i4\"/></other>"
+    "</doc>") == 3 );
+
+  // children inserted, deleted, renamed and moved
+  fail_unless( roundTrip(doc,
+    "<doc xmlns=\"http://a\" xmlns:b=\"http://b\">"
+    "<other id=\"o1\"><item id=\"i4\"/><item id=\"i5\"/></other>"
+    "<list id=\"l1\"><thing id=\"i1\" kind=\"x\"/>"
+    "<b:item id=\"i3\">text</b:item></list>"
+    "</doc>") > 0 );
+
+  fail_unless( roundTrip(doc, "<doc xmlns=\"http://a\"/>") == 3 );
+  fail_unless( roundTrip("<doc xmlns=\"http://a\"/>", doc) == 3 );
+  fail_unless( roundTrip(doc, "<other><list/></other>") > 0 );
+}
+END_TEST
+
+
+START_TEST (test_XMLNodeDiff_namespaces)
+{
+  // only the namespace declarations change
+  fail_unless( roundTrip("<r><e xmlns:p=\"urn:a\"/></r>",
+                         "<r><e xmlns:p=\"urn:b\"/></r>") == 1 );
+  fail_unless( roundTrip("<r><e/><e/></r>",
+                         "<r><e/><e xmlns:p=\"urn:a\"/></r>") == 1 );
+
+  // an attribute whose fields read like two namespace declarations
+  fail_unless( roundTrip(
+    "<r xmlns:C=\"urn:B\"><e C:A=\"urn:D\"/></r>",
+    "<r xmlns:C=\"urn:B\"><e xmlns:A=\"urn:B\" xmlns:C=\"urn:D\"/></r>")
+    > 0 );
+}
+END_TEST
+
+
+START_TEST (test_XMLNodeDiff_edits)
+{
+  XMLNode* from = parse("<a><b x=\"1\"/><c/><d/></a>");
+  XMLNode* to   = parse("<a><b x=\"2\"/><e/><d>text</d></a>");
+
+  XMLNodeDiff diff(*from, *to);
+  fail_unless( diff.getNumEdits() == 4 );
+  fail_unless( diff.getEdit(4) == NULL );
+
+  const XMLNodeEdit* edit = diff.getEdit(0);
+  fail_unless( edit->getType() == LIBLX_EDIT_SET_ATTRIBUTE );
+  fail_unless( edit->getPath() == vector<unsigned int>(1, 0) );
+  fail_unless( edit->getAttribute().getName() == "x" );
+  fail_unless( edit->getValue() == "2" );
+  fail_unless( edit->getNode() == NULL );
+
+  edit = diff.getEdit(1);
+  fail_unless( edit->getType() == LIBLX_EDIT_DELETE_NODE );
+  fail_unless( edit->getPath() == vector<unsigned int>(1, 1) );
+
+  edit = diff.getEdit(2);
+  fail_unless( edit->getType() == LIBLX_EDIT_INSERT_NODE );
+  fail_unless( edit->getPath() == vector<unsigned int>(1, 1) );
+  fail_unless( edit->getNode()->getName() == "e" );
+
+  edit = diff.getEdit(3);
+  vector<unsigned int> path(1, 2);
+  path.push_back(0);
+  fail_unless( edit->getType() == LIBLX_EDIT_INSERT_NODE );
+  fail_unless( edit->getPath() == path );
+  fail_unless( edit->getNode()->getCharacters() == "text" );
+
+  // a copy of the script works as well, and it does not fit other trees
+  XMLNodeDiff copy;
+  fail_unless( copy.isEmpty() );
+  copy = diff;
+  fail_unless( copy.getNumEdits() == 4 );
+
+  XMLNode other(XMLTriple("a", "", ""), XMLAttributes());
+  fail_unless( copy.apply(other) == LIBLX_INVALID_XML_OPERATION );
+  fail_unless( copy.apply(*from) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( from->toXMLString() == to->toXMLString() );
+
+  XMLNodeDiff_t* cdiff = XMLNodeDiff_create(from, to);
+  fail_unless( XMLNodeDiff_getNumEdits(cdiff) == 0 );
+  fail_unless( XMLNodeDiff_apply(cdiff, from) == LIBLX_OPERATION_SUCCESS );
+  XMLNodeDiff_free(cdiff);
+
+  fail_unless( XMLNodeDiff_create(NULL, to) == NULL );
+  fail_unless( XMLNodeDiff_getNumEdits(NULL) == 0 );
+  fail_unless( XMLNodeDiff_apply(NULL, from) == LIBLX_INVALID_OBJECT );
+
+  delete from;
+  delete to;
+}
+END_TEST
+
+
+START_TEST (test_XMLNodeDiff_large)
+{
+  XMLNode wide(XMLTriple("list", "", ""), XMLAttributes());
+  XMLAttributes attributes;
+
+  for (unsigned int n = 0; n < 5000; ++n)
+  {
+    attributes.clear();
+    attributes.add("n", string(1, (char)('a' + n % 26)) + char('a' + n / 26 % 26)
+                        + char('a' + n / 676));
+    wide.addChild(XMLNode(XMLTriple("item", "", ""), attributes));
+  }
+
+  XMLNode changed(wide);
+  changed.getChild(2500).addAttr("n", "changed");
+  delete changed.removeChild(100);
+  changed.insertChild(4000, XMLNode(XMLTriple("new", "", ""), XMLAttributes()));
+
+  XMLNodeDiff diff(wide, changed);
+  fail_unless( diff.getNumEdits() == 3 );
+
+  XMLNode copy(wide);
+  fail_unless( diff.apply(copy) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( copy.equals(changed) );
+  fail_unless( copy.getHash() == changed.getHash() );
+
+  // a deep chain is compared without recursion
+  XMLNode  deep(XMLTriple("n", "", ""), XMLAttributes());
+  XMLNode* node = &deep;
+  for (unsigned int n = 0; n < 5000; ++n)
+  {
+    node->addChild(XMLNode(XMLTriple("n", "", ""), XMLAttributes()));
+    node = &node->getChild(0);
+  }
+
+  XMLNode deeper(deep);
+  node = &deeper;
+  while (node->getNumChildren() > 0) node = &node->getChild(0);
+  node->addAttr("leaf", "1");
+
+  XMLNodeDiff chain(deep, deeper);
+  fail_unless( chain.getNumEdits() == 1 );
+  fail_unless( chain.getEdit(0)->getPath().size() == 5000 );
+  fail_unless( chain.apply(deep) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLNodeDiff(deep, deeper).isEmpty() );
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLNodeDiff (void)
+{
+  Suite *suite = suite_create("XMLNodeDiff");
+  TCase *tcase = tcase_create("XMLNodeDiff");
+
+  tcase_add_test( tcase, test_XMLNodeDiff_roundTrip  );
+  tcase_add_test( tcase, test_XMLNodeDiff_namespaces  );
+  tcase_add_test( tcase, test_XMLNodeDiff_edits  );
+  tcase_add_test( tcase, test_XMLNodeDiff_large  );
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
@@ -0,0 +1,250 @@
+/**
+ * @file    TestXMLNodeQuery.cpp
+ * @brief   XMLNodeQuery unit tests
+ *
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/operationReturnValues.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNamespaces.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLNodeQuery.h>
+
+#include <check.h>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+/** @endcond */
+
+
+CK_CPPSTART
+
+
+static const char* xmlstr =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<doc xmlns=\"http://a\" xmlns:b=\"http://b\">"
+  "  <list id=\"l1\">"
+  "    <item id=\"i1\" kind=\"x\"/>"
+  "    <item id=\"i2\"/>"
+  "    <b:item id=\"i3\" kind=\"x\"/>"
+  "    <list id=\"l2\">"
+  "      <item id=\"i4\" b:kind=\"y\"/>"
+  "      <item id=\"i5\" kind=\"x\"/>"
+  "    </list>"
+  "  </list>"
+  "  <b:other id=\"o1\">text</b:other>"
+  "</doc>";
+
+
+/*
+ * Returns the ids of the elements selected by path, separated by spaces,
+ * or "invalid" if path does not compile.
+ */
+static string
+selectIds (const XMLNode& root, const string& path,
+           const XMLNamespaces* namespaces = NULL)
+{
+  XMLNodeQuery query;
+  int          status = (namespaces == NULL) ? query.compile(path)
+                                             : query.compile(path, *namespaces);
+
+  if (status != LIBLX_OPERATION_SUCCESS) return "invalid";
+
+  vector<const XMLNode*> found;
+  query.evaluate(root, found);
+
+  string ids;
+  for (size_t n = 0; n < found.size(); ++n)
+  {
+    if (n > 0) ids += " ";
+    ids += found[n]->getAttrValue("id");
+  }
+
+  return ids;
+}
+
+
+START_TEST (test_XMLNodeQuery_paths)
+{
+  XMLInputStream stream(xmlstr, false);
+  XMLNode        root(stream);
+
+  fail_unless( selectIds(root, "/doc/list")            == "l1"             );
+  fail_unless( selectIds(root, "/list")                == ""               );
+  fail_unless( selectIds(root, "/doc/list/item")       == "i1 i2 i3"       );
+  fail_unless( selectIds(root, "//item")               == "i1 i2 i3 i4 i5" );
+  fail_unless( selectIds(root, "//list//item")         == "i1 i2 i3 i4 i5" );
+  fail_unless( selectIds(root, "/doc//list/item")      == "i1 i2 i3 i4 i5" );
+  fail_unless( selectIds(root, "//list")               == "l1 l2"          );
+  fail_unless( selectIds(root, "/doc/*")               == "l1 o1"          );
+  fail_unless( selectIds(root, "//b:*")                == "i3 o1"          );
+  fail_unless( selectIds(root, "//b:item")             == "i3"             );
+  fail_unless( selectIds(root, "//item[@kind]")        == "i1 i3 i4 i5"    );
+  fail_unless( selectIds(root, "//item[@kind='x']")    == "i1 i3 i5"       );
+  fail_unless( selectIds(root, "//item[@b:kind]")      == "i4"             );
+  fail_unless( selectIds(root, "//*[@id='i2']")        == "i2"             );
+
+  XMLNodeQuery query;
+  fail_unless( query.compile("//list/item") == LIBLX_OPERATION_SUCCESS );
+  fail_unless( query.getPath() == "//list/item" );
+  fail_unless( query.evaluateFirst(root)->getAttrValue("id") == "i1" );
+
+  vector<XMLNode*> found;
+  fail_unless( query.evaluate(root, found) == 5 );
+  fail_unless( found[4]->getAttrValue("id") == "i5" );
+}
+END_TEST
+
+
+START_TEST (test_XMLNodeQuery_position)
+{
+  XMLInputStream stream(xmlstr, false);
+  XMLNode        root(stream);
+
+  fail_unless( selectIds(root, "/doc/list/item[2]")         == "i2"    );
+  fail_unless( selectIds(root, "/doc/list/item[4]")         == ""      );
+  fail_unless( selectIds(root, "//item[1]")                 == "i1 i4" );
+  fail_unless( selectIds(root, "//item[@kind='x'][2]")      == "i3"    );
+  fail_unless( selectIds(root, "//item[2][@kind='x']")      == "i5"    );
+  fail_unless( selectIds(root, "//list[2]")                 == ""      );
+  fail_unless( selectIds(root, "/doc/*[2]")                 == "o1"    );
+}
+END_TEST
+
+
+START_TEST (test_XMLNodeQuery_namespaces)
+{
+  XMLInputStream stream(xmlstr, false);
+  XMLNode        root(stream);
+
+  XMLNamespaces namespaces;
+  namespaces.add("http://a", "a");
+  namespaces.add("http://b", "x");
+
+  fail_unless( selectIds(root, "//a:item", &namespaces)    == "i1 i2 i4 i5" );
+  fail_unless( selectIds(root, "//x:*", &namespaces)       == "i3 o1"       );
+  fail_unless( selectIds(root, "//b:*", &namespaces)       == "i3 o1"       );
+  fail_unless( selectIds(root, "//a:item[@x:kind]", &namespaces) == "i4"    );
+  fail_unless( selectIds(root, "//x:item[@kind]", &namespaces)   == "i3"    );
+}
+END_TEST
+
+
+START_TEST (test_XMLNodeQuery_invalid)
+{
+  XMLInputStream stream(xmlstr, false);
+  XMLNode        root(stream);
+
+  fail_unless( selectIds(root, "")                 == "invalid" );
+  fail_unless( selectIds(root, "doc")              == "invalid" );
+  fail_unless( selectIds(root, "/doc/")            == "invalid" );
+  fail_unless( selectIds(root, "/doc/@id")         == "invalid" );
+  fail_unless( selectIds(root, "//item[0]")        == "invalid" );
+  fail_unless( selectIds(root, "//item[1][2]")     == "invalid" );
+  fail_unless( selectIds(root, "//item[@id='i1]")  == "invalid" );
+
+  XMLNodeQuery query;
+  fail_unless( !query.isCompiled() );
+  fail_unless( query.evaluateFirst(root) == NULL );
+
+  query.compile("//item");
+  fail_unless( query.isCompiled() );
+
+  query.compile("//item[");
+  fail_unless( !query.isCompiled() );
+  fail_unless( query.getPath().empty() );
+}
+END_TEST
+
+
+START_TEST (test_XMLNodeQuery_parallel)
+{
+  string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<doc>";
+
+  for (unsigned int n = 0; n < 200; ++n)
+  {
+    xml += "<group><item id=\"a\"/><sub><item id=\"b\"/><item/></sub>"
+           "<item id=\"c\"/></group>";
+  }
+  xml += "</doc>";
+
+  XMLInputStream stream(xml.c_str(), false);
+  XMLNode        root(stream);
+
+  const char* paths[] = { "//item", "/doc/group/item[2]", "//sub/item[@id]",
+                          "/doc/group", "/doc" };
+
+  for (unsigned int p = 0; p < sizeof(paths) / sizeof(paths[0]); ++p)
+  {
+    XMLNodeQuery query;
+    query.compile(paths[p]);
+
+    vector<const XMLNode*> expected;
+    query.evaluate(root, expected);
+
+    for (unsigned int threads = 1; threads <= 4; ++threads)
+    {
+      vector<const XMLNode*> found;
+      fail_unless( query.evaluateParallel(root, found, threads)
+                   == expected.size() );
+      fail_unless( found == expected );
+    }
+  }
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLNodeQuery (void)
+{
+  Suite *suite = suite_create("XMLNodeQuery");
+  TCase *tcase = tcase_create("XMLNodeQuery");
+
+  tcase_add_test( tcase, test_XMLNodeQuery_paths  );
+  tcase_add_test( tcase, test_XMLNodeQuery_position  );
+  tcase_add_test( tcase, test_XMLNodeQuery_namespaces  );
+  tcase_add_test( tcase, test_XMLNodeQuery_invalid  );
+  tcase_add_test( tcase, test_XMLNodeQuery_parallel  );
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
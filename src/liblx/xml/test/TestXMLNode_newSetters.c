@@ -39,6 +39,7 @@
 #include <liblx/xml/XMLToken.h>
 #include <liblx/xml/XMLNode.h>
 #include <liblx/xml/XMLNamespaces.h>
+#include <liblx/xml/XMLNodeIterator.h>
 
 #include <liblx/xml/operationReturnValues.h>
 
@@ -405,6 +406,16 @@ START_TEST(test_XMLNode_accessWithNULL)
   fail_unless( XMLNode_hasAttrWithTriple(NULL, NULL) == 0);
   
   fail_unless( XMLNode_hasChild(NULL, NULL) == 0);
+  fail_unless( XMLNode_getNextIndex(NULL, 0) == -1);
+  fail_unless( XMLNode_getParent(NULL) == NULL);
+  fail_unless( XMLNode_addIdAttribute(NULL, NULL) == LIBLX_INVALID_OBJECT);
+  fail_unless( XMLNode_getNodeById(NULL, NULL) == NULL);
+  fail_unless( XMLNode_getNextSibling(NULL) == NULL);
+  fail_unless( XMLNode_getPreviousSibling(NULL) == NULL);
+  fail_unless( XMLNodeIterator_create(NULL, LIBLX_PRE_ORDER) == NULL);
+  fail_unless( XMLNodeIterator_next(NULL, NULL, NULL, 0) == 0);
+  fail_unless( XMLNodeIterator_isEnd(NULL) == 1);
+  fail_unless( XMLNode_getHash(NULL) == 0);
   fail_unless( XMLNode_hasNamespaceNS(NULL, NULL, NULL) == 0);
   fail_unless( XMLNode_hasNamespacePrefix(NULL, NULL) == 0);
   fail_unless( XMLNode_hasNamespaceURI(NULL, NULL) == 0);
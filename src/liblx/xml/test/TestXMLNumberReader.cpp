@@ -0,0 +1,302 @@
+/**
+ * @file    TestXMLNumberReader.cpp
+ * @brief   XMLNumberReader unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNumberReader.h>
+#include <liblx/xml/XMLOutputStream.h>
+#include <liblx/xml/XMLTriple.h>
+
+#include <check.h>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+/** @endcond */
+
+
+CK_CPPSTART
+
+
+START_TEST (test_XMLNumberReader_doubles)
+{
+  vector<double> values;
+  XMLErrorLog    log;
+
+  fail_unless( XMLNumberReader::readInto(
+    "  1 -2.5\n3e2\t.25 1.  INF -INF NaN 0.1 -0 12345678901234567890.5 \r\n",
+    values, &log) );
+
+  fail_unless( values.size() == 11 );
+  fail_unless( values[0] ==  1.0 );
+  fail_unless( values[1] == -2.5 );
+  fail_unless( values[2] == 300.0 );
+  fail_unless( values[3] == 0.25 );
+  fail_unless( values[4] == 1.0 );
+  fail_unless( values[5] ==   numeric_limits<double>::infinity() );
+  fail_unless( values[6] == - numeric_limits<double>::infinity() );
+  fail_unless( values[7] != values[7] );
+  fail_unless( values[8] == strtod("0.1", NULL) );
+  fail_unless( values[9] == 0.0 && signbit(values[9]) );
+  fail_unless( values[10] == strtod("12345678901234567890.5", NULL) );
+  fail_unless( log.getNumErrors() == 0 );
+
+  values.clear();
+  fail_unless( XMLNumberReader::readInto("", values) );
+  fail_unless( values.empty() );
+}
+END_TEST
+
+
+START_TEST (test_XMLNumberReader_matchesStrtod)
+{
+  vector<double> values;
+  string         text;
+  char           buffer[64];
+
+  srand(4711);
+
+  for (unsigned int n = 0; n < 2000; ++n)
+  {
+    double value = (rand() - RAND_MAX / 2) * pow(10.0, rand() % 40 - 20);
+    sprintf(buffer, (n % 2 == 0) ? "%.17g " : "%.6f ", value);
+    text += buffer;
+  }
+
+  fail_unless( XMLNumberReader::readInto(text, values) );
+  fail_unless( values.size() == 2000 );
+
+  const char* p = text.c_str();
+  for (unsigned int n = 0; n < values.size(); ++n)
+  {
+    char* end = NULL;
+    fail_unless( values[n] == strtod(p, &end) );
+    p = end;
+  }
+}
+END_TEST
+
+
+START_TEST (test_XMLNumberReader_invalid)
+{
+  vector<double> values;
+  XMLErrorLog    log;
+
+  fail_unless( !XMLNumberReader::readInto("1 two 3 4x inf", values, &log,
+                                          7, 9) );
+
+  fail_unless( values.size() == 3 );
+  fail_unless( values[0] == 1.0 );
+  fail_unless( values[1] == 3.0 );
+  fail_unless( log.getNumErrors() == 1 );
+  fail_unless( log.getError(0)->getErrorId() == XMLBadNumber );
+  fail_unless( log.getError(0)->getLine()    == 7 );
+  fail_unless( log.getError(0)->getColumn()  == 9 );
+
+  values.clear();
+  fail_unless( !XMLNumberReader::readInto("1e999", values) );
+  fail_unless( values.empty() );
+}
+END_TEST
+
+
+START_TEST (test_XMLNumberReader_integers)
+{
+  vector<int64_t> values;
+  XMLErrorLog     log;
+
+  fail_unless( XMLNumberReader::readInto(
+    "0 -1 +42 9223372036854775807 -9223372036854775808", values, &log) );
+
+  fail_unless( values.size() == 5 );
+  fail_unless( values[0] == 0 );
+  fail_unless( values[1] == -1 );
+  fail_unless( values[2] == 42 );
+  fail_unless( values[3] == numeric_limits<int64_t>::max() );
+  fail_unless( values[4] == numeric_limits<int64_t>::min() );
+
+  values.clear();
+  fail_unless( !XMLNumberReader::readInto(
+    "9223372036854775808 1.5 - 7", values, &log) );
+
+  fail_unless( values.size() == 1 );
+  fail_unless( values[0] == 7 );
+  fail_unless( log.getNumErrors() == 1 );
+}
+END_TEST
+
+
+START_TEST (test_XMLNumberReader_chunks)
+{
+  const string text = "1.5 -2.25e1 INF 42 NaN 0.001 -7 ";
+
+  for (size_t size = 1; size <= text.size(); ++size)
+  {
+    vector<double>  values;
+    XMLNumberReader reader(values);
+
+    for (size_t pos = 0; pos < text.size(); pos += size)
+    {
+      reader.append(text.substr(pos, size));
+    }
+
+    fail_unless( reader.finish() );
+    fail_unless( values.size() == 7 );
+    fail_unless( values[1] == -22.5 );
+    fail_unless( values[3] == 42.0 );
+    fail_unless( values[5] == 0.001 );
+    fail_unless( values[6] == -7.0 );
+  }
+
+  // the last number is only converted by finish()
+  vector<int64_t> integers;
+  XMLNumberReader reader(integers);
+
+  reader.append("12 3");
+  reader.append("4");
+  fail_unless( integers.size() == 1 );
+  fail_unless( reader.finish() );
+  fail_unless( integers.size() == 2 );
+  fail_unless( integers[1] == 34 );
+}
+END_TEST
+
+
+START_TEST (test_XMLNumberReader_stream)
+{
+  string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<data>";
+  char   buffer[32];
+
+  for (unsigned int n = 0; n < 10000; ++n)
+  {
+    sprintf(buffer, " %u.5", n);
+    xml += buffer;
+  }
+  xml += "</data>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+  stream.setCharacterChunkSize(256);
+  stream.next();
+
+  vector<double>  values;
+  XMLNumberReader reader(values, stream.getErrorLog());
+
+  stream.readCharacters(reader);
+
+  fail_unless( reader.finish() );
+  fail_unless( values.size() == 10000 );
+  fail_unless( values[0] == 0.5 );
+  fail_unless( values[9999] == 9999.5 );
+  fail_unless( stream.peek().isEnd() );
+}
+END_TEST
+
+
+START_TEST (test_XMLNumberReader_writeArray)
+{
+  vector<double> values;
+  values.push_back(0.1);
+  values.push_back(-1e-300);
+  values.push_back(numeric_limits<double>::infinity());
+  values.push_back(- numeric_limits<double>::infinity());
+  values.push_back(numeric_limits<double>::quiet_NaN());
+  values.push_back(3.0);
+
+  ostringstream   oss;
+  XMLOutputStream out(oss, "UTF-8", false);
+  XMLTriple       data("data", "", "");
+
+  out.startElement(data);
+  out.writeArray(values);
+  out.endElement(data);
+
+  fail_unless( oss.str() == "<data>0.1 -1e-300 INF -INF NaN 3</data>" );
+
+  const string   text = oss.str().substr(6, oss.str().size() - 13);
+  vector<double> read;
+
+  fail_unless( XMLNumberReader::readInto(text, read) );
+  fail_unless( read.size() == values.size() );
+  fail_unless( read[0] == values[0] );
+  fail_unless( read[1] == values[1] );
+  fail_unless( read[5] == values[5] );
+
+  vector<int64_t> integers;
+  integers.push_back(numeric_limits<int64_t>::min());
+  integers.push_back(5);
+
+  ostringstream   oss2;
+  XMLOutputStream out2(oss2, "UTF-8", false);
+
+  out2.startElement(data);
+  out2.writeArray(integers);
+  out2.endElement(data);
+
+  fail_unless( oss2.str() == "<data>-9223372036854775808 5</data>" );
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLNumberReader (void)
+{
+  Suite *suite = suite_create("XMLNumberReader");
+  TCase *tcase = tcase_create("XMLNumberReader");
+
+  tcase_add_test( tcase, test_XMLNumberReader_doubles  );
+  tcase_add_test( tcase, test_XMLNumberReader_matchesStrtod  );
+  tcase_add_test( tcase, test_XMLNumberReader_invalid  );
+  tcase_add_test( tcase, test_XMLNumberReader_integers  );
+  tcase_add_test( tcase, test_XMLNumberReader_chunks  );
+  tcase_add_test( tcase, test_XMLNumberReader_stream  );
+  tcase_add_test( tcase, test_XMLNumberReader_writeArray  );
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
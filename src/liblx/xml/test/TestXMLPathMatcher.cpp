@@ -0,0 +1,327 @@
+/**
+ * @file    TestXMLPathMatcher.cpp
+ * @brief   XMLPathMatcher unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * ------------------------------------------------------------------------ -->*/
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/operationReturnValues.h>
+#include <liblx/xml/XMLHandler.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNamespaces.h>
+#include <liblx/xml/XMLPathMatcher.h>
+#include <liblx/xml/XMLToken.h>
+
+#include <check.h>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+/** @endcond */
+
+
+CK_CPPSTART
+
+
+/*
+ * Records every match as "path:name" or "path:element@attribute=value",
+ * and the text of matched elements.
+ */
+class MatchRecorder : public XMLPathHandler
+{
+public:
+
+  MatchRecorder () : mReadText(false) { }
+
+  virtual void element (unsigned int path, const XMLToken& element,
+                        XMLInputStream& stream)
+  {
+    string match = toString(path) + ":" + element.getName();
+
+    if (mReadText && !element.isEnd())
+    {
+      Text text;
+      stream.readCharacters(text);
+      match += "=" + text.mText;
+    }
+
+    mMatches.push_back(match);
+  }
+
+  virtual void attribute (unsigned int path, const XMLToken& element,
+                          int index)
+  {
+    mMatches.push_back(toString(path) + ":" + element.getName() + "@" +
+                       element.getAttrName(index) + "=" +
+                       element.getAttrValue(index));
+  }
+
+  static string toString (unsigned int n)
+  {
+    return string(1, static_cast<char>('0' + n));
+  }
+
+  class Text : public XMLHandler
+  {
+  public:
+    virtual void characters (const XMLToken& data)
+    {
+      mText += data.getCharacters();
+    }
+
+    string mText;
+  };
+
+  vector<string> mMatches;
+  bool           mReadText;
+};
+
+
+static const char* model =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<sbml level=\"3\">\n"
+  "  <model id=\"m\">\n"
+  "    <listOfSpecies>\n"
+  "      <species id=\"A\" compartment=\"c\"/>\n"
+  "      <species id=\"B\" compartment=\"d\"><notes>B</notes></species>\n"
+  "    </listOfSpecies>\n"
+  "    <listOfReactions>\n"
+  "      <reaction id=\"r1\" reversible=\"false\">\n"
+  "        <math:math xmlns:math=\"http://www.w3.org/1998/Math/MathML\">"
+  "<math:ci>A</math:ci></math:math>\n"
+  "      </reaction>\n"
+  "      <reaction id=\"r2\"><name>second</name></reaction>\n"
+  "    </listOfReactions>\n"
+  "  </model>\n"
+  "</sbml>\n";
+
+
+static vector<string>
+runMatcher (XMLPathMatcher& matcher, bool readText = false)
+{
+  XMLInputStream stream(model, false, "");
+  MatchRecorder  recorder;
+
+  recorder.mReadText = readText;
+  matcher.match(stream, recorder);
+
+  return recorder.mMatches;
+}
+
+
+START_TEST (test_XMLPathMatcher_attributes)
+{
+  XMLPathMatcher matcher;
+
+  fail_unless( matcher.addPath("/sbml/model/listOfReactions/reaction/@id")
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( matcher.getNumPaths() == 1 );
+
+  vector<string> matches = runMatcher(matcher);
+
+  fail_unless( matches.size() == 2 );
+  fail_unless( matches[0] == "0:reaction@id=r1" );
+  fail_unless( matches[1] == "0:reaction@id=r2" );
+}
+END_TEST
+
+
+START_TEST (test_XMLPathMatcher_descendant)
+{
+  XMLPathMatcher matcher;
+
+  fail_unless( matcher.addPath("//species[@compartment='d']")
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( matcher.addPath("//math:ci") == LIBLX_OPERATION_SUCCESS );
+  fail_unless( matcher.addPath("/sbml//reaction[@reversible]/@*")
+               == LIBLX_OPERATION_SUCCESS );
+
+  vector<string> matches = runMatcher(matcher, true);
+
+  fail_unless( matches.size() == 4 );
+  fail_unless( matches[0] == "0:species=" );
+  fail_unless( matches[1] == "2:reaction@id=r1" );
+  fail_unless( matches[2] == "2:reaction@reversible=false" );
+  fail_unless( matches[3] == "1:ci=A" );
+}
+END_TEST
+
+
+START_TEST (test_XMLPathMatcher_position)
+{
+  XMLPathMatcher matcher;
+  XMLNamespaces  namespaces;
+
+  namespaces.add("http://www.w3.org/1998/Math/MathML", "m");
+
+  fail_unless( matcher.addPath("/sbml/model/listOfSpecies/species[2]/@id")
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( matcher.addPath("//reaction[1]") == LIBLX_OPERATION_SUCCESS );
+  fail_unless( matcher.addPath("//m:*", namespaces)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( matcher.addPath("/sbml/model/*[2]/*[@id][2]/@id")
+               == LIBLX_OPERATION_SUCCESS );
+
+  vector<string> matches = runMatcher(matcher);
+
+  fail_unless( matches.size() == 5 );
+  fail_unless( matches[0] == "0:species@id=B" );
+  fail_unless( matches[1] == "1:reaction" );
+  fail_unless( matches[2] == "2:math" );
+  fail_unless( matches[3] == "2:ci" );
+  fail_unless( matches[4] == "3:reaction@id=r2" );
+}
+END_TEST
+
+
+START_TEST (test_XMLPathMatcher_text)
+{
+  XMLPathMatcher matcher;
+
+  matcher.addPath("/sbml/model/listOfReactions/*/name");
+  matcher.addPath("//name");
+  matcher.addPath("//notes");
+
+  vector<string> matches = runMatcher(matcher, true);
+
+  fail_unless( matches.size() == 3 );
+  fail_unless( matches[0] == "2:notes=B" );
+  fail_unless( matches[1] == "0:name=second" );
+  // the text has already been read by the handler for the first path
+  fail_unless( matches[2] == "1:name=" );
+}
+END_TEST
+
+
+START_TEST (test_XMLPathMatcher_invalid)
+{
+  XMLPathMatcher matcher;
+
+  fail_unless( matcher.addPath("")              == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.addPath("model")         == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.addPath("/")             == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.addPath("/a/")           == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.addPath("/@id")          == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.addPath("/a/@id/b")      == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.addPath("/a[id]")        == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.addPath("/a[@id='x]")    == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.addPath("/a[@id=x]")     == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.addPath("/p:")           == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.addPath("/a[0]")         == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.addPath("/a[1][2]")      == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.getNumPaths() == 0 );
+
+  fail_unless( matcher.addPath("/a[@id=\"x\"][@b]/p:c")
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( matcher.getPath(0) == "/a[@id=\"x\"][@b]/p:c" );
+  fail_unless( matcher.getPath(1) == "" );
+
+  matcher.clear();
+  fail_unless( matcher.getNumPaths() == 0 );
+}
+END_TEST
+
+
+START_TEST (test_XMLPathMatcher_subtree)
+{
+  XMLInputStream stream(model, false, "");
+  XMLPathMatcher matcher;
+  MatchRecorder  recorder;
+
+  matcher.addPath("/species/@id");
+
+  stream.next();
+  stream.skipText();
+  stream.next();
+  stream.skipText();
+
+  XMLToken list = stream.next();
+  fail_unless( list.getName() == "listOfSpecies" );
+
+  // matching stops at the end of listOfSpecies
+  fail_unless( matcher.match(stream, recorder) == 2 );
+  fail_unless( recorder.mMatches.size() == 2 );
+  fail_unless( recorder.mMatches[1] == "0:species@id=B" );
+
+  stream.skipText();
+  fail_unless( stream.peek().isEndFor(list) );
+}
+END_TEST
+
+
+START_TEST (test_XMLPathMatcher_large)
+{
+  string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<doc>";
+
+  for (unsigned int n = 0; n < 5000; ++n)
+  {
+    xml += "<skip a=\"1\"><deep><deeper>text</deeper></deep></skip>"
+           "<item id=\"i\"/>";
+  }
+  xml += "</doc>";
+
+  XMLInputStream stream(xml.c_str(), false, "");
+  XMLPathMatcher matcher;
+  MatchRecorder  recorder;
+
+  matcher.addPath("/doc/item/@id");
+
+  fail_unless( matcher.match(stream, recorder) == 5000 );
+  fail_unless( !stream.isError() );
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLPathMatcher (void)
+{
+  Suite *suite = suite_create("XMLPathMatcher");
+  TCase *tcase = tcase_create("XMLPathMatcher");
+
+  tcase_add_test( tcase, test_XMLPathMatcher_attributes  );
+  tcase_add_test( tcase, test_XMLPathMatcher_descendant  );
+  tcase_add_test( tcase, test_XMLPathMatcher_position  );
+  tcase_add_test( tcase, test_XMLPathMatcher_text  );
+  tcase_add_test( tcase, test_XMLPathMatcher_invalid  );
+  tcase_add_test( tcase, test_XMLPathMatcher_subtree  );
+  tcase_add_test( tcase, test_XMLPathMatcher_large  );
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND